@@ -0,0 +1,646 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : AIS VDM/VDO decoder implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "AISDecoder.h"
+
+// C includes
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+// C++ includes
+
+// includes
+#include <N2kMessages.h>
+#include <NMEA0183Messages.h>
+#include "LatencyTrace.h"
+#include "Metrics.h"
+
+namespace
+{
+    // 6 bit value of a payload character, 0xff is not a payload character
+    const uint8_t kSixBit[128] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+        0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    };
+
+    // character of a 6 bit text value
+    const char kText[] = "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_ !\"#$%&'()*+,-./0123456789:;<=>?";
+
+    // bits each message must have, the spare bits at the end may be missing
+    const uint16_t kClassAPositionBits = 149;
+    const uint16_t kClassAStaticBits = 420;
+    const uint16_t kClassBPositionBits = 149;
+    const uint16_t kClassBExtendedBits = 308;
+    const uint16_t kClassBStaticABits = 160;
+    const uint16_t kClassBStaticBBits = 162;
+
+    const double kKnotsToMs = 1852.0 / 3600.0;
+    const double kDegToRad = M_PI / 180.0;
+
+    //-------------------------------------
+    // AIS fields to NMEA2000 units, the AIS not available values are
+    // sent as not available
+    //-------------------------------------
+
+    // 1/10000 minute
+    double Latitude(int32_t p_value)
+    {
+        return (p_value == 91 * 600000) ? N2kDoubleNA : p_value / 600000.0;
+    }
+
+    double Longitude(int32_t p_value)
+    {
+        return (p_value == 181 * 600000) ? N2kDoubleNA : p_value / 600000.0;
+    }
+
+    // 1/10 knot to m/s
+    double Speed(uint32_t p_value)
+    {
+        return (p_value == 1023) ? N2kDoubleNA : p_value * 0.1 * kKnotsToMs;
+    }
+
+    // 1/10 degree to rad
+    double Course(uint32_t p_value)
+    {
+        return (p_value >= 3600) ? N2kDoubleNA : p_value * 0.1 * kDegToRad;
+    }
+
+    // degree to rad
+    double Heading(uint32_t p_value)
+    {
+        return (p_value >= 360) ? N2kDoubleNA : p_value * kDegToRad;
+    }
+
+    // 4.733 x sqrt(degree/minute) to rad/s, +-127 is turning with no rate
+    double RateOfTurn(int32_t p_value)
+    {
+        if (p_value == -128 || p_value == 127 || p_value == -127)
+        {
+            return N2kDoubleNA;
+        }
+        double l_root = p_value / 4.733;
+        double l_rate = l_root * l_root * kDegToRad / 60.0;
+        return (p_value < 0) ? -l_rate : l_rate;
+    }
+
+    // m, 0 is not available
+    double Distance(uint32_t p_value)
+    {
+        return (p_value == 0) ? N2kDoubleNA : p_value;
+    }
+
+    // sum of the distances to each side, not available if both are 0
+    double Size(uint32_t p_first, uint32_t p_second)
+    {
+        return (p_first == 0 && p_second == 0) ? N2kDoubleNA : p_first + p_second;
+    }
+
+    //-------------------------------------
+    // Days since 1970 of a date
+    //-------------------------------------
+    uint16_t DaysSince1970(int p_year, unsigned int p_month, unsigned int p_day)
+    {
+        // years starting in March put the leap day last
+        int l_year = p_year - (p_month <= 2 ? 1 : 0);
+        int l_era = l_year / 400;
+        unsigned int l_yearOfEra = static_cast<unsigned int>(l_year - l_era * 400);
+        unsigned int l_dayOfYear = (153 * (p_month > 2 ? p_month - 3 : p_month + 9) + 2) / 5 + p_day - 1;
+        unsigned int l_dayOfEra = l_yearOfEra * 365 + l_yearOfEra / 4 - l_yearOfEra / 100 + l_dayOfYear;
+        return static_cast<uint16_t>(l_era * 146097 + static_cast<int>(l_dayOfEra) - 719468);
+    }
+
+    //-------------------------------------
+    // ETA has no year, it is the next time the month and day come round
+    //-------------------------------------
+    uint16_t ETADate(unsigned int p_month, unsigned int p_day)
+    {
+        if (p_month < 1 || p_month > 12 || p_day < 1 || p_day > 31)
+        {
+            return N2kUInt16NA;
+        }
+        time_t l_now = time(nullptr);
+        struct tm l_today;
+        gmtime_r(&l_now, &l_today);
+        int l_year = l_today.tm_year + 1900;
+        if (p_month < static_cast<unsigned int>(l_today.tm_mon + 1) ||
+            (p_month == static_cast<unsigned int>(l_today.tm_mon + 1) && p_day < static_cast<unsigned int>(l_today.tm_mday)))
+        {
+            l_year++;
+        }
+        return DaysSince1970(l_year, p_month, p_day);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+AISDecoder::AISDecoder(const std::string& p_rLabels)
+{
+    memset(m_partials, 0, sizeof(m_partials));
+
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    m_pDecoded = l_pRegistry->AddCounter("nmea2can_ais_decoded_total", "AIS messages decoded and sent as NMEA2000", p_rLabels);
+    m_pDropped = l_pRegistry->AddCounter("nmea2can_ais_dropped_total", "AIS sentences or messages that could not be decoded", p_rLabels);
+    m_pUnsupported = l_pRegistry->AddCounter("nmea2can_ais_unsupported_total", "AIS messages of a type that is not converted", p_rLabels);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool AISDecoder::HandleSentence(const tNMEA0183Msg &p_rMsg, SendFunction p_send)
+{
+    uint8_t l_count = 0;
+    uint8_t l_number = 0;
+    unsigned int l_sequenceId = 0;
+    char l_channel = 0;
+    char l_payload[MAX_NMEA0183_MSG_LEN];
+    unsigned int l_length = sizeof(l_payload);
+    unsigned int l_fillBits = 0;
+    if (!NMEA0183ParseVDM_nc(p_rMsg, l_count, l_number, l_sequenceId, l_channel, l_length, l_payload, l_fillBits) ||
+        l_number == 0 || l_number > l_count)
+    {
+        m_pDropped->Add();
+        return false;
+    }
+
+    // VDO is our own ship, as transmitted
+    bool l_own = p_rMsg.IsMessageCode("VDO");
+    tN2kAISTransceiverInformation l_info;
+    if (l_channel == 'B')
+    {
+        l_info = l_own ? N2kaischannel_B_VDL_transmission : N2kaischannel_B_VDL_reception;
+    }
+    else
+    {
+        l_info = l_own ? N2kaischannel_A_VDL_transmission : N2kaischannel_A_VDL_reception;
+    }
+
+    if (l_count == 1)
+    {
+        return Decode(l_payload, static_cast<uint16_t>(l_length), l_fillBits, l_info, p_send);
+    }
+
+    Partial &l_rPartial = m_partials[l_channel == 'B' ? 1 : 0][l_sequenceId % kSequenceIds];
+    if (l_number == 1)
+    {
+        // the last message with the id never finished
+        if (l_rPartial.m_count != 0)
+        {
+            m_pDropped->Add();
+        }
+        l_rPartial.m_count = l_count;
+        l_rPartial.m_received = 0;
+        l_rPartial.m_length = 0;
+        l_rPartial.m_startedMs = p_rMsg.MessageTime();
+    }
+    else if (l_rPartial.m_count != l_count || l_number != l_rPartial.m_received + 1 ||
+             p_rMsg.MessageTime() - l_rPartial.m_startedMs > kPartTimeoutMs)
+    {
+        // a part is missing
+        l_rPartial.m_count = 0;
+        m_pDropped->Add();
+        return false;
+    }
+
+    if (l_rPartial.m_length + l_length > kMaxPayload)
+    {
+        l_rPartial.m_count = 0;
+        m_pDropped->Add();
+        return false;
+    }
+    memcpy(l_rPartial.m_payload + l_rPartial.m_length, l_payload, l_length);
+    l_rPartial.m_length += static_cast<uint16_t>(l_length);
+    l_rPartial.m_received++;
+    if (l_rPartial.m_received < l_rPartial.m_count)
+    {
+        return true;
+    }
+
+    // fill bits are on the last part
+    l_rPartial.m_count = 0;
+    return Decode(l_rPartial.m_payload, l_rPartial.m_length, l_fillBits, l_info, p_send);
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+/// Decode
+///- Details:   Unpacks the payload and decodes the message by its type.
+///             A type that is not converted is not an error
+///
+///- Returns:   false if the payload or message is not valid
+///- Throws:    n/a
+bool AISDecoder::Decode(const char *p_pPayload, uint16_t p_length, unsigned int p_fillBits,
+                        tN2kAISTransceiverInformation p_info, SendFunction p_send)
+{
+    BitReader l_bits;
+    if (!l_bits.Load(p_pPayload, p_length, p_fillBits))
+    {
+        m_pDropped->Add();
+        return false;
+    }
+    LatencyTrace::Stamp(eTraceStage::Parse);
+
+    bool l_decoded = false;
+    switch (l_bits.GetUInt(0, 6))
+    {
+    case 1:
+    case 2:
+    case 3:
+        l_decoded = DecodeClassAPosition(l_bits, p_info, p_send);
+        break;
+    case 5:
+        l_decoded = DecodeClassAStatic(l_bits, p_info, p_send);
+        break;
+    case 18:
+        l_decoded = DecodeClassBPosition(l_bits, p_info, p_send);
+        break;
+    case 19:
+        l_decoded = DecodeClassBExtended(l_bits, p_info, p_send);
+        break;
+    case 24:
+        l_decoded = DecodeClassBStatic(l_bits, p_info, p_send);
+        break;
+    default:
+        m_pUnsupported->Add();
+        return true;
+    }
+
+    if (l_decoded)
+    {
+        m_pDecoded->Add();
+    }
+    else
+    {
+        m_pDropped->Add();
+    }
+    return l_decoded;
+}
+
+/// DecodeClassAPosition
+///- Details:   Message 1, 2 or 3 to PGN 129038
+///
+///- Returns:   false if the message is too short
+///- Throws:    n/a
+bool AISDecoder::DecodeClassAPosition(const BitReader &p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send)
+{
+    if (p_rBits.Bits() < kClassAPositionBits)
+    {
+        return false;
+    }
+
+    tN2kMsg l_msg;
+    SetN2kAISClassAPosition(l_msg,
+                            static_cast<uint8_t>(p_rBits.GetUInt(0, 6)),
+                            static_cast<tN2kAISRepeat>(p_rBits.GetUInt(6, 2)),
+                            p_rBits.GetUInt(8, 30),
+                            Latitude(p_rBits.GetInt(89, 27)),
+                            Longitude(p_rBits.GetInt(61, 28)),
+                            p_rBits.GetUInt(60, 1) != 0,
+                            p_rBits.GetUInt(148, 1) != 0,
+                            static_cast<uint8_t>(p_rBits.GetUInt(137, 6)),
+                            Course(p_rBits.GetUInt(116, 12)),
+                            Speed(p_rBits.GetUInt(50, 10)),
+                            p_info,
+                            Heading(p_rBits.GetUInt(128, 9)),
+                            RateOfTurn(p_rBits.GetInt(42, 8)),
+                            static_cast<tN2kAISNavStatus>(p_rBits.GetUInt(38, 4)));
+    p_send(l_msg);
+    return true;
+}
+
+/// DecodeClassAStatic
+///- Details:   Message 5 to PGN 129794. The position fixing device is
+///             sent as received, the PGN field has the AIS values
+///
+///- Returns:   false if the message is too short
+///- Throws:    n/a
+bool AISDecoder::DecodeClassAStatic(const BitReader &p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send)
+{
+    if (p_rBits.Bits() < kClassAStaticBits)
+    {
+        return false;
+    }
+
+    char l_callsign[8];
+    char l_name[21];
+    char l_destination[21];
+    p_rBits.GetText(70, 7, l_callsign);
+    p_rBits.GetText(112, 20, l_name);
+    p_rBits.GetText(302, 20, l_destination);
+
+    uint32_t l_imo = p_rBits.GetUInt(40, 30);
+    uint32_t l_bow = p_rBits.GetUInt(240, 9);
+    uint32_t l_stern = p_rBits.GetUInt(249, 9);
+    uint32_t l_port = p_rBits.GetUInt(258, 6);
+    uint32_t l_starboard = p_rBits.GetUInt(264, 6);
+    uint32_t l_hour = p_rBits.GetUInt(283, 5);
+    uint32_t l_minute = p_rBits.GetUInt(288, 6);
+    double l_etaTime = (l_hour < 24 && l_minute < 60) ? (l_hour * 3600.0 + l_minute * 60.0) : N2kDoubleNA;
+    uint32_t l_draught = p_rBits.GetUInt(294, 8);
+
+    tN2kMsg l_msg;
+    SetN2kAISClassAStatic(l_msg, 5,
+                          static_cast<tN2kAISRepeat>(p_rBits.GetUInt(6, 2)),
+                          p_rBits.GetUInt(8, 30),
+                          (l_imo == 0) ? N2kUInt32NA : l_imo,
+                          l_callsign,
+                          l_name,
+                          static_cast<uint8_t>(p_rBits.GetUInt(232, 8)),
+                          Size(l_bow, l_stern),
+                          Size(l_port, l_starboard),
+                          Distance(l_starboard),
+                          Distance(l_bow),
+                          ETADate(p_rBits.GetUInt(274, 4), p_rBits.GetUInt(278, 5)),
+                          l_etaTime,
+                          (l_draught == 0) ? N2kDoubleNA : l_draught * 0.1,
+                          l_destination,
+                          static_cast<tN2kAISVersion>(p_rBits.GetUInt(38, 2)),
+                          static_cast<tN2kGNSStype>(p_rBits.GetUInt(270, 4)),
+                          static_cast<tN2kAISDTE>(p_rBits.GetUInt(422, 1)),
+                          p_info);
+    p_send(l_msg);
+    return true;
+}
+
+/// DecodeClassBPosition
+///- Details:   Message 18 to PGN 129039
+///
+///- Returns:   false if the message is too short
+///- Throws:    n/a
+bool AISDecoder::DecodeClassBPosition(const BitReader &p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send)
+{
+    if (p_rBits.Bits() < kClassBPositionBits)
+    {
+        return false;
+    }
+
+    tN2kMsg l_msg;
+    SetN2kAISClassBPosition(l_msg, 18,
+                            static_cast<tN2kAISRepeat>(p_rBits.GetUInt(6, 2)),
+                            p_rBits.GetUInt(8, 30),
+                            Latitude(p_rBits.GetInt(85, 27)),
+                            Longitude(p_rBits.GetInt(57, 28)),
+                            p_rBits.GetUInt(56, 1) != 0,
+                            p_rBits.GetUInt(147, 1) != 0,
+                            static_cast<uint8_t>(p_rBits.GetUInt(133, 6)),
+                            Course(p_rBits.GetUInt(112, 12)),
+                            Speed(p_rBits.GetUInt(46, 10)),
+                            p_info,
+                            Heading(p_rBits.GetUInt(124, 9)),
+                            p_rBits.GetUInt(141, 1) != 0 ? N2kaisunit_ClassB_CS : N2kaisunit_ClassB_SOTDMA,
+                            p_rBits.GetUInt(142, 1) != 0,
+                            p_rBits.GetUInt(143, 1) != 0,
+                            p_rBits.GetUInt(144, 1) != 0,
+                            p_rBits.GetUInt(145, 1) != 0,
+                            p_rBits.GetUInt(146, 1) != 0 ? N2kaismode_Assigned : N2kaismode_Autonomous,
+                            p_rBits.GetUInt(148, 1) != 0);
+    p_send(l_msg);
+    return true;
+}
+
+/// DecodeClassBExtended
+///- Details:   Message 19 to PGN 129039 for the position, 129809 for the
+///             name and 129810 for the type and size. Units that send
+///             message 19 do not send message 24, so there is no call sign
+///
+///- Returns:   false if the message is too short
+///- Throws:    n/a
+bool AISDecoder::DecodeClassBExtended(const BitReader &p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send)
+{
+    if (p_rBits.Bits() < kClassBExtendedBits)
+    {
+        return false;
+    }
+
+    tN2kAISRepeat l_repeat = static_cast<tN2kAISRepeat>(p_rBits.GetUInt(6, 2));
+    uint32_t l_mmsi = p_rBits.GetUInt(8, 30);
+
+    tN2kMsg l_msg;
+    SetN2kAISClassBPosition(l_msg, 19, l_repeat, l_mmsi,
+                            Latitude(p_rBits.GetInt(85, 27)),
+                            Longitude(p_rBits.GetInt(57, 28)),
+                            p_rBits.GetUInt(56, 1) != 0,
+                            p_rBits.GetUInt(305, 1) != 0,
+                            static_cast<uint8_t>(p_rBits.GetUInt(133, 6)),
+                            Course(p_rBits.GetUInt(112, 12)),
+                            Speed(p_rBits.GetUInt(46, 10)),
+                            p_info,
+                            Heading(p_rBits.GetUInt(124, 9)),
+                            N2kaisunit_ClassB_SOTDMA, false, false, false, false,
+                            p_rBits.GetUInt(307, 1) != 0 ? N2kaismode_Assigned : N2kaismode_Autonomous,
+                            false);
+    p_send(l_msg);
+
+    char l_name[21];
+    p_rBits.GetText(143, 20, l_name);
+    SetN2kAISClassBStaticPartA(l_msg, 19, l_repeat, l_mmsi, l_name, p_info);
+    p_send(l_msg);
+
+    uint32_t l_bow = p_rBits.GetUInt(271, 9);
+    uint32_t l_stern = p_rBits.GetUInt(280, 9);
+    uint32_t l_port = p_rBits.GetUInt(289, 6);
+    uint32_t l_starboard = p_rBits.GetUInt(295, 6);
+    SetN2kAISClassBStaticPartB(l_msg, 19, l_repeat, l_mmsi,
+                               static_cast<uint8_t>(p_rBits.GetUInt(263, 8)), "", "",
+                               Size(l_bow, l_stern),
+                               Size(l_port, l_starboard),
+                               Distance(l_starboard),
+                               Distance(l_bow),
+                               N2kUInt32NA, p_info);
+    p_send(l_msg);
+    return true;
+}
+
+/// DecodeClassBStatic
+///- Details:   Message 24 part A to PGN 129809, part B to PGN 129810. An
+///             auxiliary craft (MMSI 98xxxxxxx) has the mothership's
+///             MMSI where the size would be
+///
+///- Returns:   false if the message is too short or the part not known
+///- Throws:    n/a
+bool AISDecoder::DecodeClassBStatic(const BitReader &p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send)
+{
+    tN2kAISRepeat l_repeat = static_cast<tN2kAISRepeat>(p_rBits.GetUInt(6, 2));
+    uint32_t l_mmsi = p_rBits.GetUInt(8, 30);
+    uint32_t l_part = p_rBits.GetUInt(38, 2);
+
+    tN2kMsg l_msg;
+    if (l_part == 0 && p_rBits.Bits() >= kClassBStaticABits)
+    {
+        char l_name[21];
+        p_rBits.GetText(40, 20, l_name);
+        SetN2kAISClassBStaticPartA(l_msg, 24, l_repeat, l_mmsi, l_name, p_info);
+        p_send(l_msg);
+        return true;
+    }
+    if (l_part != 1 || p_rBits.Bits() < kClassBStaticBBits)
+    {
+        return false;
+    }
+
+    char l_vendor[4];
+    char l_callsign[8];
+    p_rBits.GetText(48, 3, l_vendor);
+    p_rBits.GetText(90, 7, l_callsign);
+
+    double l_length = N2kDoubleNA;
+    double l_beam = N2kDoubleNA;
+    double l_starboard = N2kDoubleNA;
+    double l_bow = N2kDoubleNA;
+    uint32_t l_mothership = N2kUInt32NA;
+    if (l_mmsi / 10000000 == 98)
+    {
+        l_mothership = p_rBits.GetUInt(132, 30);
+    }
+    else
+    {
+        uint32_t l_toBow = p_rBits.GetUInt(132, 9);
+        uint32_t l_toStern = p_rBits.GetUInt(141, 9);
+        uint32_t l_toPort = p_rBits.GetUInt(150, 6);
+        uint32_t l_toStarboard = p_rBits.GetUInt(156, 6);
+        l_length = Size(l_toBow, l_toStern);
+        l_beam = Size(l_toPort, l_toStarboard);
+        l_starboard = Distance(l_toStarboard);
+        l_bow = Distance(l_toBow);
+    }
+
+    SetN2kAISClassBStaticPartB(l_msg, 24, l_repeat, l_mmsi,
+                               static_cast<uint8_t>(p_rBits.GetUInt(40, 8)), l_vendor, l_callsign,
+                               l_length, l_beam, l_starboard, l_bow, l_mothership, p_info);
+    p_send(l_msg);
+    return true;
+}
+
+/// BitReader::Load
+///- Details:   Looks up each character's 6 bits and packs them into
+///             bytes. The fill bits at the end are cleared
+///
+///- Returns:   false if the payload is too long or has a character that
+///             is not 6 bit
+///- Throws:    n/a
+bool AISDecoder::BitReader::Load(const char *p_pPayload, uint16_t p_length, unsigned int p_fillBits)
+{
+    if (p_length > kMaxPayload)
+    {
+        return false;
+    }
+
+    uint32_t l_pending = 0;     // bits not yet written
+    int l_pendingBits = 0;
+    uint16_t l_byte = 0;
+    for (uint16_t l_index = 0; l_index < p_length; l_index++)
+    {
+        uint8_t l_char = static_cast<uint8_t>(p_pPayload[l_index]);
+        uint8_t l_value = (l_char < sizeof(kSixBit)) ? kSixBit[l_char] : 0xff;
+        if (l_value == 0xff)
+        {
+            return false;
+        }
+        l_pending = (l_pending << 6) | l_value;
+        l_pendingBits += 6;
+        if (l_pendingBits >= 8)
+        {
+            l_pendingBits -= 8;
+            m_data[l_byte++] = static_cast<uint8_t>(l_pending >> l_pendingBits);
+            l_pending &= (1u << l_pendingBits) - 1;
+        }
+    }
+    if (l_pendingBits > 0)
+    {
+        m_data[l_byte] = static_cast<uint8_t>(l_pending << (8 - l_pendingBits));
+    }
+
+    uint16_t l_bits = p_length * 6;
+    m_bits = (p_fillBits < l_bits) ? static_cast<uint16_t>(l_bits - p_fillBits) : 0;
+    if ((m_bits & 7) != 0)
+    {
+        m_data[m_bits >> 3] &= static_cast<uint8_t>(0xff << (8 - (m_bits & 7)));
+    }
+    return true;
+}
+
+/// BitReader::GetUInt
+///- Details:   Reads an unsigned field, up to 32 bits, msb first. A byte
+///             at a time, the bits of the field in each byte are masked
+///
+///- Returns:   the field
+///- Throws:    n/a
+uint32_t AISDecoder::BitReader::GetUInt(uint16_t p_start, uint8_t p_bits) const
+{
+    uint32_t l_value = 0;
+    uint16_t l_end = p_start + p_bits;
+    uint16_t l_bytes = (m_bits + 7) >> 3;
+    for (uint16_t l_bit = p_start; l_bit < l_end;)
+    {
+        uint16_t l_byte = l_bit >> 3;
+        int l_offset = l_bit & 7;
+        int l_take = 8 - l_offset;
+        if (l_take > l_end - l_bit)
+        {
+            l_take = l_end - l_bit;
+        }
+        uint32_t l_data = (l_byte < l_bytes) ? m_data[l_byte] : 0;
+        l_value = (l_value << l_take) | ((l_data >> (8 - l_offset - l_take)) & ((1u << l_take) - 1));
+        l_bit += l_take;
+    }
+    return l_value;
+}
+
+/// BitReader::GetInt
+///- Details:   Reads a two's complement field
+///
+///- Returns:   the field
+///- Throws:    n/a
+int32_t AISDecoder::BitReader::GetInt(uint16_t p_start, uint8_t p_bits) const
+{
+    uint32_t l_value = GetUInt(p_start, p_bits);
+    if (l_value & (1u << (p_bits - 1)))
+    {
+        l_value |= ~((1u << p_bits) - 1);
+    }
+    return static_cast<int32_t>(l_value);
+}
+
+/// BitReader::GetText
+///- Details:   Reads 6 bit characters. '@' ends the text, trailing spaces
+///             are padding
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void AISDecoder::BitReader::GetText(uint16_t p_start, uint8_t p_chars, char *p_pText) const
+{
+    uint8_t l_length = 0;
+    for (; l_length < p_chars; l_length++)
+    {
+        uint32_t l_value = GetUInt(p_start + l_length * 6, 6);
+        if (l_value == 0)
+        {
+            break;
+        }
+        p_pText[l_length] = kText[l_value];
+    }
+    while (l_length > 0 && p_pText[l_length - 1] == ' ')
+    {
+        l_length--;
+    }
+    p_pText[l_length] = '\0';
+}
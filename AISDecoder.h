@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : AIS VDM/VDO decoder header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _AIS_DECODER_H_INCLUDED_
+#define _AIS_DECODER_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <string>
+
+// includes
+#include <N2kMsg.h>
+#include <N2kTypes.h>
+#include <NMEA0183Msg.h>
+
+// forward declarations
+class MetricCounter;
+
+//----------------------------------------------
+// AIS Decoder turns the AIS messages carried in VDM (other ships) and
+// VDO (own ship) sentences into the NMEA2000 AIS PGNs.
+//
+//   1, 2, 3    class A position report     129038
+//   5          class A static and voyage   129794
+//   18         class B position report     129039
+//   19         class B extended report     129039, 129809, 129810
+//   24         class B static data         129809 (part A), 129810 (part B)
+//
+// A message longer than one sentence is sent in parts with a sequential
+// message id. The parts are held, one message for each id and channel,
+// until the last part arrives. A part out of order or older than
+// kPartTimeoutMs drops the message.
+//
+// The payload is 6 bit characters, each is looked up in a table and the
+// bits packed into bytes, the fields are read from the bytes. Everything
+// is held in fixed buffers so a busy port does not allocate for each
+// message. The decoder is not thread safe, it is used by one converter
+// thread.
+//----------------------------------------------
+class AISDecoder
+{
+public:
+    typedef void (*SendFunction)(tN2kMsg& p_rMsg);
+
+    /// Constructor
+    /// Detail- AIS Decoder constructor, p_rLabels labels the metrics of
+    ///         the decoder, e.g. converter="main"
+    /// Returns- n/a
+    /// Throws - n/a
+    explicit AISDecoder(const std::string& p_rLabels = "");
+
+    /// HandleSentence
+    /// Detail- Adds a VDM or VDO sentence, when it completes a message the
+    ///         message is decoded and its PGNs are sent
+    /// Returns- false if the sentence or the message could not be used
+    /// Throws - n/a
+    bool HandleSentence
+    (
+        const tNMEA0183Msg& p_rMsg,     ///< VDM or VDO sentence
+        SendFunction p_send             ///< called with each PGN
+    );
+
+private:
+    static const uint16_t kMaxPayload = 168;        ///< characters in the longest message, 1008 bits
+    static const int kSequenceIds = 10;             ///< sequential message ids 0 to 9
+    static const uint32_t kPartTimeoutMs = 2000;    ///< time for the parts of a message to arrive
+
+    //----------------------------------------------
+    // Parts of a message received so far
+    //----------------------------------------------
+    struct Partial
+    {
+        char m_payload[kMaxPayload];    ///< payload of the parts joined
+        uint16_t m_length;              ///< characters in m_payload
+        uint8_t m_count;                ///< parts in the message, 0 when not in use
+        uint8_t m_received;             ///< parts received
+        unsigned long m_startedMs;      ///< time the first part arrived
+    };
+
+    //----------------------------------------------
+    // Reads the fields from a payload. Bits beyond the end of the
+    // payload read as 0, some senders leave off the spare bits
+    //----------------------------------------------
+    class BitReader
+    {
+    public:
+        // unpack the payload, false if a character is not 6 bit
+        bool Load(const char* p_pPayload, uint16_t p_length, unsigned int p_fillBits);
+
+        uint32_t GetUInt(uint16_t p_start, uint8_t p_bits) const;
+        int32_t GetInt(uint16_t p_start, uint8_t p_bits) const;
+
+        // 6 bit text, trailing '@' and spaces removed. p_pText holds p_chars + 1
+        void GetText(uint16_t p_start, uint8_t p_chars, char* p_pText) const;
+
+        uint16_t Bits() const { return m_bits; }
+
+    private:
+        uint8_t m_data[kMaxPayload * 6 / 8];    ///!< payload bits, first bit is the msb of m_data[0]
+        uint16_t m_bits;                        ///!< bits in the payload
+    };
+
+    // decode a complete message and send its PGNs
+    bool Decode(const char* p_pPayload, uint16_t p_length, unsigned int p_fillBits,
+                tN2kAISTransceiverInformation p_info, SendFunction p_send);
+
+    // messages, each returns false if the message is too short
+    bool DecodeClassAPosition(const BitReader& p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send);
+    bool DecodeClassAStatic(const BitReader& p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send);
+    bool DecodeClassBPosition(const BitReader& p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send);
+    bool DecodeClassBExtended(const BitReader& p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send);
+    bool DecodeClassBStatic(const BitReader& p_rBits, tN2kAISTransceiverInformation p_info, SendFunction p_send);
+
+    Partial m_partials[2][kSequenceIds];    ///!< messages being joined, for channel A and B
+
+    MetricCounter* m_pDecoded;              ///!< messages decoded
+    MetricCounter* m_pDropped;              ///!< sentences or messages that could not be used
+    MetricCounter* m_pUnsupported;          ///!< messages of types not converted
+};
+
+#endif
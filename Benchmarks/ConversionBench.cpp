@@ -0,0 +1,651 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Microbenchmarks of the NMEA0183 to NMEA2000
+//                        conversion hot path, using Google Benchmark
+//
+//                        make bench && ./bench
+//
+//                        Each benchmark reports ns/op and allocs/op, the
+//                        heap allocations made per operation. Keep a run
+//                        to compare against with
+//                        ./bench --benchmark_out=bench.json --benchmark_out_format=json
+//                        and compare with benchmark's tools/compare.py
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// C++ includes
+#include <atomic>
+#include <new>
+#include <string>
+
+// includes
+#include <benchmark/benchmark.h>
+#include <NMEA0183.h>
+#include <NMEA0183Msg.h>
+#include <NMEA0183Messages.h>
+#include <N2kMessages.h>
+#include <Seasmart.h>
+#include <NMEA2000_Loopback.h>
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations(0);     // operator new calls
+
+    const uint32_t cOpenTimeoutMs = 2000;       // time to open and claim an address
+
+    // sentences the converter handles, without the $ and checksum
+    const char cRMC[] = "GPRMC,123519.00,A,5048.123,N,00106.456,W,5.5,54.7,191026,3.1,W,A";
+    const char cGGA[] = "GPGGA,123519.00,5048.123,N,00106.456,W,1,09,0.9,10.5,M,47.0,M,,";
+    const char cGLL[] = "GPGLL,5048.123,N,00106.456,W,123519.00,A,A";
+    const char cGSV[] = "GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00";
+    const char cZDA[] = "GPZDA,123519.00,19,10,2026,00,00";
+    const char cHDT[] = "HCHDT,274.07,T";
+    const char cVTG[] = "GPVTG,54.7,T,57.8,M,5.5,N,10.2,K,A";
+    const char cMWV[] = "WIMWV,214.8,R,12.4,N,A";
+    const char cVHW[] = "VWVHW,274.1,T,277.2,M,5.1,N,9.4,K";
+    const char cDPT[] = "SDDPT,12.6,0.5,100";
+
+    //-------------------------------------
+    // full sentence with $ and checksum
+    //-------------------------------------
+    std::string MakeSentence(const char * p_pBody)
+    {
+        uint8_t l_checksum = 0;
+        for (const char * l_pChar = p_pBody; *l_pChar != '\0'; l_pChar++)
+        {
+            l_checksum ^= static_cast<uint8_t>(*l_pChar);
+        }
+        char l_tail[8];
+        snprintf(l_tail, sizeof(l_tail), "*%02X", l_checksum);
+        return std::string("$") + p_pBody + l_tail;
+    }
+
+    //-------------------------------------
+    // parsed sentence for the parser benchmarks
+    //-------------------------------------
+    tNMEA0183Msg ParsedSentence(const char * p_pBody)
+    {
+        tNMEA0183Msg l_msg;
+        if (!l_msg.SetMessage(MakeSentence(p_pBody).c_str()))
+        {
+            fprintf(stderr, "invalid benchmark sentence %s\n", p_pBody);
+            exit(1);
+        }
+        return l_msg;
+    }
+
+    //-------------------------------------
+    // the GNSS position of the converter, a 43 byte fast packet
+    //-------------------------------------
+    void SetGNSS(tN2kMsg & p_rMsg)
+    {
+        SetN2kGNSS(p_rMsg, 1, 20745, 45319.0, 50.80205, -1.10760, 10.5,
+                   N2kGNSSt_GPS, N2kGNSSm_GNSSfix, 9, 0.9, 0, 47.0, 1, N2kGNSSt_GPS, 0, 0);
+    }
+
+    //-------------------------------------
+    // Reports the heap allocations made while it is in scope as allocs/op
+    //-------------------------------------
+    class AllocationCounter
+    {
+    public:
+        explicit AllocationCounter(benchmark::State & p_rState)
+        : m_rState(p_rState), m_start(g_allocations.load(std::memory_order_relaxed)) {}
+
+        ~AllocationCounter()
+        {
+            m_rState.counters["allocs/op"] = benchmark::Counter(
+                static_cast<double>(g_allocations.load(std::memory_order_relaxed) - m_start),
+                benchmark::Counter::kAvgIterations);
+        }
+
+    private:
+        benchmark::State & m_rState;
+        uint64_t m_start;
+    };
+
+    //-------------------------------------
+    // Serial port in memory, the received bytes are a block of sentences
+    // read again and again. Gives the bytes one at a time or, as the
+    // Linux stream does, in chunks as a serial port delivers them
+    //-------------------------------------
+    class MemoryStream : public tNMEA0183Stream
+    {
+    public:
+        MemoryStream(bool p_span) : m_span(p_span), m_pos(0)
+        {
+            for (int l_index = 0; l_index < 16; l_index++)
+            {
+                m_data += MakeSentence(cRMC) + "\r\n" + MakeSentence(cGGA) + "\r\n" + MakeSentence(cHDT) + "\r\n";
+            }
+        }
+
+        int available() override { Rewind(); return static_cast<int>(m_data.size() - m_pos); }
+        int read() override { Rewind(); return static_cast<uint8_t>(m_data[m_pos++]); }
+        int readSpan(const uint8_t *& p_rpData) override
+        {
+            p_rpData = nullptr;
+            if (!m_span)
+            {
+                return -1;
+            }
+            Rewind();
+            size_t l_size = m_data.size() - m_pos;
+            p_rpData = reinterpret_cast<const uint8_t *>(m_data.data()) + m_pos;
+            return static_cast<int>(l_size < cChunkSize ? l_size : cChunkSize);
+        }
+        void consume(size_t p_size) override { m_pos += p_size; }
+        size_t write(const uint8_t *, size_t p_size) override { return p_size; }
+
+    private:
+        static const size_t cChunkSize = 64;    // a USB serial adaptor transfer
+
+        void Rewind()
+        {
+            if (m_pos == m_data.size())
+            {
+                m_pos = 0;
+            }
+        }
+
+        bool m_span;
+        std::string m_data;
+        size_t m_pos;
+    };
+
+    //-------------------------------------
+    // Loopback driver with no peer, frames sent go nowhere. Exposes the
+    // frame reassembly of the library.
+    //-------------------------------------
+    class NullNMEA2000 : public tNMEA2000_Loopback
+    {
+    public:
+        using tNMEA2000::SetN2kCANBufMsg;
+
+        // open and claim an address, so messages can be sent
+        bool Start()
+        {
+            SetMode(tNMEA2000::N2km_ListenAndNode, 45);
+            EnableForward(false);
+            for (uint32_t l_waitMs = 0; l_waitMs < cOpenTimeoutMs; l_waitMs++)
+            {
+                if (IsAddressClaimed())
+                {
+                    return true;
+                }
+                ParseMessages();
+                usleep(1000);
+            }
+            return false;
+        }
+    };
+
+    //-------------------------------------
+    // the CAN frames of a message, as the library sends them
+    //-------------------------------------
+    int MakeFrames(const tN2kMsg & p_rMsg, unsigned long & p_rCanId, unsigned char p_frames[][8], int p_maxFrames)
+    {
+        p_rCanId = (static_cast<unsigned long>(p_rMsg.Priority & 0x7) << 26) | (p_rMsg.PGN << 8) | p_rMsg.Source;
+        if (p_rMsg.DataLen <= 8)
+        {
+            memset(p_frames[0], 0xff, 8);
+            memcpy(p_frames[0], p_rMsg.Data, p_rMsg.DataLen);
+            return 1;
+        }
+
+        int l_frames = 0;
+        int l_position = 0;
+        while (l_position < p_rMsg.DataLen && l_frames < p_maxFrames)
+        {
+            unsigned char * l_pFrame = p_frames[l_frames];
+            memset(l_pFrame, 0xff, 8);
+            l_pFrame[0] = static_cast<unsigned char>(l_frames);
+            int l_start = 1;
+            if (l_frames == 0)
+            {
+                l_pFrame[1] = static_cast<unsigned char>(p_rMsg.DataLen);
+                l_start = 2;
+            }
+            for (int l_index = l_start; l_index < 8 && l_position < p_rMsg.DataLen; l_index++)
+            {
+                l_pFrame[l_index] = p_rMsg.Data[l_position++];
+            }
+            l_frames++;
+        }
+        return l_frames;
+    }
+}
+
+//----------------------------------------------------------------
+// count heap allocations for allocs/op. Every form of new and delete
+// is replaced so an array or sized delete never reaches the library
+// operator with memory from malloc. None of them is inlined, gcc would
+// otherwise pair malloc() with operator delete, or operator new with
+// free(), and warn (-Wmismatched-new-delete)
+//----------------------------------------------------------------
+static void * CountedAllocate(size_t p_size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void * l_pMemory = malloc(p_size ? p_size : 1);
+    if (l_pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return l_pMemory;
+}
+
+__attribute__((noinline)) void * operator new(size_t p_size)
+{
+    return CountedAllocate(p_size);
+}
+
+__attribute__((noinline)) void * operator new[](size_t p_size)
+{
+    return CountedAllocate(p_size);
+}
+
+__attribute__((noinline)) void operator delete(void * p_pMemory) noexcept
+{
+    free(p_pMemory);
+}
+
+__attribute__((noinline)) void operator delete(void * p_pMemory, size_t) noexcept
+{
+    free(p_pMemory);
+}
+
+__attribute__((noinline)) void operator delete[](void * p_pMemory) noexcept
+{
+    free(p_pMemory);
+}
+
+__attribute__((noinline)) void operator delete[](void * p_pMemory, size_t) noexcept
+{
+    free(p_pMemory);
+}
+
+//----------------------------------------------------------------
+// NMEA0183 sentence framing
+//----------------------------------------------------------------
+static void BM_SetMessage(benchmark::State & p_rState, const char * p_pBody)
+{
+    std::string l_sentence = MakeSentence(p_pBody);
+    tNMEA0183Msg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(l_msg.SetMessage(l_sentence.c_str()));
+    }
+}
+BENCHMARK_CAPTURE(BM_SetMessage, RMC, cRMC);
+BENCHMARK_CAPTURE(BM_SetMessage, GGA, cGGA);
+BENCHMARK_CAPTURE(BM_SetMessage, HDT, cHDT);
+BENCHMARK_CAPTURE(BM_SetMessage, MWV, cMWV);
+
+//----------------------------------------------------------------
+// NMEA0183 sentences framed from a stream, a byte at a time or a
+// chunk at a time
+//----------------------------------------------------------------
+static void BM_GetMessage(benchmark::State & p_rState, bool p_span)
+{
+    MemoryStream l_stream(p_span);
+    tNMEA0183 l_nmea0183(&l_stream);
+    l_nmea0183.Open();
+    tNMEA0183Msg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(l_nmea0183.GetMessage(l_msg));
+    }
+}
+BENCHMARK_CAPTURE(BM_GetMessage, Byte, false);
+BENCHMARK_CAPTURE(BM_GetMessage, Span, true);
+
+//----------------------------------------------------------------
+// NMEA0183 parsers used by the converter
+//----------------------------------------------------------------
+static void BM_ParseRMC(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cRMC);
+    double l_time, l_latitude, l_longitude, l_cog, l_sog, l_variation;
+    unsigned long l_days;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseRMC_nc(l_msg, l_time, l_latitude, l_longitude, l_cog, l_sog, l_days, l_variation));
+    }
+}
+BENCHMARK(BM_ParseRMC);
+
+static void BM_ParseGGA(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cGGA);
+    double l_time, l_latitude, l_longitude, l_hdop, l_altitude, l_separation, l_age;
+    int l_quality, l_satellites, l_station;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseGGA_nc(l_msg, l_time, l_latitude, l_longitude, l_quality, l_satellites,
+                                                     l_hdop, l_altitude, l_separation, l_age, l_station));
+    }
+}
+BENCHMARK(BM_ParseGGA);
+
+static void BM_ParseGLL(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cGLL);
+    tGLL l_gll;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseGLL_nc(l_msg, l_gll));
+    }
+}
+BENCHMARK(BM_ParseGLL);
+
+static void BM_ParseGSV(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cGSV);
+    int l_total, l_this, l_satellites;
+    struct tGSV l_gsv[4];
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseGSV_nc(l_msg, l_total, l_this, l_satellites, l_gsv[0], l_gsv[1], l_gsv[2], l_gsv[3]));
+    }
+}
+BENCHMARK(BM_ParseGSV);
+
+static void BM_ParseZDA(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cZDA);
+    tZDA l_zda;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseZDA(l_msg, l_zda));
+    }
+}
+BENCHMARK(BM_ParseZDA);
+
+static void BM_ParseHDT(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cHDT);
+    double l_heading;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseHDT_nc(l_msg, l_heading));
+    }
+}
+BENCHMARK(BM_ParseHDT);
+
+static void BM_ParseVTG(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cVTG);
+    double l_trueCOG, l_magneticCOG, l_sog;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseVTG_nc(l_msg, l_trueCOG, l_magneticCOG, l_sog));
+    }
+}
+BENCHMARK(BM_ParseVTG);
+
+static void BM_ParseMWV(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cMWV);
+    double l_angle, l_speed;
+    tNMEA0183WindReference l_reference;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseMWV_nc(l_msg, l_angle, l_reference, l_speed));
+    }
+}
+BENCHMARK(BM_ParseMWV);
+
+static void BM_ParseVHW(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cVHW);
+    double l_trueHeading, l_magneticHeading, l_sow;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseVHW_nc(l_msg, l_trueHeading, l_magneticHeading, l_sow));
+    }
+}
+BENCHMARK(BM_ParseVHW);
+
+static void BM_ParseDPT(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg = ParsedSentence(cDPT);
+    double l_depth, l_offset, l_range;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(NMEA0183ParseDPT_nc(l_msg, l_depth, l_offset, l_range));
+    }
+}
+BENCHMARK(BM_ParseDPT);
+
+//----------------------------------------------------------------
+// NMEA0183 sentences built from NMEA2000 data, with the checksum
+//----------------------------------------------------------------
+static void BM_BuildMWV(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg;
+    char l_buffer[MAX_NMEA0183_MSG_LEN + 8];
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        NMEA0183SetMWV(l_msg, 45.3, NMEA0183Wind_Apparent, 7.56, "II");
+        benchmark::DoNotOptimize(l_msg.GetMessage(l_buffer, sizeof(l_buffer)));
+    }
+}
+BENCHMARK(BM_BuildMWV);
+
+static void BM_BuildRMC(benchmark::State & p_rState)
+{
+    tNMEA0183Msg l_msg;
+    char l_buffer[MAX_NMEA0183_MSG_LEN + 8];
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        NMEA0183SetRMC(l_msg, 43200.5, 50.123456, -1.654321, 3.5, 4.2, 19650, 0.04, "GP");
+        benchmark::DoNotOptimize(l_msg.GetMessage(l_buffer, sizeof(l_buffer)));
+    }
+}
+BENCHMARK(BM_BuildRMC);
+
+//----------------------------------------------------------------
+// NMEA2000 messages made by the converter
+//----------------------------------------------------------------
+static void BM_SetN2kGNSS(benchmark::State & p_rState)
+{
+    tN2kMsg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        SetGNSS(l_msg);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+    }
+}
+BENCHMARK(BM_SetN2kGNSS);
+
+static void BM_SetN2kHeading(benchmark::State & p_rState)
+{
+    tN2kMsg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        SetN2kMagneticHeading(l_msg, 1, 4.78, 0, 0.05);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+        SetN2kTrueHeading(l_msg, 1, 4.83);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+    }
+}
+BENCHMARK(BM_SetN2kHeading);
+
+static void BM_SetN2kWind(benchmark::State & p_rState)
+{
+    tN2kMsg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        SetN2kWindSpeed(l_msg, 1, 6.4, 3.75, N2kWind_Apparent);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+    }
+}
+BENCHMARK(BM_SetN2kWind);
+
+static void BM_SetN2kDepth(benchmark::State & p_rState)
+{
+    tN2kMsg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        SetN2kPGN128267(l_msg, 1, 12.6, 0.5, 100);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+    }
+}
+BENCHMARK(BM_SetN2kDepth);
+
+static void BM_SetN2kSpeed(benchmark::State & p_rState)
+{
+    tN2kMsg l_msg;
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        SetN2kCOGSOGRapid(l_msg, 1, N2khr_true, 0.95, 2.83);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+        SetN2kBoatSpeed(l_msg, 1, 2.83);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+        SetN2kPGN128259(l_msg, 1, 2.62, 0.0, N2kSWRT_Paddle_wheel);
+        benchmark::DoNotOptimize(l_msg.DataLen);
+    }
+}
+BENCHMARK(BM_SetN2kSpeed);
+
+//----------------------------------------------------------------
+// NMEA2000 library send path to a driver which drops the frames
+//----------------------------------------------------------------
+static void BM_SendMsg(benchmark::State & p_rState, bool p_fastPacket)
+{
+    NullNMEA2000 l_nmea2000;
+    if (!l_nmea2000.Start())
+    {
+        p_rState.SkipWithError("NMEA2000 did not open");
+        return;
+    }
+    tN2kMsg l_msg;
+    if (p_fastPacket)
+    {
+        SetGNSS(l_msg);
+    }
+    else
+    {
+        SetN2kTrueHeading(l_msg, 1, 4.83);
+    }
+    if (!l_nmea2000.SendMsg(l_msg))
+    {
+        p_rState.SkipWithError("NMEA2000 did not send");
+        return;
+    }
+
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(l_nmea2000.SendMsg(l_msg));
+    }
+}
+BENCHMARK_CAPTURE(BM_SendMsg, SingleFrame, false);
+BENCHMARK_CAPTURE(BM_SendMsg, FastPacket, true);
+
+//----------------------------------------------------------------
+// NMEA2000 library receive path, frames to a complete message
+//----------------------------------------------------------------
+static void BM_SetN2kCANBufMsg(benchmark::State & p_rState, bool p_fastPacket)
+{
+    NullNMEA2000 l_nmea2000;
+    if (!l_nmea2000.Start())
+    {
+        p_rState.SkipWithError("NMEA2000 did not open");
+        return;
+    }
+    tN2kMsg l_msg;
+    if (p_fastPacket)
+    {
+        SetGNSS(l_msg);
+    }
+    else
+    {
+        SetN2kTrueHeading(l_msg, 1, 4.83);
+    }
+    l_msg.Source = 10;
+    l_msg.Priority = 2;
+
+    unsigned long l_canId;
+    unsigned char l_frames[32][8];
+    int l_frameCount = MakeFrames(l_msg, l_canId, l_frames, 32);
+
+    AllocationCounter l_allocations(p_rState);
+    uint8_t l_sequence = 0;
+    for (auto _ : p_rState)
+    {
+        tN2kCANMsg * l_pCANMsg = nullptr;
+        for (int l_index = 0; l_index < l_frameCount; l_index++)
+        {
+            unsigned char l_frame[8];
+            memcpy(l_frame, l_frames[l_index], 8);
+            if (l_frameCount > 1)
+            {
+                l_frame[0] |= static_cast<unsigned char>(l_sequence << 5);
+            }
+            l_pCANMsg = l_nmea2000.SetN2kCANBufMsg(l_canId, 8, l_frame);
+        }
+        if (l_pCANMsg == nullptr)
+        {
+            p_rState.SkipWithError("message not reassembled");
+            break;
+        }
+        benchmark::DoNotOptimize(l_pCANMsg->N2kMsg.DataLen);
+        l_pCANMsg->FreeMessage();
+        l_sequence = (l_sequence + 1) & 0x7;
+    }
+    p_rState.SetItemsProcessed(p_rState.iterations() * l_frameCount);
+}
+BENCHMARK_CAPTURE(BM_SetN2kCANBufMsg, SingleFrame, false);
+BENCHMARK_CAPTURE(BM_SetN2kCANBufMsg, FastPacket, true);
+
+//----------------------------------------------------------------
+// NMEA2000 message to a Seasmart $PCDIN sentence
+//----------------------------------------------------------------
+static void BM_N2kToSeasmart(benchmark::State & p_rState)
+{
+    tN2kMsg l_msg;
+    SetGNSS(l_msg);
+    char l_buffer[200];
+    AllocationCounter l_allocations(p_rState);
+    for (auto _ : p_rState)
+    {
+        benchmark::DoNotOptimize(N2kToSeasmart(l_msg, 123456, l_buffer, sizeof(l_buffer)));
+    }
+}
+BENCHMARK(BM_N2kToSeasmart);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Binary log record encoding implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "BinaryLog.h"
+
+// C includes
+#include <stdio.h>
+
+// C++ includes
+
+// includes
+
+namespace
+{
+    //----------------------------------------------
+    // Reads the tagged arguments of a record
+    //----------------------------------------------
+    class ArgReader
+    {
+    public:
+        ArgReader(const char * p_pArgs, int p_length) : m_pArgs(p_pArgs), m_length(p_length), m_position(0) {}
+
+        // next argument, false if there are no more
+        bool Next(uint8_t & p_rType, const char *& p_rpValue, int & p_rLength)
+        {
+            if (m_position >= m_length)
+            {
+                return false;
+            }
+            p_rType = static_cast<uint8_t>(m_pArgs[m_position++]);
+            p_rpValue = m_pArgs + m_position;
+            switch (p_rType)
+            {
+            case BinaryLog::cArgString:
+                if (m_position >= m_length)
+                {
+                    return false;
+                }
+                p_rLength = 1 + static_cast<uint8_t>(m_pArgs[m_position]);
+                break;
+            case BinaryLog::cArgInt:
+            case BinaryLog::cArgUInt:
+            case BinaryLog::cArgDouble:
+            case BinaryLog::cArgPointer:
+                p_rLength = 8;
+                break;
+            default:
+                m_position = m_length;
+                return false;
+            }
+            if (m_position + p_rLength > m_length)
+            {
+                m_position = m_length;
+                return false;
+            }
+            m_position += p_rLength;
+            return true;
+        }
+
+    private:
+        const char * m_pArgs;   ///< record arguments
+        int m_length;           ///< length of the arguments
+        int m_position;         ///< next argument
+    };
+
+    bool IsFlag(char p_char)
+    {
+        return p_char == '-' || p_char == '+' || p_char == ' ' || p_char == '#' || p_char == '0';
+    }
+
+    bool IsLengthModifier(char p_char)
+    {
+        return p_char == 'h' || p_char == 'l' || p_char == 'L' || p_char == 'q'
+            || p_char == 'j' || p_char == 'z' || p_char == 't';
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int BinaryLog::Format(const char * p_pFormat, const char * p_pArgs, int p_argsLength, char * p_pOut, int p_outSize)
+{
+    ArgReader l_reader(p_pArgs, p_argsLength);
+    int l_length = 0;
+
+    if (p_outSize <= 0)
+    {
+        return 0;
+    }
+
+    const char * l_pFormat = p_pFormat;
+    while (*l_pFormat != '\0' && l_length < p_outSize - 1)
+    {
+        if (*l_pFormat != '%')
+        {
+            p_pOut[l_length++] = *l_pFormat++;
+            continue;
+        }
+        if (l_pFormat[1] == '%')
+        {
+            p_pOut[l_length++] = '%';
+            l_pFormat += 2;
+            continue;
+        }
+
+        // copy the flags, width and precision, drop the length modifiers
+        char l_spec[32];
+        int l_specLength = 0;
+        l_spec[l_specLength++] = *l_pFormat++;
+        while ((IsFlag(*l_pFormat) || (*l_pFormat >= '0' && *l_pFormat <= '9') || *l_pFormat == '.')
+               && l_specLength < 24)
+        {
+            l_spec[l_specLength++] = *l_pFormat++;
+        }
+        while (IsLengthModifier(*l_pFormat))
+        {
+            l_pFormat++;
+        }
+        char l_conversion = *l_pFormat;
+        if (l_conversion == '\0')
+        {
+            break;
+        }
+        l_pFormat++;
+
+        uint8_t l_type;
+        const char * l_pValue;
+        int l_valueLength;
+        int l_room = p_outSize - l_length;
+        int l_written = 0;
+        if (!l_reader.Next(l_type, l_pValue, l_valueLength))
+        {
+            l_written = snprintf(p_pOut + l_length, l_room, "<?>");
+        }
+        else
+        {
+            int64_t l_int = 0;
+            uint64_t l_uint = 0;
+            double l_double = 0.0;
+            char l_string[256] = { 0 };
+            switch (l_type)
+            {
+            case cArgInt:
+                memcpy(&l_int, l_pValue, 8);
+                l_uint = static_cast<uint64_t>(l_int);
+                l_double = static_cast<double>(l_int);
+                break;
+            case cArgUInt:
+            case cArgPointer:
+                memcpy(&l_uint, l_pValue, 8);
+                l_int = static_cast<int64_t>(l_uint);
+                l_double = static_cast<double>(l_uint);
+                break;
+            case cArgDouble:
+                memcpy(&l_double, l_pValue, 8);
+                l_int = static_cast<int64_t>(l_double);
+                l_uint = static_cast<uint64_t>(l_int);
+                break;
+            case cArgString:
+                memcpy(l_string, l_pValue + 1, l_valueLength - 1);
+                break;
+            }
+
+            switch (l_conversion)
+            {
+            case 'd':
+            case 'i':
+                l_spec[l_specLength++] = 'l';
+                l_spec[l_specLength++] = 'l';
+                l_spec[l_specLength++] = l_conversion;
+                l_spec[l_specLength] = '\0';
+                l_written = snprintf(p_pOut + l_length, l_room, l_spec, static_cast<long long>(l_int));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                l_spec[l_specLength++] = 'l';
+                l_spec[l_specLength++] = 'l';
+                l_spec[l_specLength++] = l_conversion;
+                l_spec[l_specLength] = '\0';
+                l_written = snprintf(p_pOut + l_length, l_room, l_spec, static_cast<unsigned long long>(l_uint));
+                break;
+            case 'c':
+                l_spec[l_specLength++] = 'c';
+                l_spec[l_specLength] = '\0';
+                l_written = snprintf(p_pOut + l_length, l_room, l_spec, static_cast<int>(l_int));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                l_spec[l_specLength++] = l_conversion;
+                l_spec[l_specLength] = '\0';
+                l_written = snprintf(p_pOut + l_length, l_room, l_spec, l_double);
+                break;
+            case 's':
+                l_spec[l_specLength++] = 's';
+                l_spec[l_specLength] = '\0';
+                l_written = snprintf(p_pOut + l_length, l_room, l_spec, l_type == cArgString ? l_string : "<?>");
+                break;
+            case 'p':
+                l_written = snprintf(p_pOut + l_length, l_room, "0x%llx", static_cast<unsigned long long>(l_uint));
+                break;
+            default:
+                l_written = snprintf(p_pOut + l_length, l_room, "<%c?>", l_conversion);
+                break;
+            }
+        }
+
+        if (l_written > 0)
+        {
+            l_length += (l_written < l_room) ? l_written : l_room - 1;
+        }
+    }
+
+    p_pOut[l_length] = '\0';
+    return l_length;
+}
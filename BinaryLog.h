@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Binary log record encoding header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _BINARY_LOG_H_INCLUDED_
+#define _BINARY_LOG_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+#include <string.h>
+
+// C++ includes
+#include <type_traits>
+
+// includes
+
+//----------------------------------------------
+// Deferred format logging. A call site records the id of its
+// format string and the raw arguments, each tagged with its type.
+// The text is made later by the logger thread or by the offline
+// decoder (Tools/LogDecode.cpp) from the binary log file.
+//
+// Binary log file -
+//   cFileMagic
+//   records, each starting with a record type byte
+//   Format  - 'F' id(2) length(2) format string
+//   Message - 'M' id(2) time ms since epoch(8) length(2) arguments
+// Numbers are little endian. Each file holds the formats it uses.
+//----------------------------------------------
+namespace BinaryLog
+{
+    const char cFileMagic[8] = { 'N', '2', 'C', 'B', 'L', 'O', 'G', '1' };
+    const uint8_t cRecordFormat = 'F';
+    const uint8_t cRecordMessage = 'M';
+
+    // argument type tags
+    const uint8_t cArgInt = 'i';        ///< int64
+    const uint8_t cArgUInt = 'u';       ///< uint64
+    const uint8_t cArgDouble = 'd';     ///< double
+    const uint8_t cArgString = 's';     ///< length(1) and characters, truncated to 255
+    const uint8_t cArgPointer = 'p';    ///< uint64
+
+    //----------------------------------------------
+    // Writes tagged arguments into a record
+    //----------------------------------------------
+    class ArgWriter
+    {
+    public:
+        ArgWriter(char * p_pBuffer, int p_size) : m_pBuffer(p_pBuffer), m_size(p_size), m_length(0), m_overflow(false) {}
+
+        void Put(uint8_t p_type, const void * p_pValue, int p_length)
+        {
+            if (m_length + 1 + p_length > m_size)
+            {
+                m_overflow = true;
+                return;
+            }
+            m_pBuffer[m_length++] = static_cast<char>(p_type);
+            memcpy(m_pBuffer + m_length, p_pValue, p_length);
+            m_length += p_length;
+        }
+
+        int GetLength() const { return m_length; }
+        bool IsOverflow() const { return m_overflow; }
+
+    private:
+        char * m_pBuffer;   ///< record arguments
+        int m_size;         ///< size of the buffer
+        int m_length;       ///< bytes written
+        bool m_overflow;    ///< arguments did not fit
+    };
+
+    // argument encoders, one per type family
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    PutArg(ArgWriter & p_rWriter, T p_value)
+    {
+        int64_t l_value = p_value;
+        p_rWriter.Put(cArgInt, &l_value, sizeof(l_value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    PutArg(ArgWriter & p_rWriter, T p_value)
+    {
+        uint64_t l_value = p_value;
+        p_rWriter.Put(cArgUInt, &l_value, sizeof(l_value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type
+    PutArg(ArgWriter & p_rWriter, T p_value)
+    {
+        int64_t l_value = static_cast<int64_t>(p_value);
+        p_rWriter.Put(cArgInt, &l_value, sizeof(l_value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    PutArg(ArgWriter & p_rWriter, T p_value)
+    {
+        double l_value = p_value;
+        p_rWriter.Put(cArgDouble, &l_value, sizeof(l_value));
+    }
+
+    inline void PutArg(ArgWriter & p_rWriter, const char * p_pValue)
+    {
+        if (p_pValue == nullptr)
+        {
+            p_pValue = "(null)";
+        }
+        size_t l_length = strlen(p_pValue);
+        char l_buffer[256];
+        l_buffer[0] = static_cast<char>(l_length > 255 ? 255 : l_length);
+        memcpy(l_buffer + 1, p_pValue, static_cast<uint8_t>(l_buffer[0]));
+        p_rWriter.Put(cArgString, l_buffer, 1 + static_cast<uint8_t>(l_buffer[0]));
+    }
+
+    inline void PutArg(ArgWriter & p_rWriter, char * p_pValue)
+    {
+        PutArg(p_rWriter, static_cast<const char *>(p_pValue));
+    }
+
+    inline void PutArg(ArgWriter & p_rWriter, const void * p_pValue)
+    {
+        uint64_t l_value = reinterpret_cast<uintptr_t>(p_pValue);
+        p_rWriter.Put(cArgPointer, &l_value, sizeof(l_value));
+    }
+
+    inline void PutArgs(ArgWriter &)
+    {
+    }
+
+    template <typename T, typename... Args>
+    void PutArgs(ArgWriter & p_rWriter, T p_value, Args... p_args)
+    {
+        PutArg(p_rWriter, p_value);
+        PutArgs(p_rWriter, p_args...);
+    }
+
+    /// Format
+    /// Detail- printf style formatting of recorded arguments. Length
+    ///         modifiers in the format are ignored, the recorded type
+    ///         is used. Missing arguments are shown as <?>
+    /// Returns- length of the text, truncated to fit p_outSize
+    /// Throws - n/a
+    int Format
+    (
+        const char * p_pFormat,     ///< format string of the call site
+        const char * p_pArgs,       ///< recorded arguments
+        int p_argsLength,           ///< length of the arguments
+        char * p_pOut,              ///< text output
+        int p_outSize               ///< size of the output
+    );
+}
+
+#endif
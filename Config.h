@@ -32,12 +32,37 @@ const uint16_t cDEFAULT_IQ_STREAM_OUTPUT_PORT = 14105;
 
 const uint16_t cDEFAULT_NMEA_PORT       = 15001;
 
+// UDP NMEA0183 input. With a multicast group the reader joins it on the
+// adaptor, empty to receive unicast and broadcast. Without a group more
+// than one reader shares the port with SO_REUSEPORT, each sender is read
+// by one of them
+const uint16_t cUDP_NMEA_PORT = 2031;
+const char cUDP_MULTICAST_GROUP[] = {""};
+const uint32_t cUDP_READER_THREADS = 1;
+
+// UDP NMEA0183 sources, address/prefix lists ending with 0. A denied
+// source is dropped, and when there is an allow list only the sources
+// on it are read. Each source may send cUDP_SOURCE_RATE datagrams a
+// second with bursts of cUDP_SOURCE_BURST (rate 0 for no limit). The
+// sources on cUDP_ROUTE_BUS1_SOURCES are converted onto the second bus
+// only, the rest go to both buses
+const char * const cUDP_ALLOW_SOURCES[] = {0};
+const char * const cUDP_DENY_SOURCES[] = {0};
+const uint32_t cUDP_SOURCE_RATE = 200;
+const uint32_t cUDP_SOURCE_BURST = 50;
+const char * const cUDP_ROUTE_BUS1_SOURCES[] = {0};
+
 // Addressesq
 const char cDEFAULT_ADAPTOR_ADDRESS[] = {"0.0.0.0"};
 const char cADDRESS_ANY[] = {"192.168.1.21"};
 
 // Devices
+// Serial NMEA0183 inputs, read as the UDP input. A port that is not
+// present is skipped
 const char cSERIAL_DEVICE[] = {"/dev/ttyUSB0"};
+const uint32_t cSERIAL_BAUD = 4800;
+const char cSERIAL_DEVICE_AIS[] = {"/dev/ttyUSB1"};
+const uint32_t cSERIAL_BAUD_AIS = 38400;
 #ifdef ZYNQ
 const char cDEFAULT_ADAPTOR[] = {"eth0"};
 const char cDEFAULT_ADAPTOR_ALT[] = {"eth0"};
@@ -47,9 +72,78 @@ const char cDEFAULT_ADAPTOR[] = {"wlan0"};
 //const char cDEFAULT_ADAPTOR_ALT[] = {"wlan0"};
 #endif
 
+// TCP NMEA0183 - clients connect to cDEFAULT_TCP_PORT, and the gateway
+// connects out to a multiplexer at cTCP_CLIENT_ADDRESS (empty for none).
+// Sentences for a client that is not reading are dropped once
+// cTCP_TX_QUEUE_BYTES are queued to it
+const char cTCP_CLIENT_ADDRESS[] = {""};
+const uint16_t cTCP_CLIENT_PORT = 10110;
+const uint32_t cTCP_MAX_CONNECTIONS = 512;
+const uint32_t cTCP_TX_QUEUE_BYTES = 64 * 1024;
+const uint32_t cTCP_RECONNECT_MS = 5000;
+
 // Timeouts
 const uint16_t cGUI_LINK_TIMEOUT_MS = 5000;
 const uint16_t cNMEA_TIME_OUT_MS = 5000;
 
+// NMEA2000 buses
+const char cCAN_PORT_0[] = {"can0"};
+const char cCAN_PORT_1[] = {"can1"};
+const uint8_t cN2K_ADDRESS_0 = 45;
+const uint8_t cN2K_ADDRESS_1 = 46;
+// bus 1 uses CAN FD framing, for a private FD segment between gateways
+const bool cCAN_FD_1 = false;
+
+// Bus bridge
+// longest and shortest time a forwarded message is expected back on a loop,
+// the window is twice the repeat interval of the message between these
+const uint32_t cBRIDGE_LOOP_WINDOW_MS = 750;
+const uint32_t cBRIDGE_LOOP_MIN_WINDOW_MS = 50;
+// forwarded messages remembered for loop suppression
+const uint32_t cBRIDGE_LOOP_RECORDS = 1024;
+// broadcast PGNs forwarded between the buses (0 terminated)
+const unsigned long cBRIDGE_PGNS[] = { 127245L, 127250L, 127251L, 127257L, 127258L,
+                                       128259L, 128267L, 129025L, 129026L, 129029L,
+                                       129033L, 130306L, 130310L, 130312L, 0 };
+
+// NMEA2000 to NMEA0183 - depth, wind, heading, speed, position and engine
+// data from bus 0 is sent as NMEA0183 to the TCP clients, and over UDP to
+// cNMEA0183_OUT_UDP_ADDRESS (a host or multicast group, empty for none)
+const char cNMEA0183_OUT_UDP_ADDRESS[] = {""};
+const uint16_t cNMEA0183_OUT_UDP_PORT = 10110;
+
+// CAN bus monitor - queued messages are paced while the bus is busy or
+// the controller is error passive
+const uint8_t cCAN_BUSLOAD_BACKOFF_PERCENT = 70;
+const uint32_t cCAN_BUSLOAD_WINDOW_MS = 1000;
+const uint32_t cCAN_BACKOFF_INTERVAL_MS = 10;
+// messages waiting for each bus, the oldest is dropped when it is full
+const uint32_t cCAN_TX_QUEUE_DEPTH = 512;
+
+// CAN capture - every frame on each bus is recorded to a rotating set of
+// files in $HOME/capture, export with the cancapture tool (make cancapture)
+const bool cCAN_CAPTURE = true;
+const uint32_t cCAN_CAPTURE_FILES = 4;
+const uint32_t cCAN_CAPTURE_FILE_SIZE = 16 * 1024 * 1024;
+
+// EVENT_DEBUG messages go unformatted to logs/EventLog_<date>.bin,
+// read them with the logdecode tool (make logdecode)
+const bool cBINARY_DEBUG_LOG = true;
+
+// Latency trace - time from a sentence being received to each stage up to
+// the CAN driver, kept per sentence type. Dumped to the event log on SIGUSR1
+// and at the end of a replay, which fails a paced replay when the p99 time
+// to the CAN driver is over the SLO
+const bool cLATENCY_TRACE = true;
+const uint32_t cLATENCY_SLO_WIRE_P99_US = 5000;
+
+// Metrics - counters, gauges and histograms in the Prometheus text format at
+// http://127.0.0.1:<cMETRICS_PORT>/metrics and on the Unix socket
+// (curl --unix-socket <cMETRICS_SOCKET> http://localhost/metrics).
+// CAN driver statistics are sampled every cMETRICS_SAMPLE_MS
+const uint16_t cMETRICS_PORT = 14110;
+const char cMETRICS_SOCKET[] = {"/tmp/nmea2can-metrics.sock"};
+const uint32_t cMETRICS_SAMPLE_MS = 1000;
+
 #endif
 
@@ -19,35 +19,85 @@
 #include <time.h>	
 #include <sys/stat.h>
 #include <errno.h>
+#include <fcntl.h>
 
 #ifdef __linux__
 #include <unistd.h>
+#include <sys/prctl.h>
 #else
 #include <direct.h>
 #endif
 
 // C++ includes
+#include <chrono>
 
 // includes
-#include "IThread.h"
 
 namespace
 {
     const char * cEventLogDirectory = "logs";
     const char * cLogFileNamePrefix = "EventLog";
     const char * cLogFileNameSuffix = ".log";
+    const char * cBinaryLogFileNameSuffix = ".bin";
+    const int cLogFlushIntervalMs = 50;         // logger thread wakes to write out the ring
+    const int64_t cLogSyncIntervalMs = 5000;    // fsync the log file at most this often
+    const int64_t cMsPerDay = 24 * 3600 * 1000;
+    const size_t cLogBatchSize = 64 * 1024;     // write the batch when it gets this big
+#define LOGGER_THREAD_NAME "EventLogger"
+
+    int64_t NowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // write all of a buffer to an fd
+    void WriteAll(int p_fd, const std::string & p_rBuffer)
+    {
+        size_t l_done = 0;
+        while (l_done < p_rBuffer.size())
+        {
+            ssize_t l_written = write(p_fd, p_rBuffer.data() + l_done, p_rBuffer.size() - l_done);
+            if (l_written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return;
+            }
+            l_done += l_written;
+        }
+    }
 }
 
 EventLogger* EventLogger::s_pInstance = nullptr;
+bool EventLogger::s_destroyed = false;
 bool EventLogger::m_bVerbose = (false);
 //----------------------------------------------------------------
 //
 //----------------------------------------------------------------
 EventLogger::EventLogger()
     : m_LogDebugData(false)
+    , m_binaryLogging(false)
+    , m_writePos(0)
+    , m_dropped(0)
+    , m_readPos(0)
+    , m_logFd(-1)
+    , m_binaryLogFd(-1)
+    , m_logFileDay(-1)
+    , m_lastSyncMs(0)
+    , m_unsynced(false)
+    , m_droppedReported(0)
     , m_lenLast(0)
 {
-    memset(m_lastMessage, 0x0, cMaxEventMsgSize);
+    memset(m_lastMessage, 0x0, sizeof(m_lastMessage));
+    for (uint32_t l_index = 0; l_index < cLogRecords; l_index++)
+    {
+        m_records[l_index].m_sequence.store(l_index, std::memory_order_relaxed);
+    }
+    m_fileBuffer.reserve(cLogBatchSize + cMaxErrorMsgSize);
+    m_consoleBuffer.reserve(cLogBatchSize + cMaxErrorMsgSize);
+    m_binaryBuffer.reserve(cLogBatchSize + cMaxErrorMsgSize);
 
     // Ensure the application path exists
     char l_temp[cBufferSize];
@@ -73,6 +123,8 @@ EventLogger::EventLogger()
     m_logDirectory = l_temp;
     (void) _mkdir(l_temp);
 #endif
+
+    StartThread();
 }
 
 //----------------------------------------------------------------
@@ -80,7 +132,9 @@ EventLogger::EventLogger()
 //----------------------------------------------------------------
 EventLogger::~EventLogger()
 {
-    WriteLogFile("Closing LogFile");
+    LogEvent("Closing LogFile");
+    StopThread();
+    CloseLogFile();
 }
 
 //----------------------------------------------------------------
@@ -88,7 +142,7 @@ EventLogger::~EventLogger()
 //----------------------------------------------------------------
 EventLogger* EventLogger::GetInstance()
 {
-    if (s_pInstance == nullptr)
+    if (s_pInstance == nullptr && !s_destroyed)
     {
         s_pInstance = new (std::nothrow) EventLogger();
     }
@@ -100,19 +154,15 @@ EventLogger* EventLogger::GetInstance()
 //----------------------------------------------------------------
 void EventLogger::LogEvent(const char * p_format, ...)
 {
+    EventLogger * l_pLogger = GetInstance();
+    if (l_pLogger == nullptr)
+    {
+        return;
+    }
     va_list  l_args;
     va_start(l_args, p_format);
-    char l_message[cMaxEventMsgSize];
-    vsnprintf(l_message, cMaxEventMsgSize, p_format, l_args);
+    l_pLogger->Enqueue(l_pLogger->m_LogDebugData, "", p_format, l_args);
     va_end(l_args);
-
-    // Write to the log file
-    GetInstance()->WriteLogFile(l_message);
-
-    if (GetInstance()->m_LogDebugData)
-    {
-    	std::cout << l_message << std::endl;
-    }
 }
 
 //----------------------------------------------------------------
@@ -120,19 +170,13 @@ void EventLogger::LogEvent(const char * p_format, ...)
 //----------------------------------------------------------------
 void EventLogger::Debug(const char* p_format, ...)
 {
-    if (GetInstance()->m_LogDebugData)
+    EventLogger * l_pLogger = GetInstance();
+    if (l_pLogger != nullptr && l_pLogger->m_LogDebugData)
     {
         va_list  l_args;
         va_start(l_args, p_format);
-        char l_message[cMaxEventMsgSize] = { 0 };
-        vsnprintf(l_message, cMaxEventMsgSize, p_format, l_args);
+        l_pLogger->Enqueue(true, "#Debug# ", p_format, l_args);
         va_end(l_args);
-        std::cout << l_message << std::endl;
-
-        char l_errorMessage[cMaxErrorMsgSize] = { 0 };
-        snprintf(l_errorMessage, cMaxErrorMsgSize, "#Debug# %s", l_message);
-
-        GetInstance()->WriteLogFile(l_errorMessage);
     }
 }
 
@@ -141,38 +185,90 @@ void EventLogger::Debug(const char* p_format, ...)
 //----------------------------------------------------------------
 void EventLogger::Error(const char* p_format, ...)
 {
+    // capture errno before anything else can change it
+    int l_errno = errno;
+    EventLogger * l_pLogger = GetInstance();
+    if (l_pLogger == nullptr)
+    {
+        return;
+    }
+
     va_list  l_args;
     va_start(l_args, p_format);
-    char l_message[cMaxEventMsgSize] = { 0 };
-    vsnprintf(l_message, cMaxEventMsgSize, p_format, l_args);
-    va_end(l_args);
-
-    char l_errorMessage[cMaxErrorMsgSize] = { 0 };
 #ifdef __linux__
-    snprintf(l_errorMessage, cMaxErrorMsgSize, "*Error* %s %s", l_message, errno > 0 ? strerror(errno) : "");
+    char l_suffix[cBufferSize] = { 0 };
+    if (l_errno > 0)
+    {
+        snprintf(l_suffix, sizeof(l_suffix), " %s", strerror(l_errno));
+    }
+    l_pLogger->Enqueue(true, "*Error* ", p_format, l_args, l_suffix);
 #else
-    snprintf(l_errorMessage, cMaxEventMsgSize, "*Error* %s", l_message);
+    l_pLogger->Enqueue(true, "*Error* ", p_format, l_args);
 #endif
-
-    std::cout << l_errorMessage << std::endl;
-    GetInstance()->WriteLogFile(l_errorMessage);
+    va_end(l_args);
 }
 
 
 
 
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+uint16_t EventLogger::RegisterFormat(const char * p_pFormat)
+{
+    EventLogger * l_pLogger = GetInstance();
+    if (l_pLogger == nullptr)
+    {
+        return 0;
+    }
+    std::lock_guard<std::mutex> l_lock(l_pLogger->m_formatLock);
+    if (l_pLogger->m_formats.size() >= UINT16_MAX)
+    {
+        return 0;
+    }
+    l_pLogger->m_formats.push_back(p_pFormat);
+    return static_cast<uint16_t>(l_pLogger->m_formats.size());
+}
+
 //----------------------------------------------------------------
 //
 //----------------------------------------------------------------
 void EventLogger::SetLogLevel(eLogLevel p_level)
 {
-    if (p_level == eLogLevel::Debug)
+    m_LogDebugData = (p_level == eLogLevel::Debug);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool EventLogger::StartThread()
+{
+    bool l_success(false);
+    // start the logger thread
+    m_threadRunning = true;
+    m_threadHandle = std::thread([=]
+                                 { LoggerThread(); });
+    if (m_threadHandle.joinable())
     {
-        GetInstance()->m_LogDebugData = true;
+        l_success = true;
     }
-    else
+    return l_success;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void EventLogger::StopThread()
+{
+    // stop the logger thread, it writes out the ring on exit
+    if (m_threadRunning)
     {
-        GetInstance()->m_LogDebugData = false;
+        m_threadRunning = false;
+        m_interruptTimeOut.Notify();
+        if (m_threadHandle.joinable())
+        {
+            m_threadHandle.join();
+        }
     }
 }
 
@@ -182,94 +278,429 @@ void EventLogger::SetLogLevel(eLogLevel p_level)
 // Private Methods
 //--------------------------------------------
 
-/// OpenLogFile
-///- Details:   Opens the log file on disk
+///  Claim
+///- Details:   Claims a record in the ring. Multiple producers claim
+///             records with a compare and swap on the write position,
+///             each record sequence tells if it is free, ready or
+///             still in use. A full ring drops the message
+///
+///- Returns:   the record, nullptr when the ring is full
+///- Throws:    n/a
+EventLogger::LogRecord * EventLogger::Claim
+(
+    uint32_t & p_rPosition      ///!< ring position of the record
+)
+{
+    uint32_t l_position = m_writePos.load(std::memory_order_relaxed);
+    LogRecord * l_pRecord;
+    for (;;)
+    {
+        l_pRecord = &m_records[l_position & (cLogRecords - 1)];
+        int32_t l_diff = static_cast<int32_t>(l_pRecord->m_sequence.load(std::memory_order_acquire) - l_position);
+        if (l_diff == 0)
+        {
+            if (m_writePos.compare_exchange_weak(l_position, l_position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (l_diff < 0)
+        {
+            // the logger thread has not written this record out yet
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            l_position = m_writePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    l_pRecord->m_timeMs = NowMs();
+    p_rPosition = l_position;
+    return l_pRecord;
+}
+
+///  Publish
+///- Details:   Passes a claimed record to the logger thread
 ///
 ///- Returns:   n/a
 ///- Throws:    n/a
-void EventLogger::OpenLogFile()
+void EventLogger::Publish
+(
+    LogRecord * p_pRecord,      ///!< record from Claim
+    uint32_t p_position         ///!< ring position from Claim
+)
 {
-    char l_logFileName[cBufferSize] = { 0 };
+    p_pRecord->m_sequence.store(p_position + 1, std::memory_order_release);
+}
 
-#ifdef __linux__
-    snprintf(l_logFileName, cBufferSize, "%s/%s_%s%s"
-        , m_logDirectory.c_str()
-        , cLogFileNamePrefix
-        , GetFileDateString().c_str()
-        , cLogFileNameSuffix);
-#else
-    snprintf(l_logFileName, cBufferSize, "%s\\%s_%s%s"
-        , m_logDirectory.c_str()
-        , cLogFileNamePrefix
-        , GetFileDateString().c_str()
-        , cLogFileNameSuffix);
+///  Enqueue
+///- Details:   Formats the message into a ring record
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::Enqueue
+(
+    bool p_console,             ///!< also write to standard out
+    const char * p_prefix,      ///!< text before the message
+    const char * p_format,      ///!< message format
+    va_list p_args,             ///!< message arguments
+    const char * p_suffix       ///!< text after the message
+)
+{
+    uint32_t l_position;
+    LogRecord * l_pRecord = Claim(l_position);
+    if (l_pRecord == nullptr)
+    {
+        return;
+    }
+
+    l_pRecord->m_formatId = 0;
+    l_pRecord->m_console = p_console;
 
+    int l_length = snprintf(l_pRecord->m_text, cLogRecordTextSize, "%s", p_prefix);
+    if (l_length < cLogRecordTextSize)
+    {
+        int l_written = vsnprintf(l_pRecord->m_text + l_length, cLogRecordTextSize - l_length, p_format, p_args);
+        l_length += (l_written > 0) ? l_written : 0;
+    }
+    if (l_length < cLogRecordTextSize)
+    {
+        l_length += snprintf(l_pRecord->m_text + l_length, cLogRecordTextSize - l_length, "%s", p_suffix);
+    }
+    if (l_length >= cLogRecordTextSize)
+    {
+        l_length = cLogRecordTextSize - 1;
+    }
+    // drop a trailing new line, one is added on output
+    if (l_length > 0 && l_pRecord->m_text[l_length - 1] == '\n')
+    {
+        l_length--;
+    }
+    l_pRecord->m_length = static_cast<uint16_t>(l_length);
+
+    Publish(l_pRecord, l_position);
+}
+
+/// Logger Thread
+///- Details:   Writes the ring out every cLogFlushIntervalMs and
+///             when stopped
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::LoggerThread()
+{
+#ifdef __linux__
+    // Set the thread name for system debugging
+    prctl(PR_SET_NAME, LOGGER_THREAD_NAME, 0, 0, 0);
 #endif
 
-    m_hLogFile.open(l_logFileName, std::ios::out | std::ios::app);
-    if (!m_hLogFile.is_open())
+    while (m_threadRunning)
     {
-        perror("Unable to open Log File");
+        m_interruptTimeOut.Wait_For(std::chrono::milliseconds(cLogFlushIntervalMs));
+        Drain();
     }
+    Drain();
 }
 
+///  Drain
+///- Details:   Writes all the ready records to the log file and
+///             standard out as one batch each
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::Drain()
+{
+    for (;;)
+    {
+        LogRecord & l_rRecord = m_records[m_readPos & (cLogRecords - 1)];
+        if (l_rRecord.m_sequence.load(std::memory_order_acquire) != m_readPos + 1)
+        {
+            break;
+        }
+
+        Output(l_rRecord);
 
-///  WriteLogFile
-///- Details:   Writes the string in to the log file
+        // hand the record back to the producers
+        l_rRecord.m_sequence.store(m_readPos + cLogRecords, std::memory_order_release);
+        m_readPos++;
+    }
+
+    uint32_t l_dropped = m_dropped.load(std::memory_order_relaxed);
+    if (l_dropped != m_droppedReported)
+    {
+        LogRecord l_record;
+        l_record.m_timeMs = NowMs();
+        l_record.m_formatId = 0;
+        l_record.m_console = true;
+        l_record.m_length = static_cast<uint16_t>(snprintf(l_record.m_text, cLogRecordTextSize,
+            "*Error* EventLogger ring full, %u messages dropped", l_dropped - m_droppedReported));
+        Output(l_record);
+        m_droppedReported = l_dropped;
+    }
+
+    Flush();
+
+    int64_t l_now = NowMs();
+    if (m_unsynced && l_now - m_lastSyncMs >= cLogSyncIntervalMs)
+    {
+        if (m_logFd >= 0)
+        {
+            fsync(m_logFd);
+        }
+        if (m_binaryLogFd >= 0)
+        {
+            fsync(m_binaryLogFd);
+        }
+        m_lastSyncMs = l_now;
+        m_unsynced = false;
+    }
+}
+
+///  Output
+///- Details:   Adds a record to the batches, opening the next day's
+///             log files when the date changes. EVENT_DEBUG records
+///             are formatted here unless they go to the binary log
 ///
 ///- Returns:   n/a
 ///- Throws:    n/a
-void EventLogger::WriteLogFile
+void EventLogger::Output
 (
-    const char * p_eventMsg ///!< message to write to disk
+    const LogRecord & p_rRecord     ///!< record to write
 )
 {
-    // make sure two threads aren't writing at the same time
-    Lock l_lock(m_lock);
+    if (p_rRecord.m_timeMs / cMsPerDay != m_logFileDay)
+    {
+        Flush();
+        CloseLogFile();
+        OpenLogFile(p_rRecord.m_timeMs);
+    }
 
-    int l_length = static_cast<int> (strlen(p_eventMsg));
+    if (p_rRecord.m_formatId == 0)
+    {
+        OutputText(p_rRecord.m_timeMs, p_rRecord.m_console, p_rRecord.m_text, p_rRecord.m_length);
+    }
+    else if (!p_rRecord.m_console)
+    {
+        OutputBinary(p_rRecord);
+    }
+    else
+    {
+        char l_text[cLogRecordTextSize];
+        const char * l_pPrefix = "#Debug# ";
+        int l_length = snprintf(l_text, sizeof(l_text), "%s", l_pPrefix);
+        l_length += BinaryLog::Format(GetFormat(p_rRecord.m_formatId), p_rRecord.m_text, p_rRecord.m_length,
+                                      l_text + l_length, sizeof(l_text) - l_length);
+        if (l_length > 0 && l_text[l_length - 1] == '\n')
+        {
+            l_length--;
+        }
+        OutputText(p_rRecord.m_timeMs, true, l_text, l_length);
+    }
+
+    if (m_fileBuffer.size() >= cLogBatchSize || m_consoleBuffer.size() >= cLogBatchSize
+        || m_binaryBuffer.size() >= cLogBatchSize)
+    {
+        Flush();
+    }
+}
+
+///  OutputText
+///- Details:   Adds a text line to the batches
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::OutputText
+(
+    int64_t p_timeMs,           ///!< time of the event
+    bool p_console,             ///!< also write to standard out
+    const char * p_pText,       ///!< message text
+    int p_length                ///!< length of the text
+)
+{
+    if (p_length > cLogRecordTextSize)
+    {
+        p_length = cLogRecordTextSize;
+    }
+
+    if (p_console)
+    {
+        m_consoleBuffer.append(p_pText, p_length);
+        m_consoleBuffer += '\n';
+    }
 
     // avoid writing the same message twice
-    if (l_length != m_lenLast && memcmp(p_eventMsg, m_lastMessage, l_length) != 0 )
+    if (p_length == m_lenLast && memcmp(p_pText, m_lastMessage, m_lenLast) == 0)
     {
-        // copy the last l_message
-        snprintf(m_lastMessage, sizeof(m_lastMessage), "%s", p_eventMsg);
-        m_lenLast = l_length;
+        return;
+    }
+    memcpy(m_lastMessage, p_pText, p_length);
+    m_lenLast = p_length;
+
+    m_fileBuffer += '[';
+    m_fileBuffer += GetEventLogTimeString(p_timeMs);
+    m_fileBuffer += "] ";
+    m_fileBuffer.append(p_pText, p_length);
+    m_fileBuffer += '\n';
+}
 
-        char l_logMessage[cMaxEventMsgSize] = { 0 };
-        l_length = snprintf(l_logMessage, cMaxEventMsgSize, "[%s] %s", GetEventLogTimeString().c_str(), p_eventMsg);
+///  OutputBinary
+///- Details:   Adds a message record to the binary batch, preceded
+///             by the record of its format the first time the format
+///             is used in the file (see BinaryLog.h)
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::OutputBinary
+(
+    const LogRecord & p_rRecord     ///!< EVENT_DEBUG record
+)
+{
+    if (m_binaryLogFd < 0)
+    {
+        OpenBinaryLogFile();
+    }
 
-        // add a cr-lf if not there
-        if (l_logMessage[l_length - 1] != '\n')
-        {
-            l_logMessage[l_length] = '\n';
-        }
+    uint16_t l_formatId = p_rRecord.m_formatId;
+    if (l_formatId >= m_formatWritten.size())
+    {
+        m_formatWritten.resize(l_formatId + 1, false);
+    }
+    if (!m_formatWritten[l_formatId])
+    {
+        const char * l_pFormat = GetFormat(l_formatId);
+        uint16_t l_length = static_cast<uint16_t>(strnlen(l_pFormat, UINT16_MAX));
+        m_binaryBuffer += static_cast<char>(BinaryLog::cRecordFormat);
+        m_binaryBuffer.append(reinterpret_cast<const char *>(&l_formatId), sizeof(l_formatId));
+        m_binaryBuffer.append(reinterpret_cast<const char *>(&l_length), sizeof(l_length));
+        m_binaryBuffer.append(l_pFormat, l_length);
+        m_formatWritten[l_formatId] = true;
+    }
 
-        // Open the Log File
-        OpenLogFile();
+    m_binaryBuffer += static_cast<char>(BinaryLog::cRecordMessage);
+    m_binaryBuffer.append(reinterpret_cast<const char *>(&l_formatId), sizeof(l_formatId));
+    m_binaryBuffer.append(reinterpret_cast<const char *>(&p_rRecord.m_timeMs), sizeof(p_rRecord.m_timeMs));
+    m_binaryBuffer.append(reinterpret_cast<const char *>(&p_rRecord.m_length), sizeof(p_rRecord.m_length));
+    m_binaryBuffer.append(p_rRecord.m_text, p_rRecord.m_length);
+}
 
-        // if the log file is open
-        if (m_hLogFile.is_open())
+///  GetFormat
+///- Details:   Looks up a registered format string
+///
+///- Returns:   the format string
+///- Throws:    n/a
+const char * EventLogger::GetFormat
+(
+    uint16_t p_formatId     ///!< id from RegisterFormat
+)
+{
+    std::lock_guard<std::mutex> l_lock(m_formatLock);
+    if (p_formatId == 0 || p_formatId > m_formats.size())
+    {
+        return "";
+    }
+    return m_formats[p_formatId - 1];
+}
+
+///  Flush
+///- Details:   Writes the batches to the log file and standard out
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::Flush()
+{
+    if (!m_fileBuffer.empty())
+    {
+        if (m_logFd >= 0)
+        {
+            WriteAll(m_logFd, m_fileBuffer);
+            m_unsynced = true;
+        }
+        m_fileBuffer.clear();
+    }
+    if (!m_consoleBuffer.empty())
+    {
+        WriteAll(STDOUT_FILENO, m_consoleBuffer);
+        m_consoleBuffer.clear();
+    }
+    if (!m_binaryBuffer.empty())
+    {
+        if (m_binaryLogFd >= 0)
         {
-            m_hLogFile << l_logMessage;
-            m_hLogFile.flush();
+            WriteAll(m_binaryLogFd, m_binaryBuffer);
+            m_unsynced = true;
         }
+        m_binaryBuffer.clear();
+    }
+}
 
-        // Keep the log file closed
-        CloseLogFile();
+/// OpenLogFile
+///- Details:   Opens the log file on disk for the day, it is kept
+///             open until the day changes
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::OpenLogFile
+(
+    int64_t p_timeMs    ///!< time in the day to log
+)
+{
+    m_logFileDay = p_timeMs / cMsPerDay;
+    m_logFd = open(GetLogFileName(p_timeMs, cLogFileNameSuffix).c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (m_logFd < 0)
+    {
+        perror("Unable to open Log File");
+    }
+    m_lastSyncMs = NowMs();
+}
+
+/// OpenBinaryLogFile
+///- Details:   Opens the binary log file for the day of the log
+///             file, a new file starts with the file magic
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void EventLogger::OpenBinaryLogFile()
+{
+    m_formatWritten.clear();
+    m_binaryLogFd = open(GetLogFileName(m_logFileDay * cMsPerDay, cBinaryLogFileNameSuffix).c_str(),
+                         O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (m_binaryLogFd < 0)
+    {
+        perror("Unable to open Binary Log File");
+        return;
+    }
+
+    struct stat l_stat;
+    if (fstat(m_binaryLogFd, &l_stat) == 0 && l_stat.st_size == 0)
+    {
+        m_binaryBuffer.insert(0, BinaryLog::cFileMagic, sizeof(BinaryLog::cFileMagic));
     }
 }
 
 ///  CloseLogFile
-///- Details:   Closes the log file
+///- Details:   Syncs and closes the log file
 ///
 ///- Returns:   n/a
 ///- Throws:    n/a
 void EventLogger::CloseLogFile()
 {
-    if (m_hLogFile.is_open())
+    if (m_logFd >= 0)
+    {
+        if (m_unsynced)
+        {
+            fsync(m_logFd);
+            m_unsynced = false;
+        }
+        close(m_logFd);
+        m_logFd = -1;
+    }
+    if (m_binaryLogFd >= 0)
     {
-        m_hLogFile.close();
+        fsync(m_binaryLogFd);
+        close(m_binaryLogFd);
+        m_binaryLogFd = -1;
     }
 }
 
@@ -278,9 +709,12 @@ void EventLogger::CloseLogFile()
 ///
 ///- Returns:   std::string with the time tamp
 ///- Throws:    n/a
-std::string EventLogger::GetEventLogTimeString()
+std::string EventLogger::GetEventLogTimeString
+(
+    int64_t p_timeMs    ///!< ms since epoch
+)
 {
-    int64_t l_secondsEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t l_secondsEpoch = p_timeMs;
 
     int l_mseconds = static_cast<int>  ((l_secondsEpoch) % 1000);
     l_secondsEpoch /= 1000;
@@ -293,15 +727,49 @@ std::string EventLogger::GetEventLogTimeString()
     return l_result;
 }
 
+///  GetLogFileName
+///- Details:   Name of the log file for the day
+///
+///- Returns:   std::string with the path
+///- Throws:    n/a
+std::string EventLogger::GetLogFileName
+(
+    int64_t p_timeMs,           ///!< ms since epoch
+    const char * p_pSuffix      ///!< file extension
+)
+{
+    char l_logFileName[cBufferSize] = { 0 };
+
+#ifdef __linux__
+    snprintf(l_logFileName, cBufferSize, "%s/%s_%s%s"
+        , m_logDirectory.c_str()
+        , cLogFileNamePrefix
+        , GetFileDateString(p_timeMs).c_str()
+        , p_pSuffix);
+#else
+    snprintf(l_logFileName, cBufferSize, "%s\\%s_%s%s"
+        , m_logDirectory.c_str()
+        , cLogFileNamePrefix
+        , GetFileDateString(p_timeMs).c_str()
+        , p_pSuffix);
+
+#endif
+    std::string l_result = l_logFileName;
+    return l_result;
+}
+
 ///  GetFileDateString
 ///- Details:   Used when creating Disk Files
 ///             in the format DD_MM_YYYY
 ///
 ///- Returns:   std::string with the date stamp
 ///- Throws:    n/a
-std::string EventLogger::GetFileDateString()
+std::string EventLogger::GetFileDateString
+(
+    int64_t p_timeMs    ///!< ms since epoch
+)
 {
-    time_t l_rawtime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    time_t l_rawtime = static_cast<time_t>(p_timeMs / 1000);
     
 #ifdef __linux__
     // need to fix this for linux
@@ -17,12 +17,16 @@
 // C Includes
 
 // C++ Includes
-#include <fstream>
 #include <iostream>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <cstdarg>
+#include <vector>
 
 // Includes
+#include "IThread.h"
+#include "BinaryLog.h"
 
 //-------------------------------------
 //
@@ -32,8 +36,23 @@ namespace
     const int16_t cMaxEventMsgSize = 1024 - 32;
     const int16_t cMaxErrorMsgSize = 1024;
     const int16_t cBufferSize = 256;
+    const int16_t cLogRecordTextSize = 256 - 16;  // longer messages are truncated
+    const uint32_t cLogRecords = 1024;             // power of 2
 }
 
+//-------------------------------------
+// Debug message with deferred formatting, for hot paths.
+// Records the format id and the raw arguments only, the text
+// is made on the logger thread or, with binary logging on, by
+// the offline decoder (make logdecode)
+//-------------------------------------
+#define EVENT_DEBUG(p_format, ...) \
+    do \
+    { \
+        static const uint16_t l_formatId = EventLogger::RegisterFormat(p_format); \
+        EventLogger::DebugFormat(l_formatId, ##__VA_ARGS__); \
+    } while (0)
+
 enum  class eLogLevel
 {
     None,
@@ -44,8 +63,15 @@ enum  class eLogLevel
 //---------------------------------------------------
 // class logs event from the processor to a log file
 // this will be used during development and debugging
+//
+// Callers format straight into a lock free ring of fixed
+// size records and return. The logger thread writes the
+// records in batches to the open log file and standard out,
+// syncs the file periodically and starts a new file each day.
+// When the ring is full messages are dropped and counted,
+// the caller never waits for the disk.
 //---------------------------------------------------
-class EventLogger
+class EventLogger : public IThread
 {
 public:
 
@@ -64,20 +90,23 @@ public:
 
     /// GetInstance
     ///- Details: Class is a singleton class , this method gets access to the instance
-    ///
-    ///- Returns:   Instance of the ErrorLogger
+    ///           The instance is not created again after DestroyInstance
+    ///- Returns:   Instance of the ErrorLogger, nullptr after DestroyInstance
     ///- Throws:    n/a
     static EventLogger* GetInstance();
 
     /// DestroyInstance
     ///- Details: Class is a singleton class , destroys the instance
-    ///
+    ///           after writing out the waiting messages. Messages logged
+    ///           after this are dropped
     ///- Returns:   n/a
     ///- Throws:    n/a
     static void DestroyInstance() 
     { 
+        s_destroyed = true;
         if (s_pInstance != nullptr) 
         delete s_pInstance; 
+        s_pInstance = nullptr;
     }
 
     /// LogEvent
@@ -115,6 +144,62 @@ public:
         ...                     ///< vargs
     );
 
+    /// DebugFormat
+    ///- Details:   Logs a debug message as format id and arguments,
+    ///             use through EVENT_DEBUG
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    template <typename... Args>
+    static void DebugFormat
+    (
+        uint16_t p_formatId,    ///< id from RegisterFormat
+        Args... p_args          ///< arguments of the format
+    )
+    {
+        EventLogger * l_pLogger = GetInstance();
+        if (l_pLogger == nullptr || !l_pLogger->m_LogDebugData)
+        {
+            return;
+        }
+
+        uint32_t l_position;
+        LogRecord * l_pRecord = l_pLogger->Claim(l_position);
+        if (l_pRecord != nullptr)
+        {
+            BinaryLog::ArgWriter l_writer(l_pRecord->m_text, cLogRecordTextSize);
+            BinaryLog::PutArgs(l_writer, p_args...);
+            l_pRecord->m_formatId = p_formatId;
+            l_pRecord->m_length = static_cast<uint16_t>(l_writer.GetLength());
+            l_pRecord->m_console = !l_pLogger->m_binaryLogging;
+            l_pLogger->Publish(l_pRecord, l_position);
+        }
+    }
+
+    /// RegisterFormat
+    ///- Details:   Registers the format string of a EVENT_DEBUG call site
+    ///
+    ///- Returns:   format id
+    ///- Throws:    n/a
+    static uint16_t RegisterFormat
+    (
+        const char * p_pFormat  ///< format string, must be static
+    );
+
+    /// SetBinaryLogging
+    ///- Details:   Writes EVENT_DEBUG messages unformatted to the binary
+    ///             log file instead of the log file and standard out
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    void SetBinaryLogging
+    (
+        bool p_enable       ///< true for binary logging
+    )
+    {
+        m_binaryLogging = p_enable;
+    }
+
     /// SetLogLevel 
     ///- Details:   Sets the logging level
     ///
@@ -125,29 +210,111 @@ public:
         eLogLevel p_level   ///< the logging level
     );
 
+    /// GetDropped
+    ///- Details:   Number of messages dropped because the ring was full
+    ///
+    ///- Returns:   dropped message count
+    ///- Throws:    n/a
+    uint32_t GetDropped() const { return m_dropped; }
+
+    /// StartThread
+    ///- Details:   Starts the logger thread, called by the constructor
+    ///
+    ///- Returns:   true if the thread was started
+    ///- Throws:    n/a
+    bool StartThread() override;
+
+    /// StopThread
+    ///- Details:   Writes the remaining records and stops the logger thread
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    void StopThread() override;
+
 private:
 
-    // Open the log file
-    void OpenLogFile();
+    // one log message waiting for the logger thread
+    struct LogRecord
+    {
+        std::atomic<uint32_t> m_sequence;   ///!< ring position the record is free or ready for
+        uint16_t m_length;                  ///!< length of the text
+        uint16_t m_formatId;                ///!< format of a EVENT_DEBUG record, 0 for text
+        bool m_console;                     ///!< also write to standard out, binary records are formatted
+        int64_t m_timeMs;                   ///!< time of the event, ms since epoch
+        char m_text[cLogRecordTextSize];    ///!< message text or arguments
+    };
+
+    // claim a record in the ring, nullptr when full, never blocks
+    LogRecord * Claim(uint32_t & p_rPosition);
+
+    // pass a claimed record to the logger thread
+    void Publish(LogRecord * p_pRecord, uint32_t p_position);
+
+    // format a message into the ring, never blocks
+    void Enqueue(bool p_console, const char * p_prefix, const char * p_format, va_list p_args, const char * p_suffix = "");
 
-    // Write Log File
-    void WriteLogFile(const char * p_eventMsg);
+    // logger thread
+    void LoggerThread();
+
+    // write out the records in the ring
+    void Drain();
+
+    // add a record to the output buffers
+    void Output(const LogRecord & p_rRecord);
+
+    // add a text line to the output buffers
+    void OutputText(int64_t p_timeMs, bool p_console, const char * p_pText, int p_length);
+
+    // add a binary record to the binary output buffer
+    void OutputBinary(const LogRecord & p_rRecord);
+
+    // format string of an id
+    const char * GetFormat(uint16_t p_formatId);
+
+    // write the output buffers out
+    void Flush();
+
+    // Open the log file for the day of p_timeMs
+    void OpenLogFile(int64_t p_timeMs);
+
+    // Open the binary log file for the day of the log file
+    void OpenBinaryLogFile();
 
     // Close the log file
     void CloseLogFile();
 
     // Log file date and time
-    std::string GetEventLogTimeString();
-    std::string GetFileDateString();
+    std::string GetEventLogTimeString(int64_t p_timeMs);
+    std::string GetFileDateString(int64_t p_timeMs);
+    std::string GetLogFileName(int64_t p_timeMs, const char * p_pSuffix);
 
     static EventLogger* s_pInstance;        ///!< instance of the log as a singleton
+    static bool s_destroyed;                ///!< DestroyInstance was called
     static bool m_bVerbose;                 ///!< its in verbose mode
-    std::fstream m_hLogFile;                ///!< the log file
     bool m_LogDebugData;                    ///!< Logs debug data
-    char m_lastMessage[cMaxEventMsgSize];   ///!< the last message, stop duplicate messages flooding the event log
-    int  m_lenLast;                         ///!< length of the last message
+    bool m_binaryLogging;                   ///!< EVENT_DEBUG records go to the binary log
     std::string m_logDirectory;             ///!< Directory to log event files
-    std::mutex m_lock;			            ///!< log file access lock
+
+    LogRecord m_records[cLogRecords];       ///!< ring of messages waiting to be written
+    std::atomic<uint32_t> m_writePos;       ///!< next ring position to claim
+    std::atomic<uint32_t> m_dropped;        ///!< messages dropped on a full ring
+    uint32_t m_readPos;                     ///!< next ring position to write out
+    std::vector<const char *> m_formats;    ///!< EVENT_DEBUG format strings, id - 1
+    std::mutex m_formatLock;                ///!< format registration lock
+
+    // logger thread only
+    int m_logFd;                            ///!< the log file
+    int m_binaryLogFd;                      ///!< the binary log file
+    std::vector<bool> m_formatWritten;      ///!< format is in the binary log file
+    int64_t m_logFileDay;                   ///!< day number of the open log file
+    int64_t m_lastSyncMs;                   ///!< time of the last fsync
+    bool m_unsynced;                        ///!< data written since the last fsync
+    uint32_t m_droppedReported;             ///!< dropped count already logged
+    char m_lastMessage[cLogRecordTextSize]; ///!< the last message, stop duplicate messages flooding the event log
+    int  m_lenLast;                         ///!< length of the last message
+    std::string m_fileBuffer;               ///!< batch for the log file
+    std::string m_consoleBuffer;            ///!< batch for standard out
+    std::string m_binaryBuffer;             ///!< batch for the binary log file
 };
 
 #endif
\ No newline at end of file
@@ -21,6 +21,8 @@
 
 // Includes
 #include "EventLogger.h"
+#include "LatencyTrace.h"
+#include "Metrics.h"
 
 constexpr char cERROR_MESSAGE[] = {"Error No Handler Configured"};
 
@@ -47,6 +49,9 @@ MessageHandler *MessageHandler::s_pInstance = nullptr;
 MessageHandler::MessageHandler()
 {
     s_pInstance = this;
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    m_pDispatched = l_pRegistry->AddCounter("nmea2can_messages_dispatched_total", "Messages passed to a subscribed handler");
+    m_pUnhandled = l_pRegistry->AddCounter("nmea2can_messages_unhandled_total", "Messages no subscribed handler accepted");
 }
 
 //--------------------------------------- ---
@@ -61,21 +66,21 @@ MessageHandler::~MessageHandler()
 //------------------------------------------
 //
 //------------------------------------------
-bool MessageHandler::HandleMessage(const uint8_t *p_pMessage, uint16_t& p_size , int p_socket)
+bool MessageHandler::HandleMessage(const uint8_t *p_pMessage, uint16_t& p_size , int p_socket, uint32_t p_sourceAddress)
 {
-    static_cast<void>(p_socket);
-
     uint16_t l_bytesHandled(0); // bytes used by the handlers. Should be 0 when all messages processed
     bool l_handled(true);      // Indicates if message was handled
 
-    // lock the map while it gets searched for handlers
-    m_mapLock.lock();
+    // lock the map while it gets searched for handlers, readers on
+    // several threads dispatch at the same time
+    m_mapLock.lock_shared();
 
-    // The current plan is that the message should start with a $ symbol
-    while ((l_bytesHandled < p_size) && *(p_pMessage + l_bytesHandled) == cSTART_MSG)
+    // The message should start with a $ symbol, or ! for encapsulated sentences
+    while ((l_bytesHandled < p_size) &&
+           (*(p_pMessage + l_bytesHandled) == cSTART_MSG || *(p_pMessage + l_bytesHandled) == cSTART_ENCAPSULATED))
     {
         char l_header[cHeaderSize] = {0};
-        strncpy(l_header, reinterpret_cast<const char *>(p_pMessage), cHeaderSize - 1);
+        strncpy(l_header, reinterpret_cast<const char *>(p_pMessage + l_bytesHandled), cHeaderSize - 1);
         
         // pass the remainder of the message to the handler
         uint16_t l_processed (p_size - l_bytesHandled); 
@@ -86,7 +91,9 @@ bool MessageHandler::HandleMessage(const uint8_t *p_pMessage, uint16_t& p_size ,
             // look at the message header and call the appropiate handler
             if (l_item.second == l_header)
             {
-                l_handled &= l_item.first->HandleMessage(p_pMessage + l_bytesHandled, l_processed , p_socket);
+                LatencyTrace::Stamp(eTraceStage::Dispatch);
+                m_pDispatched->Add();
+                l_handled &= l_item.first->HandleMessage(p_pMessage + l_bytesHandled, l_processed , p_socket, p_sourceAddress);
             }
         }
         // if it hasn't been processed or there is nothing left to process
@@ -101,11 +108,15 @@ bool MessageHandler::HandleMessage(const uint8_t *p_pMessage, uint16_t& p_size ,
     }
 
     // if the message was not handled, tell the client
+    if (!l_handled || l_bytesHandled == 0)
+    {
+        m_pUnhandled->Add();
+    }
     if ((!l_handled || l_bytesHandled == 0) && m_pNetwork != nullptr)
     {
         m_pNetwork->SendData(cERROR_MESSAGE, sizeof(cERROR_MESSAGE));
     }
-    m_mapLock.unlock();
+    m_mapLock.unlock_shared();
     
     // set the number of bytes handled
     p_size = l_bytesHandled;
@@ -158,7 +169,14 @@ void MessageHandler::_SubscribeHandler
 ) 
 {
     m_mapLock.lock();
-    m_handlerMap[p_pHandlerInterface] = l_header;
+    // once for each header
+    auto l_range = m_handlerMap.equal_range(p_pHandlerInterface);
+    auto l_it = l_range.first;
+    for (; l_it != l_range.second && l_it->second != l_header; ++l_it);
+    if (l_it == l_range.second)
+    {
+        m_handlerMap.emplace(p_pHandlerInterface, l_header);
+    }
     m_mapLock.unlock();
     EventLogger::Debug("Handler for %s subscribed", l_header.c_str());
 }
@@ -174,7 +192,11 @@ void MessageHandler::_UnSubscribeHandler
 )
 {
     m_mapLock.lock();
-    EventLogger::Debug("Handler for %s unsubscribed", m_handlerMap[p_pHandlerInterface].c_str());
+    auto l_range = m_handlerMap.equal_range(p_pHandlerInterface);
+    for (auto l_it = l_range.first; l_it != l_range.second; ++l_it)
+    {
+        EventLogger::Debug("Handler for %s unsubscribed", l_it->second.c_str());
+    }
     m_handlerMap.erase(p_pHandlerInterface);
     m_mapLock.unlock();
 }
@@ -22,17 +22,22 @@
 #include <map>
 #include <string>
 #include <mutex>
+#include <shared_mutex>
 #include <memory>
 
 // Includes
 #include "MessageHandlerInterface.h"
 #include "Network/INetwork.h"
 
+// forward declarations
+class MetricCounter;
+
 //-------------------------------------
 // Consts & defines for class
 //-------------------------------------
 const int cHeaderSize = 2; // e.g. $XXX:
 const char cSTART_MSG = '$';
+const char cSTART_ENCAPSULATED = '!';   // e.g. AIS !AIVDM
 
 //---------------------------------------------
 // Handles all the incoming messages, dispatching them to a subscribed 
@@ -61,13 +66,15 @@ public: // Functions
     (
         const uint8_t *p_pMessage,  ///< pointer to the message
         uint16_t& p_size,           ///< size of the message, returns the number of bytes processed
-        int p_socket = -1           ///< socket receiving the data
+        int p_socket = -1,          ///< socket receiving the data
+        uint32_t p_sourceAddress = 0 ///< IPv4 address of the sender, network byte order
     ) override;
 
     /// SubscribeHandler
     /// Detail- Message handlers can subscribe into the message handler to
-    ///         have the messages forwarded to them. It is static so the
-    ///         handler does not need an instance of the message handler
+    ///         have the messages forwarded to them. A handler can subscribe
+    ///         to several headers. It is static so the handler does not
+    ///         need an instance of the message handler
     /// Returns- n/a
     /// Throws - n/a
     static void SubscribeHandler
@@ -78,7 +85,8 @@ public: // Functions
 
     /// UnSubscribeHandler
     /// Detail- Message handlers can unsubscribe from the message handler to
-    ///         stop the messages being forwarded to them. It is static so the
+    ///         stop the messages being forwarded to them, for all the headers
+    ///         subscribed to. It is static so the
     ///         handler does not need an instance of the message handler
     /// Returns- n/a
     /// Throws - n/a
@@ -102,10 +110,12 @@ private: // Functions
 
 private:                                                            
     // Private Member Variables
-    std::map<IMessageHandlerInterface *, std::string> m_handlerMap; ///< map containing the subscriptions
-    std::mutex m_mapLock;                                           ///< lock for the handler map
+    std::multimap<IMessageHandlerInterface *, std::string> m_handlerMap; ///< map containing the subscriptions
+    std::shared_timed_mutex m_mapLock;                              ///< lock for the handler map, shared while dispatching
     static MessageHandler *s_pInstance;                             ///< Instance pointer of this class
     std::shared_ptr<INetwork> m_pNetwork;                           ///< Pointer to the owning network
+    MetricCounter *m_pDispatched;                                   ///< messages passed to a handler
+    MetricCounter *m_pUnhandled;                                    ///< messages no handler took
 };
 
 #endif
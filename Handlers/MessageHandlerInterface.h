@@ -66,7 +66,8 @@ public:
     (
         const uint8_t *p_pMessage,  ///< pointer to the message
         uint16_t &p_size,           ///< size of the message in bytes, returns the number of bytes processed
-        int p_socket = -1           ///< socket receiving the data (-1 if the socket doesn't matter)
+        int p_socket = -1,          ///< socket receiving the data (-1 if the socket doesn't matter)
+        uint32_t p_sourceAddress = 0 ///< IPv4 address of the sender, network byte order (0 if not known)
     ) = 0;
 
 
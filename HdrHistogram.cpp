@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : High dynamic range histogram implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "HdrHistogram.h"
+
+// C includes
+#include <math.h>
+
+// C++ includes
+
+// includes
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+HdrHistogram::HdrHistogram(uint64_t p_highestValue, int p_significantDigits)
+: m_highestValue(p_highestValue < 2 ? 2 : p_highestValue)
+, m_totalCount(0)
+, m_total(0)
+, m_max(0)
+{
+    if (p_significantDigits < 1)
+    {
+        p_significantDigits = 1;
+    }
+    else if (p_significantDigits > 4)
+    {
+        p_significantDigits = 4;
+    }
+
+    // enough sub buckets to tell apart values one unit in the last digit
+    uint64_t l_largestSingleUnitValue = 2 * static_cast<uint64_t>(pow(10.0, p_significantDigits));
+    int l_subBucketCountMagnitude = static_cast<int>(ceil(log2(static_cast<double>(l_largestSingleUnitValue))));
+    m_subBucketHalfCountMagnitude = l_subBucketCountMagnitude - 1;
+    uint64_t l_subBucketCount = 1ULL << l_subBucketCountMagnitude;
+    m_subBucketHalfCount = l_subBucketCount / 2;
+    m_subBucketMask = l_subBucketCount - 1;
+
+    // a bucket for each power of 2 up to the highest value
+    uint64_t l_smallestUntrackable = l_subBucketCount;
+    int l_buckets = 1;
+    while (l_smallestUntrackable <= m_highestValue)
+    {
+        l_smallestUntrackable <<= 1;
+        l_buckets++;
+    }
+    m_countsLength = (l_buckets + 1) * static_cast<int>(m_subBucketHalfCount);
+    m_counts.reset(new std::atomic<uint32_t>[m_countsLength]);
+    Reset();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void HdrHistogram::Record(uint64_t p_value)
+{
+    if (p_value == 0)
+    {
+        p_value = 1;
+    }
+    else if (p_value > m_highestValue)
+    {
+        p_value = m_highestValue;
+    }
+
+    m_counts[CountsIndex(p_value)].fetch_add(1, std::memory_order_relaxed);
+    m_totalCount.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(p_value, std::memory_order_relaxed);
+
+    uint64_t l_max = m_max.load(std::memory_order_relaxed);
+    while (p_value > l_max && !m_max.compare_exchange_weak(l_max, p_value, std::memory_order_relaxed))
+    {
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+uint64_t HdrHistogram::GetValueAtPercentile(double p_percentile) const
+{
+    uint64_t l_totalCount = GetCount();
+    if (l_totalCount == 0)
+    {
+        return 0;
+    }
+    if (p_percentile > 100.0)
+    {
+        p_percentile = 100.0;
+    }
+
+    uint64_t l_countAtPercentile = static_cast<uint64_t>(ceil(p_percentile / 100.0 * l_totalCount));
+    if (l_countAtPercentile == 0)
+    {
+        l_countAtPercentile = 1;
+    }
+
+    uint64_t l_count = 0;
+    for (int l_index = 0; l_index < m_countsLength; l_index++)
+    {
+        l_count += m_counts[l_index].load(std::memory_order_relaxed);
+        if (l_count >= l_countAtPercentile)
+        {
+            uint64_t l_value = HighestEquivalentValue(l_index);
+            uint64_t l_max = GetMax();
+            return (l_value > l_max) ? l_max : l_value;
+        }
+    }
+    return GetMax();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void HdrHistogram::Reset()
+{
+    for (int l_index = 0; l_index < m_countsLength; l_index++)
+    {
+        m_counts[l_index].store(0, std::memory_order_relaxed);
+    }
+    m_totalCount.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+double HdrHistogram::GetMean() const
+{
+    uint64_t l_totalCount = GetCount();
+    return (l_totalCount == 0) ? 0.0 : static_cast<double>(m_total.load(std::memory_order_relaxed)) / l_totalCount;
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+//----------------------------------------------------------------
+// bucket from the highest bit set, sub bucket from the bits below it
+//----------------------------------------------------------------
+int HdrHistogram::CountsIndex(uint64_t p_value) const
+{
+    int l_pow2Ceiling = 64 - __builtin_clzll(p_value | m_subBucketMask);
+    int l_bucketIndex = l_pow2Ceiling - (m_subBucketHalfCountMagnitude + 1);
+    uint64_t l_subBucketIndex = p_value >> l_bucketIndex;
+    return ((l_bucketIndex + 1) << m_subBucketHalfCountMagnitude)
+           + static_cast<int>(l_subBucketIndex - m_subBucketHalfCount);
+}
+
+//----------------------------------------------------------------
+// largest value counted at an index
+//----------------------------------------------------------------
+uint64_t HdrHistogram::HighestEquivalentValue(int p_index) const
+{
+    int l_bucketIndex = (p_index >> m_subBucketHalfCountMagnitude) - 1;
+    uint64_t l_subBucketIndex = (p_index & (m_subBucketHalfCount - 1)) + m_subBucketHalfCount;
+    if (l_bucketIndex < 0)
+    {
+        l_subBucketIndex -= m_subBucketHalfCount;
+        l_bucketIndex = 0;
+    }
+    return (l_subBucketIndex << l_bucketIndex) + (1ULL << l_bucketIndex) - 1;
+}
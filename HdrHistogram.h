@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : High dynamic range histogram header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _HDR_HISTOGRAM_H_INCLUDED_
+#define _HDR_HISTOGRAM_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <atomic>
+#include <memory>
+
+// includes
+
+//----------------------------------------------
+// HDR histogram of values from 1 to a highest value, kept to a
+// number of significant decimal digits at every magnitude. The
+// counts are in buckets, one per power of 2, each split into the
+// same number of linear sub buckets, so recording is a bit scan,
+// a shift and an atomic increment. Values above the highest are
+// counted as the highest.
+//
+// Recording is lock free and may be done from any number of
+// threads, reading while recording gives a close snapshot.
+//----------------------------------------------
+class HdrHistogram
+{
+public:
+    /// Constructor
+    /// Detail- Sizes the counts for the range and precision
+    /// Returns- n/a
+    /// Throws - n/a
+    HdrHistogram
+    (
+        uint64_t p_highestValue,        ///< largest value kept to precision
+        int p_significantDigits = 2     ///< decimal digits of precision, 1 to 4
+    );
+
+    /// Record
+    /// Detail- Counts one value, 0 is counted as 1
+    /// Returns- n/a
+    /// Throws - n/a
+    void Record
+    (
+        uint64_t p_value                ///< value to count
+    );
+
+    /// GetValueAtPercentile
+    /// Detail- The value at or below which the percentile of the
+    ///         recorded values fall, to the precision of the histogram
+    /// Returns- value, 0 when nothing is recorded
+    /// Throws - n/a
+    uint64_t GetValueAtPercentile
+    (
+        double p_percentile             ///< 0 to 100
+    ) const;
+
+    /// Reset
+    /// Detail- Clears the counts, not safe while recording
+    /// Returns- n/a
+    /// Throws - n/a
+    void Reset();
+
+    uint64_t GetCount() const { return m_totalCount.load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return m_max.load(std::memory_order_relaxed); }
+    double GetMean() const;
+
+private:
+    int CountsIndex(uint64_t p_value) const;
+    uint64_t HighestEquivalentValue(int p_index) const;
+
+    uint64_t m_highestValue;                        ///!< largest value counted
+    int m_subBucketHalfCountMagnitude;              ///!< log2 of half the sub buckets
+    uint64_t m_subBucketHalfCount;                  ///!< half the sub buckets in a bucket
+    uint64_t m_subBucketMask;                       ///!< sub buckets - 1
+    int m_countsLength;                             ///!< number of counts
+    std::unique_ptr<std::atomic<uint32_t>[]> m_counts;  ///!< counts by index
+    std::atomic<uint64_t> m_totalCount;             ///!< values recorded
+    std::atomic<uint64_t> m_total;                  ///!< sum of the values, for the mean
+    std::atomic<uint64_t> m_max;                    ///!< largest value recorded
+};
+
+#endif
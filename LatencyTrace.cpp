@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Latency trace implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "LatencyTrace.h"
+
+// C includes
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+// C++ includes
+#include <atomic>
+#include <memory>
+
+// includes
+#include "HdrHistogram.h"
+
+namespace
+{
+    const int cStages = static_cast<int>(eTraceStage::Count);
+    const uint64_t cHighestNs = 10000000000ULL;     // 10 s, longer times are counted as 10 s
+
+    // sentence types traced, the last is every other sentence
+    const char * const cTypeNames[] = { "GGA", "HDT", "VTG", "RMC", "GSV", "MWV",
+                                        "VHW", "DPT", "GLL", "ZDA", "RSA", "other" };
+    const int cTypes = sizeof(cTypeNames) / sizeof(cTypeNames[0]);
+
+    const char * const cStageNames[] = { "receive", "dispatch", "enqueue", "dequeue",
+                                         "parse", "encode", "tx-queue", "wire" };
+
+    std::atomic<bool> s_enabled(false);
+    std::unique_ptr<HdrHistogram> s_histograms[cTypes][cStages];
+    volatile sig_atomic_t s_dumpRequested = 0;
+
+    thread_local TraceContext t_context;
+    thread_local TraceContext * t_pCurrent = nullptr;
+
+    uint64_t MonotonicNs()
+    {
+        struct timespec l_now;
+        clock_gettime(CLOCK_MONOTONIC, &l_now);
+        return static_cast<uint64_t>(l_now.tv_sec) * 1000000000ULL + l_now.tv_nsec;
+    }
+
+    void HandleDumpSignal(int)
+    {
+        s_dumpRequested = 1;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Enable(bool p_enable)
+{
+    if (p_enable && !s_histograms[0][0])
+    {
+        for (int l_type = 0; l_type < cTypes; l_type++)
+        {
+            for (int l_stage = 0; l_stage < cStages; l_stage++)
+            {
+                s_histograms[l_type][l_stage].reset(new HdrHistogram(cHighestNs, 2));
+            }
+        }
+    }
+    s_enabled.store(p_enable, std::memory_order_release);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool LatencyTrace::IsEnabled()
+{
+    return s_enabled.load(std::memory_order_acquire);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Begin()
+{
+    if (!IsEnabled())
+    {
+        t_pCurrent = nullptr;
+        return;
+    }
+    memset(&t_context, 0, sizeof(t_context));
+    t_context.m_type = cTypes - 1;
+    t_context.m_stampNs[static_cast<int>(eTraceStage::Receive)] = MonotonicNs();
+    t_pCurrent = &t_context;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::SetCurrent(TraceContext * p_pContext)
+{
+    t_pCurrent = p_pContext;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+TraceContext * LatencyTrace::GetCurrent()
+{
+    return t_pCurrent;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Copy(TraceContext & p_rContext)
+{
+    if (t_pCurrent != nullptr)
+    {
+        p_rContext = *t_pCurrent;
+    }
+    else
+    {
+        p_rContext.m_stampNs[static_cast<int>(eTraceStage::Receive)] = 0;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Stamp(eTraceStage p_stage)
+{
+    if (t_pCurrent != nullptr)
+    {
+        Stamp(*t_pCurrent, p_stage);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Stamp(TraceContext & p_rContext, eTraceStage p_stage)
+{
+    if (p_rContext.m_stampNs[static_cast<int>(eTraceStage::Receive)] != 0)
+    {
+        p_rContext.m_stampNs[static_cast<int>(p_stage)] = MonotonicNs();
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::SetType(TraceContext & p_rContext, const char * p_pCode)
+{
+    int l_type = 0;
+    while (l_type < cTypes - 1 && strcmp(cTypeNames[l_type], p_pCode) != 0)
+    {
+        l_type++;
+    }
+    p_rContext.m_type = static_cast<uint8_t>(l_type);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Record(const TraceContext & p_rContext, eTraceStage p_first, eTraceStage p_last)
+{
+    uint64_t l_receiveNs = p_rContext.m_stampNs[static_cast<int>(eTraceStage::Receive)];
+    if (l_receiveNs == 0 || !IsEnabled() || p_rContext.m_type >= cTypes)
+    {
+        return;
+    }
+
+    for (int l_stage = static_cast<int>(p_first); l_stage <= static_cast<int>(p_last); l_stage++)
+    {
+        uint64_t l_stampNs = p_rContext.m_stampNs[l_stage];
+        if (l_stampNs != 0)
+        {
+            s_histograms[p_rContext.m_type][l_stage]->Record((l_stampNs > l_receiveNs) ? l_stampNs - l_receiveNs : 0);
+        }
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+std::vector<std::string> LatencyTrace::Report()
+{
+    std::vector<std::string> l_lines;
+    if (!s_histograms[0][0])
+    {
+        return l_lines;
+    }
+
+    char l_line[128];
+    for (int l_type = 0; l_type < cTypes; l_type++)
+    {
+        for (int l_stage = static_cast<int>(eTraceStage::Dispatch); l_stage < cStages; l_stage++)
+        {
+            const HdrHistogram & l_rHistogram = *s_histograms[l_type][l_stage];
+            if (l_rHistogram.GetCount() == 0)
+            {
+                continue;
+            }
+            if (l_lines.empty())
+            {
+                l_lines.push_back("latency from receive, us");
+                snprintf(l_line, sizeof(l_line), "  %-5s %-9s %8s %8s %8s %8s %8s %8s",
+                         "type", "stage", "count", "p50", "p90", "p99", "p99.9", "max");
+                l_lines.push_back(l_line);
+            }
+            snprintf(l_line, sizeof(l_line), "  %-5s %-9s %8llu %8.1f %8.1f %8.1f %8.1f %8.1f",
+                     cTypeNames[l_type], cStageNames[l_stage],
+                     static_cast<unsigned long long>(l_rHistogram.GetCount()),
+                     l_rHistogram.GetValueAtPercentile(50.0) / 1000.0,
+                     l_rHistogram.GetValueAtPercentile(90.0) / 1000.0,
+                     l_rHistogram.GetValueAtPercentile(99.0) / 1000.0,
+                     l_rHistogram.GetValueAtPercentile(99.9) / 1000.0,
+                     l_rHistogram.GetMax() / 1000.0);
+            l_lines.push_back(l_line);
+        }
+    }
+    return l_lines;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Dump(FILE * p_pFile)
+{
+    for (const std::string & l_rLine : Report())
+    {
+        fprintf(p_pFile, "%s\n", l_rLine.c_str());
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+uint64_t LatencyTrace::GetWorstPercentileUs(eTraceStage p_stage, double p_percentile)
+{
+    uint64_t l_worstNs = 0;
+    if (s_histograms[0][0])
+    {
+        for (int l_type = 0; l_type < cTypes; l_type++)
+        {
+            uint64_t l_valueNs = s_histograms[l_type][static_cast<int>(p_stage)]->GetValueAtPercentile(p_percentile);
+            if (l_valueNs > l_worstNs)
+            {
+                l_worstNs = l_valueNs;
+            }
+        }
+    }
+    return l_worstNs / 1000;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::Reset()
+{
+    if (s_histograms[0][0])
+    {
+        for (int l_type = 0; l_type < cTypes; l_type++)
+        {
+            for (int l_stage = 0; l_stage < cStages; l_stage++)
+            {
+                s_histograms[l_type][l_stage]->Reset();
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void LatencyTrace::InstallSignalHandler()
+{
+    struct sigaction l_action;
+    memset(&l_action, 0, sizeof(l_action));
+    l_action.sa_handler = HandleDumpSignal;
+    sigemptyset(&l_action.sa_mask);
+    l_action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &l_action, nullptr);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool LatencyTrace::TakeDumpRequest()
+{
+    if (s_dumpRequested == 0)
+    {
+        return false;
+    }
+    s_dumpRequested = 0;
+    return true;
+}
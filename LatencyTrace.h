@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Latency trace header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _LATENCY_TRACE_H_INCLUDED_
+#define _LATENCY_TRACE_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+#include <stdio.h>
+
+// C++ includes
+#include <string>
+#include <vector>
+
+// includes
+
+//-------------------------------------
+// Stages of a sentence on its way from the network to the CAN bus
+//-------------------------------------
+enum class eTraceStage
+{
+    Receive,        ///< read from the socket
+    Dispatch,       ///< passed to a subscriber by the MessageHandler
+    Enqueue,        ///< queued for the converter
+    Dequeue,        ///< taken off the queue by the converter thread
+    Parse,          ///< sentence parsed
+    Encode,         ///< NMEA2000 message made
+    TxQueue,        ///< queued for the CAN reactor
+    Wire,           ///< handed to the CAN driver
+    Count
+};
+
+//-------------------------------------
+// Monotonic time of each stage a sentence has passed, 0 for a
+// stage not reached. Copied along with the sentence and with
+// each message made from it
+//-------------------------------------
+struct TraceContext
+{
+    uint64_t m_stampNs[static_cast<int>(eTraceStage::Count)];   ///< ns, CLOCK_MONOTONIC
+    uint8_t m_type;                                             ///< sentence type index
+};
+
+//----------------------------------------------
+// End to end latency of the NMEA0183 to NMEA2000 path.
+//
+// The receiving thread begins a trace for each datagram, the stages
+// stamp it as the sentence passes, and the converter and the CAN
+// reactor record the time of each stage from the receive into a HDR
+// histogram per sentence type and stage. Stamps are a clock read into
+// the context, recording is lock free, nothing is done while tracing
+// is disabled.
+//
+// The histograms are dumped with Report, or to the event log when the
+// process is sent SIGUSR1 (kill -USR1 <pid>).
+//----------------------------------------------
+class LatencyTrace
+{
+public:
+    LatencyTrace() = delete;
+    ~LatencyTrace() = delete;
+
+    /// Enable
+    ///- Details:   Creates the histograms and starts tracing
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Enable
+    (
+        bool p_enable       ///< true to trace
+    );
+
+    /// IsEnabled
+    ///- Details:   Tracing is on
+    ///
+    ///- Returns:   true when enabled
+    ///- Throws:    n/a
+    static bool IsEnabled();
+
+    /// Begin
+    ///- Details:   Starts the trace of a received datagram on this thread,
+    ///             stamped with the receive time
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Begin();
+
+    /// SetCurrent
+    ///- Details:   The trace stamped by Stamp on this thread, nullptr for none
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void SetCurrent
+    (
+        TraceContext * p_pContext   ///< trace of the sentence being handled
+    );
+
+    /// GetCurrent
+    ///- Details:   The trace of the sentence being handled on this thread
+    ///
+    ///- Returns:   the trace, nullptr for none
+    ///- Throws:    n/a
+    static TraceContext * GetCurrent();
+
+    /// Copy
+    ///- Details:   Copies the current trace of this thread, a trace
+    ///             that is not recorded if there is none
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Copy
+    (
+        TraceContext & p_rContext   ///< copy of the trace
+    );
+
+    /// Stamp
+    ///- Details:   Stamps a stage of the current trace of this thread
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Stamp
+    (
+        eTraceStage p_stage         ///< stage reached
+    );
+
+    /// Stamp
+    ///- Details:   Stamps a stage of a trace
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Stamp
+    (
+        TraceContext & p_rContext,  ///< trace
+        eTraceStage p_stage         ///< stage reached
+    );
+
+    /// SetType
+    ///- Details:   Sets the sentence type of a trace from the message code
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void SetType
+    (
+        TraceContext & p_rContext,  ///< trace
+        const char * p_pCode        ///< message code, e.g. "GGA"
+    );
+
+    /// Record
+    ///- Details:   Adds the time from receive of each stamped stage
+    ///             from p_first to p_last to the histograms
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Record
+    (
+        const TraceContext & p_rContext,    ///< trace
+        eTraceStage p_first,                ///< first stage recorded
+        eTraceStage p_last                  ///< last stage recorded
+    );
+
+    /// Report
+    ///- Details:   Percentiles of the time from receive to each stage,
+    ///             a line per sentence type and stage
+    ///
+    ///- Returns:   lines of the report, empty if nothing was recorded
+    ///- Throws:    n/a
+    static std::vector<std::string> Report();
+
+    /// Dump
+    ///- Details:   Writes the report
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Dump
+    (
+        FILE * p_pFile      ///< file to write to
+    );
+
+    /// GetWorstPercentileUs
+    ///- Details:   Highest percentile time from receive to a stage over
+    ///             all the sentence types
+    ///
+    ///- Returns:   time in us, 0 if nothing was recorded
+    ///- Throws:    n/a
+    static uint64_t GetWorstPercentileUs
+    (
+        eTraceStage p_stage,    ///< stage
+        double p_percentile     ///< 0 to 100
+    );
+
+    /// Reset
+    ///- Details:   Clears the histograms, not while sentences are handled
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void Reset();
+
+    /// InstallSignalHandler
+    ///- Details:   SIGUSR1 requests a dump, see TakeDumpRequest
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    static void InstallSignalHandler();
+
+    /// TakeDumpRequest
+    ///- Details:   A dump was requested by signal since the last call
+    ///
+    ///- Returns:   true if a dump was requested
+    ///- Throws:    n/a
+    static bool TakeDumpRequest();
+};
+
+#endif
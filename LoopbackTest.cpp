@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Loopback throughput test implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "LoopbackTest.h"
+
+// C includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// C++ includes
+#include <atomic>
+#include <string>
+
+// includes
+#include "Config.h"
+#include "EventLogger.h"
+#include "Utils.h"
+#include "Network/Reactor.h"
+#include "Network/CANInterface.h"
+#include <NMEA2000_Loopback.h>
+#include <N2kMessages.h>
+
+namespace
+{
+    const uint32_t cOpenTimeoutMs = 2000;       // time to open and claim an address
+    const uint32_t cIdleTimeoutMs = 2000;       // time without a message before giving up
+    const uint32_t cDefaultMessages = 300000;   // messages sent by default
+    const uint32_t cBatchSize = cCAN_TX_QUEUE_DEPTH; // messages queued before waiting for the queue to empty
+
+    //-------------------------------------
+    // Counts the test messages handled on the receiving side and their
+    // latency from the frame being received
+    //-------------------------------------
+    class MessageCounter : public tNMEA2000::tMsgHandler
+    {
+    public:
+        MessageCounter(tNMEA2000 * p_pNMEA2000)
+        : tNMEA2000::tMsgHandler(0, p_pNMEA2000), m_count(0), m_latencyTotalUs(0), m_latencyMaxUs(0) {}
+
+        std::atomic<uint32_t> m_count;  ///< messages handled
+        uint64_t m_latencyTotalUs;      ///< sum of the latencies, read once the reactor has stopped
+        uint64_t m_latencyMaxUs;        ///< largest latency, read once the reactor has stopped
+
+    protected:
+        void HandleMsg(const tN2kMsg & p_rMsg) override
+        {
+            if (p_rMsg.PGN != 129029L && p_rMsg.PGN != 127250L && p_rMsg.PGN != 130306L)
+            {
+                return;
+            }
+            uint64_t l_now = Utils::CurrentTimestampMicroSeconds();
+            uint64_t l_latency = (l_now > p_rMsg.MsgTimeUs) ? l_now - p_rMsg.MsgTimeUs : 0;
+            m_latencyTotalUs += l_latency;
+            if (l_latency > m_latencyMaxUs)
+            {
+                m_latencyMaxUs = l_latency;
+            }
+            m_count.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    //-------------------------------------
+    // the library opens once its scheduler has ticked
+    //-------------------------------------
+    bool OpenDriver(tNMEA2000 & p_rNMEA2000)
+    {
+        for (uint32_t l_waitMs = 0; l_waitMs < cOpenTimeoutMs; l_waitMs++)
+        {
+            if (p_rNMEA2000.Open())
+            {
+                return true;
+            }
+            usleep(1000);
+        }
+        EventLogger::Error("LoopbackTest() NMEA2000 loopback driver failed to open");
+        return false;
+    }
+
+    //-------------------------------------
+    // one of the test messages, a third are 43 byte fast packets
+    //-------------------------------------
+    void MakeMessage(uint32_t p_index, tN2kMsg & p_rMsg)
+    {
+        switch (p_index % 3)
+        {
+        case 0:
+            SetN2kGNSS(p_rMsg, 1, 20000, 43200.0 + p_index, 50.8 + p_index * 1e-7, -1.1, 10.0,
+                       N2kGNSSt_GPS, N2kGNSSm_GNSSfix, 9, 0.9, 1.5, 47.0, 1, N2kGNSSt_GPS, 0, 0);
+            break;
+        case 1:
+            SetN2kTrueHeading(p_rMsg, 1, DegToRad(p_index % 360));
+            break;
+        default:
+            SetN2kWindSpeed(p_rMsg, 1, 7.5, DegToRad(p_index % 360), N2kWind_Apparent);
+            break;
+        }
+    }
+
+    double PerSecond(uint64_t p_count, uint64_t p_elapsedUs)
+    {
+        return (p_elapsedUs == 0) ? 0.0 : static_cast<double>(p_count) * 1000000.0 / p_elapsedUs;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool LoopbackTest::IsRequested(int argc, char * argv[])
+{
+    for (int l_index = 1; l_index < argc; l_index++)
+    {
+        if (strcmp(argv[l_index], "--loopback") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int LoopbackTest::Run(int argc, char * argv[])
+{
+    tNMEA2000_Loopback::tTransport l_transport = tNMEA2000_Loopback::lt_Ring;
+    bool l_canFD = false;
+    uint32_t l_messages = cDefaultMessages;
+
+    for (int l_index = 1; l_index < argc; l_index++)
+    {
+        std::string l_arg = argv[l_index];
+        if (l_arg == "--loopback")
+        {
+        }
+        else if (l_arg == "--pipe")
+        {
+            l_transport = tNMEA2000_Loopback::lt_Pipe;
+        }
+        else if (l_arg == "--fd")
+        {
+            l_canFD = true;
+        }
+        else if (l_arg == "--messages" && l_index + 1 < argc && atoi(argv[l_index + 1]) > 0)
+        {
+            l_messages = static_cast<uint32_t>(atoi(argv[++l_index]));
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s --loopback [--pipe] [--fd] [--messages <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    tNMEA2000_Loopback l_sender(l_transport, l_canFD);
+    tNMEA2000_Loopback l_receiver(l_transport, l_canFD);
+    if (!tNMEA2000_Loopback::Connect(l_sender, l_receiver))
+    {
+        EventLogger::Error("LoopbackTest() can not connect the loopback drivers");
+        return 1;
+    }
+    MessageCounter l_counter(&l_receiver);
+    l_sender.SetMode(tNMEA2000::N2km_ListenAndNode, cN2K_ADDRESS_0);
+    l_sender.EnableForward(false);
+    l_receiver.SetMode(tNMEA2000::N2km_ListenAndNode, cN2K_ADDRESS_1);
+    l_receiver.EnableForward(false);
+
+    Reactor l_senderReactor;
+    Reactor l_receiverReactor;
+    CANInterface l_senderInterface(l_sender, l_senderReactor);
+    CANInterface l_receiverInterface(l_receiver, l_receiverReactor);
+    if (!OpenDriver(l_sender) || !OpenDriver(l_receiver)
+        || !l_senderReactor.Init() || !l_senderInterface.Init() || !l_senderReactor.StartThread()
+        || !l_receiverReactor.Init() || !l_receiverInterface.Init() || !l_receiverReactor.StartThread())
+    {
+        EventLogger::Error("LoopbackTest() CAN reactor failed");
+        return 1;
+    }
+    for (uint32_t l_waitMs = 0; !(l_sender.IsAddressClaimed() && l_receiver.IsAddressClaimed())
+                                && l_waitMs < cOpenTimeoutMs; l_waitMs++)
+    {
+        usleep(1000);
+    }
+    uint32_t l_framesBefore = l_receiver.GetFramesReceived();
+
+    // queue in batches no larger than the tx queue, so none are dropped
+    tN2kMsg l_msg;
+    uint64_t l_startUs = Utils::CurrentTimestampMicroSeconds();
+    for (uint32_t l_index = 0; l_index < l_messages; l_index++)
+    {
+        MakeMessage(l_index, l_msg);
+        l_senderInterface.SendMsg(l_msg);
+        if ((l_index + 1) % cBatchSize == 0)
+        {
+            while (!l_senderInterface.IsTxQueueEmpty())
+            {
+                usleep(50);
+            }
+        }
+    }
+
+    // wait for the last messages, giving up when they stop arriving
+    uint32_t l_lastCount = 0;
+    uint64_t l_endUs = Utils::CurrentTimestampMicroSeconds();
+    uint64_t l_lastProgressUs = l_endUs;
+    while (l_counter.m_count.load(std::memory_order_acquire) < l_messages
+           && l_endUs - l_lastProgressUs < cIdleTimeoutMs * 1000ULL)
+    {
+        usleep(100);
+        l_endUs = Utils::CurrentTimestampMicroSeconds();
+        uint32_t l_count = l_counter.m_count.load(std::memory_order_acquire);
+        if (l_count != l_lastCount)
+        {
+            l_lastCount = l_count;
+            l_lastProgressUs = l_endUs;
+        }
+    }
+
+    l_senderReactor.StopThread();
+    l_receiverReactor.StopThread();
+
+    uint32_t l_handled = l_counter.m_count.load(std::memory_order_acquire);
+    uint32_t l_frames = l_receiver.GetFramesReceived() - l_framesBefore;
+    uint64_t l_elapsedUs = l_endUs - l_startUs;
+    const tNMEA2000_SocketCAN::tTxStats & l_txStats = l_sender.GetTxStats();
+    printf("Loopback %s%s: %u of %u messages in %.3f s\n",
+           (l_transport == tNMEA2000_Loopback::lt_Ring) ? "ring" : "pipe", l_sender.IsCANFD() ? " CAN FD" : "",
+           l_handled, l_messages, l_elapsedUs / 1000000.0);
+    printf("  %u frames, %.0f frames/s, %.0f messages/s\n", l_frames,
+           PerSecond(l_frames, l_elapsedUs), PerSecond(l_handled, l_elapsedUs));
+    printf("  latency frame received to message handled avg %llu us, max %llu us\n",
+           static_cast<unsigned long long>(l_handled ? l_counter.m_latencyTotalUs / l_handled : 0),
+           static_cast<unsigned long long>(l_counter.m_latencyMaxUs));
+    printf("  sender stalls %u, stalled %llu us\n", l_txStats.SocketFull + l_txStats.DeviceQueueFull,
+           static_cast<unsigned long long>(l_txStats.StallTimeUs));
+    return (l_handled == l_messages) ? 0 : 1;
+}
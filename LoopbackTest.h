@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Loopback throughput test header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _LOOPBACK_TEST_H_INCLUDED_
+#define _LOOPBACK_TEST_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+
+// includes
+
+//----------------------------------------------
+// Measures the NMEA2000 stack on an in-process bus, no CAN port needed.
+//
+//  nmea2can --loopback [--pipe] [--fd] [--messages <n>]
+//
+// Two loopback drivers are connected, each behind a CANInterface on its
+// own reactor as in the gateway. Messages queued on the first are framed,
+// carried by a memory ring (or a socket pair with --pipe) and reassembled
+// and dispatched to a handler on the second. The mix is a GNSS position
+// fast packet, heading and wind. Ends with the frame and message rates
+// and the latency from the last frame of a message arriving to it being
+// handled.
+//----------------------------------------------
+class LoopbackTest
+{
+public:
+    /// IsRequested
+    /// Detail- The command line asks for a loopback test
+    /// Returns- true for loopback mode
+    /// Throws - n/a
+    static bool IsRequested
+    (
+        int argc,           ///< argument count
+        char * argv[]       ///< arguments
+    );
+
+    /// Run
+    /// Detail- Runs the test given on the command line
+    /// Returns- exit code of the program
+    /// Throws - n/a
+    static int Run
+    (
+        int argc,           ///< argument count
+        char * argv[]       ///< arguments
+    );
+};
+
+#endif
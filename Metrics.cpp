@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Metrics registry implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "Metrics.h"
+
+// C includes
+#include <stdio.h>
+
+// C++ includes
+
+// includes
+#include "EventLogger.h"
+
+namespace
+{
+    std::atomic<uint32_t> s_nextShard(0);
+    thread_local uint32_t t_shard = UINT32_MAX;
+
+    const char * TypeName(int p_type)
+    {
+        static const char * const l_names[] = { "counter", "gauge", "histogram" };
+        return l_names[p_type];
+    }
+
+    // name{labels} or name{labels,extra}
+    std::string Series(const std::string & p_rName, const std::string & p_rLabels, const std::string & p_rExtra = "")
+    {
+        std::string l_labels = p_rLabels;
+        if (!p_rExtra.empty())
+        {
+            l_labels += (l_labels.empty() ? "" : ",") + p_rExtra;
+        }
+        return l_labels.empty() ? p_rName : p_rName + "{" + l_labels + "}";
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+uint32_t MetricShardIndex()
+{
+    if (t_shard == UINT32_MAX)
+    {
+        t_shard = s_nextShard.fetch_add(1, std::memory_order_relaxed) & (cMetricShards - 1);
+    }
+    return t_shard;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricCounter::MetricCounter()
+{
+    for (Shard & l_rShard : m_shards)
+    {
+        l_rShard.m_value.store(0, std::memory_order_relaxed);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+uint64_t MetricCounter::GetValue() const
+{
+    uint64_t l_value = 0;
+    for (const Shard & l_rShard : m_shards)
+    {
+        l_value += l_rShard.m_value.load(std::memory_order_relaxed);
+    }
+    return l_value;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricHistogram::MetricHistogram(const std::vector<uint64_t> & p_rBounds)
+: m_bucketCount(0)
+{
+    for (uint64_t l_bound : p_rBounds)
+    {
+        if (m_bucketCount == cMetricMaxBuckets)
+        {
+            break;
+        }
+        m_bounds[m_bucketCount++] = l_bound;
+    }
+    for (Shard & l_rShard : m_shards)
+    {
+        for (std::atomic<uint64_t> & l_rCount : l_rShard.m_counts)
+        {
+            l_rCount.store(0, std::memory_order_relaxed);
+        }
+        l_rShard.m_sum.store(0, std::memory_order_relaxed);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void MetricHistogram::GetCounts(uint64_t * p_pCounts, uint64_t & p_rSum) const
+{
+    p_rSum = 0;
+    for (uint32_t l_bucket = 0; l_bucket <= m_bucketCount; l_bucket++)
+    {
+        p_pCounts[l_bucket] = 0;
+    }
+    for (const Shard & l_rShard : m_shards)
+    {
+        for (uint32_t l_bucket = 0; l_bucket <= m_bucketCount; l_bucket++)
+        {
+            p_pCounts[l_bucket] += l_rShard.m_counts[l_bucket].load(std::memory_order_relaxed);
+        }
+        p_rSum += l_rShard.m_sum.load(std::memory_order_relaxed);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricsRegistry * MetricsRegistry::GetInstance()
+{
+    static MetricsRegistry s_instance;
+    return &s_instance;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricCounter * MetricsRegistry::AddCounter(const std::string & p_rName, const std::string & p_rHelp,
+                                            const std::string & p_rLabels)
+{
+    Lock l_lock(m_lock);
+    Metric & l_rMetric = FindOrAdd(p_rName, p_rHelp, p_rLabels, eMetricType::Counter);
+    if (!l_rMetric.m_pCounter)
+    {
+        l_rMetric.m_pCounter.reset(new MetricCounter());
+    }
+    return l_rMetric.m_pCounter.get();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricGauge * MetricsRegistry::AddGauge(const std::string & p_rName, const std::string & p_rHelp,
+                                        const std::string & p_rLabels)
+{
+    Lock l_lock(m_lock);
+    Metric & l_rMetric = FindOrAdd(p_rName, p_rHelp, p_rLabels, eMetricType::Gauge);
+    if (!l_rMetric.m_pGauge)
+    {
+        l_rMetric.m_pGauge.reset(new MetricGauge());
+    }
+    return l_rMetric.m_pGauge.get();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricHistogram * MetricsRegistry::AddHistogram(const std::string & p_rName, const std::string & p_rHelp,
+                                                const std::vector<uint64_t> & p_rBounds, const std::string & p_rLabels)
+{
+    Lock l_lock(m_lock);
+    Metric & l_rMetric = FindOrAdd(p_rName, p_rHelp, p_rLabels, eMetricType::Histogram);
+    if (!l_rMetric.m_pHistogram)
+    {
+        l_rMetric.m_pHistogram.reset(new MetricHistogram(p_rBounds));
+    }
+    return l_rMetric.m_pHistogram.get();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+std::string MetricsRegistry::Snapshot()
+{
+    Lock l_lock(m_lock);
+    std::string l_text;
+    std::vector<bool> l_written(m_metrics.size(), false);
+    char l_value[64];
+
+    // a family is written together, under one HELP and TYPE
+    for (size_t l_first = 0; l_first < m_metrics.size(); l_first++)
+    {
+        if (l_written[l_first] || m_metrics[l_first]->m_name.empty())
+        {
+            continue;
+        }
+        const Metric & l_rFamily = *m_metrics[l_first];
+        l_text += "# HELP " + l_rFamily.m_name + " " + l_rFamily.m_help + "\n";
+        l_text += "# TYPE " + l_rFamily.m_name + " " + TypeName(static_cast<int>(l_rFamily.m_type)) + "\n";
+
+        for (size_t l_index = l_first; l_index < m_metrics.size(); l_index++)
+        {
+            const Metric & l_rMetric = *m_metrics[l_index];
+            if (l_written[l_index] || l_rMetric.m_name != l_rFamily.m_name)
+            {
+                continue;
+            }
+            l_written[l_index] = true;
+
+            switch (l_rMetric.m_type)
+            {
+            case eMetricType::Counter:
+                snprintf(l_value, sizeof(l_value), " %llu\n",
+                         static_cast<unsigned long long>(l_rMetric.m_pCounter->GetValue()));
+                l_text += Series(l_rMetric.m_name, l_rMetric.m_labels) + l_value;
+                break;
+
+            case eMetricType::Gauge:
+                snprintf(l_value, sizeof(l_value), " %lld\n",
+                         static_cast<long long>(l_rMetric.m_pGauge->GetValue()));
+                l_text += Series(l_rMetric.m_name, l_rMetric.m_labels) + l_value;
+                break;
+
+            case eMetricType::Histogram:
+            {
+                const MetricHistogram & l_rHistogram = *l_rMetric.m_pHistogram;
+                uint64_t l_counts[cMetricMaxBuckets + 1];
+                uint64_t l_sum;
+                l_rHistogram.GetCounts(l_counts, l_sum);
+
+                uint64_t l_cumulative = 0;
+                for (uint32_t l_bucket = 0; l_bucket <= l_rHistogram.GetBucketCount(); l_bucket++)
+                {
+                    l_cumulative += l_counts[l_bucket];
+                    std::string l_le = "le=\"+Inf\"";
+                    if (l_bucket < l_rHistogram.GetBucketCount())
+                    {
+                        snprintf(l_value, sizeof(l_value), "le=\"%llu\"",
+                                 static_cast<unsigned long long>(l_rHistogram.GetBound(l_bucket)));
+                        l_le = l_value;
+                    }
+                    snprintf(l_value, sizeof(l_value), " %llu\n", static_cast<unsigned long long>(l_cumulative));
+                    l_text += Series(l_rMetric.m_name + "_bucket", l_rMetric.m_labels, l_le) + l_value;
+                }
+                snprintf(l_value, sizeof(l_value), " %llu\n", static_cast<unsigned long long>(l_sum));
+                l_text += Series(l_rMetric.m_name + "_sum", l_rMetric.m_labels) + l_value;
+                snprintf(l_value, sizeof(l_value), " %llu\n", static_cast<unsigned long long>(l_cumulative));
+                l_text += Series(l_rMetric.m_name + "_count", l_rMetric.m_labels) + l_value;
+                break;
+            }
+            }
+        }
+    }
+    return l_text;
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricsRegistry::Metric & MetricsRegistry::FindOrAdd(const std::string & p_rName, const std::string & p_rHelp,
+                                                     const std::string & p_rLabels, eMetricType p_type)
+{
+    bool l_clash = false;
+    for (std::unique_ptr<Metric> & l_rpMetric : m_metrics)
+    {
+        if (l_rpMetric->m_name != p_rName)
+        {
+            continue;
+        }
+        if (l_rpMetric->m_type != p_type)
+        {
+            l_clash = true;
+        }
+        else if (l_rpMetric->m_labels == p_rLabels)
+        {
+            return *l_rpMetric;
+        }
+    }
+
+    // a name used for another type of metric still gets a metric
+    // to record into, it is not exported
+    if (l_clash)
+    {
+        EventLogger::Error("MetricsRegistry() %s is already registered as another type", p_rName.c_str());
+    }
+    m_metrics.emplace_back(new Metric());
+    Metric & l_rMetric = *m_metrics.back();
+    l_rMetric.m_name = l_clash ? "" : p_rName;
+    l_rMetric.m_help = p_rHelp;
+    l_rMetric.m_labels = p_rLabels;
+    l_rMetric.m_type = p_type;
+    return l_rMetric;
+}
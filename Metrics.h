@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Metrics registry header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _METRICS_H_INCLUDED_
+#define _METRICS_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// includes
+
+namespace
+{
+    const uint32_t cMetricShards = 16;          // power of 2
+    const uint32_t cMetricMaxBuckets = 16;      // histogram bucket bounds
+    const size_t cMetricCacheLine = 64;
+}
+
+//-------------------------------------
+// Shard used by the calling thread, threads are spread over
+// the shards in the order they first record
+//-------------------------------------
+uint32_t MetricShardIndex();
+
+//----------------------------------------------
+// Counter, only goes up. Each thread adds to its own cache line
+// so recording threads do not contend, the shards are summed
+// when read
+//----------------------------------------------
+class MetricCounter
+{
+public:
+    MetricCounter();
+
+    /// Add
+    /// Detail- Adds to the counter, lock free
+    /// Returns- n/a
+    /// Throws - n/a
+    void Add
+    (
+        uint64_t p_value = 1        ///< amount to add
+    )
+    {
+        m_shards[MetricShardIndex()].m_value.fetch_add(p_value, std::memory_order_relaxed);
+    }
+
+    /// GetValue
+    /// Detail- Sum of the shards
+    /// Returns- counter value
+    /// Throws - n/a
+    uint64_t GetValue() const;
+
+private:
+    // padded to a cache line, alignas is not honoured by new before C++17
+    struct Shard
+    {
+        std::atomic<uint64_t> m_value;
+        char m_pad[cMetricCacheLine - sizeof(std::atomic<uint64_t>)];
+    };
+    Shard m_shards[cMetricShards];      ///!< per thread counts
+};
+
+//----------------------------------------------
+// Gauge, a value that goes up and down, set by its owner
+//----------------------------------------------
+class MetricGauge
+{
+public:
+    MetricGauge() : m_value(0) {}
+
+    void Set(int64_t p_value) { m_value.store(p_value, std::memory_order_relaxed); }
+    void Add(int64_t p_value) { m_value.fetch_add(p_value, std::memory_order_relaxed); }
+    int64_t GetValue() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> m_value;       ///!< current value
+};
+
+//----------------------------------------------
+// Histogram with fixed bucket bounds, sharded as the counter.
+// A value is counted in the first bucket whose bound it does not
+// exceed, or the +Inf bucket
+//----------------------------------------------
+class MetricHistogram
+{
+public:
+    /// Constructor
+    /// Detail- Bounds must be increasing, at most cMetricMaxBuckets are used
+    /// Returns- n/a
+    /// Throws - n/a
+    MetricHistogram
+    (
+        const std::vector<uint64_t> & p_rBounds     ///< upper bound of each bucket
+    );
+
+    /// Record
+    /// Detail- Counts a value, lock free
+    /// Returns- n/a
+    /// Throws - n/a
+    void Record
+    (
+        uint64_t p_value            ///< value to count
+    )
+    {
+        uint32_t l_bucket = 0;
+        while (l_bucket < m_bucketCount && p_value > m_bounds[l_bucket])
+        {
+            l_bucket++;
+        }
+        Shard & l_rShard = m_shards[MetricShardIndex()];
+        l_rShard.m_counts[l_bucket].fetch_add(1, std::memory_order_relaxed);
+        l_rShard.m_sum.fetch_add(p_value, std::memory_order_relaxed);
+    }
+
+    uint32_t GetBucketCount() const { return m_bucketCount; }
+    uint64_t GetBound(uint32_t p_bucket) const { return m_bounds[p_bucket]; }
+
+    /// GetCounts
+    /// Detail- Count of each bucket summed over the shards, the last is +Inf
+    /// Returns- n/a
+    /// Throws - n/a
+    void GetCounts
+    (
+        uint64_t * p_pCounts,       ///< GetBucketCount() + 1 counts
+        uint64_t & p_rSum           ///< sum of the values
+    ) const;
+
+private:
+    struct Shard
+    {
+        std::atomic<uint64_t> m_counts[cMetricMaxBuckets + 1];
+        std::atomic<uint64_t> m_sum;
+        char m_pad[cMetricCacheLine - ((cMetricMaxBuckets + 2) * sizeof(std::atomic<uint64_t>)) % cMetricCacheLine];
+    };
+    uint64_t m_bounds[cMetricMaxBuckets];   ///!< bucket upper bounds
+    uint32_t m_bucketCount;                 ///!< bounds used
+    Shard m_shards[cMetricShards];          ///!< per thread counts
+};
+
+//---------------------------------------------------
+// Registry of the metrics of the gateway.
+//
+// Components register their metrics once and keep the pointer,
+// the registry owns them for the life of the process so a
+// component may be created again and get the same metric back.
+// Registering takes a lock, recording never does. Snapshot
+// writes every metric in the Prometheus text format.
+//---------------------------------------------------
+class MetricsRegistry
+{
+public:
+    /// GetInstance
+    ///- Details: Class is a singleton class , this method gets access to the instance
+    ///
+    ///- Returns:   Instance of the MetricsRegistry
+    ///- Throws:    n/a
+    static MetricsRegistry * GetInstance();
+
+    /// AddCounter
+    ///- Details:   Registers a counter, or finds the one registered with the
+    ///             same name and labels
+    ///
+    ///- Returns:   the counter
+    ///- Throws:    n/a
+    MetricCounter * AddCounter
+    (
+        const std::string & p_rName,            ///< metric name, ends in _total
+        const std::string & p_rHelp,            ///< description
+        const std::string & p_rLabels = ""      ///< labels, e.g. bus="can0"
+    );
+
+    /// AddGauge
+    ///- Details:   Registers a gauge, or finds the one registered with the
+    ///             same name and labels
+    ///
+    ///- Returns:   the gauge
+    ///- Throws:    n/a
+    MetricGauge * AddGauge
+    (
+        const std::string & p_rName,            ///< metric name
+        const std::string & p_rHelp,            ///< description
+        const std::string & p_rLabels = ""      ///< labels, e.g. bus="can0"
+    );
+
+    /// AddHistogram
+    ///- Details:   Registers a histogram, or finds the one registered with
+    ///             the same name and labels
+    ///
+    ///- Returns:   the histogram
+    ///- Throws:    n/a
+    MetricHistogram * AddHistogram
+    (
+        const std::string & p_rName,                ///< metric name
+        const std::string & p_rHelp,                ///< description
+        const std::vector<uint64_t> & p_rBounds,    ///< upper bound of each bucket
+        const std::string & p_rLabels = ""          ///< labels, e.g. bus="can0"
+    );
+
+    /// Snapshot
+    ///- Details:   Current value of every metric, Prometheus text format 0.0.4
+    ///
+    ///- Returns:   the exposition text
+    ///- Throws:    n/a
+    std::string Snapshot();
+
+private:
+    enum class eMetricType
+    {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    struct Metric
+    {
+        std::string m_name;
+        std::string m_help;
+        std::string m_labels;
+        eMetricType m_type;
+        std::unique_ptr<MetricCounter> m_pCounter;
+        std::unique_ptr<MetricGauge> m_pGauge;
+        std::unique_ptr<MetricHistogram> m_pHistogram;
+    };
+
+    MetricsRegistry() {}
+
+    // the metric of the name and labels, added if not found
+    Metric & FindOrAdd(const std::string & p_rName, const std::string & p_rHelp,
+                       const std::string & p_rLabels, eMetricType p_type);
+
+    std::mutex m_lock;                              ///!< guards the list
+    std::vector<std::unique_ptr<Metric>> m_metrics; ///!< in registration order
+};
+
+#endif
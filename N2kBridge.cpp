@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : NMEA2000 bus bridge implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "N2kBridge.h"
+
+// C includes
+
+// C++ includes
+#include <algorithm>
+
+// includes
+#include <N2kTimer.h>
+#include "Config.h"
+#include "EventLogger.h"
+
+namespace
+{
+    // Network management PGNs belong to the local bus and are never bridged
+    const unsigned long cSystemPGNs[] = { 59392L, 59904L, 60160L, 60416L, 60928L, 65240L,
+                                          126208L, 126464L, 126993L, 126996L, 126998L };
+
+    //-------------------------------------
+    // FNV-1a hash of the source, PGN and data
+    //-------------------------------------
+    uint32_t HashMsg(const tN2kMsg &p_rMsg)
+    {
+        uint32_t l_hash = (2166136261UL ^ p_rMsg.Source) * 16777619UL;
+        for (int l_index = 0; l_index < 3; l_index++)
+        {
+            l_hash = (l_hash ^ ((p_rMsg.PGN >> (l_index * 8)) & 0xff)) * 16777619UL;
+        }
+        for (int l_index = 0; l_index < p_rMsg.DataLen; l_index++)
+        {
+            l_hash = (l_hash ^ p_rMsg.Data[l_index]) * 16777619UL;
+        }
+        return l_hash;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+N2kBridge::N2kBridge(tNMEA2000 &p_rNMEA2000Bus0, CANInterface &p_rInterfaceBus0,
+                     tNMEA2000 &p_rNMEA2000Bus1, CANInterface &p_rInterfaceBus1)
+    : m_direction0(*this, 0, &p_rNMEA2000Bus0)
+    , m_direction1(*this, 1, &p_rNMEA2000Bus1)
+    , m_records(cBRIDGE_LOOP_RECORDS)
+{
+    m_pNMEA2000[0] = &p_rNMEA2000Bus0;
+    m_pNMEA2000[1] = &p_rNMEA2000Bus1;
+    m_pInterface[0] = &p_rInterfaceBus0;
+    m_pInterface[1] = &p_rInterfaceBus1;
+    for (int l_bus = 0; l_bus < 2; l_bus++)
+    {
+        m_forwarded[l_bus] = 0;
+        m_suppressed[l_bus] = 0;
+    }
+    for (ForwardRecord &l_record : m_records)
+    {
+        l_record.m_hash = 0;
+        l_record.m_time[0] = 0;
+        l_record.m_time[1] = 0;
+        l_record.m_interval = 0;
+        l_record.m_toBuses = 0;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void N2kBridge::AddPGN(unsigned long p_PGN)
+{
+    const unsigned long *l_pSystemEnd = cSystemPGNs + sizeof(cSystemPGNs) / sizeof(cSystemPGNs[0]);
+    if (std::find(cSystemPGNs, l_pSystemEnd, p_PGN) != l_pSystemEnd)
+    {
+        EventLogger::Error("N2kBridge() system PGN %lu can not be bridged", p_PGN);
+        return;
+    }
+
+    std::vector<unsigned long>::iterator l_it = std::lower_bound(m_PGNs.begin(), m_PGNs.end(), p_PGN);
+    if (l_it == m_PGNs.end() || *l_it != p_PGN)
+    {
+        m_PGNs.insert(l_it, p_PGN);
+    }
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool N2kBridge::IsForwarded(unsigned long p_PGN) const
+{
+    return std::binary_search(m_PGNs.begin(), m_PGNs.end(), p_PGN);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool N2kBridge::IsLooped(int p_fromBus, uint32_t p_hash)
+{
+    uint32_t l_now = N2kMillis();
+    Lock l_lock(m_recordMutex);
+
+    ForwardRecord &l_record = m_records[p_hash % m_records.size()];
+    if (l_record.m_hash != p_hash)
+    {
+        // a different message used the slot, it is forgotten
+        l_record.m_hash = p_hash;
+        l_record.m_interval = 0;
+        l_record.m_toBuses = 0;
+    }
+
+    if ((l_record.m_toBuses & (1 << p_fromBus)) != 0)
+    {
+        // a source repeating the same content is not a loop once twice
+        // its interval has passed
+        uint32_t l_window = cBRIDGE_LOOP_WINDOW_MS;
+        if (l_record.m_interval != 0)
+        {
+            l_window = std::min(std::max(2 * l_record.m_interval, cBRIDGE_LOOP_MIN_WINDOW_MS), cBRIDGE_LOOP_WINDOW_MS);
+        }
+        if ((l_now - l_record.m_time[p_fromBus]) < l_window)
+        {
+            return true;
+        }
+    }
+
+    int l_toBus = p_fromBus ^ 1;
+    if ((l_record.m_toBuses & (1 << l_toBus)) != 0)
+    {
+        l_record.m_interval = l_now - l_record.m_time[l_toBus];
+    }
+    l_record.m_time[l_toBus] = l_now;
+    l_record.m_toBuses |= (1 << l_toBus);
+    return false;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void N2kBridge::Forward(int p_fromBus, const tN2kMsg &p_rMsg)
+{
+    // only broadcast messages from other nodes on the list are bridged
+    if (p_rMsg.Destination != 0xff || !IsForwarded(p_rMsg.PGN))
+    {
+        return;
+    }
+    if (p_rMsg.Source == m_pNMEA2000[p_fromBus]->GetN2kSource())
+    {
+        return;
+    }
+
+    if (IsLooped(p_fromBus, HashMsg(p_rMsg)))
+    {
+        m_suppressed[p_fromBus]++;
+        return;
+    }
+
+    if (m_pInterface[p_fromBus ^ 1]->SendMsg(p_rMsg))
+    {
+        m_forwarded[p_fromBus]++;
+    }
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : NMEA2000 bus bridge header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _N2K_BRIDGE_H_INCLUDED_
+#define _N2K_BRIDGE_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+// includes
+#include <NMEA2000.h>
+#include "Network/CANInterface.h"
+
+//----------------------------------------------
+// Bridge forwards selected broadcast PGNs between two NMEA2000 buses.
+// Each direction runs on the reactor thread of the receiving bus and
+// sends through the tx queue of the other bus.
+//
+// Loop suppression - a message with the same source and content is not
+// forwarded back to the bus it was forwarded to within twice its repeat
+// interval, limited to cBRIDGE_LOOP_MIN_WINDOW_MS..cBRIDGE_LOOP_WINDOW_MS,
+// so a second gateway or a cabling loop between the backbones cannot make
+// messages circulate. Records are kept in a table indexed by the message
+// hash, so a loop is found however many other messages were forwarded.
+//----------------------------------------------
+class N2kBridge
+{
+public:
+    /// Default Constructor
+    /// Detail- Bridge constructor, attaches to both buses
+    /// Returns- n/a
+    /// Throws - n/a
+    N2kBridge
+    (
+        tNMEA2000& p_rNMEA2000Bus0,         ///< NMEA2000 object of bus 0
+        CANInterface& p_rInterfaceBus0,     ///< tx interface of bus 0
+        tNMEA2000& p_rNMEA2000Bus1,         ///< NMEA2000 object of bus 1
+        CANInterface& p_rInterfaceBus1      ///< tx interface of bus 1
+    );
+
+    /// AddPGN
+    /// Detail- Adds a PGN to the forward list. Call before the reactors are started
+    /// Returns- n/a
+    /// Throws - n/a
+    void AddPGN
+    (
+        unsigned long p_PGN                 ///< PGN to forward
+    );
+
+    /// GetForwarded
+    /// Detail- number of messages forwarded from the bus
+    /// Returns- message count
+    /// Throws - n/a
+    uint32_t GetForwarded(int p_fromBus) const { return m_forwarded[p_fromBus & 1]; }
+
+    /// GetSuppressed
+    /// Detail- number of looped messages dropped on the bus
+    /// Returns- message count
+    /// Throws - n/a
+    uint32_t GetSuppressed(int p_fromBus) const { return m_suppressed[p_fromBus & 1]; }
+
+private:
+    //----------------------------------------------
+    // Message handler for one direction
+    //----------------------------------------------
+    class Direction : public tNMEA2000::tMsgHandler
+    {
+    public:
+        Direction(N2kBridge& p_rBridge, int p_fromBus, tNMEA2000* p_pNMEA2000)
+        : tNMEA2000::tMsgHandler(0, p_pNMEA2000), m_rBridge(p_rBridge), m_fromBus(p_fromBus) {}
+
+    protected:
+        void HandleMsg(const tN2kMsg& p_rMsg) override { m_rBridge.Forward(m_fromBus, p_rMsg); }
+
+    private:
+        N2kBridge& m_rBridge;
+        int m_fromBus;
+    };
+
+    // record of a forwarded message for loop suppression
+    struct ForwardRecord
+    {
+        uint32_t m_hash;            ///< hash of source, PGN and data
+        uint32_t m_time[2];         ///< N2kMillis when forwarded to each bus
+        uint32_t m_interval;        ///< repeat interval, 0 if not known
+        uint8_t m_toBuses;          ///< bit per bus with a valid m_time
+    };
+
+    // forward a message received on a bus to the other bus
+    void Forward(int p_fromBus, const tN2kMsg& p_rMsg);
+
+    // true if the PGN is on the forward list
+    bool IsForwarded(unsigned long p_PGN) const;
+
+    // true if the message was recently forwarded to p_fromBus,
+    // otherwise records it as forwarded to the other bus
+    bool IsLooped(int p_fromBus, uint32_t p_hash);
+
+    tNMEA2000* m_pNMEA2000[2];              ///< NMEA2000 objects
+    CANInterface* m_pInterface[2];          ///< tx interfaces
+    Direction m_direction0;                 ///< bus 0 -> bus 1
+    Direction m_direction1;                 ///< bus 1 -> bus 0
+    std::vector<unsigned long> m_PGNs;      ///< sorted forward list
+
+    std::mutex m_recordMutex;               ///< protects the forward records
+    std::vector<ForwardRecord> m_records;   ///< recently forwarded messages by hash
+
+    std::atomic<uint32_t> m_forwarded[2];   ///< forwarded count per source bus
+    std::atomic<uint32_t> m_suppressed[2];  ///< suppressed count per source bus
+};
+
+#endif
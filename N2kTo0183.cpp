@@ -0,0 +1,477 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : NMEA2000 to NMEA0183 converter implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "N2kTo0183.h"
+
+// C includes
+#include <string.h>
+
+// C++ includes
+
+// includes
+#include <N2kMessages.h>
+#include <N2kMessagesLayout.h>
+#include <N2kTimer.h>
+#include <NMEA0183Messages.h>
+#include "Metrics.h"
+
+namespace
+{
+    // ms between two of a sentence for an instance, 0 sends every one.
+    // In the order of eSentence
+    const uint32_t kIntervalMs[] = {
+        200,    // DPT
+        200,    // DBT
+        100,    // MWV
+        100,    // HDG
+        100,    // HDT
+        100,    // ROT
+        200,    // VHW
+        200,    // VTG
+        500,    // GGA
+        500,    // RMC
+        100,    // RPM
+        500     // XDR
+    };
+
+    //-------------------------------------
+    // NMEA0183 number from a NMEA2000 one, the not available values differ
+    //-------------------------------------
+    uint32_t ToUInt32(uint8_t p_value)
+    {
+        return (p_value == N2kUInt8NA) ? NMEA0183UInt32NA : p_value;
+    }
+
+    uint32_t ToUInt32(uint16_t p_value)
+    {
+        return (p_value == N2kUInt16NA) ? NMEA0183UInt32NA : p_value;
+    }
+
+    //-------------------------------------
+    // XDR transducer name, e.g. ENGTEMP#1
+    //-------------------------------------
+    void SetName(char *p_pName, const char *p_pPrefix, uint8_t p_instance)
+    {
+        size_t l_length = strlen(p_pPrefix);
+        memcpy(p_pName, p_pPrefix, l_length);
+        p_pName[l_length] = '#';
+        p_pName[l_length + 1] = static_cast<char>('0' + p_instance % 10);
+        p_pName[l_length + 2] = '\0';
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+N2kTo0183::N2kTo0183(tNMEA2000 &p_rNMEA2000)
+    : m_rNMEA2000(p_rNMEA2000)
+    , m_trueHeading(NMEA0183DoubleNA)
+    , m_magneticHeading(NMEA0183DoubleNA)
+    , m_variation(NMEA0183DoubleNA)
+    , m_COG(NMEA0183DoubleNA)
+    , m_SOG(NMEA0183DoubleNA)
+{
+    static_assert(sizeof(kIntervalMs) / sizeof(kIntervalMs[0]) == SentenceCount, "an interval for each sentence");
+    memset(m_lastSentMs, 0, sizeof(m_lastSentMs));
+
+    m_handlers.emplace_back(new Handler(*this, 128267L, &N2kTo0183::ConvertWaterDepth, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 130306L, &N2kTo0183::ConvertWind, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 127250L, &N2kTo0183::ConvertHeading, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 127251L, &N2kTo0183::ConvertRateOfTurn, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 128259L, &N2kTo0183::ConvertBoatSpeed, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 129026L, &N2kTo0183::ConvertCOGSOG, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 129029L, &N2kTo0183::ConvertGNSS, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 127488L, &N2kTo0183::ConvertEngineRapid, &p_rNMEA2000));
+    m_handlers.emplace_back(new Handler(*this, 127489L, &N2kTo0183::ConvertEngineDynamic, &p_rNMEA2000));
+
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    m_pSent = l_pRegistry->AddCounter("nmea2can_0183_out_sentences_total", "NMEA0183 sentences converted from NMEA2000 and sent");
+    m_pLimited = l_pRegistry->AddCounter("nmea2can_0183_out_limited_total", "NMEA0183 sentences dropped, sent within their interval");
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+N2kTo0183::~N2kTo0183()
+{
+    // the handlers detach from the bus
+    m_handlers.clear();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void N2kTo0183::AddOutput(INetwork *p_pNetwork)
+{
+    if (p_pNetwork != nullptr)
+    {
+        m_outputs.push_back(p_pNetwork);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void N2kTo0183::Handler::HandleMsg(const tN2kMsg &p_rMsg)
+{
+    // our own messages came from NMEA0183
+    if (p_rMsg.Source != m_rConverter.m_rNMEA2000.GetN2kSource())
+    {
+        (m_rConverter.*m_convert)(p_rMsg);
+    }
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+/// IsDue
+///- Details:   Checks the sentence has not been sent for the instance
+///             within its interval
+///
+///- Returns:   true if the sentence is to be sent
+///- Throws:    n/a
+bool N2kTo0183::IsDue(eSentence p_sentence, uint8_t p_instance)
+{
+    uint32_t l_now = N2kMillis();
+    uint32_t &l_rLastSent = m_lastSentMs[p_sentence][p_instance % kInstances];
+    if (l_rLastSent != 0 && (l_now - l_rLastSent) < kIntervalMs[p_sentence])
+    {
+        m_pLimited->Add();
+        return false;
+    }
+    l_rLastSent = l_now;
+    return true;
+}
+
+/// Send
+///- Details:   Formats the sentence with its checksum and line end, and
+///             sends it to each output
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::Send(const tNMEA0183Msg &p_rMsg)
+{
+    char l_buffer[MAX_NMEA0183_MSG_LEN + 8];
+    if (!p_rMsg.GetMessage(l_buffer, sizeof(l_buffer) - 2))
+    {
+        return;
+    }
+    size_t l_length = strlen(l_buffer);
+    l_buffer[l_length++] = '\r';
+    l_buffer[l_length++] = '\n';
+
+    for (INetwork *l_pOutput : m_outputs)
+    {
+        l_pOutput->SendData(l_buffer, static_cast<uint16_t>(l_length));
+    }
+    m_pSent->Add();
+}
+
+/// ConvertWaterDepth
+///- Details:   PGN 128267 to DPT, and DBT for the plotters without DPT
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertWaterDepth(const tN2kMsg &p_rMsg)
+{
+    unsigned char l_SID;
+    double l_depth;
+    double l_offset;
+    double l_range;
+    if (!ParseN2kWaterDepth(p_rMsg, l_SID, l_depth, l_offset, l_range))
+    {
+        return;
+    }
+
+    tNMEA0183Msg l_msg;
+    if (IsDue(DPT) && NMEA0183SetDPT(l_msg, l_depth, l_offset, l_range, "II"))
+    {
+        Send(l_msg);
+    }
+    if (IsDue(DBT) && NMEA0183SetDBT(l_msg, l_depth, "II"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertWind
+///- Details:   PGN 130306 to MWV. The ground referenced true wind has no
+///             MWV, it is not converted
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertWind(const tN2kMsg &p_rMsg)
+{
+    tN2kPGN130306Data l_wind;
+    if (!l_wind.Decode(p_rMsg))
+    {
+        return;
+    }
+
+    tNMEA0183WindReference l_0183Reference;
+    switch (l_wind.WindReference)
+    {
+        case N2kWind_Apparent:
+            l_0183Reference = NMEA0183Wind_Apparent;
+            break;
+        case N2kWind_True_boat:
+        case N2kWind_True_water:
+            l_0183Reference = NMEA0183Wind_True;
+            break;
+        default:
+            return;
+    }
+
+    // apparent and true are limited separately
+    tNMEA0183Msg l_msg;
+    if (IsDue(MWV, static_cast<uint8_t>(l_0183Reference))
+        && NMEA0183SetMWV(l_msg, RadToDeg(l_wind.WindAngle), l_0183Reference, l_wind.WindSpeed, "II"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertHeading
+///- Details:   PGN 127250 to HDG for a compass, HDT for a true heading.
+///             The headings and variation are kept for VHW and RMC
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertHeading(const tN2kMsg &p_rMsg)
+{
+    tN2kPGN127250Data l_heading;
+    if (!l_heading.Decode(p_rMsg))
+    {
+        return;
+    }
+    if (!N2kIsNA(l_heading.Variation))
+    {
+        m_variation = l_heading.Variation;
+    }
+
+    tNMEA0183Msg l_msg;
+    if (l_heading.ref == N2khr_magnetic)
+    {
+        m_magneticHeading = l_heading.Heading;
+        if (IsDue(HDG) && NMEA0183SetHDG(l_msg, l_heading.Heading, l_heading.Deviation, l_heading.Variation, "II"))
+        {
+            Send(l_msg);
+        }
+    }
+    else if (l_heading.ref == N2khr_true)
+    {
+        m_trueHeading = l_heading.Heading;
+        if (IsDue(HDT) && NMEA0183SetHDT(l_msg, l_heading.Heading, "II"))
+        {
+            Send(l_msg);
+        }
+    }
+}
+
+/// ConvertRateOfTurn
+///- Details:   PGN 127251 to ROT, which is per minute
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertRateOfTurn(const tN2kMsg &p_rMsg)
+{
+    unsigned char l_SID;
+    double l_rateOfTurn;
+    if (!ParseN2kRateOfTurn(p_rMsg, l_SID, l_rateOfTurn) || N2kIsNA(l_rateOfTurn))
+    {
+        return;
+    }
+
+    tNMEA0183Msg l_msg;
+    if (IsDue(ROT) && NMEA0183SetROT(l_msg, l_rateOfTurn * 60.0, "II"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertBoatSpeed
+///- Details:   PGN 128259 to VHW with the last headings
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertBoatSpeed(const tN2kMsg &p_rMsg)
+{
+    tN2kPGN128259Data l_speed;
+    if (!l_speed.Decode(p_rMsg) || N2kIsNA(l_speed.WaterReferenced))
+    {
+        return;
+    }
+
+    tNMEA0183Msg l_msg;
+    if (IsDue(VHW) && NMEA0183SetVHW(l_msg, m_trueHeading, m_magneticHeading, l_speed.WaterReferenced, "II"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertCOGSOG
+///- Details:   PGN 129026 to VTG. The true COG and SOG are kept for RMC
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertCOGSOG(const tN2kMsg &p_rMsg)
+{
+    tN2kPGN129026Data l_COGSOG;
+    if (!l_COGSOG.Decode(p_rMsg))
+    {
+        return;
+    }
+
+    double l_trueCOG = NMEA0183DoubleNA;
+    double l_magneticCOG = NMEA0183DoubleNA;
+    if (l_COGSOG.ref == N2khr_true)
+    {
+        l_trueCOG = l_COGSOG.COG;
+    }
+    else if (l_COGSOG.ref == N2khr_magnetic)
+    {
+        l_magneticCOG = l_COGSOG.COG;
+        if (!N2kIsNA(l_COGSOG.COG) && !N2kIsNA(m_variation))
+        {
+            l_trueCOG = l_COGSOG.COG + m_variation;
+        }
+    }
+    m_COG = l_trueCOG;
+    m_SOG = l_COGSOG.SOG;
+
+    tNMEA0183Msg l_msg;
+    if (IsDue(VTG) && NMEA0183SetVTG(l_msg, l_trueCOG, l_magneticCOG, l_COGSOG.SOG, "GP"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertGNSS
+///- Details:   PGN 129029 to GGA, and RMC with the last COG and SOG
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertGNSS(const tN2kMsg &p_rMsg)
+{
+    tN2kPGN129029Data l_GNSS;
+    if (!l_GNSS.Decode(p_rMsg))
+    {
+        return;
+    }
+
+    // the GGA quality indicator has the same values as the method up to 8
+    uint32_t l_quality = (l_GNSS.GNSSmethod <= 8) ? static_cast<uint32_t>(l_GNSS.GNSSmethod) : 0;
+    tNMEA0183Msg l_msg;
+    if (IsDue(GGA) && NMEA0183SetGGA(l_msg, l_GNSS.SecondsSinceMidnight, l_GNSS.Latitude, l_GNSS.Longitude,
+                                     l_quality, ToUInt32(l_GNSS.nSatellites), l_GNSS.HDOP, l_GNSS.Altitude,
+                                     l_GNSS.GeoidalSeparation, l_GNSS.AgeOfCorrection,
+                                     (l_GNSS.nReferenceStations > 0) ? ToUInt32(l_GNSS.ReferenceSationID)
+                                                                     : NMEA0183UInt32NA, "GP"))
+    {
+        Send(l_msg);
+    }
+    if (IsDue(RMC) && NMEA0183SetRMC(l_msg, l_GNSS.SecondsSinceMidnight, l_GNSS.Latitude, l_GNSS.Longitude,
+                                     m_COG, m_SOG, ToUInt32(l_GNSS.DaysSince1970), m_variation, "GP"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertEngineRapid
+///- Details:   PGN 127488 to RPM, $IIRPM,E,<engine>,<rpm>,<pitch>,A
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertEngineRapid(const tN2kMsg &p_rMsg)
+{
+    unsigned char l_instance;
+    double l_speed;
+    double l_boost;
+    int8_t l_trim;
+    if (!ParseN2kEngineParamRapid(p_rMsg, l_instance, l_speed, l_boost, l_trim) || N2kIsNA(l_speed))
+    {
+        return;
+    }
+
+    tNMEA0183Msg l_msg;
+    if (IsDue(RPM, l_instance)
+        && l_msg.Init("RPM", "II")
+        && l_msg.AddStrField("E")
+        && l_msg.AddUInt32Field(l_instance)
+        && l_msg.AddDoubleField(l_speed)
+        && l_msg.AddEmptyField()
+        && l_msg.AddStrField("A"))
+    {
+        Send(l_msg);
+    }
+}
+
+/// ConvertEngineDynamic
+///- Details:   PGN 127489 to XDR with the oil pressure (Pa), coolant
+///             temperature (C) and alternator voltage of the engine
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void N2kTo0183::ConvertEngineDynamic(const tN2kMsg &p_rMsg)
+{
+    unsigned char l_instance;
+    double l_oilPressure;
+    double l_oilTemperature;
+    double l_coolantTemperature;
+    double l_alternatorVoltage;
+    double l_fuelRate;
+    double l_engineHours;
+    double l_coolantPressure;
+    double l_fuelPressure;
+    int8_t l_load;
+    int8_t l_torque;
+    tN2kEngineDiscreteStatus1 l_status1;
+    tN2kEngineDiscreteStatus2 l_status2;
+    if (!ParseN2kEngineDynamicParam(p_rMsg, l_instance, l_oilPressure, l_oilTemperature, l_coolantTemperature,
+                                    l_alternatorVoltage, l_fuelRate, l_engineHours, l_coolantPressure,
+                                    l_fuelPressure, l_load, l_torque, l_status1, l_status2))
+    {
+        return;
+    }
+    if (!IsDue(XDR, l_instance))
+    {
+        return;
+    }
+
+    char l_name[16];
+    tNMEA0183Msg l_msg;
+    bool l_built = l_msg.Init("XDR", "II");
+    if (!N2kIsNA(l_oilPressure))
+    {
+        SetName(l_name, "ENGOILP", l_instance);
+        l_built = l_built && l_msg.AddStrField("P") && l_msg.AddDoubleField(l_oilPressure, 1, "%.0f", "P")
+                  && l_msg.AddStrField(l_name);
+    }
+    if (!N2kIsNA(l_coolantTemperature))
+    {
+        SetName(l_name, "ENGTEMP", l_instance);
+        l_built = l_built && l_msg.AddStrField("C") && l_msg.AddDoubleField(KelvinToC(l_coolantTemperature), 1, "%.1f", "C")
+                  && l_msg.AddStrField(l_name);
+    }
+    if (!N2kIsNA(l_alternatorVoltage))
+    {
+        SetName(l_name, "ALTVOLT", l_instance);
+        l_built = l_built && l_msg.AddStrField("U") && l_msg.AddDoubleField(l_alternatorVoltage, 1, "%.2f", "V")
+                  && l_msg.AddStrField(l_name);
+    }
+    if (l_built && l_msg.FieldCount() > 0)
+    {
+        Send(l_msg);
+    }
+}
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : NMEA2000 to NMEA0183 converter header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _N2K_TO_0183_H_INCLUDED_
+#define _N2K_TO_0183_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <memory>
+#include <vector>
+
+// includes
+#include <NMEA2000.h>
+#include <NMEA0183Msg.h>
+#include "Network/INetwork.h"
+
+// forward declarations
+class MetricCounter;
+
+//----------------------------------------------
+// N2kTo0183 converts the NMEA2000 messages received on a bus into
+// NMEA0183 sentences for the plotters that only read 0183, and sends
+// them to each output (TCP clients, UDP).
+//
+//   128267 water depth         DPT, DBT
+//   130306 wind                MWV (apparent and boat referenced true)
+//   127250 heading             HDG (magnetic) or HDT (true)
+//   127251 rate of turn        ROT
+//   128259 boat speed          VHW
+//   129026 COG and SOG         VTG
+//   129029 GNSS position       GGA, RMC
+//   127488 engine rapid        RPM
+//   127489 engine dynamic      XDR
+//
+// The conversion runs on the reactor thread of the bus, each PGN has a
+// handler attached to the bus. A sentence is sent at most once every
+// interval set for it, for each instance (e.g. engine), the rest are
+// dropped. The intervals are at or below the PGN's normal rate so data
+// goes out at the rate it is received unless a bus has several
+// sources for it. Messages from the gateway itself are not converted,
+// they came from NMEA0183.
+//----------------------------------------------
+class N2kTo0183
+{
+public:
+    /// Default Constructor
+    /// Detail- Converter constructor, attaches to the bus. Construct
+    ///         before the reactor of the bus is started
+    /// Returns- n/a
+    /// Throws - n/a
+    explicit N2kTo0183
+    (
+        tNMEA2000& p_rNMEA2000              ///< NMEA2000 object of the bus
+    );
+
+    /// Default Destructor
+    /// Detail- Detaches from the bus. The reactor thread must be stopped
+    /// Returns- n/a
+    /// Throws - n/a
+    ~N2kTo0183();
+
+    /// AddOutput
+    /// Detail- Sentences are sent to every output. Call before the
+    ///         reactor of the bus is started
+    /// Returns- n/a
+    /// Throws - n/a
+    void AddOutput
+    (
+        INetwork* p_pNetwork                ///< network to send the sentences to
+    );
+
+private:
+    //----------------------------------------------
+    // Sentences sent, with an interval for each
+    //----------------------------------------------
+    enum eSentence
+    {
+        DPT, DBT, MWV, HDG, HDT, ROT, VHW, VTG, GGA, RMC, RPM, XDR,
+        SentenceCount
+    };
+
+    //----------------------------------------------
+    // Message handler for one PGN
+    //----------------------------------------------
+    class Handler : public tNMEA2000::tMsgHandler
+    {
+    public:
+        typedef void (N2kTo0183::*Convert)(const tN2kMsg&);
+
+        Handler(N2kTo0183& p_rConverter, unsigned long p_PGN, Convert p_convert, tNMEA2000* p_pNMEA2000)
+        : tNMEA2000::tMsgHandler(p_PGN, p_pNMEA2000), m_rConverter(p_rConverter), m_convert(p_convert) {}
+
+    protected:
+        void HandleMsg(const tN2kMsg& p_rMsg) override;
+
+    private:
+        N2kTo0183& m_rConverter;
+        Convert m_convert;
+    };
+
+    static const int kInstances = 4;        ///< instances limited separately
+
+    // conversions, one for each PGN
+    void ConvertWaterDepth(const tN2kMsg& p_rMsg);
+    void ConvertWind(const tN2kMsg& p_rMsg);
+    void ConvertHeading(const tN2kMsg& p_rMsg);
+    void ConvertRateOfTurn(const tN2kMsg& p_rMsg);
+    void ConvertBoatSpeed(const tN2kMsg& p_rMsg);
+    void ConvertCOGSOG(const tN2kMsg& p_rMsg);
+    void ConvertGNSS(const tN2kMsg& p_rMsg);
+    void ConvertEngineRapid(const tN2kMsg& p_rMsg);
+    void ConvertEngineDynamic(const tN2kMsg& p_rMsg);
+
+    // true if the sentence is due, and marks it sent
+    bool IsDue(eSentence p_sentence, uint8_t p_instance = 0);
+
+    // send a sentence to every output
+    void Send(const tNMEA0183Msg& p_rMsg);
+
+    tNMEA2000& m_rNMEA2000;                             ///!< the bus
+    std::vector<std::unique_ptr<Handler>> m_handlers;   ///!< handler for each PGN
+    std::vector<INetwork*> m_outputs;                   ///!< networks sent to
+    uint32_t m_lastSentMs[SentenceCount][kInstances];   ///!< time each sentence was sent
+
+    // from the other PGNs, for the sentences that carry them
+    double m_trueHeading;                   ///!< rad
+    double m_magneticHeading;               ///!< rad
+    double m_variation;                     ///!< rad
+    double m_COG;                           ///!< true, rad
+    double m_SOG;                           ///!< m/s
+
+    MetricCounter* m_pSent;                 ///!< sentences sent
+    MetricCounter* m_pLimited;              ///!< sentences dropped by the intervals
+};
+
+#endif
@@ -24,6 +24,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #ifndef ARDUINO
 #include <cstdio>
+#include <cstring>
 #endif
 #include "NMEA0183.h"
 
@@ -85,37 +86,113 @@ void tNMEA0183::ParseMessages() {
     kick();
 }
 
+#ifndef ARDUINO
+//*****************************************************************************
+// Position of the first '$' or '!' in data, or 0
+static const uint8_t *FindMsgStart(const uint8_t *data, size_t size) {
+  const uint8_t *start=(const uint8_t *)memchr(data,'$',size);
+  const uint8_t *aisStart=(const uint8_t *)memchr(data,'!',start!=0?(size_t)(start-data):size);
+  return aisStart!=0?aisStart:start;
+}
+
+//*****************************************************************************
+// Frames messages from a span of received bytes with the same rules as
+// reading them a byte at a time. Stops after a valid message, used returns
+// the bytes taken from the span.
+bool tNMEA0183::ParseSpan(const uint8_t *data, size_t size, size_t &used, tNMEA0183Msg &NMEA0183Msg) {
+  size_t pos=0;
+
+  while ( pos<size ) {
+    if ( !MsgInStarted ) { // skip to the message start
+      const uint8_t *start=FindMsgStart(data+pos,size-pos);
+      if ( start==0 ) break;
+      pos=start-data;
+      StartMsg(data[pos]);
+      pos++;
+      continue;
+    }
+
+    // message up to and with the '*', or the two checksum characters
+    size_t len=size-pos;
+    if ( MsgCheckSumStartPos==SIZE_MAX ) {
+      const uint8_t *star=(const uint8_t *)memchr(data+pos,'*',len);
+      if ( star!=0 ) len=star-(data+pos)+1;
+    } else if ( MsgCheckSumStartPos+3-MsgInPos<len ) {
+      len=MsgCheckSumStartPos+3-MsgInPos;
+    }
+
+    // A new start within the part begins the message again
+    const uint8_t *start=FindMsgStart(data+pos,len);
+    if ( start!=0 ) {
+      pos=start-data;
+      ResetMsg();
+      continue;
+    }
+
+    pos+=len;
+    if ( MsgInPos+len>=MAX_NMEA0183_MSG_BUF_LEN ) { // Too may chars in message. Start from beginning
+      ResetMsg();
+      continue;
+    }
+
+    memcpy(MsgInBuf+MsgInPos,data+pos-len,len);
+    MsgInPos+=len;
+    if ( MsgCheckSumStartPos==SIZE_MAX && MsgInBuf[MsgInPos-1]=='*' ) MsgCheckSumStartPos=MsgInPos-1;
+
+    if ( MsgCheckSumStartPos!=SIZE_MAX && MsgCheckSumStartPos+3==MsgInPos ) { // We have full checksum and so full message
+      MsgInBuf[MsgInPos]=0; // add null termination
+      bool result=NMEA0183Msg.SetMessage(MsgInBuf);
+      ResetMsg();
+      if ( result ) {
+        NMEA0183Msg.SourceID=SourceID;
+        used=pos;
+        return true;
+      }
+    }
+  }
+
+  used=size;
+  return false;
+}
+#endif
+
 //*****************************************************************************
 bool tNMEA0183::GetMessage(tNMEA0183Msg &NMEA0183Msg) {
   if ( !IsOpen() ) return false;
 
   bool result=false;
 
+  #ifndef ARDUINO
+  // Streams which can give the received bytes as a span are scanned a
+  // chunk at a time
+  const uint8_t *data;
+  int size;
+  while ( (size=port->readSpan(data))>0 ) {
+    size_t used;
+    result=ParseSpan(data,size,used,NMEA0183Msg);
+    port->consume(used);
+    if ( result ) return true;
+  }
+  if ( size==0 ) return false;
+  #endif
+
   while (port->available() > 0 && !result) {
     int NewByte=port->read();
       if (NewByte=='$' || NewByte=='!') { // Message start
-        MsgInStarted=true;
-        MsgInPos=0;
-        MsgInBuf[MsgInPos]=NewByte;
-        MsgInPos++;
+        StartMsg(NewByte);
       } else if (MsgInStarted) {
         MsgInBuf[MsgInPos]=NewByte;
-        if (NewByte=='*') MsgCheckSumStartPos=MsgInPos;
+        if (NewByte=='*' && MsgCheckSumStartPos==SIZE_MAX) MsgCheckSumStartPos=MsgInPos;
         MsgInPos++;
-        if (MsgCheckSumStartPos!=SIZE_MAX and MsgCheckSumStartPos+3==MsgInPos) { // We have full checksum and so full message
+        if (MsgInPos>=MAX_NMEA0183_MSG_BUF_LEN) { // Too may chars in message. Start from beginning
+          ResetMsg();
+        } else if (MsgCheckSumStartPos!=SIZE_MAX and MsgCheckSumStartPos+3==MsgInPos) { // We have full checksum and so full message
             MsgInBuf[MsgInPos]=0; // add null termination
           if (NMEA0183Msg.SetMessage(MsgInBuf)) {
             NMEA0183Msg.SourceID=SourceID;
             result=true;
           }
-          MsgInStarted=false;
-          MsgInPos=0;
-          MsgCheckSumStartPos=SIZE_MAX;
-        }
-        if (MsgInPos>=MAX_NMEA0183_MSG_BUF_LEN) { // Too may chars in message. Start from beginning
-          MsgInStarted=false;
-          MsgInPos=0;
-          MsgCheckSumStartPos=SIZE_MAX;
+          ResetMsg();
         }
       }
   }
@@ -26,6 +26,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define _tNMEA0183_H_
 
 #include <stdint.h>
+#include <stddef.h>
 #include "NMEA0183Stream.h"
 #include "NMEA0183Msg.h"
 
@@ -52,6 +53,11 @@ class tNMEA0183
       return (MsgOutReadPos<MsgOutWritePos?MsgOutBufSize-(MsgOutWritePos-MsgOutReadPos):MsgOutBufSize+MsgOutReadPos-MsgOutWritePos);
     }
     bool IsOpen() const { return ( port!=0 && MsgOutBuf!=0 ); }
+    void StartMsg(char c) { MsgInStarted=true; MsgInBuf[0]=c; MsgInPos=1; MsgCheckSumStartPos=SIZE_MAX; }
+    void ResetMsg() { MsgInStarted=false; MsgInPos=0; MsgCheckSumStartPos=SIZE_MAX; }
+    #ifndef ARDUINO
+    bool ParseSpan(const uint8_t *data, size_t size, size_t &used, tNMEA0183Msg &NMEA0183Msg);
+    #endif
     bool SendBuf(const char *buf);
     bool CanSendByte();
   public:
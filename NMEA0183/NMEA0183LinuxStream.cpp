@@ -30,25 +30,76 @@ Inherited tNMEA0183Stream object for Linux
 #include <iostream>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <termios.h>
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include "NMEA0183LinuxStream.h"
 
 
 //*****************************************************************************
-tNMEA0183LinuxStream::tNMEA0183LinuxStream(const char *_port) : port(-1) {
+tNMEA0183LinuxStream::tNMEA0183LinuxStream(const char *_port, unsigned long _baud) : port(-1), rxPos(0), rxLen(0) {
   if ( _port!=0 ) {
-    port=open(_port, O_RDWR | O_NOCTTY | O_NDELAY);
+    port=open(_port, O_RDWR | O_NOCTTY | O_NDELAY | O_CLOEXEC);
   }
 
   if ( port!=-1 ) {
+    if ( _baud!=0 && !Configure(_baud) ) {
+      close(port);
+      port=-1;
+    }
 //    cout << _port << " Opened" << endl;
   } else {
 //    if ( _port!=0 ) cout << "Failed to open port " << _port << endl;
   }
 }
 
+//*****************************************************************************
+// Raw 8N1, no flow control, reads return what has arrived without waiting
+bool tNMEA0183LinuxStream::Configure(unsigned long _baud) {
+  speed_t speed;
+  switch (_baud) {
+    case 4800: speed=B4800; break;
+    case 9600: speed=B9600; break;
+    case 19200: speed=B19200; break;
+    case 38400: speed=B38400; break;
+    case 57600: speed=B57600; break;
+    case 115200: speed=B115200; break;
+    default: return false;
+  }
+
+  struct termios tty;
+  if ( tcgetattr(port,&tty)!=0 ) return false;
+
+  cfmakeraw(&tty);
+  tty.c_cflag&=~(CSTOPB | CRTSCTS);
+  tty.c_cflag|=CLOCAL | CREAD;
+  tty.c_iflag&=~(IXON | IXOFF | IXANY);
+  tty.c_cc[VMIN]=0;
+  tty.c_cc[VTIME]=0;
+  cfsetispeed(&tty,speed);
+  cfsetospeed(&tty,speed);
+
+  if ( tcsetattr(port,TCSANOW,&tty)!=0 ) return false;
+  tcflush(port,TCIFLUSH);
+  return true;
+}
+
+//*****************************************************************************
+// Reads what the port has, up to the buffer size. Returns false when
+// there is nothing to read
+bool tNMEA0183LinuxStream::Fill() {
+  ssize_t len;
+  do {
+    len=::read(port,rxBuf,sizeof(rxBuf));
+  } while ( len<0 && errno==EINTR );
+
+  rxPos=0;
+  rxLen=(len>0?len:0);
+  return rxLen>0;
+}
+
 //*****************************************************************************
 tNMEA0183LinuxStream::~tNMEA0183LinuxStream() {
   if ( port!=-1 ) {
@@ -63,9 +114,19 @@ tNMEA0183LinuxStream::~tNMEA0183LinuxStream() {
 *
 *
 **********************************************************************/
+int tNMEA0183LinuxStream::available() {
+  if ( port!=-1 ) {
+    if ( rxPos==rxLen ) Fill();
+    return rxLen-rxPos;
+  }
+  return 1;
+}
+
+//*****************************************************************************
 int tNMEA0183LinuxStream:: read() {
   if ( port!=-1 ) {
-    return -1;
+    if ( rxPos==rxLen && !Fill() ) return -1;
+    return rxBuf[rxPos++];
   } else {
     // Serial stream bridge -- Returns first byte if incoming data, or -1 on no available data.
     struct timeval tv = { 0L, 0L };
@@ -82,6 +143,21 @@ int tNMEA0183LinuxStream:: read() {
 
 
 
+//*****************************************************************************
+int tNMEA0183LinuxStream::readSpan(const uint8_t *&data) {
+  data=0;
+  if ( port==-1 ) return -1;
+
+  if ( rxPos==rxLen && !Fill() ) return 0;
+  data=rxBuf+rxPos;
+  return rxLen-rxPos;
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxStream::consume(size_t size) {
+  rxPos+=(size<rxLen-rxPos?size:rxLen-rxPos);
+}
+
 //*****************************************************************************
 size_t tNMEA0183LinuxStream:: write(const uint8_t* data, size_t size) {                // Serial Stream bridge -- Write data to stream.
   if ( port!=-1 ) {
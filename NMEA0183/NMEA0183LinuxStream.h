@@ -34,10 +34,26 @@ Inherited tNMEA0183Stream object for Linux
 class tNMEA0183LinuxStream : public tNMEA0183Stream {
 protected:
   int port;
+  // Port is read in chunks, so parsing a byte at a time does not
+  // cost a system call per byte
+  uint8_t rxBuf[256];
+  size_t rxPos;
+  size_t rxLen;
+
+  bool Configure(unsigned long _baud);
+  bool Fill();
 public:
-    tNMEA0183LinuxStream(const char *_port=0);
+    // Opens the serial device non blocking. With _baud set the port is
+    // set to raw 8N1 at that speed, 0 leaves the settings as they are.
+    tNMEA0183LinuxStream(const char *_port=0, unsigned long _baud=0);
     virtual ~tNMEA0183LinuxStream();
+    bool IsOpen() const { return port!=-1; }
+    // File descriptor of the port, to wait for data with poll/epoll
+    int GetFd() const { return port; }
+    int available();
     int read();
+    int readSpan(const uint8_t *&data);
+    void consume(size_t size);
     size_t write(const uint8_t* data, size_t size);
 };
 #endif
@@ -403,13 +403,16 @@ bool NMEA0183SetRMC(tNMEA0183Msg &NMEA0183Msg, double GPSTime, double Latitude,
     if ( !NMEA0183Msg.AddStrField("") ) return false;
   }
   
-  if ( !(FAAModeIndicator==0xff || NavStatus==0xff) ) {
-    if ( FAAModeIndicator!=0xff ) {
+  // 0xff is not set. char may be signed, so compare as uint8_t
+  bool HasFAAModeIndicator=( (uint8_t)FAAModeIndicator!=0xff );
+  bool HasNavStatus=( (uint8_t)NavStatus!=0xff );
+  if ( HasFAAModeIndicator || HasNavStatus ) {
+    if ( HasFAAModeIndicator ) {
       if ( !NMEA0183Msg.AddStrField(FAAModeIndicator) ) return false;
     } else {
       if ( !NMEA0183Msg.AddStrField("") ) return false;
     }
-    if ( NavStatus!=0xff ) {
+    if ( HasNavStatus ) {
       if ( !NMEA0183Msg.AddStrField(NavStatus) ) return false;
     }
   }
@@ -137,6 +137,72 @@ bool tNMEA0183Msg::SetMessage(const char *buf) {
   return result;
 }
 
+//*****************************************************************************
+// Writes val in decimal, returns length. Buffer must hold 11 characters.
+static int FormatUInt32(char *buf, uint32_t val) {
+  char digits[10];
+  int n=0;
+  do { digits[n++]='0'+val%10; val/=10; } while ( val!=0 );
+  for (int i=0; i<n; i++) buf[i]=digits[n-1-i];
+  buf[n]=0;
+  return n;
+}
+
+//*****************************************************************************
+// Formats val as snprintf(buf,BufSize,Format,val) does for the %[0][width].[precision]f
+// formats the message builders use, without printf. Returns needed length as snprintf
+// or -1, if format or value is not handled here and snprintf must be used. Close to
+// half way between outputs the scaled double may be on the wrong side, so the exact
+// binary value is compared with fma and exact ties go to even, as snprintf does.
+static int FormatFixed(char *buf, size_t BufSize, double val, const char *Format) {
+  static const double Scale[]={1,10,100,1000,10000,100000,1000000};
+  if ( Format==0 || Format[0]!='%' ) return -1;
+  const char *f=Format+1;
+  bool ZeroPad=(*f=='0');
+  if ( ZeroPad ) f++;
+  int width=0;
+  for (; *f>='0' && *f<='9'; f++) width=width*10+(*f-'0');
+  if ( *f!='.' ) return -1;
+  f++;
+  int precision=0;
+  for (; *f>='0' && *f<='9'; f++) precision=precision*10+(*f-'0');
+  if ( f[0]!='f' || f[1]!=0 || precision>6 || width>20 ) return -1;
+
+  bool Negative=signbit(val);
+  double scaled=fabs(val)*Scale[precision];
+  if ( !(scaled<1e8) ) return -1; // also NaN
+  double whole=floor(scaled);
+  double fraction=scaled-whole;
+  uint32_t n=(uint32_t)whole;
+  if ( fabs(fraction-0.5)<1e-6 ) {
+    double Exact=fma(fabs(val),Scale[precision],-(whole+0.5));
+    if ( Exact>0 || (Exact==0 && (n&1)!=0) ) n++;
+  } else if ( fraction>0.5 ) {
+    n++;
+  }
+
+  char digits[32];
+  int len=0;
+  for (int i=0; i<precision; i++) { digits[len++]='0'+n%10; n/=10; }
+  if ( precision>0 ) digits[len++]='.';
+  do { digits[len++]='0'+n%10; n/=10; } while ( n!=0 );
+  int total=len+(Negative?1:0);
+  int padding=(width>total?width-total:0);
+  total+=padding;
+
+  if ( (size_t)total+1>BufSize ) {
+    if ( BufSize>0 ) buf[0]=0;
+    return total;
+  }
+  char *out=buf;
+  if ( !ZeroPad ) for (; padding>0; padding--) *out++=' ';
+  if ( Negative ) *out++='-';
+  for (; padding>0; padding--) *out++='0';
+  while ( len>0 ) *out++=digits[--len];
+  *out=0;
+  return total;
+}
+
 //*****************************************************************************
 bool tNMEA0183Msg::AddToBuf(const char *data, char * &buf, size_t &BufSize) const {
   size_t len=strlen(data);
@@ -164,7 +230,11 @@ bool tNMEA0183Msg::GetMessage(char *MsgData, size_t BufSize) const {
   }
 
   if ( BufSize<5 ) return false; // Is there room for termination *xx0
-  sprintf(MsgData,"*%02X",GetCheckSum());
+  static const char Hex[]="0123456789ABCDEF";
+  MsgData[0]='*';
+  MsgData[1]=Hex[GetCheckSum()>>4];
+  MsgData[2]=Hex[GetCheckSum()&0x0f];
+  MsgData[3]=0;
   return true;
 }
 
@@ -255,10 +325,14 @@ bool tNMEA0183Msg::AddUInt32Field(uint32_t val) {
 
   cs^=',';
   Fields[_FieldCount]=iAddData;   // Set start of field
-  needSize=snprintf((Data+iAddData),MAX_NMEA0183_MSG_LEN-iAddData,"%lu",(unsigned long)val);
-  ForceNullTermination();
-
-  if ( needSize>MAX_NMEA0183_MSG_LEN-1-iAddData ) return false;
+  if ( MAX_NMEA0183_MSG_LEN-iAddData<11 ) {
+    char StrVal[11];
+    needSize=FormatUInt32(StrVal,val);
+    if ( needSize>MAX_NMEA0183_MSG_LEN-1-iAddData ) return false;
+    strcpy((Data+iAddData),StrVal);
+  } else {
+    needSize=FormatUInt32((Data+iAddData),val);
+  }
 
   for ( int i=iAddData; Data[i]!=0; i++ ) cs^=Data[i];
   iAddData+=needSize+1;
@@ -285,7 +359,8 @@ bool tNMEA0183Msg::AddDoubleField(double val, double multiplier, const char *For
   cs^=',';
   Fields[_FieldCount]=iAddData;   // Set start of field
   #ifndef NO_PRINTF_DOUBLE_SUPPORT
-  needSize=snprintf((Data+iAddData),MAX_NMEA0183_MSG_LEN-iAddData,Format,val*multiplier);
+  needSize=FormatFixed((Data+iAddData),MAX_NMEA0183_MSG_LEN-iAddData,val*multiplier,Format);
+  if ( needSize<0 ) needSize=snprintf((Data+iAddData),MAX_NMEA0183_MSG_LEN-iAddData,Format,val*multiplier);
   ForceNullTermination();
   #else
   char StrVal[20];
@@ -485,16 +560,20 @@ unsigned long tNMEA0183Msg::CalcTimeTDaysTo1970Offset() {
 }
 
 //*****************************************************************************
+// Date is calculated from the days, breakTime would go through the local time zone.
 unsigned long tNMEA0183Msg::DaysToNMEA0183Date(unsigned long val) {
   if ( val!=NMEA0183UInt32NA  ) {
-    tmElements_t tm;
-    #ifndef _Time_h
-    time_t t=daysToTime_t(val);
-    #else
-    time_t t=val*86400;
-    #endif
-    breakTime(t, tm);
-    val=(unsigned long)GetDay(tm)*10000+(unsigned long)GetMonth(tm)*100+((unsigned long)GetYear(tm)-2000);
+    // Days from 1.3.0000, years starting in March put the leap day last
+    unsigned long days=val+719468;
+    unsigned long era=days/146097;
+    unsigned long dayOfEra=days-era*146097;
+    unsigned long yearOfEra=(dayOfEra-dayOfEra/1460+dayOfEra/36524-dayOfEra/146096)/365;
+    unsigned long dayOfYear=dayOfEra-(365*yearOfEra+yearOfEra/4-yearOfEra/100);
+    unsigned long monthIndex=(5*dayOfYear+2)/153;
+    unsigned long day=dayOfYear-(153*monthIndex+2)/5+1;
+    unsigned long month=(monthIndex<10?monthIndex+3:monthIndex-9);
+    unsigned long year=yearOfEra+era*400+(month<=2?1:0);
+    val=day*10000+month*100+year%100;
   }
 
   return val;
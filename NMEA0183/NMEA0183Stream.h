@@ -46,6 +46,14 @@ class tNMEA0183Stream {
    // Returns first byte if incoming data, or -1 on no available data.
    virtual int read() = 0;
 
+   // Chunked read. Points data to the bytes received so far and returns
+   // their count, 0 if there are none. The bytes stay valid until
+   // consume() or read() is called. Returns -1 if the stream only
+   // supports read().
+   virtual int readSpan(const uint8_t *&data) { data=0; return -1; }
+   // Drops size bytes of the span from the stream.
+   virtual void consume(size_t size) { (void)size; }
+
    // Write data to stream.
    virtual size_t write(const uint8_t* data, size_t size) = 0;
    // Write char to stream.
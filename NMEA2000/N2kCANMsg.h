@@ -47,9 +47,6 @@ public:
    */
   tN2kCANMsg()
     : Ready(false),FreeMsg(true),SystemMessage(false), KnownMessage(false) 
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-      ,TPRequireCTS(false), TPMaxPackets(0) 
-#endif
     {
 	  N2kMsg.Clear();
   }
@@ -64,12 +61,6 @@ public:
   bool SystemMessage;
   /** \brief Message is already known   */
   bool KnownMessage;
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-  /** \brief =0 no, n=after each n frames   */
-  unsigned char TPRequireCTS; 
-  /** \brief =0 not TP message. >0 number of packets can be received  */
-  unsigned char TPMaxPackets; 
-#endif
   /** \brief  Last received frame sequence number on fast 
    *          packets or multi packet  */
   unsigned char LastFrame; // 
@@ -85,9 +76,6 @@ public:
    */
   void FreeMessage() { 
     FreeMsg=true; Ready=false; SystemMessage=false; 
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-    TPMaxPackets=0; TPRequireCTS=false; 
-#endif
     N2kMsg.Clear(); N2kMsg.Source=0; 
   }  
 };
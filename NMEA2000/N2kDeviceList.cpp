@@ -42,6 +42,7 @@ tN2kDeviceList::tN2kDeviceList(tNMEA2000 *_pNMEA2000) : tNMEA2000::tMsgHandler(0
   MaxDevices=0;
   ListUpdated=false;
   HasPendingRequests=true;
+  if ( _pNMEA2000!=0 ) RequestTimer.Attach(&_pNMEA2000->GetTimerWheel());
 }
 
 //*****************************************************************************
@@ -159,6 +160,8 @@ void tN2kDeviceList::HandleMsg(const tN2kMsg &N2kMsg) {
     }
     Sources[N2kMsg.Source]->LastMessageTime=N2kMillis();
   }
+
+  if ( HasPendingRequests ) ScheduleRequests();
 }
 
 //*****************************************************************************
@@ -169,12 +172,18 @@ void tN2kDeviceList::HandleOther(const tN2kMsg &N2kMsg) {
 
   if ( !HasPendingRequests ) return;
 
-  HasPendingRequests=false;
-
   // Require name for every device.
   if ( Sources[N2kMsg.Source]->ShouldRequestName() && RequestIsoAddressClaim(N2kMsg.Source) ) {
     Sources[N2kMsg.Source]->SetNameRequested();
-    HasPendingRequests=true;
+  }
+}
+
+//*****************************************************************************
+void tN2kDeviceList::SendPendingRequests() {
+  HasPendingRequests=false;
+
+  for ( int i=0; i<MaxDevices; i++) {
+    if ( Sources[i]!=0 ) HasPendingRequests|=Sources[i]->ShouldRequestName();
   }
 
   // First we try to request product information for all devices
@@ -188,9 +197,8 @@ void tN2kDeviceList::HandleOther(const tN2kMsg &N2kMsg) {
           HasPendingRequests=true;
           return;
         }
-      } else {
-        HasPendingRequests|=Sources[i]->ShouldRequestProductInformation();
       }
+      HasPendingRequests|=Sources[i]->ShouldRequestProductInformation();
     }
   }
   if ( HasPendingRequests ) return;
@@ -206,9 +214,8 @@ void tN2kDeviceList::HandleOther(const tN2kMsg &N2kMsg) {
           HasPendingRequests=true;
           return;
         }
-      } else {
-        HasPendingRequests|=Sources[i]->ShouldRequestConfigurationInformation();
       }
+      HasPendingRequests|=Sources[i]->ShouldRequestConfigurationInformation();
     }
   }
   if ( HasPendingRequests ) return;
@@ -224,11 +231,80 @@ void tN2kDeviceList::HandleOther(const tN2kMsg &N2kMsg) {
           HasPendingRequests=true;
           return;
         }
-      } else {
-        HasPendingRequests|=Sources[i]->ShouldRequestPGNList();
       }
+      HasPendingRequests|=Sources[i]->ShouldRequestPGNList();
+    }
+  }
+}
+
+//*****************************************************************************
+// Time left until Start+Elapsed, 0 if it has passed. Same test as N2kHasElapsed
+static uint32_t N2kTimeLeft(uint32_t Start, uint32_t Elapsed, uint32_t Now) {
+  uint32_t Left=(Start+Elapsed)-Now;
+  return ( Left<INT32_MAX?Left:0 );
+}
+
+//*****************************************************************************
+bool tN2kDeviceList::GetTimeToNextRequest(uint32_t &Time) {
+  uint32_t Now=N2kMillis();
+  bool Found=false;
+
+  // Same order as SendPendingRequests, later requests wait for the earlier ones
+  Time=UINT32_MAX;
+  for ( int i=0; i<MaxDevices; i++) {
+    if ( Sources[i]!=0 && Sources[i]->ShouldRequestProductInformation() ) {
+      uint32_t Left=N2kTimeLeft(Sources[i]->ProdIRequested,N2kDL_TimeBetweenPIRequest,Now);
+      uint32_t First=N2kTimeLeft(Sources[i]->GetCreateTime(),N2kDL_TimeForFirstRequest,Now);
+      if ( First>Left ) Left=First;
+      if ( Left<Time ) Time=Left;
+      Found=true;
+    }
+  }
+  if ( Found ) return true;
+
+  for ( int i=0; i<MaxDevices; i++) {
+    if ( Sources[i]!=0 && Sources[i]->ShouldRequestConfigurationInformation() ) {
+      // ReadyForRequestConfigurationInformation requires more than the time
+      uint32_t Left=N2kTimeLeft(Sources[i]->ConfIRequested,N2kDL_TimeBetweenCIRequest+1,Now);
+      uint32_t First=N2kTimeLeft(Sources[i]->GetCreateTime(),N2kDL_TimeForFirstRequest+1,Now);
+      if ( First>Left ) Left=First;
+      if ( Left<Time ) Time=Left;
+      Found=true;
+    }
+  }
+  if ( Found ) return true;
+
+  for ( int i=0; i<MaxDevices; i++) {
+    if ( Sources[i]!=0 && Sources[i]->ShouldRequestPGNList() ) {
+      uint32_t Left=N2kTimeLeft(Sources[i]->PGNsRequested,N2kDL_TimeBetweenPGNListRequest,Now);
+      uint32_t First=N2kTimeLeft(Sources[i]->GetCreateTime(),N2kDL_TimeForFirstRequest,Now);
+      if ( First>Left ) Left=First;
+      if ( Left<Time ) Time=Left;
+      Found=true;
     }
   }
+  return Found;
+}
+
+//*****************************************************************************
+void tN2kDeviceList::ScheduleRequests() {
+  uint32_t Time;
+
+  if ( RequestTimer.IsEnabled() ) return; // Next round will check the time again
+  if ( GetTimeToNextRequest(Time) ) RequestTimer.FromNow(Time);
+}
+
+//*****************************************************************************
+void tN2kDeviceList::HandleTimers() {
+  uint32_t Time;
+
+  if ( !RequestTimer.IsTime() ) return;
+
+  RequestTimer.Disable();
+  SendPendingRequests();
+  if ( HasPendingRequests && GetTimeToNextRequest(Time) ) {
+    RequestTimer.FromNow(Time>N2kDL_TimeBetweenRequests?Time:N2kDL_TimeBetweenRequests);
+  }
 }
 
 //*****************************************************************************
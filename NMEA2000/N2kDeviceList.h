@@ -47,6 +47,13 @@
 /** \brief  Time in ms between configuration information requests */
 #define N2kDL_TimeBetweenCIRequest 1000 
 
+/** \brief  Time in ms between supported PGN list requests */
+#define N2kDL_TimeBetweenPGNListRequest 1000
+
+/** \brief  Minimum time in ms between two request rounds, so that
+ * requests to several devices are not sent as a burst */
+#define N2kDL_TimeBetweenRequests 50
+
 /************************************************************************//**
  * \class   tN2kDeviceList
  * \brief   Helper class to keep track of all devices on the bus
@@ -435,7 +442,7 @@ class tN2kDeviceList : public tNMEA2000::tMsgHandler {
          * \return true 
          * \return false 
          */
-        bool ReadyForRequestPGNList() { return ( ShouldRequestPGNList() && N2kHasElapsed(PGNsRequested,1000) && N2kHasElapsed(GetCreateTime(),N2kDL_TimeForFirstRequest) ); }
+        bool ReadyForRequestPGNList() { return ( ShouldRequestPGNList() && N2kHasElapsed(PGNsRequested,N2kDL_TimeBetweenPGNListRequest) && N2kHasElapsed(GetCreateTime(),N2kDL_TimeForFirstRequest) ); }
     }; // tInternalDevice
 
   protected:
@@ -449,6 +456,8 @@ class tN2kDeviceList : public tNMEA2000::tMsgHandler {
     bool ListUpdated;
     /** \brief There are still requests pending*/
     bool HasPendingRequests;
+    /** \brief Next request round, on the timer wheel of the tNMEA2000 object*/
+    tN2kWheelScheduler RequestTimer;
 
   protected:
     /********************************************************************//**
@@ -507,12 +516,33 @@ class tN2kDeviceList : public tNMEA2000::tMsgHandler {
      * \brief Handles all Other messages
      * 
      * If request is pending ( \ref HasPendingRequests == true) it requires
-     * a name for every device, then loads product + config informations 
-     * and supported PGN lists as needed.
+     * a name for the device sending the message. Other requests are sent
+     * by \ref SendPendingRequests on \ref RequestTimer.
      *
      * \param N2kMsg    Reference to a N2kMsg Object, 
      */
     void HandleOther(const tN2kMsg &N2kMsg);
+    /********************************************************************//**
+     * \brief Send next pending request
+     *
+     * Loads product + config informations and supported PGN lists as
+     * needed, one request for each round. Called when \ref RequestTimer
+     * expires.
+     */
+    void SendPendingRequests();
+    /********************************************************************//**
+     * \brief Time to the next request any device is ready for
+     *
+     * \param Time   Time in ms from now
+     * \return true  -> there is a product information, configuration
+     *                 information or PGN list request to be sent
+     */
+    bool GetTimeToNextRequest(uint32_t &Time);
+    /********************************************************************//**
+     * \brief Schedule \ref RequestTimer for the next request, if it is not
+     *        already scheduled
+     */
+    void ScheduleRequests();
     /********************************************************************//**
      * \brief Find a device in \ref Sources by the source address
      *
@@ -627,6 +657,13 @@ class tN2kDeviceList : public tNMEA2000::tMsgHandler {
      * \param N2kMsg    Reference to a N2kMsg Object, 
      */
     void HandleMsg(const tN2kMsg &N2kMsg);
+    /********************************************************************//**
+     * \brief Handle expired timers
+     *
+     * Sends the next pending request, when \ref RequestTimer has expired,
+     * and schedules the timer for the request after it.
+     */
+    void HandleTimers();
 
     // 
     /********************************************************************//**
@@ -21,6 +21,7 @@ CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFT
 OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 #include "N2kMessages.h"
+#include "N2kMessagesLayout.h"
 #include <string.h>
 
 //*****************************************************************************
@@ -279,27 +280,11 @@ bool ParseN2kPGN127245(const tN2kMsg &N2kMsg, double &RudderPosition, unsigned c
 // Vessel Heading
 // Angles should be in radians
 void SetN2kPGN127250(tN2kMsg &N2kMsg, unsigned char SID, double Heading, double Deviation, double Variation, tN2kHeadingReference ref) {
-    N2kMsg.SetPGN(127250L);
-    N2kMsg.Priority=2;
-    N2kMsg.AddByte(SID);
-    N2kMsg.Add2ByteUDouble(Heading,0.0001);
-    N2kMsg.Add2ByteDouble(Deviation,0.0001);
-    N2kMsg.Add2ByteDouble(Variation,0.0001);
-    N2kMsg.AddByte(0xfc | ref);
+    tN2kPGN127250Layout::Encode(N2kMsg,SID,Heading,Deviation,Variation,ref);
 }
 
 bool ParseN2kPGN127250(const tN2kMsg &N2kMsg, unsigned char &SID, double &Heading, double &Deviation, double &Variation, tN2kHeadingReference &ref) {
-  if (N2kMsg.PGN!=127250L) return false;
-
-  int Index=0;
-
-  SID=N2kMsg.GetByte(Index);
-  Heading=N2kMsg.Get2ByteUDouble(0.0001,Index);
-  Deviation=N2kMsg.Get2ByteDouble(0.0001,Index);
-  Variation=N2kMsg.Get2ByteDouble(0.0001,Index);
-  ref=(tN2kHeadingReference)(N2kMsg.GetByte(Index)&0x03);
-
-  return true;
+  return tN2kPGN127250Layout::Decode(N2kMsg,SID,Heading,Deviation,Variation,ref);
 }
 
 //*****************************************************************************
@@ -923,27 +908,11 @@ bool ParseN2kPGN128000(const tN2kMsg &N2kMsg, unsigned char &SID, double &Leeway
 //*****************************************************************************
 // Boat speed
 void SetN2kPGN128259(tN2kMsg &N2kMsg, unsigned char SID, double WaterReferenced, double GroundReferenced, tN2kSpeedWaterReferenceType SWRT) {
-    N2kMsg.SetPGN(128259L);
-    N2kMsg.Priority=2;
-    N2kMsg.AddByte(SID);
-    N2kMsg.Add2ByteUDouble(WaterReferenced,0.01);
-    N2kMsg.Add2ByteUDouble(GroundReferenced,0.01);
-    N2kMsg.AddByte(SWRT);
-    N2kMsg.AddByte(0xff); // Reserved
-    N2kMsg.AddByte(0xff); // Reserved
+    tN2kPGN128259Layout::Encode(N2kMsg,SID,WaterReferenced,GroundReferenced,SWRT);
 }
 
 bool ParseN2kPGN128259(const tN2kMsg &N2kMsg, unsigned char &SID, double &WaterReferenced, double &GroundReferenced, tN2kSpeedWaterReferenceType &SWRT) {
-  if (N2kMsg.PGN!=128259L) return false;
-
-  int Index=0;
-
-  SID=N2kMsg.GetByte(Index);
-  WaterReferenced=N2kMsg.Get2ByteUDouble(0.01,Index);
-  GroundReferenced=N2kMsg.Get2ByteUDouble(0.01,Index);
-  SWRT=(tN2kSpeedWaterReferenceType)(N2kMsg.GetByte(Index)&0x0F);
-
-  return true;
+  return tN2kPGN128259Layout::Decode(N2kMsg,SID,WaterReferenced,GroundReferenced,SWRT);
 }
 
 //*****************************************************************************
@@ -1158,46 +1127,22 @@ bool ParseN2kPGN128778(
 //*****************************************************************************
 // Lat long rapid
 void SetN2kPGN129025(tN2kMsg &N2kMsg, double Latitude, double Longitude) {
-    N2kMsg.SetPGN(129025L);
-    N2kMsg.Priority=2;
-    N2kMsg.Add4ByteDouble(Latitude,1e-7);
-    N2kMsg.Add4ByteDouble(Longitude,1e-7);
+    tN2kPGN129025Layout::Encode(N2kMsg,Latitude,Longitude);
 }
 
 bool ParseN2kPGN129025(const tN2kMsg &N2kMsg, double &Latitude, double &Longitude) {
-	if (N2kMsg.PGN!=129025L) return false;
-
-	int Index = 0;
-	Latitude=N2kMsg.Get4ByteDouble(1e-7, Index);
-	Longitude=N2kMsg.Get4ByteDouble(1e-7, Index);
-	return true;
+	return tN2kPGN129025Layout::Decode(N2kMsg,Latitude,Longitude);
 }
 //*****************************************************************************
 // COG SOG rapid
 // COG should be in radians
 // SOG should be in m/s
 void SetN2kPGN129026(tN2kMsg &N2kMsg, unsigned char SID, tN2kHeadingReference ref, double COG, double SOG) {
-    N2kMsg.SetPGN(129026L);
-    N2kMsg.Priority=2;
-    N2kMsg.AddByte(SID);
-    N2kMsg.AddByte( (((unsigned char)(ref)) & 0x03) | 0xfc );
-    N2kMsg.Add2ByteUDouble(COG,0.0001); //0.0057295779513082332);
-    N2kMsg.Add2ByteUDouble(SOG,0.01);
-    N2kMsg.AddByte(0xff); // Reserved
-    N2kMsg.AddByte(0xff); // Reserved
+    tN2kPGN129026Layout::Encode(N2kMsg,SID,ref,COG,SOG);
 }
 
 bool ParseN2kPGN129026(const tN2kMsg &N2kMsg, unsigned char &SID, tN2kHeadingReference &ref, double &COG, double &SOG) {
-  if (N2kMsg.PGN!=129026L) return false;
-  int Index=0;
-  unsigned char b;
-
-  SID=N2kMsg.GetByte(Index);
-  b=N2kMsg.GetByte(Index); ref=(tN2kHeadingReference)( b & 0x03 );
-  COG=N2kMsg.Get2ByteUDouble(0.0001,Index);
-  SOG=N2kMsg.Get2ByteUDouble(0.01,Index);
-
-  return true;
+  return tN2kPGN129026Layout::Decode(N2kMsg,SID,ref,COG,SOG);
 }
 
 //*****************************************************************************
@@ -1211,20 +1156,10 @@ void SetN2kPGN129029(tN2kMsg &N2kMsg, unsigned char SID, uint16_t DaysSince1970,
                      ) {
 
 
-    N2kMsg.SetPGN(129029L);
-    N2kMsg.Priority=3;
-    N2kMsg.AddByte(SID);
-    N2kMsg.Add2ByteUInt(DaysSince1970);
-    N2kMsg.Add4ByteUDouble(SecondsSinceMidnight,0.0001);
-    N2kMsg.Add8ByteDouble(Latitude,1e-16);
-    N2kMsg.Add8ByteDouble(Longitude,1e-16);
-    N2kMsg.Add8ByteDouble(Altitude,1e-6);
-    N2kMsg.AddByte( (((unsigned char) GNSStype) & 0x0f) | (((unsigned char) GNSSmethod) & 0x0f)<<4 );
-    N2kMsg.AddByte(1 | 0xfc);  // Integrity 2 bit, reserved 6 bits
-    N2kMsg.AddByte(nSatellites);
-    N2kMsg.Add2ByteDouble(HDOP,0.01);
-    N2kMsg.Add2ByteDouble(PDOP,0.01);
-    N2kMsg.Add4ByteDouble(GeoidalSeparation,0.01);
+    tN2kPGN129029Layout::Encode(N2kMsg,SID,DaysSince1970,SecondsSinceMidnight,
+                                Latitude,Longitude,Altitude,
+                                GNSStype,GNSSmethod,
+                                nSatellites,HDOP,PDOP,GeoidalSeparation);
     if (nReferenceStations!=0xff && nReferenceStations>0) {
       N2kMsg.AddByte(1); // Note that we have values for only one reference station, so pass only one values.
       N2kMsg.Add2ByteInt( (((int)ReferenceStationType) & 0x0f) | ReferenceSationID<<4 );
@@ -1239,23 +1174,13 @@ bool ParseN2kPGN129029(const tN2kMsg &N2kMsg, unsigned char &SID, uint16_t &Days
                      uint8_t &nReferenceStations, tN2kGNSStype &ReferenceStationType, uint16_t &ReferenceSationID,
                      double &AgeOfCorrection
                      ) {
-  if (N2kMsg.PGN!=129029L) return false;
-  int Index=0;
-  unsigned char vb;
+  if ( !tN2kPGN129029Layout::Decode(N2kMsg,SID,DaysSince1970,SecondsSinceMidnight,
+                                    Latitude,Longitude,Altitude,
+                                    GNSStype,GNSSmethod,
+                                    nSatellites,HDOP,PDOP,GeoidalSeparation) ) return false;
+  int Index=tN2kPGN129029Layout::Length;
   int16_t vi;
 
-  SID=N2kMsg.GetByte(Index);
-  DaysSince1970=N2kMsg.Get2ByteUInt(Index);
-  SecondsSinceMidnight=N2kMsg.Get4ByteUDouble(0.0001,Index);
-  Latitude=N2kMsg.Get8ByteDouble(1e-16,Index);
-  Longitude=N2kMsg.Get8ByteDouble(1e-16,Index);
-  Altitude=N2kMsg.Get8ByteDouble(1e-6,Index);
-  vb=N2kMsg.GetByte(Index); GNSStype=(tN2kGNSStype)(vb & 0x0f); GNSSmethod=(tN2kGNSSmethod)((vb>>4) & 0x0f);
-  vb=N2kMsg.GetByte(Index);  // Integrity 2 bit, reserved 6 bits
-  nSatellites=N2kMsg.GetByte(Index);
-  HDOP=N2kMsg.Get2ByteDouble(0.01,Index);
-  PDOP=N2kMsg.Get2ByteDouble(0.01,Index);
-  GeoidalSeparation=N2kMsg.Get4ByteDouble(0.01,Index);
   nReferenceStations=N2kMsg.GetByte(Index);
   if (nReferenceStations!=N2kUInt8NA && nReferenceStations>0) {
     // Note that we return real number of stations, but we only have variabes for one.
@@ -1875,25 +1800,11 @@ bool AppendN2kPGN130074(tN2kMsg &N2kMsg, uint16_t ID, char* Name, double Latitud
 //*****************************************************************************
 // Wind Speed
 void SetN2kPGN130306(tN2kMsg &N2kMsg, unsigned char SID, double WindSpeed, double WindAngle, tN2kWindReference WindReference) {
-    N2kMsg.SetPGN(130306L);
-    N2kMsg.Priority=2;
-    N2kMsg.AddByte(SID);
-    N2kMsg.Add2ByteUDouble(WindSpeed,0.01);
-    N2kMsg.Add2ByteUDouble(WindAngle,0.0001);
-    N2kMsg.AddByte((unsigned char)WindReference);
-    N2kMsg.AddByte(0xff); // Reserved
-    N2kMsg.AddByte(0xff); // Reserved
+    tN2kPGN130306Layout::Encode(N2kMsg,SID,WindSpeed,WindAngle,WindReference);
 }
 
 bool ParseN2kPGN130306(const tN2kMsg &N2kMsg, unsigned char &SID, double &WindSpeed, double &WindAngle, tN2kWindReference &WindReference) {
-  if (N2kMsg.PGN!=130306L) return false;
-  int Index=0;
-  SID=N2kMsg.GetByte(Index);
-  WindSpeed=N2kMsg.Get2ByteUDouble(0.01,Index);
-  WindAngle=N2kMsg.Get2ByteUDouble(0.0001,Index);
-  WindReference=(tN2kWindReference)(N2kMsg.GetByte(Index)&0x07);
-
-  return true;
+  return tN2kPGN130306Layout::Decode(N2kMsg,SID,WindSpeed,WindAngle,WindReference);
 }
 
 //*****************************************************************************
@@ -0,0 +1,243 @@
+/*
+ * N2kMessagesLayout.h
+ *
+ * Copyright (c) 2026 Chelton Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/*************************************************************************//**
+ * \file  N2kMessagesLayout.h
+ * \brief Field layouts for high rate PGNs
+ *
+ * These layouts are used by the corresponding SetN2kPGNxxx and
+ * ParseN2kPGNxxx functions in N2kMessages.cpp. Field order on each layout
+ * is the same as parameter order on the SetN2kPGNxxx function.
+ *
+ * Each layout has also a POD data struct for structured decoding, e.g.
+ * \code
+ * tN2kPGN129026Data COGSOG;
+ * if ( COGSOG.Decode(N2kMsg) ) { ... }
+ * \endcode
+ *
+ * See \ref N2kMsgLayout.h
+ */
+
+#ifndef _N2kMessagesLayout_H_
+#define _N2kMessagesLayout_H_
+
+#include "N2kMsgLayout.h"
+#include "N2kMessages.h"
+
+/************************************************************************//**
+ * \brief PGN 127250 Vessel Heading
+ *
+ * SID, Heading, Deviation, Variation, ref
+ */
+typedef tN2kMsgLayout<127250L,2,8,
+          tN2kByteField<0>,
+          tN2kDoubleField<1,2,false,tN2kResolution<10000> >,
+          tN2kDoubleField<3,2,true,tN2kResolution<10000> >,
+          tN2kDoubleField<5,2,true,tN2kResolution<10000> >,
+          tN2kBitField<7,0,0x03>
+        > tN2kPGN127250Layout;
+
+/************************************************************************//**
+ * \brief PGN 127250 data for structured decoding
+ */
+struct tN2kPGN127250Data {
+  typedef tN2kPGN127250Layout tLayout;
+  unsigned char SID;
+  double Heading;
+  double Deviation;
+  double Variation;
+  tN2kHeadingReference ref;
+
+  bool Decode(const tN2kMsg &N2kMsg) { return tLayout::Decode(N2kMsg,SID,Heading,Deviation,Variation,ref); }
+  void Encode(tN2kMsg &N2kMsg) const { tLayout::Encode(N2kMsg,SID,Heading,Deviation,Variation,ref); }
+};
+
+/************************************************************************//**
+ * \brief PGN 128259 Boat speed
+ *
+ * SID, WaterReferenced, GroundReferenced, SWRT
+ */
+typedef tN2kMsgLayout<128259L,2,8,
+          tN2kByteField<0>,
+          tN2kDoubleField<1,2,false,tN2kResolution<100> >,
+          tN2kDoubleField<3,2,false,tN2kResolution<100> >,
+          tN2kByteField<5,0x0f>
+        > tN2kPGN128259Layout;
+
+/************************************************************************//**
+ * \brief PGN 128259 data for structured decoding
+ */
+struct tN2kPGN128259Data {
+  typedef tN2kPGN128259Layout tLayout;
+  unsigned char SID;
+  double WaterReferenced;
+  double GroundReferenced;
+  tN2kSpeedWaterReferenceType SWRT;
+
+  bool Decode(const tN2kMsg &N2kMsg) { return tLayout::Decode(N2kMsg,SID,WaterReferenced,GroundReferenced,SWRT); }
+  void Encode(tN2kMsg &N2kMsg) const { tLayout::Encode(N2kMsg,SID,WaterReferenced,GroundReferenced,SWRT); }
+};
+
+/************************************************************************//**
+ * \brief PGN 129025 Lat long rapid
+ *
+ * Latitude, Longitude
+ */
+typedef tN2kMsgLayout<129025L,2,8,
+          tN2kDoubleField<0,4,true,tN2kResolution<10000000> >,
+          tN2kDoubleField<4,4,true,tN2kResolution<10000000> >
+        > tN2kPGN129025Layout;
+
+/************************************************************************//**
+ * \brief PGN 129025 data for structured decoding
+ */
+struct tN2kPGN129025Data {
+  typedef tN2kPGN129025Layout tLayout;
+  double Latitude;
+  double Longitude;
+
+  bool Decode(const tN2kMsg &N2kMsg) { return tLayout::Decode(N2kMsg,Latitude,Longitude); }
+  void Encode(tN2kMsg &N2kMsg) const { tLayout::Encode(N2kMsg,Latitude,Longitude); }
+};
+
+/************************************************************************//**
+ * \brief PGN 129026 COG SOG rapid
+ *
+ * SID, ref, COG, SOG
+ */
+typedef tN2kMsgLayout<129026L,2,8,
+          tN2kByteField<0>,
+          tN2kBitField<1,0,0x03>,
+          tN2kDoubleField<2,2,false,tN2kResolution<10000> >,
+          tN2kDoubleField<4,2,false,tN2kResolution<100> >
+        > tN2kPGN129026Layout;
+
+/************************************************************************//**
+ * \brief PGN 129026 data for structured decoding
+ */
+struct tN2kPGN129026Data {
+  typedef tN2kPGN129026Layout tLayout;
+  unsigned char SID;
+  tN2kHeadingReference ref;
+  double COG;
+  double SOG;
+
+  bool Decode(const tN2kMsg &N2kMsg) { return tLayout::Decode(N2kMsg,SID,ref,COG,SOG); }
+  void Encode(tN2kMsg &N2kMsg) const { tLayout::Encode(N2kMsg,SID,ref,COG,SOG); }
+};
+
+/************************************************************************//**
+ * \brief PGN 129029 GNSS Position Data, fixed part
+ *
+ * SID, DaysSince1970, SecondsSinceMidnight, Latitude, Longitude, Altitude,
+ * GNSStype, GNSSmethod, nSatellites, HDOP, PDOP, GeoidalSeparation
+ *
+ * Integrity byte is constant. Reference station part starting from
+ * byte 42 is variable length and is handled by SetN2kPGN129029.
+ */
+typedef tN2kMsgLayout<129029L,3,42,
+          tN2kByteField<0>,
+          tN2kUInt16Field<1>,
+          tN2kDoubleField<3,4,false,tN2kResolution<10000> >,
+          tN2kDoubleField<7,8,true,tN2kResolution<10000000000000000ULL> >,
+          tN2kDoubleField<15,8,true,tN2kResolution<10000000000000000ULL> >,
+          tN2kDoubleField<23,8,true,tN2kResolution<1000000> >,
+          tN2kBitField<31,0,0x0f>,
+          tN2kBitField<31,4,0x0f>,
+          tN2kConstField<32,1 | 0xfc>,
+          tN2kByteField<33>,
+          tN2kDoubleField<34,2,true,tN2kResolution<100> >,
+          tN2kDoubleField<36,2,true,tN2kResolution<100> >,
+          tN2kDoubleField<38,4,true,tN2kResolution<100> >
+        > tN2kPGN129029Layout;
+
+/************************************************************************//**
+ * \brief PGN 129029 data for structured decoding
+ *
+ * Fixed part is decoded with the layout. Reference station part is handled
+ * by ParseN2kPGN129029 / SetN2kPGN129029.
+ */
+struct tN2kPGN129029Data {
+  typedef tN2kPGN129029Layout tLayout;
+  unsigned char SID;
+  uint16_t DaysSince1970;
+  double SecondsSinceMidnight;
+  double Latitude;
+  double Longitude;
+  double Altitude;
+  tN2kGNSStype GNSStype;
+  tN2kGNSSmethod GNSSmethod;
+  uint8_t nSatellites;
+  double HDOP;
+  double PDOP;
+  double GeoidalSeparation;
+  uint8_t nReferenceStations;
+  tN2kGNSStype ReferenceStationType;
+  uint16_t ReferenceSationID;
+  double AgeOfCorrection;
+
+  bool Decode(const tN2kMsg &N2kMsg) {
+    return ParseN2kPGN129029(N2kMsg,SID,DaysSince1970,SecondsSinceMidnight,
+                             Latitude,Longitude,Altitude,
+                             GNSStype,GNSSmethod,
+                             nSatellites,HDOP,PDOP,GeoidalSeparation,
+                             nReferenceStations,ReferenceStationType,ReferenceSationID,
+                             AgeOfCorrection);
+  }
+  void Encode(tN2kMsg &N2kMsg) const {
+    SetN2kPGN129029(N2kMsg,SID,DaysSince1970,SecondsSinceMidnight,
+                    Latitude,Longitude,Altitude,
+                    GNSStype,GNSSmethod,
+                    nSatellites,HDOP,PDOP,GeoidalSeparation,
+                    nReferenceStations,ReferenceStationType,ReferenceSationID,
+                    AgeOfCorrection);
+  }
+};
+
+/************************************************************************//**
+ * \brief PGN 130306 Wind Speed
+ *
+ * SID, WindSpeed, WindAngle, WindReference
+ */
+typedef tN2kMsgLayout<130306L,2,8,
+          tN2kByteField<0>,
+          tN2kDoubleField<1,2,false,tN2kResolution<100> >,
+          tN2kDoubleField<3,2,false,tN2kResolution<10000> >,
+          tN2kByteField<5,0x07>
+        > tN2kPGN130306Layout;
+
+/************************************************************************//**
+ * \brief PGN 130306 data for structured decoding
+ */
+struct tN2kPGN130306Data {
+  typedef tN2kPGN130306Layout tLayout;
+  unsigned char SID;
+  double WindSpeed;
+  double WindAngle;
+  tN2kWindReference WindReference;
+
+  bool Decode(const tN2kMsg &N2kMsg) { return tLayout::Decode(N2kMsg,SID,WindSpeed,WindAngle,WindReference); }
+  void Encode(tN2kMsg &N2kMsg) const { tLayout::Encode(N2kMsg,SID,WindSpeed,WindAngle,WindReference); }
+};
+
+#endif
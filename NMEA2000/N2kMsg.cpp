@@ -95,6 +95,7 @@ void tN2kMsg::Clear() {
   PGN=0;
   DataLen=0;
   MsgTime=0;
+  MsgTimeUs=0;
 }
 
 //*****************************************************************************
@@ -725,6 +725,10 @@ public:
   unsigned char Data[MaxDataLen];
   /** \brief timestamp (ms since start [max 49days]) of the NMEA2000 message*/
   unsigned long MsgTime;
+  /** \brief Receive timestamp (us since the Unix epoch) of the frame which
+   *         completed the message, taken by the CAN driver. 0 if the driver
+   *         does not provide timestamps or message was created locally.*/
+  uint64_t MsgTimeUs;
 protected:
   /** \brief Fills the whole data buffer with 0xff*/
   void ResetData();
@@ -797,7 +801,8 @@ public:
 
   /************************************************************************//**
    * \brief Clears the content of the N2kMsg object
-   * The method sets the \ref PGN, \ref DataLen and \ref MsgTime to zero.
+   * The method sets the \ref PGN, \ref DataLen, \ref MsgTime and
+   * \ref MsgTimeUs to zero.
    */
   virtual void Clear();
 
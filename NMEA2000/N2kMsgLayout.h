@@ -0,0 +1,518 @@
+/*
+ * N2kMsgLayout.h
+ *
+ * Copyright (c) 2026 Chelton Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/*************************************************************************//**
+ * \file  N2kMsgLayout.h
+ * \brief Compile time field layout description for fixed length PGNs.
+ *
+ * Normal SetN2kPGNxxx functions build the message field by field with
+ * tN2kMsg::Add2ByteUDouble and similar. Each call goes through a non inline
+ * function, re-checks NA, divides by a run time precision and moves the
+ * DataLen index.
+ *
+ * With the templates on this file a PGN can be described once as a list of
+ * fields with fixed offsets and resolutions. \ref tN2kMsgLayout then
+ * generates fused encode and decode routines, where offsets and scale
+ * factors are compile time constants, so the compiler produces straight
+ * line stores for the whole message.
+ *
+ * Encoding is byte-identical to the tN2kMsg::AddXXX functions: same NA
+ * values, same rounding and same out of range values.
+ *
+ * Example:
+ * \code
+ * typedef tN2kMsgLayout<128259L,2,8,
+ *           tN2kByteField<0>,                               // SID
+ *           tN2kDoubleField<1,2,false,tN2kResolution<100> >, // Water referenced
+ *           tN2kDoubleField<3,2,false,tN2kResolution<100> >, // Ground referenced
+ *           tN2kByteField<5,0x0f>                           // SWRT
+ *         > tN2kPGN128259Layout;
+ *
+ * tN2kPGN128259Layout::Encode(N2kMsg,SID,WaterReferenced,GroundReferenced,SWRT);
+ * \endcode
+ *
+ * Bytes not covered by any field are filled with 0xff (reserved).
+ *
+ * For structured decoding each layout may have a POD data struct with
+ * Decode and Encode members, see N2kMessagesLayout.h. With that
+ * \ref N2kDecodeMessages decodes a whole log buffer of one PGN to an array
+ * of structs.
+ */
+
+#ifndef _N2kMsgLayout_H_
+#define _N2kMsgLayout_H_
+
+#include "N2kMsg.h"
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+/************************************************************************//**
+ * \brief Compile time field resolution Num/Den
+ *
+ * Resolution is expressed as a ratio, because C++14 does not allow double
+ * template parameters. Since IEEE division is correctly rounded,
+ * tN2kResolution<10000>::Value() is exactly the same double as literal
+ * 0.0001 used on tN2kMsg::Add2ByteUDouble calls.
+ *
+ * \tparam Den  Denominator
+ * \tparam Num  Numerator
+ */
+template<unsigned long long Den, unsigned long long Num=1>
+struct tN2kResolution {
+  static constexpr double Value() { return (double)Num/(double)Den; }
+};
+
+/************************************************************************//**
+ * \brief Rounding as done in N2kMsg.cpp
+ *
+ * Compiler builtin round() may differ from the one N2kMsg.cpp uses, so
+ * same formula is repeated here to keep encoding identical.
+ */
+inline double N2kLayoutRound(double val) {
+  return val >= 0
+      ? floor(val + 0.5)
+      : ceil(val - 0.5);
+}
+
+/************************************************************************//**
+ * \brief Little endian store and load helpers
+ *
+ * Byte wise shifts are endian independent and compilers merge them to
+ * single unaligned store/load on platforms which allow that.
+ */
+inline void N2kLayoutStore(unsigned char *p, uint8_t v) { p[0]=v; }
+inline void N2kLayoutStore(unsigned char *p, uint16_t v) { p[0]=(unsigned char)v; p[1]=(unsigned char)(v>>8); }
+inline void N2kLayoutStore24(unsigned char *p, uint32_t v) { p[0]=(unsigned char)v; p[1]=(unsigned char)(v>>8); p[2]=(unsigned char)(v>>16); }
+inline void N2kLayoutStore(unsigned char *p, uint32_t v) { N2kLayoutStore24(p,v); p[3]=(unsigned char)(v>>24); }
+inline void N2kLayoutStore(unsigned char *p, uint64_t v) { N2kLayoutStore(p,(uint32_t)v); N2kLayoutStore(p+4,(uint32_t)(v>>32)); }
+
+inline uint16_t N2kLayoutLoad16(const unsigned char *p) { return (uint16_t)(p[0] | (p[1]<<8)); }
+inline uint32_t N2kLayoutLoad24(const unsigned char *p) { return (uint32_t)p[0] | ((uint32_t)p[1]<<8) | ((uint32_t)p[2]<<16); }
+inline uint32_t N2kLayoutLoad32(const unsigned char *p) { return N2kLayoutLoad24(p) | ((uint32_t)p[3]<<24); }
+inline uint64_t N2kLayoutLoad64(const unsigned char *p) { return (uint64_t)N2kLayoutLoad32(p) | ((uint64_t)N2kLayoutLoad32(p+4)<<32); }
+
+/************************************************************************//**
+ * \brief Raw value properties for scaled fields
+ *
+ * Values must match N2kMsg.cpp SetBufXByteDouble/GetBufXByteDouble.
+ *
+ * \tparam Bytes  Field size in bytes
+ * \tparam Signed Field is signed
+ */
+template<int Bytes, bool Signed> struct tN2kRawTraits;
+
+template<> struct tN2kRawTraits<1,true> {
+  typedef int8_t tRaw;
+  static constexpr double Min() { return -128; }
+  static constexpr tRaw OR() { return 0x7e; }
+  static constexpr tRaw NA() { return 0x7f; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore(p,(uint8_t)v); }
+  static inline tRaw Load(const unsigned char *p) { return (tRaw)p[0]; }
+};
+
+template<> struct tN2kRawTraits<1,false> {
+  typedef uint8_t tRaw;
+  static constexpr double Min() { return 0; }
+  static constexpr tRaw OR() { return 0xfe; }
+  static constexpr tRaw NA() { return 0xff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore(p,v); }
+  static inline tRaw Load(const unsigned char *p) { return p[0]; }
+};
+
+template<> struct tN2kRawTraits<2,true> {
+  typedef int16_t tRaw;
+  static constexpr double Min() { return -32768; }
+  static constexpr tRaw OR() { return 0x7ffe; }
+  static constexpr tRaw NA() { return 0x7fff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore(p,(uint16_t)v); }
+  static inline tRaw Load(const unsigned char *p) { return (tRaw)N2kLayoutLoad16(p); }
+};
+
+template<> struct tN2kRawTraits<2,false> {
+  typedef uint16_t tRaw;
+  static constexpr double Min() { return 0; }
+  static constexpr tRaw OR() { return 0xfffe; }
+  static constexpr tRaw NA() { return 0xffff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore(p,v); }
+  static inline tRaw Load(const unsigned char *p) { return N2kLayoutLoad16(p); }
+};
+
+// Note that 3 byte signed values are not sign extended on read. This is same
+// as on GetBuf3ByteDouble.
+template<> struct tN2kRawTraits<3,true> {
+  typedef int32_t tRaw;
+  static constexpr double Min() { return -8388608L; }
+  static constexpr tRaw OR() { return 0x7ffffe; }
+  static constexpr tRaw NA() { return 0x7fffff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore24(p,(uint32_t)v); }
+  static inline tRaw Load(const unsigned char *p) { return (tRaw)N2kLayoutLoad24(p); }
+};
+
+template<> struct tN2kRawTraits<3,false> {
+  typedef int32_t tRaw;
+  static constexpr double Min() { return 0; }
+  static constexpr tRaw OR() { return 0xfffffe; }
+  static constexpr tRaw NA() { return 0xffffff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore24(p,(uint32_t)v); }
+  static inline tRaw Load(const unsigned char *p) { return (tRaw)N2kLayoutLoad24(p); }
+};
+
+template<> struct tN2kRawTraits<4,true> {
+  typedef int32_t tRaw;
+  static constexpr double Min() { return -2147483648.0; }
+  static constexpr tRaw OR() { return 0x7ffffffe; }
+  static constexpr tRaw NA() { return 0x7fffffff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore(p,(uint32_t)v); }
+  static inline tRaw Load(const unsigned char *p) { return (tRaw)N2kLayoutLoad32(p); }
+};
+
+template<> struct tN2kRawTraits<4,false> {
+  typedef uint32_t tRaw;
+  static constexpr double Min() { return 0; }
+  static constexpr tRaw OR() { return 0xfffffffe; }
+  static constexpr tRaw NA() { return 0xffffffff; }
+  static inline void Store(unsigned char *p, tRaw v) { N2kLayoutStore(p,v); }
+  static inline tRaw Load(const unsigned char *p) { return N2kLayoutLoad32(p); }
+};
+
+/************************************************************************//**
+ * \brief Single byte field
+ *
+ * Encodes value as is (same as tN2kMsg::AddByte) and decodes with mask.
+ *
+ * \tparam _Offset      Byte offset on message
+ * \tparam DecodeMask   Mask used on decoding, e.g. 0x0f for enum nibble
+ */
+template<int _Offset, unsigned char DecodeMask=0xff>
+struct tN2kByteField {
+  static const int Offset=_Offset;
+  static const int Size=1;
+  static const int Args=1;
+  template<typename T> static inline void Encode(unsigned char *buf, const T &v) { buf[Offset]=(unsigned char)v; }
+  template<typename T> static inline void Decode(const unsigned char *buf, T &v) { v=(T)(buf[Offset] & DecodeMask); }
+  template<typename T> static inline void DecodeNA(T &v) { v=(T)(0xff & DecodeMask); }
+};
+
+/************************************************************************//**
+ * \brief Bit field inside byte
+ *
+ * Other bits of the byte are left as they are, so several bit fields can
+ * share same byte. Since message bytes are prefilled with 0xff, unused bits
+ * will be 1 as required for reserved bits.
+ *
+ * \tparam _Offset  Byte offset on message
+ * \tparam Shift    Bit position of lowest bit
+ * \tparam Mask     Value mask before shift
+ */
+template<int _Offset, int Shift, unsigned char Mask>
+struct tN2kBitField {
+  static const int Offset=_Offset;
+  static const int Size=1;
+  static const int Args=1;
+  template<typename T> static inline void Encode(unsigned char *buf, const T &v) {
+    buf[Offset]=(unsigned char)( (buf[Offset] & ~(Mask<<Shift)) | ((((unsigned char)v) & Mask)<<Shift) );
+  }
+  template<typename T> static inline void Decode(const unsigned char *buf, T &v) { v=(T)((buf[Offset]>>Shift) & Mask); }
+  template<typename T> static inline void DecodeNA(T &v) { v=(T)((0xff>>Shift) & Mask); }
+};
+
+/************************************************************************//**
+ * \brief Constant byte
+ *
+ * Field does not take any argument. It is skipped on decoding.
+ *
+ * \tparam _Offset  Byte offset on message
+ * \tparam Value    Constant value
+ */
+template<int _Offset, unsigned char Value>
+struct tN2kConstField {
+  static const int Offset=_Offset;
+  static const int Size=1;
+  static const int Args=0;
+  static inline void Encode(unsigned char *buf) { buf[Offset]=Value; }
+};
+
+/************************************************************************//**
+ * \brief 2 byte unsigned integer field
+ *
+ * Same as tN2kMsg::Add2ByteUInt and tN2kMsg::Get2ByteUInt
+ *
+ * \tparam _Offset  Byte offset on message
+ */
+template<int _Offset>
+struct tN2kUInt16Field {
+  static const int Offset=_Offset;
+  static const int Size=2;
+  static const int Args=1;
+  static inline void Encode(unsigned char *buf, uint16_t v) { N2kLayoutStore(buf+Offset,v); }
+  static inline void Decode(const unsigned char *buf, uint16_t &v) { v=N2kLayoutLoad16(buf+Offset); }
+  static inline void DecodeNA(uint16_t &v) { v=N2kUInt16NA; }
+};
+
+/************************************************************************//**
+ * \brief Scaled double field with 1-4 bytes
+ *
+ * Same as tN2kMsg::AddXByteDouble/AddXByteUDouble and
+ * tN2kMsg::GetXByteDouble/GetXByteUDouble. Decoding NA handling is branch
+ * free select.
+ *
+ * \tparam _Offset      Byte offset on message
+ * \tparam Bytes        Field size 1-4. 8 byte fields has own specialization.
+ * \tparam Signed       Field is signed
+ * \tparam Resolution   tN2kResolution type
+ */
+template<int _Offset, int Bytes, bool Signed, class Resolution>
+struct tN2kDoubleField {
+  typedef tN2kRawTraits<Bytes,Signed> tTraits;
+  typedef typename tTraits::tRaw tRaw;
+  static const int Offset=_Offset;
+  static const int Size=Bytes;
+  static const int Args=1;
+  static inline void Encode(unsigned char *buf, double v) {
+    tRaw vi;
+    if ( v!=N2kDoubleNA ) {
+      double vd=N2kLayoutRound((v/Resolution::Value()));
+      vi=(vd>=tTraits::Min() && vd<tTraits::OR())?(tRaw)vd:tTraits::OR();
+    } else {
+      vi=tTraits::NA();
+    }
+    tTraits::Store(buf+Offset,vi);
+  }
+  static inline void Decode(const unsigned char *buf, double &v) {
+    tRaw vl=tTraits::Load(buf+Offset);
+    double vd=vl*Resolution::Value();
+    v=(vl==tTraits::NA()?N2kDoubleNA:vd);
+  }
+  static inline void DecodeNA(double &v) { v=N2kDoubleNA; }
+};
+
+/************************************************************************//**
+ * \brief Scaled 8 byte double field
+ *
+ * Same as tN2kMsg::Add8ByteDouble and tN2kMsg::Get8ByteDouble. Note that
+ * 8 byte values are truncated, not rounded.
+ */
+template<int _Offset, class Resolution>
+struct tN2kDoubleField<_Offset,8,true,Resolution> {
+  static const int Offset=_Offset;
+  static const int Size=8;
+  static const int Args=1;
+  static inline void Encode(unsigned char *buf, double v) {
+    int64_t vll;
+    if ( v!=N2kDoubleNA ) {
+      if ( sizeof(double)<8 ) {
+        double fp=Resolution::Value()*1e6;
+        int64_t fpll=1/fp;
+        vll=v*1e6L;
+        vll*=fpll;
+      } else {
+        vll=v/Resolution::Value();
+      }
+    } else {
+      vll=N2kInt64NA;
+    }
+    N2kLayoutStore(buf+Offset,(uint64_t)vll);
+  }
+  static inline void Decode(const unsigned char *buf, double &v) {
+    int64_t vl=(int64_t)N2kLayoutLoad64(buf+Offset);
+    double vd=vl*Resolution::Value();
+    v=(vl==N2kInt64NA?N2kDoubleNA:vd);
+  }
+  static inline void DecodeNA(double &v) { v=N2kDoubleNA; }
+};
+
+/************************************************************************//**
+ * \brief End offset of field list
+ */
+template<class... Fields> struct tN2kFieldsEnd;
+template<> struct tN2kFieldsEnd<> { static const int Value=0; };
+template<class Field, class... Rest> struct tN2kFieldsEnd<Field,Rest...> {
+  static const int Value=( Field::Offset+Field::Size>tN2kFieldsEnd<Rest...>::Value
+                           ? Field::Offset+Field::Size
+                           : tN2kFieldsEnd<Rest...>::Value );
+};
+
+/************************************************************************//**
+ * \brief Field list encoder/decoder
+ *
+ * Arguments are paired with fields in order. Fields with Args==0 (e.g.
+ * tN2kConstField) do not consume argument.
+ */
+template<class... Fields> struct tN2kFieldCodec;
+template<bool HasArg, class Field, class... Rest> struct tN2kFieldCodecStep;
+
+template<> struct tN2kFieldCodec<> {
+  static inline void Encode(unsigned char *) {}
+  static inline void Decode(const unsigned char *) {}
+  static inline void DecodeChecked(const unsigned char *, int) {}
+};
+
+template<class Field, class... Rest>
+struct tN2kFieldCodec<Field,Rest...> : public tN2kFieldCodecStep<(Field::Args>0),Field,Rest...> {};
+
+template<class Field, class... Rest>
+struct tN2kFieldCodecStep<true,Field,Rest...> {
+  template<typename T, typename... Args>
+  static inline void Encode(unsigned char *buf, const T &v, const Args&... args) {
+    Field::Encode(buf,v);
+    tN2kFieldCodec<Rest...>::Encode(buf,args...);
+  }
+  template<typename T, typename... Args>
+  static inline void Decode(const unsigned char *buf, T &v, Args&... args) {
+    Field::Decode(buf,v);
+    tN2kFieldCodec<Rest...>::Decode(buf,args...);
+  }
+  template<typename T, typename... Args>
+  static inline void DecodeChecked(const unsigned char *buf, int len, T &v, Args&... args) {
+    if ( Field::Offset+Field::Size<=len ) { Field::Decode(buf,v); } else { Field::DecodeNA(v); }
+    tN2kFieldCodec<Rest...>::DecodeChecked(buf,len,args...);
+  }
+};
+
+template<class Field, class... Rest>
+struct tN2kFieldCodecStep<false,Field,Rest...> {
+  template<typename... Args>
+  static inline void Encode(unsigned char *buf, const Args&... args) {
+    Field::Encode(buf);
+    tN2kFieldCodec<Rest...>::Encode(buf,args...);
+  }
+  template<typename... Args>
+  static inline void Decode(const unsigned char *buf, Args&... args) {
+    tN2kFieldCodec<Rest...>::Decode(buf,args...);
+  }
+  template<typename... Args>
+  static inline void DecodeChecked(const unsigned char *buf, int len, Args&... args) {
+    tN2kFieldCodec<Rest...>::DecodeChecked(buf,len,args...);
+  }
+};
+
+/************************************************************************//**
+ * \class tN2kMsgLayout
+ * \brief Fixed length PGN layout
+ *
+ * \tparam _PGN       PGN
+ * \tparam _Priority  Default priority
+ * \tparam _Length    Fixed message length. Bytes not covered by fields
+ *                    will be 0xff.
+ * \tparam Fields     Field list
+ */
+template<unsigned long _PGN, unsigned char _Priority, int _Length, class... Fields>
+class tN2kMsgLayout {
+public:
+  static const unsigned long PGN=_PGN;
+  static const unsigned char Priority=_Priority;
+  static const int Length=_Length;
+
+  static_assert(_Length<=tN2kMsg::MaxDataLen,"Layout too long");
+  static_assert(tN2kFieldsEnd<Fields...>::Value<=_Length,"Field out of layout length");
+
+public:
+  /**********************************************************************//**
+   * \brief Encode message
+   *
+   * Sets PGN and priority as SetN2kPGNxxx functions do and stores all
+   * fields. After call DataLen is Length, so caller can continue adding
+   * variable part with tN2kMsg::AddXXX functions.
+   *
+   * \param N2kMsg  Reference to a N2kMsg Object
+   * \param args    Field values in field order
+   */
+  template<typename... Args>
+  static inline void Encode(tN2kMsg &N2kMsg, const Args&... args) {
+    N2kMsg.SetPGN(PGN);
+    N2kMsg.Priority=Priority;
+    memset(N2kMsg.Data,0xff,Length);
+    tN2kFieldCodec<Fields...>::Encode(N2kMsg.Data,args...);
+    N2kMsg.DataLen=Length;
+  }
+
+  /**********************************************************************//**
+   * \brief Decode message
+   *
+   * On full length message all fields are decoded without bounds checks.
+   * For shorter messages missing fields will be set to NA.
+   *
+   * \param N2kMsg  Reference to a N2kMsg Object
+   * \param args    References to field values in field order
+   *
+   * \retval true   PGN matched and fields were decoded
+   * \retval false  Wrong PGN
+   */
+  template<typename... Args>
+  static inline bool Decode(const tN2kMsg &N2kMsg, Args&... args) {
+    if ( N2kMsg.PGN!=PGN ) return false;
+    if ( N2kMsg.DataLen>=Length ) {
+      tN2kFieldCodec<Fields...>::Decode(N2kMsg.Data,args...);
+    } else {
+      tN2kFieldCodec<Fields...>::DecodeChecked(N2kMsg.Data,N2kMsg.DataLen,args...);
+    }
+    return true;
+  }
+};
+
+/************************************************************************//**
+ * \brief Decoded message with its header information
+ *
+ * \tparam tData  Layout data struct, e.g. tN2kPGN129025Data
+ */
+template<class tData>
+struct tN2kDecodedMsg {
+  unsigned char Source;
+  unsigned long MsgTime;
+  tData Data;
+};
+
+/************************************************************************//**
+ * \brief Decode all messages of one PGN from a message buffer
+ *
+ * Messages with other PGN are skipped, so buffer can be e.g. a bus log.
+ * Decoding is done with the layout of tData, so there is no per field
+ * function call or bounds check for full length messages.
+ *
+ * \tparam tData     Layout data struct. It must have typedef tLayout and
+ *                   member bool Decode(const tN2kMsg &)
+ * \param Msgs       Message buffer
+ * \param nMsgs      Number of messages in buffer
+ * \param Decoded    Output buffer
+ * \param MaxDecoded Size of output buffer
+ *
+ * \returns Number of decoded messages
+ */
+template<class tData>
+int N2kDecodeMessages(const tN2kMsg *Msgs, int nMsgs, tN2kDecodedMsg<tData> *Decoded, int MaxDecoded) {
+  int nDecoded=0;
+
+  for (int i=0; i<nMsgs && nDecoded<MaxDecoded; i++) {
+    if ( Msgs[i].PGN!=tData::tLayout::PGN ) continue;
+    if ( Decoded[nDecoded].Data.Decode(Msgs[i]) ) {
+      Decoded[nDecoded].Source=Msgs[i].Source;
+      Decoded[nDecoded].MsgTime=Msgs[i].MsgTime;
+      nDecoded++;
+    }
+  }
+
+  return nDecoded;
+}
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ * N2kTPSession.h
+ *
+ * Copyright (c) 2026 Chelton Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/*************************************************************************//**
+ * \file  N2kTPSession.h
+ * \brief ISO Transport Protocol session used internally on tNMEA2000.
+ *
+ * Each ISO TP transfer, incoming or outgoing, BAM or RTS/CTS, is an
+ * independent session with own message buffer and own timer. tNMEA2000
+ * keeps a pool of sessions, so several transfers can run concurrently.
+ * Only rule is one BAM per sender and one RTS/CTS per sender-receiver pair
+ * as required by ISO 11783-3.
+ */
+
+#ifndef _tN2kTPSession_H_
+#define _tN2kTPSession_H_
+
+#include "N2kCANMsg.h"
+#include "N2kTimerWheel.h"
+
+/************************************************************************//**
+ * \class tN2kTPSession
+ * \brief ISO Transport Protocol session
+ * \ingroup group_core
+ */
+class tN2kTPSession
+{
+public:
+  /** \brief Session type */
+  typedef enum {
+                tpst_RxBAM,     ///< Receiving broadcast
+                tpst_RxRTS,     ///< Receiving connection mode message
+                tpst_TxBAM,     ///< Sending broadcast
+                tpst_TxRTS      ///< Sending connection mode message
+               } tType;
+
+public:
+  /** \brief Session type */
+  tType Type;
+  /** \brief Index of own device. For received messages not for us this is -1. */
+  int iDev;
+  /** \brief Message buffer. Session is free, when CANMsg.FreeMsg is set. */
+  tN2kCANMsg CANMsg;
+  /** \brief Total number of data packets */
+  uint8_t nPackets;
+  /** \brief Number of data packets sent or received */
+  uint8_t PacketsDone;
+  /** \brief Last packet number allowed by current CTS */
+  uint8_t WindowEnd;
+  /** \brief Max packets per CTS we allow on receiving */
+  uint8_t MaxPackets;
+  /** \brief Next BAM data packet time or session timeout */
+  tN2kWheelScheduler Timer;
+  /** \brief Session start time */
+  unsigned long StartTime;
+
+public:
+  /************************************************************************//**
+   * \brief Constructor of class \ref tN2kTPSession
+   */
+  tN2kTPSession() : Type(tpst_RxBAM), iDev(-1), nPackets(0), PacketsDone(0), WindowEnd(0), MaxPackets(0), StartTime(0) {}
+
+  /** \brief Check if session is free */
+  bool IsFree() const { return CANMsg.FreeMsg; }
+  /** \brief Check if session receives message */
+  bool IsRx() const { return Type==tpst_RxBAM || Type==tpst_RxRTS; }
+  /** \brief Check if session is broadcast session */
+  bool IsBAM() const { return Type==tpst_RxBAM || Type==tpst_TxBAM; }
+  /** \brief Check if all data has been transferred */
+  bool IsComplete() const { return PacketsDone>=nPackets; }
+  /** \brief PGN transferred */
+  unsigned long PGN() const { return CANMsg.N2kMsg.PGN; }
+
+  /************************************************************************//**
+   * \brief Start session
+   *
+   * \param _Type     Session type
+   * \param _iDev     Own device index or -1
+   * \param nBytes    Message length
+   */
+  void Start(tType _Type, int _iDev, uint16_t nBytes) {
+    Type=_Type;
+    iDev=_iDev;
+    CANMsg.FreeMsg=false;
+    CANMsg.Ready=false;
+    CANMsg.CopiedLen=0;
+    CANMsg.LastFrame=0;
+    CANMsg.N2kMsg.SetIsTPMessage();
+    nPackets=nBytes/7+(nBytes%7!=0?1:0);
+    PacketsDone=0;
+    WindowEnd=0;
+    StartTime=N2kMillis();
+  }
+
+  /************************************************************************//**
+   * \brief Free session
+   */
+  void Free() { Timer.Disable(); CANMsg.FreeMessage(); }
+};
+
+/************************************************************************//**
+ * \class tN2kTPStatistics
+ * \brief ISO Transport Protocol session statistics
+ * \ingroup group_core
+ *
+ * Bytes and Time are collected only from completed sessions, so
+ * Bytes/Time is the real transfer throughput.
+ */
+class tN2kTPStatistics
+{
+public:
+  /** \brief Statistics for one direction */
+  struct tDirection {
+    /** \brief Sessions started */
+    uint32_t Started;
+    /** \brief Sessions completed successfully */
+    uint32_t Completed;
+    /** \brief Sessions aborted by either side */
+    uint32_t Aborted;
+    /** \brief Sessions timed out */
+    uint32_t TimedOut;
+    /** \brief Bytes transferred in completed sessions */
+    uint32_t Bytes;
+    /** \brief Total time in ms of completed sessions */
+    uint32_t Time;
+
+    /** \brief Throughput of completed sessions in bytes/s */
+    uint32_t BytesPerSecond() const { return (Time>0?(uint32_t)((uint64_t)Bytes*1000/Time):0); }
+  };
+
+  /** \brief Received sessions */
+  tDirection Rx;
+  /** \brief Sent sessions */
+  tDirection Tx;
+  /** \brief Sessions rejected due to full session pool */
+  uint32_t NoFreeSession;
+  /** \brief Max concurrent sessions seen */
+  uint8_t MaxActiveSessions;
+
+public:
+  tN2kTPStatistics() { Clear(); }
+  /** \brief Clear all statistics */
+  void Clear() {
+    Rx.Started=Rx.Completed=Rx.Aborted=Rx.TimedOut=Rx.Bytes=Rx.Time=0;
+    Tx=Rx;
+    NoFreeSession=0;
+    MaxActiveSessions=0;
+  }
+};
+
+#endif
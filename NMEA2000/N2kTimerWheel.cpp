@@ -0,0 +1,205 @@
+/*
+ * N2kTimerWheel.cpp
+ *
+ * Copyright (c) 2026 Chelton Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#include "N2kTimerWheel.h"
+
+#define N2kWheelSlotBit(Index) (1ULL<<(Index))
+
+//*****************************************************************************
+tN2kTimerWheel::tN2kTimerWheel() : Current(N2kMillis64()), Count(0) {
+  for (int Level=0; Level<Levels; Level++) {
+    Occupied[Level]=0;
+    for (uint32_t Index=0; Index<SlotsPerLevel; Index++) {
+      Slots[Level][Index].Prev=Slots[Level][Index].Next=&Slots[Level][Index];
+    }
+  }
+}
+
+//*****************************************************************************
+// Timer goes to the lowest level, which range covers its delta from Current.
+// Timers beyond the wheel range are placed on the last slot within range and
+// they will be cascaded again.
+void tN2kTimerWheel::Place(tTimer &Timer) {
+  uint64_t Expires=( Timer.Expires<Current?Current:Timer.Expires );
+  uint64_t Delta=Expires-Current;
+  int Level=0;
+
+  while ( Level<Levels-1 && Delta>=(1ULL<<((Level+1)*LevelBits)) ) Level++;
+  if ( Delta>=(1ULL<<(Levels*LevelBits)) ) Expires=Current+(1ULL<<(Levels*LevelBits))-1;
+
+  uint32_t Index=(Expires>>(Level*LevelBits)) & SlotMask;
+  tTimer &Head=Slots[Level][Index];
+  Timer.Next=&Head;
+  Timer.Prev=Head.Prev;
+  Head.Prev->Next=&Timer;
+  Head.Prev=&Timer;
+  Timer.Slot=Level*SlotsPerLevel+Index;
+  Occupied[Level]|=N2kWheelSlotBit(Index);
+}
+
+//*****************************************************************************
+void tN2kTimerWheel::Unlink(tTimer &Timer) {
+  int Level=Timer.Slot/SlotsPerLevel;
+  uint32_t Index=Timer.Slot%SlotsPerLevel;
+  Timer.Prev->Next=Timer.Next;
+  Timer.Next->Prev=Timer.Prev;
+  Timer.Prev=Timer.Next=0;
+  if ( Slots[Level][Index].Next==&Slots[Level][Index] ) Occupied[Level]&=~N2kWheelSlotBit(Index);
+}
+
+//*****************************************************************************
+void tN2kTimerWheel::Schedule(tTimer &Timer, uint64_t At) {
+  if ( Timer.IsPending() ) {
+    Unlink(Timer);
+  } else {
+    Count++;
+  }
+  Timer.Expires=At;
+  Place(Timer);
+}
+
+//*****************************************************************************
+void tN2kTimerWheel::Cancel(tTimer &Timer) {
+  if ( !Timer.IsPending() ) return;
+  Unlink(Timer);
+  Count--;
+}
+
+//*****************************************************************************
+// Move timers on current slot of Level down to lower levels. Called, when
+// lower level wraps around.
+void tN2kTimerWheel::Cascade(int Level) {
+  if ( Level>=Levels ) return;
+
+  uint32_t Index=(Current>>(Level*LevelBits)) & SlotMask;
+  if ( Index==0 ) Cascade(Level+1);
+  if ( (Occupied[Level] & N2kWheelSlotBit(Index))==0 ) return;
+
+  tTimer &Head=Slots[Level][Index];
+  tTimer *Timer=Head.Next;
+  Head.Prev=Head.Next=&Head;
+  Occupied[Level]&=~N2kWheelSlotBit(Index);
+  while ( Timer!=&Head ) {
+    tTimer *Next=Timer->Next;
+    Place(*Timer);
+    Timer=Next;
+  }
+}
+
+//*****************************************************************************
+int tN2kTimerWheel::ExpireSlot(uint32_t Index, uint64_t Now) {
+  tTimer &Head=Slots[0][Index];
+  tTimer *Timer=Head.Next;
+  int Expired=0;
+
+  while ( Timer!=&Head ) {
+    tTimer *Next=Timer->Next;
+    if ( Timer->Expires<=Now ) {
+      Unlink(*Timer);
+      Count--;
+      Expired++;
+    }
+    Timer=Next;
+  }
+
+  return Expired;
+}
+
+//*****************************************************************************
+int tN2kTimerWheel::Run(uint64_t Now) {
+  int Expired=0;
+
+  // Timers scheduled to already handled time are on current slot.
+  if ( Current>Now && (Occupied[0] & N2kWheelSlotBit(Current & SlotMask)) ) {
+    Expired+=ExpireSlot(Current & SlotMask,Now);
+  }
+
+  while ( Current<=Now ) {
+    if ( Count==0 ) { // Nothing to wait, just move time
+      Current=Now+1;
+      break;
+    }
+
+    uint32_t Index=Current & SlotMask;
+    if ( Index==0 ) Cascade(1);
+    if ( Occupied[0] & N2kWheelSlotBit(Index) ) Expired+=ExpireSlot(Index,Current);
+
+    // Jump over empty slots. We must stop on each level 0 wrap for cascading.
+    uint64_t Later=Occupied[0] & ~((N2kWheelSlotBit(Index)<<1)-1);
+    uint64_t Next=( Later!=0?Current-Index+__builtin_ctzll(Later):(Current|SlotMask)+1 );
+    Current=( Next<=Now?Next:Now+1 );
+  }
+
+  return Expired;
+}
+
+//*****************************************************************************
+uint64_t tN2kTimerWheel::SlotMinExpires(int Level, uint32_t Index) const {
+  uint64_t Min=N2kScheduler64Disabled;
+  const tTimer &Head=Slots[Level][Index];
+
+  for (const tTimer *Timer=Head.Next; Timer!=&Head; Timer=Timer->Next) {
+    if ( Timer->Expires<Min ) Min=Timer->Expires;
+  }
+
+  return Min;
+}
+
+//*****************************************************************************
+// First non empty slot from current position on each level has the earliest
+// timers of that level. Only exception is the current slot on upper levels,
+// which may hold timers one full round ahead, so then we check also the next
+// non empty slot. Last level may have timers beyond wheel range, so there we
+// check all slots.
+uint64_t tN2kTimerWheel::GetNextExpires() const {
+  uint64_t Next=N2kScheduler64Disabled;
+
+  if ( Count==0 ) return Next;
+
+  for (int Level=0; Level<Levels; Level++) {
+    uint64_t Bits=Occupied[Level];
+    if ( Bits==0 ) continue;
+
+    uint64_t Min=N2kScheduler64Disabled;
+    if ( Level==Levels-1 ) {
+      for (uint32_t Index=0; Bits!=0; Index++, Bits>>=1) {
+        if ( Bits & 1 ) {
+          uint64_t SlotMin=SlotMinExpires(Level,Index);
+          if ( SlotMin<Min ) Min=SlotMin;
+        }
+      }
+    } else {
+      uint32_t Index=(Current>>(Level*LevelBits)) & SlotMask;
+      if ( Index!=0 ) Bits=(Bits>>Index) | (Bits<<(SlotsPerLevel-Index));
+      uint32_t First=__builtin_ctzll(Bits);
+      Min=SlotMinExpires(Level,(Index+First) & SlotMask);
+      if ( Level>0 && First==0 && (Bits&~1ULL)!=0 ) {
+        uint64_t Second=SlotMinExpires(Level,(Index+__builtin_ctzll(Bits&~1ULL)) & SlotMask);
+        if ( Second<Min ) Min=Second;
+      }
+    }
+    if ( Min<Next ) Next=Min;
+  }
+
+  return Next;
+}
@@ -0,0 +1,232 @@
+/*
+ * N2kTimerWheel.h
+ *
+ * Copyright (c) 2026 Chelton Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/*************************************************************************//**
+ * \file  N2kTimerWheel.h
+ * \brief Hierarchical timer wheel for library timers
+ *
+ * tN2kTimerWheel keeps all pending deadlines of one tNMEA2000 object, so
+ * the library knows the time to next event without polling every timer.
+ * Wheel has 4 levels of 64 slots with 1 ms resolution on first level, which
+ * covers about 4.6 hours. Longer timers will be cascaded again.
+ *
+ * Insert and cancel are O(1). Timers are intrusive, so the wheel never
+ * allocates memory.
+ *
+ * tN2kWheelScheduler and tN2kWheelSyncScheduler have same interface as
+ * tN2kScheduler and tN2kSyncScheduler, but they also keep their deadline on
+ * the wheel after \ref tN2kWheelScheduler::Attach. Wheel fires timer at
+ * first millisecond when IsTime() returns true.
+ */
+
+#ifndef _N2kTimerWheel_H_
+#define _N2kTimerWheel_H_
+
+#include "N2kTimer.h"
+
+/************************************************************************//**
+ * \class tN2kTimerWheel
+ * \brief Hierarchical timer wheel
+ * \ingroup group_core
+ */
+class tN2kTimerWheel
+{
+public:
+  /************************************************************************//**
+   * \class tTimer
+   * \brief Intrusive timer node
+   *
+   * Timer node can be on one wheel at a time. Node must not be moved or
+   * copied while it is pending.
+   */
+  class tTimer {
+    friend class tN2kTimerWheel;
+  protected:
+    /** \brief Previous node on slot list */
+    tTimer *Prev;
+    /** \brief Next node on slot list */
+    tTimer *Next;
+    /** \brief Expiration time in ms */
+    uint64_t Expires;
+    /** \brief Slot index on wheel */
+    uint16_t Slot;
+
+  public:
+    tTimer() : Prev(0), Next(0), Expires(N2kScheduler64Disabled), Slot(0) {}
+    tTimer(const tTimer &)=delete;
+    tTimer &operator=(const tTimer &)=delete;
+    /** \brief Check if timer is waiting on wheel */
+    bool IsPending() const { return Prev!=0; }
+    /** \brief Expiration time in ms */
+    uint64_t GetExpires() const { return Expires; }
+  };
+
+protected:
+  static const int LevelBits=6;
+  static const int Levels=4;
+  static const uint32_t SlotsPerLevel=1UL<<LevelBits;
+  static const uint32_t SlotMask=SlotsPerLevel-1;
+
+  /** \brief Slot list heads */
+  tTimer Slots[Levels][SlotsPerLevel];
+  /** \brief Bit set for each non empty slot */
+  uint64_t Occupied[Levels];
+  /** \brief Next millisecond to be handled */
+  uint64_t Current;
+  /** \brief Number of pending timers */
+  uint32_t Count;
+
+protected:
+  void Place(tTimer &Timer);
+  void Unlink(tTimer &Timer);
+  void Cascade(int Level);
+  int ExpireSlot(uint32_t Index, uint64_t Now);
+  uint64_t SlotMinExpires(int Level, uint32_t Index) const;
+
+public:
+  /************************************************************************//**
+   * \brief Constructor of class \ref tN2kTimerWheel
+   */
+  tN2kTimerWheel();
+
+  /************************************************************************//**
+   * \brief Schedule timer
+   *
+   * If timer is already pending, it will be rescheduled.
+   *
+   * \param Timer   Timer node
+   * \param At      Expiration time as N2kMillis64() value
+   */
+  void Schedule(tTimer &Timer, uint64_t At);
+
+  /************************************************************************//**
+   * \brief Cancel timer
+   *
+   * \param Timer   Timer node. Nothing will be done, if it is not pending.
+   */
+  void Cancel(tTimer &Timer);
+
+  /************************************************************************//**
+   * \brief Run wheel up to given time
+   *
+   * All timers expired up to Now will be removed from wheel.
+   *
+   * \param Now     Current time as N2kMillis64() value
+   * \return Number of expired timers
+   */
+  int Run(uint64_t Now);
+
+  /************************************************************************//**
+   * \brief Get next expiration time
+   *
+   * \return Earliest expiration time of pending timers or
+   *         N2kScheduler64Disabled, if there is none.
+   */
+  uint64_t GetNextExpires() const;
+
+  /** \brief Number of pending timers */
+  uint32_t GetCount() const { return Count; }
+};
+
+/************************************************************************//**
+ * \class tN2kWheelScheduler
+ * \brief tN2kScheduler with deadline on timer wheel
+ * \ingroup group_core
+ */
+class tN2kWheelScheduler : public tN2kScheduler
+{
+protected:
+  tN2kTimerWheel *Wheel;
+  tN2kTimerWheel::tTimer WheelTimer;
+
+public:
+  tN2kWheelScheduler() : tN2kScheduler(), Wheel(0) {}
+  ~tN2kWheelScheduler() { if ( Wheel!=0 ) Wheel->Cancel(WheelTimer); }
+
+  /************************************************************************//**
+   * \brief Attach scheduler to timer wheel
+   *
+   * Scheduler must be attached before it is enabled.
+   *
+   * \param _Wheel  Timer wheel
+   */
+  void Attach(tN2kTimerWheel *_Wheel) { Wheel=_Wheel; }
+  /** \brief Disable the Scheduler */
+  void Disable() {
+    tN2kScheduler::Disable();
+    if ( Wheel!=0 ) Wheel->Cancel(WheelTimer);
+  }
+  /************************************************************************//**
+   * \brief Set Timestamp for next event relative to now
+   *
+   * \param _Add Time delay from now for next event
+   */
+  void FromNow(uint32_t _Add) {
+    tN2kScheduler::FromNow(_Add);
+    if ( Wheel!=0 ) Wheel->Schedule(WheelTimer,N2kMillis64()+_Add+1);
+  }
+};
+
+/************************************************************************//**
+ * \class tN2kWheelSyncScheduler
+ * \brief tN2kSyncScheduler with deadline on timer wheel
+ * \ingroup group_core
+ */
+class tN2kWheelSyncScheduler : public tN2kSyncScheduler
+{
+protected:
+  tN2kTimerWheel *Wheel;
+  tN2kTimerWheel::tTimer WheelTimer;
+
+  void Sync() {
+    if ( Wheel==0 ) return;
+    if ( IsDisabled() ) {
+      Wheel->Cancel(WheelTimer);
+    } else {
+      Wheel->Schedule(WheelTimer,NextTime+1);
+    }
+  }
+
+public:
+  tN2kWheelSyncScheduler() : tN2kSyncScheduler(), Wheel(0) {}
+  ~tN2kWheelSyncScheduler() { if ( Wheel!=0 ) Wheel->Cancel(WheelTimer); }
+
+  /************************************************************************//**
+   * \brief Attach scheduler to timer wheel
+   *
+   * \param _Wheel  Timer wheel
+   */
+  void Attach(tN2kTimerWheel *_Wheel) { Wheel=_Wheel; Sync(); }
+  /** \brief Disable Scheduler */
+  void Disable() { tN2kSyncScheduler::Disable(); Sync(); }
+  /** \brief Set the Period of the Scheduler */
+  void SetPeriod(uint32_t _Period) { tN2kSyncScheduler::SetPeriod(_Period); Sync(); }
+  /** \brief Set the Offset of the Scheduler */
+  void SetOffset(uint32_t _Offset) { tN2kSyncScheduler::SetOffset(_Offset); Sync(); }
+  /** \brief Set the Period And Offset of the Scheduler */
+  void SetPeriodAndOffset(uint32_t _Period, uint32_t _Offset) { tN2kSyncScheduler::SetPeriodAndOffset(_Period,_Offset); Sync(); }
+  /** \brief Update the timestamp for NextTime */
+  void UpdateNextTime() { tN2kSyncScheduler::UpdateNextTime(); Sync(); }
+};
+
+#endif
@@ -137,6 +137,23 @@ void N2kPrintFreeMemory(const char *Source) {
 /** \brief A timeout occurred and this is the connection abort to close the
  * session */
 #define TP_CM_AbortTimeout 3
+/** \brief CTS messages received when data transfer is in progress */
+#define TP_CM_AbortCTSInProgress 4
+/** \brief Bad sequence number (software cannot recover) */
+#define TP_CM_AbortBadSequence 7
+
+/** \brief Default ISO TP session pool size */
+#define TP_DEFAULT_SESSIONS 8
+/** \brief Time between BAM data packets in ms */
+#define TP_BAM_PACKET_INTERVAL 50
+/** \brief ISO 11783-3 T1, receiver timeout between data packets in ms */
+#define TP_TIMEOUT_T1 750
+/** \brief ISO 11783-3 T2, receiver timeout for data after CTS in ms */
+#define TP_TIMEOUT_T2 1250
+/** \brief ISO 11783-3 T3, sender timeout for CTS or EndAck in ms */
+#define TP_TIMEOUT_T3 1250
+/** \brief ISO 11783-3 T4, sender timeout after CTS hold (0 packets) in ms */
+#define TP_TIMEOUT_T4 1050
 
 /************************************************************************//**
  * \
@@ -699,6 +716,12 @@ tNMEA2000::tNMEA2000() {
 
   N2kCANMsgBuf=0;
   MaxN2kCANMsgs=0;
+  CANFrameTimeUs=0;
+  CANFrameDataLen=8;
+#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
+  TPSessions=0;
+  MaxTPSessions=0;
+#endif
 
   MaxCANSendFrames=40;
   MaxCANReceiveFrames=0; // Use driver default
@@ -709,6 +732,7 @@ tNMEA2000::tNMEA2000() {
   MsgHandlers=0;
   ISORqstHandler=0;
 
+  OpenScheduler.Attach(&TimerWheel);
   OpenScheduler.FromNow(0);
   OpenState=os_None;
   AddressChanged=false;
@@ -738,7 +762,11 @@ void tNMEA2000::SetDeviceCount(const uint8_t _DeviceCount) {
 void tNMEA2000::InitDevices() {
   if ( Devices==0 ) {
     N2kDbgln("Init devices");
+    // SetDeviceCount keeps the count in 1..9. Checking it here also bounds
+    // the allocation for the compiler.
+    if ( DeviceCount<1 || DeviceCount>=10 ) DeviceCount=1;
     Devices=new tInternalDevice[DeviceCount];
+    for (int i=0; i<DeviceCount; i++) Devices[i].AttachTimers(&TimerWheel);
     MaxCANSendFrames*=DeviceCount; // We need bigger buffer for sending all information
 //    for (int i=0; i<DeviceCount; i++) Devices[i].tDevice();
     // We set default device information here.
@@ -1236,6 +1264,11 @@ bool tNMEA2000::Open() {
       if ( MaxN2kCANMsgs==0 ) MaxN2kCANMsgs=5;
       N2kCANMsgBuf = new tN2kCANMsg[MaxN2kCANMsgs];
       for (int i=0; i<MaxN2kCANMsgs; i++) N2kCANMsgBuf[i].FreeMessage();
+      #if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
+      if ( MaxTPSessions==0 ) MaxTPSessions=TP_DEFAULT_SESSIONS;
+      TPSessions = new tN2kTPSession[MaxTPSessions];
+      for (int i=0; i<MaxTPSessions; i++) TPSessions[i].Timer.Attach(&TimerWheel);
+      #endif
 
       #if !defined(N2K_NO_GROUP_FUNCTION_SUPPORT)
       // On first open try add also default group function handlers
@@ -1280,7 +1313,7 @@ bool tNMEA2000::Open() {
     // Read rubbish out from CAN controller
     unsigned long canId;
     unsigned char len = 0;
-    unsigned char buf[8];
+    unsigned char buf[N2K_MAX_CAN_FRAME_DATA_LEN];
     while ( CANGetFrame(canId,len,buf) );
   }
 
@@ -1368,7 +1401,7 @@ bool tNMEA2000::SendFrame(unsigned long id, unsigned char len, const unsigned ch
       N2kFrameOutDbgStart("Frame failed "); N2kFrameOutDbgln(id);
       return false;
     }
-    len=N2kMin<unsigned char>(len,8);
+    len=N2kMin<unsigned char>(len,N2K_MAX_CAN_FRAME_DATA_LEN);
     Frame->id=id;
     Frame->len=len;
     Frame->wait_sent=wait_sent;
@@ -1457,11 +1490,11 @@ tNMEA2000::tCANSendFrame *tNMEA2000::GetNextFreeCANSendFrame() {
 
 //*****************************************************************************
 void tNMEA2000::SendPendingInformation() {
+  #if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
+  HandleTPSessionTimers();
+  #endif
   for (int i=0; i<DeviceCount; i++ ) {
     if (  Devices[i].HasPendingInformation ) {
-      #if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-      SendPendingTPMessage(i);
-      #endif
       if ( Devices[i].QueryPendingIsoAddressClaim() ) {
         SendIsoAddressClaim(0xff,i);
         Devices[i].ClearPendingIsoAddressClaim();
@@ -1472,6 +1505,19 @@ void tNMEA2000::SendPendingInformation() {
   }
 }
 
+//*****************************************************************************
+// Fast packet frames are always 8 bytes on classic CAN. On CAN FD last frame
+// is rounded up to next valid FD data length.
+static int CANFrameLen(int used) {
+  static const unsigned char FDLen[]={12,16,20,24,32,48,64};
+
+  if ( used<=8 ) return 8;
+  for (size_t i=0; i<sizeof(FDLen); i++) {
+    if ( used<=FDLen[i] ) return FDLen[i];
+  }
+  return 64;
+}
+
 //*****************************************************************************
 // Sends message to N2k bus
 //
@@ -1519,35 +1565,38 @@ bool tNMEA2000::SendMsg(const tN2kMsg &N2kMsg, int DeviceIndex) {
         } else
 #endif
         {
-          unsigned char temp[8]; // {0,0,0,0,0,0,0,0};
+          unsigned char temp[N2K_MAX_CAN_FRAME_DATA_LEN]; // {0,0,0,0,0,0,0,0};
           int cur=0;
-          int frames=(N2kMsg.DataLen>6 ? (N2kMsg.DataLen-6-1)/7+1+1 : 1 );
+          int FrameLen=CANFrameDataLen; // 8 on classic CAN
+          int frames=(N2kMsg.DataLen>FrameLen-2 ? (N2kMsg.DataLen-(FrameLen-2)-1)/(FrameLen-1)+1+1 : 1 );
           int Order=GetSequenceCounter(N2kMsg.PGN,DeviceIndex)<<5;
           result=true;
           for (int i = 0; i<frames && result; i++) {
+              int j;
               temp[0] = i|Order; //frame counter
               if (i==0) {
                   temp[1] = N2kMsg.DataLen; //total bytes in fast packet
-                  //send the first 6 bytes
-                  for (int j = 2; j<8; j++) {
+                  //send the first 6 (or FrameLen-2) bytes
+                  for (j = 2; j<FrameLen && cur<N2kMsg.DataLen; j++) {
                        temp[j]=N2kMsg.Data[cur];
                        cur++;
                    }
                   N2kPrintFreeMemory("SendMsg, fastpacket");
               } else {
-                   int j=1;
-                   //send the next 7 data bytes
-                   for (; j<8 && cur<N2kMsg.DataLen; j++) {
+                   j=1;
+                   //send the next 7 (or FrameLen-1) data bytes
+                   for (; j<FrameLen && cur<N2kMsg.DataLen; j++) {
                        temp[j]=N2kMsg.Data[cur];
                        cur++;
                    }
-                   for (; j<8; j++) {
-                       temp[j]=0xff;
-                   }
+              }
+              int SendLen=CANFrameLen(j);
+              for (; j<SendLen; j++) {
+                  temp[j]=0xff;
               }
 
-              DbgPrintBuf(8,temp,true);
-              result=SendFrame(canId, 8, temp, true);
+              DbgPrintBuf(SendLen,temp,true);
+              result=SendFrame(canId, SendLen, temp, true);
               if (!result && ForwardStream!=0 && ForwardType==tNMEA2000::fwdt_Text) {
                 ForwardStream->print(F("PGN ")); ForwardStream->print(N2kMsg.PGN);
                 ForwardStream->print(F(", frame:")); ForwardStream->print(i); ForwardStream->print(F("/")); ForwardStream->print(frames);
@@ -1658,11 +1707,7 @@ void CopyBufToCANMsg(tN2kCANMsg &CANMsg, unsigned char start, unsigned char len,
 }
 
 //*****************************************************************************
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-void tNMEA2000::FindFreeCANMsgIndex(unsigned long PGN, unsigned char Source, unsigned char Destination, bool TPMsg, uint8_t &MsgIndex) {
-#else
 void tNMEA2000::FindFreeCANMsgIndex(unsigned long PGN, unsigned char Source, unsigned char Destination, uint8_t &MsgIndex) {
-#endif
   unsigned long OldestMsgTime,CurTime;
   int OldestIndex;
 
@@ -1672,9 +1717,6 @@ void tNMEA2000::FindFreeCANMsgIndex(unsigned long PGN, unsigned char Source, uns
          ( N2kCANMsgBuf[MsgIndex].N2kMsg.PGN==PGN
            && N2kCANMsgBuf[MsgIndex].N2kMsg.Source==Source
            && N2kCANMsgBuf[MsgIndex].N2kMsg.Destination==Destination
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-           && N2kCANMsgBuf[MsgIndex].N2kMsg.IsTPMessage()==TPMsg
-#endif
          )
         );
        MsgIndex++) { // Find free message place
@@ -1693,40 +1735,93 @@ void tNMEA2000::FindFreeCANMsgIndex(unsigned long PGN, unsigned char Source, uns
 #if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
 
 //*****************************************************************************
-bool tNMEA2000::SendTPCM_BAM(int iDev) {
+tN2kTPSession *tNMEA2000::FindTPSession(bool Rx, unsigned char Source, unsigned char Destination) {
+  if ( TPSessions==0 ) return 0;
+
+  for (int i=0; i<MaxTPSessions; i++) {
+    if ( !TPSessions[i].IsFree()
+         && TPSessions[i].IsRx()==Rx
+         && TPSessions[i].CANMsg.N2kMsg.Source==Source
+         && TPSessions[i].CANMsg.N2kMsg.Destination==Destination ) return &(TPSessions[i]);
+  }
+
+  return 0;
+}
+
+//*****************************************************************************
+tN2kTPSession *tNMEA2000::GetFreeTPSession() {
+  if ( TPSessions==0 ) return 0;
+
+  tN2kTPSession *FreeSession=0;
+  uint8_t Active=1; // Count also the one we are going to start
+
+  for (int i=0; i<MaxTPSessions; i++) {
+    if ( TPSessions[i].IsFree() ) {
+      if ( FreeSession==0 ) FreeSession=&(TPSessions[i]);
+    } else Active++;
+  }
+
+  if ( FreeSession==0 ) {
+    TPStatistics.NoFreeSession++;
+  } else if ( Active>TPStatistics.MaxActiveSessions ) {
+    TPStatistics.MaxActiveSessions=Active;
+  }
+
+  return FreeSession;
+}
+
+//*****************************************************************************
+void UpdateTPStatistics(tN2kTPStatistics::tDirection &Stat, const tN2kTPSession &Session, bool Completed, bool TimedOut) {
+  if ( Completed ) {
+    Stat.Completed++;
+    Stat.Bytes+=Session.CANMsg.N2kMsg.DataLen;
+    Stat.Time+=N2kMillis()-Session.StartTime;
+  } else if ( TimedOut ) {
+    Stat.TimedOut++;
+  } else {
+    Stat.Aborted++;
+  }
+}
+
+//*****************************************************************************
+void tNMEA2000::EndTPSession(tN2kTPSession &Session, bool Completed, bool TimedOut) {
+  UpdateTPStatistics((Session.IsRx()?TPStatistics.Rx:TPStatistics.Tx),Session,Completed,TimedOut);
+  Session.Free();
+}
+
+//*****************************************************************************
+bool tNMEA2000::SendTPCM_BAM(tN2kTPSession &Session) {
   if ( !IsActiveNode() ) return false;
 
   tN2kMsg N2kMsg;
 
-  N2kMsg.Source=Devices[iDev].N2kSource;
+  N2kMsg.Source=Devices[Session.iDev].N2kSource;
   N2kMsg.Destination=0xff;
   N2kMsg.SetPGN(TP_CM);
   N2kMsg.Priority=6;
   N2kMsg.AddByte(TP_CM_BAM);
-  int nBytes=Devices[iDev].PendingTPMsg.DataLen;
-  N2kMsg.Add2ByteUInt(nBytes);
-  N2kMsg.AddByte(nBytes/7+(nBytes%7!=0?1:0));
+  N2kMsg.Add2ByteUInt(Session.CANMsg.N2kMsg.DataLen);
+  N2kMsg.AddByte(Session.nPackets);
   N2kMsg.AddByte(0xff); // Reserved;
-  N2kMsg.Add3ByteInt(Devices[iDev].PendingTPMsg.PGN);
-  return SendMsg(N2kMsg,iDev);
+  N2kMsg.Add3ByteInt(Session.PGN());
+  return SendMsg(N2kMsg,Session.iDev);
 }
 
 //*****************************************************************************
-bool tNMEA2000::SendTPCM_RTS(int iDev) {
+bool tNMEA2000::SendTPCM_RTS(tN2kTPSession &Session) {
   if ( !IsActiveNode() ) return false;
 
   tN2kMsg N2kMsg;
-  N2kMsg.Source=Devices[iDev].N2kSource;
-  N2kMsg.Destination=Devices[iDev].PendingTPMsg.Destination;
+  N2kMsg.Source=Devices[Session.iDev].N2kSource;
+  N2kMsg.Destination=Session.CANMsg.N2kMsg.Destination;
   N2kMsg.SetPGN(TP_CM);
   N2kMsg.Priority=6;
   N2kMsg.AddByte(TP_CM_RTS);
-  int nBytes=Devices[iDev].PendingTPMsg.DataLen;
-  N2kMsg.Add2ByteUInt(nBytes);
-  N2kMsg.AddByte(nBytes/7+(nBytes%7!=0?1:0));
-  N2kMsg.AddByte(0xff); // Reserved;
-  N2kMsg.Add3ByteInt(Devices[iDev].PendingTPMsg.PGN);
-  return SendMsg(N2kMsg,iDev);
+  N2kMsg.Add2ByteUInt(Session.CANMsg.N2kMsg.DataLen);
+  N2kMsg.AddByte(Session.nPackets);
+  N2kMsg.AddByte(0xff); // No limit for packets per CTS
+  N2kMsg.Add3ByteInt(Session.PGN());
+  return SendMsg(N2kMsg,Session.iDev);
 }
 
 unsigned char TPCtsPackets(unsigned char nPackets) { return tNMEA2000::N2kMax<unsigned char>(1,tNMEA2000::N2kMin<unsigned char>(nPackets,TP_MAX_FRAMES)); }
@@ -1786,36 +1881,36 @@ void tNMEA2000::SendTPCM_Abort(unsigned long PGN, unsigned char Destination, int
 
 //*****************************************************************************
 // Caller should take care of not calling this after all has been done.
-// Use HasAllTPDTSent for checking.
-bool tNMEA2000::SendTPDT(int iDev) {
+// Use tN2kTPSession::IsComplete for checking.
+bool tNMEA2000::SendTPDT(tN2kTPSession &Session) {
   tN2kMsg N2kMsg;
-  N2kMsg.Source=Devices[iDev].N2kSource;
-  N2kMsg.Destination=Devices[iDev].PendingTPMsg.Destination;
+  N2kMsg.Source=Devices[Session.iDev].N2kSource;
+  N2kMsg.Destination=Session.CANMsg.N2kMsg.Destination;
   N2kMsg.SetPGN(TP_DT);
   N2kMsg.Priority=6;
-  N2kMsg.AddByte(Devices[iDev].NextDTSequence+1);
-  int iByteToSend=Devices[iDev].NextDTSequence*7;
+  N2kMsg.AddByte(Session.PacketsDone+1);
+  int iByteToSend=Session.PacketsDone*7;
   for ( int i=0; i<7; i++,iByteToSend++ ) {
-    if ( iByteToSend<Devices[iDev].PendingTPMsg.DataLen ) {
-      N2kMsg.AddByte(Devices[iDev].PendingTPMsg.Data[iByteToSend]);
+    if ( iByteToSend<Session.CANMsg.N2kMsg.DataLen ) {
+      N2kMsg.AddByte(Session.CANMsg.N2kMsg.Data[iByteToSend]);
     } else N2kMsg.AddByte(0xff);
   }
-  Devices[iDev].NextDTSequence++;
 
-  return SendMsg(N2kMsg,iDev);
-}
+  if ( !SendMsg(N2kMsg,Session.iDev) ) return false;
 
-//*****************************************************************************
-bool tNMEA2000::HasAllTPDTSent(int iDev) {
-  return ( Devices[iDev].NextDTSequence*7>=Devices[iDev].PendingTPMsg.DataLen );
+  Session.PacketsDone++;
+  return true;
 }
 
 //*****************************************************************************
 bool tNMEA2000::TestHandleTPMessage(unsigned long PGN, unsigned char Source, unsigned char Destination,
                                     unsigned char len, unsigned char *buf,
-                                    uint8_t &MsgIndex) {
-  MsgIndex=MaxN2kCANMsgs;
+                                    tN2kCANMsg *&ReadyMsg) {
+  ReadyMsg=0;
+  if ( PGN!=TP_CM && PGN!=TP_DT ) return false;
+
   int iDev=FindSourceDeviceIndex(Destination);
+  tN2kTPSession *Session;
 
   if ( PGN==TP_CM ) {
     unsigned char TP_CM_Control=buf[0];
@@ -1829,166 +1924,195 @@ bool tNMEA2000::TestHandleTPMessage(unsigned long PGN, unsigned char Source, uns
         Index=1;
         uint16_t nBytes=GetBuf2ByteUInt(Index,buf);
         uint8_t TPMaxPackets=buf[Index++];
-        //Index++; // reserved
+        bool RespondCTS=( (TP_CM_Control==TP_CM_RTS) && (iDev>=0) ); // If it was for us and not broadcast, we need to response
+
+        // New announce from same sender replaces previous session
+        Session=FindTPSession(true,Source,Destination);
+        if ( Session!=0 ) {
+          EndTPSession(*Session,false);
+        } else {
+          Session=GetFreeTPSession();
+        }
 
-        FindFreeCANMsgIndex(TransportPGN,Source,Destination,true,MsgIndex);
+        if ( Session==0 ) { // No free session
+          N2kMsgDbgStart("No free TP session"); N2kMsgDbgln();
+          if ( RespondCTS ) SendTPCM_Abort(TransportPGN,Source,iDev,TP_CM_AbortBusy);
+          break;
+        }
 
-        if (MsgIndex==MaxN2kCANMsgs) { // No free msg place
-          N2kMsgDbgStart("No free msg slot"); N2kMsgDbgln();
-          if ( (TP_CM_Control==TP_CM_RTS) && (iDev>=0) ) { // If it was for us and not broadcast, we need to abort transport
-            SendTPCM_Abort(TransportPGN,Source,iDev,TP_CM_AbortBusy);
-          }
-        } else { // Start transport
-          N2kMsgDbgStart("Use msg slot: "); N2kMsgDbgln(MsgIndex);
-          bool FastPacket;
-          N2kCANMsgBuf[MsgIndex].KnownMessage=CheckKnownMessage(TransportPGN,N2kCANMsgBuf[MsgIndex].SystemMessage,FastPacket);
-          if ( nBytes < tN2kMsg::MaxDataLen &&  // Currently we can handle only tN2kMsg::MaxDataLen long messages
-               (N2kCANMsgBuf[MsgIndex].KnownMessage || !HandleOnlyKnownMessages()) ) {
-            N2kCANMsgBuf[MsgIndex].FreeMsg=false;
-            N2kCANMsgBuf[MsgIndex].N2kMsg.Init(7 /* Priority? */,TransportPGN,Source,Destination);
-            N2kCANMsgBuf[MsgIndex].CopiedLen=0;
-            N2kCANMsgBuf[MsgIndex].LastFrame=0;
-            N2kCANMsgBuf[MsgIndex].N2kMsg.DataLen=nBytes;
-            N2kCANMsgBuf[MsgIndex].N2kMsg.SetIsTPMessage();
-            N2kCANMsgBuf[MsgIndex].TPMaxPackets=TPMaxPackets;
-            if ( (TP_CM_Control==TP_CM_RTS) && (iDev>=0) ) { // If it was for us and not broadcast, we need to response
-              SendTPCM_CTS(TransportPGN,Source,iDev,N2kCANMsgBuf[MsgIndex].TPMaxPackets,N2kCANMsgBuf[MsgIndex].LastFrame+1);
-              N2kCANMsgBuf[MsgIndex].TPRequireCTS=TPCtsPackets(N2kCANMsgBuf[MsgIndex].TPMaxPackets);
-            } else {
-              N2kCANMsgBuf[MsgIndex].TPMaxPackets=0xff; // TPMaxPackets>0 indicates that it is TP message
-            }
-          } else { // Too long or unknown
-            if ( (TP_CM_Control==TP_CM_RTS) && (iDev>=0) ) { // If it was for us and not broadcast, we need to response
-              SendTPCM_Abort(TransportPGN,Source,iDev,TP_CM_AbortBusy);  // Abort
-            }
+        bool FastPacket;
+        bool SystemMessage;
+        bool KnownMessage=CheckKnownMessage(TransportPGN,SystemMessage,FastPacket);
+        if ( nBytes < tN2kMsg::MaxDataLen &&  // Currently we can handle only tN2kMsg::MaxDataLen long messages
+             (KnownMessage || !HandleOnlyKnownMessages()) ) {
+          Session->CANMsg.N2kMsg.Init(7 /* Priority? */,TransportPGN,Source,Destination);
+          Session->CANMsg.N2kMsg.DataLen=nBytes;
+          Session->Start((TP_CM_Control==TP_CM_BAM?tN2kTPSession::tpst_RxBAM:tN2kTPSession::tpst_RxRTS),iDev,nBytes);
+          Session->CANMsg.KnownMessage=KnownMessage;
+          Session->CANMsg.SystemMessage=SystemMessage;
+          TPStatistics.Rx.Started++;
+          if ( RespondCTS ) {
+            Session->MaxPackets=TPCtsPackets(TPMaxPackets);
+            Session->WindowEnd=N2kMin<uint8_t>(Session->MaxPackets,Session->nPackets);
+            SendTPCM_CTS(TransportPGN,Source,iDev,Session->WindowEnd,1);
+            Session->Timer.FromNow(TP_TIMEOUT_T2);
+          } else { // BAM or RTS/CTS between other devices. We just listen data.
+            Session->MaxPackets=0;
+            Session->WindowEnd=Session->nPackets;
+            Session->Timer.FromNow(TP_TIMEOUT_T1);
           }
+        } else { // Too long or unknown
+          if ( RespondCTS ) SendTPCM_Abort(TransportPGN,Source,iDev,TP_CM_AbortBusy);
         }
         break;
       }
-      case TP_CM_CTS:
-        if ( !IsValidDevice(iDev) ) break; // Should never fail
-        N2kMsgDbgStart("Got TP CTS"); N2kMsgDbgln(MsgIndex);
-        if ( IsBroadcast(Devices[iDev].PendingTPMsg.Destination) ) break; // We should not get controls for broadcast TP msg
-        if ( Devices[iDev].PendingTPMsg.PGN!=TransportPGN ) { // Some failure on communication
-          EndSendTPMessage(iDev); // Should we retry from beginning?
+      case TP_CM_CTS: {
+        if ( iDev<0 ) break; // CTS between other devices
+        Session=FindTPSession(false,Destination,Source);
+        if ( Session==0 || Session->IsBAM() ) break; // We should not get controls for broadcast TP msg
+        N2kMsgDbgStart("Got TP CTS"); N2kMsgDbgln(TransportPGN);
+        if ( Session->PGN()!=TransportPGN ) { // Some failure on communication
+          EndTPSession(*Session,false);
           break;
         }
-        // Now respond with next data packets
-        if ( buf[1]>0 ) { // Note that with 0, receiver wants to have break
-          if ( buf[2]-1!=Devices[iDev].NextDTSequence ) { // We got sequence error
-            EndSendTPMessage(iDev); // Should we retry from beginning?
-            break;
-          }
-          uint8_t MaxTPSequences=buf[1];
-          bool TPDTResult=true;
-          for ( uint8_t iSeq=0; TPDTResult &&iSeq<MaxTPSequences && !HasAllTPDTSent(iDev); iSeq++ ) TPDTResult&=SendTPDT(iDev);
-          if ( !TPDTResult ) EndSendTPMessage(iDev);
+        if ( buf[1]==0 ) { // Receiver wants to have break
+          Session->Timer.FromNow(TP_TIMEOUT_T4);
+          break;
         }
-        Devices[iDev].NextDTSendTime.FromNow(100); // Set timeout for next response
+        // Receiver may request retransmit of packets already sent, but not skip packets
+        if ( buf[2]==0 || buf[2]>Session->PacketsDone+1 || buf[2]>Session->nPackets ) {
+          SendTPCM_Abort(TransportPGN,Source,iDev,TP_CM_AbortBadSequence);
+          EndTPSession(*Session,false);
+          break;
+        }
+        Session->PacketsDone=buf[2]-1;
+        Session->WindowEnd=N2kMin<int>(Session->PacketsDone+buf[1],Session->nPackets);
+        bool TPDTResult=true;
+        while ( TPDTResult && Session->PacketsDone<Session->WindowEnd ) TPDTResult=SendTPDT(*Session);
+        if ( !TPDTResult ) {
+          SendTPCM_Abort(TransportPGN,Source,iDev,TP_CM_AbortNoResources);
+          EndTPSession(*Session,false);
+          break;
+        }
+        Session->Timer.FromNow(TP_TIMEOUT_T3); // Set timeout for next response
         break;
+      }
       case TP_CM_ACK:
-        if ( !IsValidDevice(iDev) ) break; // Should never fail
-        N2kMsgDbgStart("Got TP ACK"); N2kMsgDbgln(MsgIndex);
-        if ( IsBroadcast(Devices[iDev].PendingTPMsg.Destination) ) break; // We should not get controls for broadcast TP msg
-        EndSendTPMessage(iDev);
+        if ( iDev<0 ) break;
+        Session=FindTPSession(false,Destination,Source);
+        if ( Session==0 || Session->IsBAM() ) break; // We should not get controls for broadcast TP msg
+        N2kMsgDbgStart("Got TP ACK"); N2kMsgDbgln(TransportPGN);
+        EndTPSession(*Session,Session->IsComplete());
         break;
       case TP_CM_Abort:
-        if ( !IsValidDevice(iDev) ) break; // Should never fail
-        N2kMsgDbgStart("Got TP Abort"); N2kMsgDbgln(MsgIndex);
-        if ( IsBroadcast(Devices[iDev].PendingTPMsg.Destination) ) break; // We should not get controls for broadcast TP msg
-        EndSendTPMessage(iDev);
+        N2kMsgDbgStart("Got TP Abort"); N2kMsgDbgln(TransportPGN);
+        // Abort can come from receiver of our message or from either side of
+        // message we are receiving.
+        Session=FindTPSession(false,Destination,Source);
+        if ( Session==0 ) Session=FindTPSession(true,Source,Destination);
+        if ( Session==0 ) Session=FindTPSession(true,Destination,Source);
+        if ( Session!=0 && !Session->IsBAM() ) EndTPSession(*Session,false);
         break;
       default:
         ;
     }
-    MsgIndex=MaxN2kCANMsgs;  // After TP_CM, message is newer ready.
     return true;
-  } else if ( PGN==TP_DT ) { // Datapacket
-    N2kMsgDbgStart("Got TP data"); N2kMsgDbgln(MsgIndex);
-    // So we need to find TP msg which sender and destination matches.
-    for (MsgIndex=0;
-         MsgIndex<MaxN2kCANMsgs &&
-         !( !N2kCANMsgBuf[MsgIndex].FreeMsg
-            && N2kCANMsgBuf[MsgIndex].N2kMsg.IsTPMessage()
-            && N2kCANMsgBuf[MsgIndex].N2kMsg.Destination==Destination
-            && N2kCANMsgBuf[MsgIndex].N2kMsg.Source==Source
-          );
-         MsgIndex++);
-    // if (MsgIndex==MaxN2kCANMsgs) N2kMsgDbgln("TP data msg not found");
-    // for (int i=1; i<len; i++) N2kMsgDbgln(buf[i]);
-    if (MsgIndex<MaxN2kCANMsgs) { // found TP message under reception
-      N2kMsgDbgStart("Use msg slot: "); N2kMsgDbgln(MsgIndex);
-      if (N2kCANMsgBuf[MsgIndex].LastFrame+1 == buf[0]) { // Right packet is coming
-        // Add packet to the message
-        CopyBufToCANMsg(N2kCANMsgBuf[MsgIndex],1,len,buf);
-        N2kCANMsgBuf[MsgIndex].LastFrame=buf[0];
-        // Transport protocol is slower, so to avoid timeout, we reset message time
-        N2kCANMsgBuf[MsgIndex].N2kMsg.MsgTime=N2kMillis();
-        if ( N2kCANMsgBuf[MsgIndex].CopiedLen>=N2kCANMsgBuf[MsgIndex].N2kMsg.DataLen ) { // all done
-          N2kCANMsgBuf[MsgIndex].Ready=true;
-          if ( N2kCANMsgBuf[MsgIndex].TPRequireCTS>0 && iDev>=0 ) { // send response
-            SendTPCM_EndAck(N2kCANMsgBuf[MsgIndex].N2kMsg.PGN,Source,iDev,N2kCANMsgBuf[MsgIndex].N2kMsg.DataLen,N2kCANMsgBuf[MsgIndex].LastFrame);
-          }
-        } else {
-          if ( N2kCANMsgBuf[MsgIndex].TPRequireCTS>0 && ((N2kCANMsgBuf[MsgIndex].LastFrame)%N2kCANMsgBuf[MsgIndex].TPRequireCTS)==0 ) { // send response
-            SendTPCM_CTS(N2kCANMsgBuf[MsgIndex].N2kMsg.PGN,Source,iDev,N2kCANMsgBuf[MsgIndex].TPMaxPackets,N2kCANMsgBuf[MsgIndex].LastFrame+1);
-          }
-        }
-      } else { // Wrong packet - either we lost packet or sender sends wrong, so free this
-        N2kMsgDbgStart("Invalid packet: "); N2kMsgDbgln(buf[0]);
-        if ( N2kCANMsgBuf[MsgIndex].TPRequireCTS>0 && iDev>=0 ) { // We need to abort transport
-          SendTPCM_Abort(N2kCANMsgBuf[MsgIndex].N2kMsg.PGN,Source,iDev,TP_CM_AbortTimeout);  // Abort transport
-        }
-        N2kCANMsgBuf[MsgIndex].FreeMessage();
+  }
 
+  // Datapacket
+  N2kMsgDbgStart("Got TP data"); N2kMsgDbgln(buf[0]);
+  Session=FindTPSession(true,Source,Destination);
+  if ( Session==0 || Session->CANMsg.Ready ) return true; // Orphan packet
+
+  if ( buf[0]==Session->PacketsDone+1 && buf[0]<=Session->WindowEnd ) { // Right packet is coming
+    // Add packet to the message
+    CopyBufToCANMsg(Session->CANMsg,1,len,buf);
+    Session->PacketsDone++;
+    Session->CANMsg.LastFrame=buf[0];
+    Session->CANMsg.N2kMsg.MsgTime=N2kMillis();
+    Session->CANMsg.N2kMsg.MsgTimeUs=CANFrameTimeUs;
+    if ( Session->CANMsg.CopiedLen>=Session->CANMsg.N2kMsg.DataLen ) { // all done
+      if ( Session->MaxPackets>0 ) { // send response
+        SendTPCM_EndAck(Session->PGN(),Source,iDev,Session->CANMsg.N2kMsg.DataLen,Session->PacketsDone);
       }
-      if ( !N2kCANMsgBuf[MsgIndex].Ready ) MsgIndex=MaxN2kCANMsgs;
+      UpdateTPStatistics(TPStatistics.Rx,*Session,true,false);
+      Session->Timer.Disable();
+      Session->CANMsg.Ready=true;
+      ReadyMsg=&(Session->CANMsg); // Session will be free, when caller frees message.
+    } else if ( Session->MaxPackets>0 && Session->PacketsDone==Session->WindowEnd ) { // send response
+      Session->WindowEnd=N2kMin<int>(Session->PacketsDone+Session->MaxPackets,Session->nPackets);
+      SendTPCM_CTS(Session->PGN(),Source,iDev,Session->WindowEnd-Session->PacketsDone,Session->PacketsDone+1);
+      Session->Timer.FromNow(TP_TIMEOUT_T2);
+    } else {
+      Session->Timer.FromNow(TP_TIMEOUT_T1);
+    }
+  } else if ( buf[0]<=Session->PacketsDone ) { // Duplicate packet, just skip
+    N2kMsgDbgStart("Duplicate packet: "); N2kMsgDbgln(buf[0]);
+  } else { // Lost packet or sender sends wrong, so end session
+    N2kMsgDbgStart("Invalid packet: "); N2kMsgDbgln(buf[0]);
+    if ( Session->MaxPackets>0 ) { // We need to abort transport
+      SendTPCM_Abort(Session->PGN(),Source,iDev,TP_CM_AbortBadSequence);
     }
-    return true; // We handled message
+    EndTPSession(*Session,false);
   }
 
-  return false;
+  return true; // We handled message
 }
 
 //*****************************************************************************
 bool tNMEA2000::StartSendTPMessage(const tN2kMsg& msg, int iDev) {
   if ( !IsValidDevice(iDev) ) return false;
 
-  if ( Devices[iDev].PendingTPMsg.PGN!=0 ) return false; // No room for sending TP message
+  if ( FindTPSession(false,msg.Source,msg.Destination)!=0 ) return false; // Previous session to same destination still running
 
-  int result=false;
+  tN2kTPSession *Session=GetFreeTPSession();
+  if ( Session==0 ) return false; // No room for sending TP message
 
-  Devices[iDev].HasPendingInformation=true;
-  Devices[iDev].PendingTPMsg=msg;
-  Devices[iDev].NextDTSequence=0;
-  Devices[iDev].NextDTSendTime.FromNow(50);
-  if ( IsBroadcast(msg.Destination) ) { // Start with BAM
-    result=SendTPCM_BAM(iDev);
+  bool result=false;
+  bool Broadcast=IsBroadcast(msg.Destination);
+
+  Session->CANMsg.N2kMsg=msg;
+  Session->Start((Broadcast?tN2kTPSession::tpst_TxBAM:tN2kTPSession::tpst_TxRTS),iDev,msg.DataLen);
+  TPStatistics.Tx.Started++;
+  if ( Broadcast ) { // Start with BAM
+    result=SendTPCM_BAM(*Session);
+    Session->Timer.FromNow(TP_BAM_PACKET_INTERVAL);
   } else {
-    result=SendTPCM_RTS(iDev);
+    result=SendTPCM_RTS(*Session);
+    Session->Timer.FromNow(TP_TIMEOUT_T3);
   }
 
-  if ( !result ) EndSendTPMessage(iDev); // Currently no retry
+  if ( !result ) EndTPSession(*Session,false); // Currently no retry
 
   return result;
 }
 
 //*****************************************************************************
-void tNMEA2000::EndSendTPMessage(int iDev) {
-  Devices[iDev].PendingTPMsg.Clear();
-  Devices[iDev].NextDTSendTime.Disable();
-  Devices[iDev].UpdateHasPendingInformation();
-}
+void tNMEA2000::HandleTPSessionTimers() {
+  if ( TPSessions==0 ) return;
 
-//*****************************************************************************
-void tNMEA2000::SendPendingTPMessage(int iDev) {
-  if ( Devices[iDev].PendingTPMsg.PGN!=0 && Devices[iDev].NextDTSendTime.IsTime() ) { // Pending message and timed out
-    if ( IsBroadcast(Devices[iDev].PendingTPMsg.Destination) ) { // For broadcast we just send next data
-      SendTPDT(iDev);
-      Devices[iDev].NextDTSendTime.FromNow(50);
-      if ( HasAllTPDTSent(iDev) ) EndSendTPMessage(iDev); // All done
-    } else { // We have not got response from receiver within timeout, so just end. Or should we retry?
-      EndSendTPMessage(iDev);
+  for (int i=0; i<MaxTPSessions; i++) {
+    tN2kTPSession &Session=TPSessions[i];
+    if ( Session.IsFree() || !Session.Timer.IsTime() ) continue;
+
+    switch ( Session.Type ) {
+      case tN2kTPSession::tpst_TxBAM: // For broadcast we just send next data
+        SendTPDT(Session); // On failure we retry same packet next time
+        if ( Session.IsComplete() ) {
+          EndTPSession(Session,true); // All done
+        } else {
+          Session.Timer.FromNow(TP_BAM_PACKET_INTERVAL);
+        }
+        break;
+      case tN2kTPSession::tpst_TxRTS: // We have not got response from receiver within timeout
+        SendTPCM_Abort(Session.PGN(),Session.CANMsg.N2kMsg.Destination,Session.iDev,TP_CM_AbortTimeout);
+        EndTPSession(Session,false,true);
+        break;
+      default: // Receiving timed out
+        if ( Session.MaxPackets>0 ) {
+          SendTPCM_Abort(Session.PGN(),Session.CANMsg.N2kMsg.Source,Session.iDev,TP_CM_AbortTimeout);
+        }
+        EndTPSession(Session,false,true);
     }
   }
 }
@@ -2000,9 +2124,9 @@ inline bool IsFastPacketFirstFrame(unsigned char b) { return ((b & 0x1F)==0); }
 
 //*****************************************************************************
 // Function handles received CAN frame and adds it to tN2kCANMsg.
-// Returns: Index to ready tN2kCANMsg or MaxN2kCANMsgs, if we skipped the frame
+// Returns: Pointer to ready tN2kCANMsg or 0, if we skipped the frame
 //          or message is not ready (fast packet or ISO Multi-Packet)
-uint8_t tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf) {
+tN2kCANMsg *tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf) {
   unsigned char Priority;
   unsigned long PGN;
   unsigned char Source;
@@ -2014,7 +2138,8 @@ uint8_t tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsig
 
     CanIdToN2k(canId,Priority,PGN,Source,Destination);
 #if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-    if ( !TestHandleTPMessage(PGN,Source,Destination,len,buf,MsgIndex) )
+    tN2kCANMsg *TPMsg;
+    if ( TestHandleTPMessage(PGN,Source,Destination,len,buf,TPMsg) ) return TPMsg;
 #endif
     {
       KnownMessage=CheckKnownMessage(PGN,SystemMessage,FastPacket);
@@ -2026,9 +2151,6 @@ uint8_t tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsig
                MsgIndex<MaxN2kCANMsgs &&
                !( N2kCANMsgBuf[MsgIndex].N2kMsg.PGN==PGN
                   && N2kCANMsgBuf[MsgIndex].N2kMsg.Source==Source
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-                  && !N2kCANMsgBuf[MsgIndex].N2kMsg.IsTPMessage()
-#endif
                 );
                MsgIndex++);
           if (MsgIndex<MaxN2kCANMsgs) { // we found start for this message, so add data to it.
@@ -2047,11 +2169,7 @@ uint8_t tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsig
               N2kFrameErrDbg(Source); N2kFrameErrDbg(" for: "); N2kFrameErrDbgln(PGN);
           }
         } else { // Handle first frame
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-          FindFreeCANMsgIndex(PGN,Source,Destination,false,MsgIndex);
-#else
           FindFreeCANMsgIndex(PGN,Source,Destination,MsgIndex);
-#endif
           if ( MsgIndex<MaxN2kCANMsgs ) { // we found free place, so handle frame
             N2kMsgDbgStart("Use msg slot: "); N2kMsgDbgln(MsgIndex);
             N2kCANMsgBuf[MsgIndex].FreeMsg=false;
@@ -2077,13 +2195,14 @@ uint8_t tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsig
         }
 
         if ( MsgIndex<MaxN2kCANMsgs ) {
+          N2kCANMsgBuf[MsgIndex].N2kMsg.MsgTimeUs=CANFrameTimeUs; // Message time is time of the last frame
           N2kCANMsgBuf[MsgIndex].Ready=(N2kCANMsgBuf[MsgIndex].CopiedLen>=N2kCANMsgBuf[MsgIndex].N2kMsg.DataLen);
           if ( !N2kCANMsgBuf[MsgIndex].Ready ) MsgIndex=MaxN2kCANMsgs; // If packet is not ready, do not return index to it
         }
       }
     }
 
-    return MsgIndex;
+    return (MsgIndex<MaxN2kCANMsgs?&(N2kCANMsgBuf[MsgIndex]):0);
 }
 
 //*****************************************************************************
@@ -2574,29 +2693,29 @@ void tNMEA2000::GetNextAddress(int DeviceIndex, bool RestartAtEnd) {
 }
 
 //*****************************************************************************
-bool tNMEA2000::HandleReceivedSystemMessage(int MsgIndex) {
+bool tNMEA2000::HandleReceivedSystemMessage(const tN2kCANMsg &CANMsg) {
   bool result=false;
 
    if ( N2kMode==N2km_SendOnly || N2kMode==N2km_ListenAndSend ) return result;
 
-    if ( N2kCANMsgBuf[MsgIndex].SystemMessage ) {
-      if ( ForwardSystemMessages() ) ForwardMessage(N2kCANMsgBuf[MsgIndex].N2kMsg);
+    if ( CANMsg.SystemMessage ) {
+      if ( ForwardSystemMessages() ) ForwardMessage(CANMsg.N2kMsg);
       if ( N2kMode!=N2km_ListenOnly ) { // Note that in listen only mode we will not inform us to the bus
-        switch (N2kCANMsgBuf[MsgIndex].N2kMsg.PGN) {
+        switch (CANMsg.N2kMsg.PGN) {
           case 59392L: /*ISO Acknowledgement*/
             break;
           case 59904L: /*ISO Request*/
-            HandleISORequest(N2kCANMsgBuf[MsgIndex].N2kMsg);
+            HandleISORequest(CANMsg.N2kMsg);
             break;
           case 60928L: /*ISO Address Claim*/
-            HandleISOAddressClaim(N2kCANMsgBuf[MsgIndex].N2kMsg);
+            HandleISOAddressClaim(CANMsg.N2kMsg);
             break;
           case 65240L: /*Commanded Address*/
-            HandleCommandedAddress(N2kCANMsgBuf[MsgIndex].N2kMsg);
+            HandleCommandedAddress(CANMsg.N2kMsg);
             break;
 #if !defined(N2K_NO_GROUP_FUNCTION_SUPPORT)
           case 126208L: /*NMEA Request/Command/Acknowledge group function*/
-            HandleGroupFunction(N2kCANMsgBuf[MsgIndex].N2kMsg);
+            HandleGroupFunction(CANMsg.N2kMsg);
             break;
 #endif
         }
@@ -2611,8 +2730,8 @@ bool tNMEA2000::HandleReceivedSystemMessage(int MsgIndex) {
 void tNMEA2000::ParseMessages() {
     unsigned long canId;
     unsigned char len = 0;
-    unsigned char buf[8];
-    uint8_t MsgIndex;
+    unsigned char buf[N2K_MAX_CAN_FRAME_DATA_LEN];
+    tN2kCANMsg *CANMsg;
     static const int MaxReadFramesOnParse=20;
     int FramesRead=0;
 //    tN2kMsg N2kMsg;
@@ -2624,30 +2743,51 @@ void tNMEA2000::ParseMessages() {
     if (dbMode != dm_None) return; // No much to do here, when in Debug mode
 
     SendFrames();
-    SendPendingInformation();
+    // Timers are handled only, when some of them has expired. Any expired
+    // timer runs all timed work, so work delayed by state (e.g. address claim
+    // in progress) will be retried on next timer event.
+    if ( TimerWheel.Run(N2kMillis64())>0 ) {
+      SendPendingInformation();
+#if !defined(N2K_NO_HEARTBEAT_SUPPORT)
+      SendHeartbeat();
+#endif
+      RunHandlerTimers();
+    }
 #if defined(DEBUG_NMEA2000_ISR)
     TestISR();
 #endif
 
-    while (FramesRead<MaxReadFramesOnParse && CANGetFrame(canId,len,buf) ) {           // check if data coming
+    while (FramesRead<MaxReadFramesOnParse && CANGetFrame(canId,len,buf,CANFrameTimeUs) ) {           // check if data coming
         FramesRead++;
         N2kMsgDbgStart("Received frame, can ID:"); N2kMsgDbg(canId); N2kMsgDbg(" len:"); N2kMsgDbg(len); N2kMsgDbg(" data:"); DbgPrintBuf(len,buf,false); N2kMsgDbgln();
-        MsgIndex=SetN2kCANBufMsg(canId,len,buf);
-        if (MsgIndex<MaxN2kCANMsgs) {
-          if ( !HandleReceivedSystemMessage(MsgIndex) ) {
-            N2kMsgDbgStart(" - Non system message, MsgIndex: "); N2kMsgDbgln(MsgIndex);
-            ForwardMessage(N2kCANMsgBuf[MsgIndex]);
+        CANMsg=SetN2kCANBufMsg(canId,len,buf);
+        if (CANMsg!=0) {
+          if ( !HandleReceivedSystemMessage(*CANMsg) ) {
+            N2kMsgDbgStart(" - Non system message, PGN: "); N2kMsgDbgln(CANMsg->N2kMsg.PGN);
+            ForwardMessage(*CANMsg);
           }
-//          N2kCANMsgBuf[MsgIndex].N2kMsg.Print(Serial);
-          RunMessageHandlers(N2kCANMsgBuf[MsgIndex].N2kMsg);
-          N2kCANMsgBuf[MsgIndex].FreeMessage();
-          N2kMsgDbgStart(" - Free message, MsgIndex: "); N2kMsgDbg(MsgIndex); N2kMsgDbgln();
+//          CANMsg->N2kMsg.Print(Serial);
+          RunMessageHandlers(CANMsg->N2kMsg);
+          N2kMsgDbgStart(" - Free message, PGN: "); N2kMsgDbg(CANMsg->N2kMsg.PGN); N2kMsgDbgln();
+          CANMsg->FreeMessage();
         }
     }
+}
 
-#if !defined(N2K_NO_HEARTBEAT_SUPPORT)
-    SendHeartbeat();
-#endif
+//*****************************************************************************
+uint32_t tNMEA2000::GetTimeToNextEvent() {
+  if ( OpenState==os_Open && dbMode!=dm_None ) return N2kNoEvent;
+  uint64_t Next=TimerWheel.GetNextExpires();
+  if ( Next==N2kScheduler64Disabled ) return N2kNoEvent;
+
+  uint64_t Now=N2kMillis64();
+  if ( Next<=Now ) return 0;
+  return ( Next-Now<N2kNoEvent?(uint32_t)(Next-Now):N2kNoEvent-1 );
+}
+
+//*****************************************************************************
+void tNMEA2000::RunHandlerTimers() {
+  for (tMsgHandler *MsgHandler=MsgHandlers; MsgHandler!=0; MsgHandler=MsgHandler->pNext) MsgHandler->HandleTimers();
 }
 
 //*****************************************************************************
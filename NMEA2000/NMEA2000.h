@@ -51,6 +51,10 @@
 #include "N2kMsg.h"
 #include "N2kCANMsg.h"
 #include "N2kTimer.h"
+#include "N2kTimerWheel.h"
+#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
+#include "N2kTPSession.h"
+#endif
 
 #if !defined(N2K_NO_GROUP_FUNCTION_SUPPORT)
 #include "N2kGroupFunction.h"
@@ -106,6 +110,14 @@
 #define N2kMaxCanBusAddress 251
 /** \brief Null Address (???)*/
 #define N2kNullCanBusAddress 254
+/** \brief Returned by tNMEA2000::GetTimeToNextEvent, when there is no pending event */
+#define N2kNoEvent 0xffffffffUL
+/** \brief Max data length of CAN frame handled by the library. Define as 64
+ * for drivers, which can carry fast packets on CAN FD frames.
+ * \sa tNMEA2000::SetCANFrameDataLen */
+#ifndef N2K_MAX_CAN_FRAME_DATA_LEN
+#define N2K_MAX_CAN_FRAME_DATA_LEN 8
+#endif
 
 /************************************************************************//**
  * \class tNMEA2000
@@ -628,6 +640,14 @@ public:
        * \param N2kMsg Reference to a N2kMsg Object
        */
       virtual void HandleMsg(const tN2kMsg &N2kMsg)=0;
+      /*******************************************************************//**
+       * \brief Handles expired timers
+       *
+       * Called from \ref tNMEA2000::ParseMessages, when a timer on the
+       * timer wheel of the tNMEA2000 object has expired. Handler with own
+       * tN2kWheelScheduler timers on that wheel does its timed work here.
+       */
+      virtual void HandleTimers() {}
       /** \brief Returns the tNMEA2000 object of this handler
        * \return  tNMEA2000   */
       tNMEA2000 *GetNMEA2000() { return pNMEA2000; }
@@ -786,16 +806,16 @@ protected:
     char *ManufacturerSerialCode;
     /** \brief Timestamp set while last \ref tNMEA2000::SendIsoAddressClaim 
      * was executed*/
-    tN2kScheduler PendingIsoAddressClaim;
+    tN2kWheelScheduler PendingIsoAddressClaim;
     /** \brief Timestamp set while last \ref tNMEA2000::SendProductInformation 
      * was executed*/
-    tN2kScheduler PendingProductInformation;
+    tN2kWheelScheduler PendingProductInformation;
     /** \brief Timestamp set while last \ref 
      * tNMEA2000::SendConfigurationInformation was executed */
-    tN2kScheduler PendingConfigurationInformation;
+    tN2kWheelScheduler PendingConfigurationInformation;
     /** \brief Timer value for AddressClaim
     */
-    tN2kScheduler AddressClaimTimer;
+    tN2kWheelScheduler AddressClaimTimer;
     /** \brief Pointer to a buffer that holds all supported transmit
      * PGNs for this device*/
     const unsigned long *TransmitMessages;
@@ -811,19 +831,11 @@ protected:
     /** \brief internal device has pending information*/
     bool HasPendingInformation;
 
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-      /** \brief Pending N2k message */
-      tN2kMsg PendingTPMsg;
-      /** \brief Timestamp, when next data packet can be send on TP broadcast*/
-      tN2kScheduler NextDTSendTime; 
-      /** \brief Next Sequence*/
-      uint8_t NextDTSequence;
-#endif
 #if !defined(N2K_NO_HEARTBEAT_SUPPORT)
 	/** \brief Interval for Heartbeat */
     #define DefaultHeartbeatInterval 60000
     /** \brief Scheduler for the heartbeat message */
-    tN2kSyncScheduler HeartbeatScheduler;
+    tN2kWheelSyncScheduler HeartbeatScheduler;
     /** \brief Heartbeat Sequence */
     uint8_t HeartbeatSequence;
 #endif
@@ -841,9 +853,6 @@ protected:
       AddressClaimEndSource=N2kMaxCanBusAddress; //GetNextAddressFromBeginning=true;
       TransmitMessages=0; ReceiveMessages=0;
       PGNSequenceCounters=0; MaxPGNSequenceCounters=0;
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-      NextDTSequence=0;
-#endif
 
 #if !defined(N2K_NO_HEARTBEAT_SUPPORT)
       HeartbeatSequence=0;
@@ -912,6 +921,19 @@ protected:
      * \retval false 
      */
     bool QueryPendingConfigurationInformation() { return PendingConfigurationInformation.IsTime(); }
+    /*********************************************************************//**
+     * \brief Attach device timers to timer wheel
+     * \param Wheel   Timer wheel of tNMEA2000 object
+     */
+    void AttachTimers(tN2kTimerWheel *Wheel) {
+      PendingIsoAddressClaim.Attach(Wheel);
+      PendingProductInformation.Attach(Wheel);
+      PendingConfigurationInformation.Attach(Wheel);
+      AddressClaimTimer.Attach(Wheel);
+#if !defined(N2K_NO_HEARTBEAT_SUPPORT)
+      HeartbeatScheduler.Attach(Wheel);
+#endif
+    }
     /*********************************************************************//**
      * \brief Updates \ref AddressClaimEndSource 
      */
@@ -922,11 +944,7 @@ protected:
     void UpdateHasPendingInformation() {
       HasPendingInformation=  PendingIsoAddressClaim.IsEnabled()
                             || PendingProductInformation.IsEnabled()
-                            || PendingConfigurationInformation.IsEnabled()
-                            #if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-                            || NextDTSendTime.IsEnabled()
-                            #endif
-                            ;
+                            || PendingConfigurationInformation.IsEnabled();
     }
   };
 
@@ -962,8 +980,10 @@ protected:
     /** \brief  Pointer to a buffer for Message Handlers*/
     tMsgHandler *MsgHandlers;
 
+    /** \brief Timer wheel for all library timers */
+    tN2kTimerWheel TimerWheel;
     /** Open the Scheduler */
-    tN2kScheduler OpenScheduler;
+    tN2kWheelScheduler OpenScheduler;
     /** State of the .... */
     tOpenState OpenState;
     /** \brief  Flag that the address has changed */
@@ -997,13 +1017,13 @@ protected:
       /** \brief  Length of carried data of the CAN Message*/
       unsigned char len;
       /** \brief  Data payload for the CAN Message*/
-      unsigned char buf[8];
+      unsigned char buf[N2K_MAX_CAN_FRAME_DATA_LEN];
       /** \brief  Has the CAN Message to wait before sending*/
       bool wait_sent;
 
     public:
       /** Clears all the fields of the CAN Message */
-      void Clear() {id=0; len=0; for (int i=0; i<8; i++) { buf[i]=0; } }
+      void Clear() {id=0; len=0; for (int i=0; i<N2K_MAX_CAN_FRAME_DATA_LEN; i++) { buf[i]=0; } }
     };
 
 protected:
@@ -1019,6 +1039,27 @@ protected:
      * - \ref tNMEA2000::SetN2kCANMsgBufSize()
      */
     uint8_t MaxN2kCANMsgs;
+    /** \brief Receive timestamp of the frame being handled
+     * \sa \ref tNMEA2000::CANGetFrame(unsigned long&,unsigned char&,unsigned char*,uint64_t&)
+     */
+    uint64_t CANFrameTimeUs;
+    /** \brief Data length of frames used for fast packet messages
+     * \sa \ref tNMEA2000::SetCANFrameDataLen
+     */
+    unsigned char CANFrameDataLen;
+
+#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
+    /** \brief Pool of ISO TP sessions
+     * \sa
+     *  - \ref MaxTPSessions
+     *  - \ref tNMEA2000::SetTPSessionPoolSize()
+    */
+    tN2kTPSession *TPSessions;
+    /** \brief Size of TPSessions pool */
+    uint8_t MaxTPSessions;
+    /** \brief ISO TP session statistics */
+    tN2kTPStatistics TPStatistics;
+#endif
 
     /** \brief Buffer for library send out CAN frames
      * 
@@ -1133,6 +1174,42 @@ protected:
      * \retval false  Nothing read. 
      */
     virtual bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf)=0;
+
+    /*********************************************************************//**
+     * \brief Read frame from driver class with its receive timestamp.
+     *
+     * Drivers, which can timestamp frames on receive (e.g. kernel or
+     * hardware timestamps), should override this function. The timestamp
+     * is carried to \ref tN2kMsg::MsgTimeUs of the message completed by the
+     * frame. Default implementation calls \ref CANGetFrame without timestamp.
+     *
+     * \param id      CAN id of the frame
+     * \param len     Length of the frame
+     * \param buf     Frame data
+     * \param TimeUs  Receive time in us since the Unix epoch, 0 if not available
+     *
+     * \retval true   New frame read from buffer.
+     * \retval false  Nothing read.
+     */
+    virtual bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs) {
+      TimeUs=0;
+      return CANGetFrame(id,len,buf);
+    }
+
+    /*********************************************************************//**
+     * \brief Set data length of frames used for fast packet messages
+     *
+     * Driver, which has opened CAN FD interface, can set this to 64. Fast
+     * packet messages are then sent in up to 64 byte frames (62 data bytes
+     * on first and 63 on next frames), so e.g. 129029 fits one frame.
+     * Single frame and ISO TP messages are not affected. Receiving handles
+     * any frame length up to \ref N2K_MAX_CAN_FRAME_DATA_LEN.
+     *
+     * \param len  Frame data length, 8 for classic CAN
+     */
+    void SetCANFrameDataLen(unsigned char len) {
+      CANFrameDataLen=( len>N2K_MAX_CAN_FRAME_DATA_LEN ? N2K_MAX_CAN_FRAME_DATA_LEN : (len<8 ? 8 : len) );
+    }
     
     /*********************************************************************//**
      * \brief Initialize CAN Frame buffers
@@ -1233,24 +1310,6 @@ protected:
      */
     bool IsInitialized() { return (N2kCANMsgBuf!=0); }
 
-#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
-    /*********************************************************************//**
-     * \brief Find index for free space for a message on \ref N2kCANMsgBuf
-     *
-     * This functions searches for free space at \ref N2kCANMsgBuf. If 
-     * there is free space in buffer or there is a message with the 
-     * same, source, PGN and destination at the buffer the corresponding
-     * Index is returned. If this is not the case, the Index of the oldest
-     * message inside the buffer is returned.
-     * 
-     * \param PGN           PNG for the message
-     * \param Source        Source address of the message 
-     * \param Destination   Destination of the message
-     * \param TPMsg         Message is Multi Packet message
-     * \param MsgIndex      Index 
-     */
-    void FindFreeCANMsgIndex(unsigned long PGN, unsigned char Source, unsigned char Destination, bool TPMsg, uint8_t &MsgIndex);
-#else
     /*********************************************************************//**
      * \brief Find index for free space for a message on \ref N2kCANMsgBuf
      *
@@ -1266,21 +1325,21 @@ protected:
      * \param MsgIndex      Index 
      */
     void FindFreeCANMsgIndex(unsigned long PGN, unsigned char Source, unsigned char Destination, uint8_t &MsgIndex);
-#endif
     /*********************************************************************//**
      * \brief Function handles received CAN frame and adds it to tN2kCANMsg
      *  
-     * This function returns Index to a ready \ref tN2kCANMsg on buffer
-     * \ref N2kCANMsgBuf (max \ref MaxN2kCANMsgs), 
+     * This function returns pointer to a ready \ref tN2kCANMsg either on
+     * buffer \ref N2kCANMsgBuf or on ISO TP session buffer. It returns 0,
      * if we skipped the frame or message is not ready (fast packet or 
-     * ISO Multi-Packet)
+     * ISO Multi-Packet). Caller must free ready message with
+     * tN2kCANMsg::FreeMessage after handling it.
      * 
      * \param canId     ID of CAN message
      * \param len       length of payload
      * \param buf       buffer for payload of message
-     * \return uint8_t  -> Index of the CAN message on \ref N2kCANMsgBuf
+     * \return tN2kCANMsg*  -> Ready message or 0
      */
-    uint8_t SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf);
+    tN2kCANMsg *SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf);
 
     /*********************************************************************//**
      * \brief Check if this PNG is a fast packet message
@@ -1339,11 +1398,11 @@ protected:
      *  - \ref HandleCommandedAddress
      *  - \ref HandleCommandedAddress
      * 
-     * \param MsgIndex  Message Index on \ref N2kCANMsgBuf
+     * \param CANMsg    Received message
      * \retval true    message was handled
      * \retval false 
      */
-    bool HandleReceivedSystemMessage(int MsgIndex);
+    bool HandleReceivedSystemMessage(const tN2kCANMsg &CANMsg);
 
     /*********************************************************************//**
      * \brief Forwards a N2k message
@@ -1558,6 +1617,13 @@ protected:
      */
     void RunMessageHandlers(const tN2kMsg &N2kMsg);
 
+    /*********************************************************************//**
+     * \brief Run timed work of all message handlers
+     *
+     * Called when a timer on the timer wheel has expired.
+     */
+    void RunHandlerTimers();
+
     /*********************************************************************//**
      * \brief Should received message be handled depending on the destination
      *        of the received message
@@ -1611,41 +1677,66 @@ protected:
     /*********************************************************************//**
      * \brief ISO Transport Protocol handlers for multi packet support
      * 
+     * Handles TP.CM and TP.DT frames for all sessions. When incoming
+     * session has been completed, ReadyMsg will point to session message
+     * buffer.
+     * 
      * \param PGN           PGN 
      * \param Source        Source address 
      * \param Destination   Destination address
      * \param len           length of the data payload
      * \param buf           pointer to a byte buffer for the 
-     * \param MsgIndex      MsgIndex for \ref N2kCANMsgBuf
+     * \param ReadyMsg      Completed message or 0
      * 
-     * \retval true 
+     * \retval true        Frame was TP frame and has been handled
      * \retval false 
      */
     bool TestHandleTPMessage(unsigned long PGN, unsigned char Source, unsigned char Destination,
                              unsigned char len, unsigned char *buf,
-                             uint8_t &MsgIndex);
+                             tN2kCANMsg *&ReadyMsg);
+
+    /*********************************************************************//**
+     * \brief Find active ISO TP session
+     *
+     * BAM sessions are identified by sender only and RTS/CTS sessions
+     * by sender and receiver.
+     *
+     * \param Rx            Find incoming (true) or outgoing session
+     * \param Source        Source address of the transferred message
+     * \param Destination   Destination address of the transferred message
+     *
+     * \return tN2kTPSession* -> Session or 0, if not found
+     */
+    tN2kTPSession *FindTPSession(bool Rx, unsigned char Source, unsigned char Destination);
+
+    /*********************************************************************//**
+     * \brief Get free ISO TP session from pool
+     *
+     * \return tN2kTPSession* -> Free session or 0, if pool is full
+     */
+    tN2kTPSession *GetFreeTPSession();
 
     /*********************************************************************//**
      * \brief   Send ISO Transport Protocol message BAM
      * 
      * This is used for Broadcast messages
      *
-     * \param iDev    index of the device on \ref Devices
+     * \param Session   TP session
      * 
      * \retval true 
      * \retval false 
      */
-    bool SendTPCM_BAM(int iDev);
+    bool SendTPCM_BAM(tN2kTPSession &Session);
 
     /*********************************************************************//**
      * \brief   Send ISO Transport Protocol message RTS
      *
-     * \param iDev    index of the device on \ref Devices
+     * \param Session   TP session
      * 
      * \retval true 
      * \retval false 
      */
-    bool SendTPCM_RTS(int iDev);
+    bool SendTPCM_RTS(tN2kTPSession &Session);
 
     /*********************************************************************//**
      * \brief   Send ISO Transport Protocol message CTS
@@ -1684,29 +1775,21 @@ protected:
      * \brief Send ISO Transport Protocol data packet
      *
      * \note Caller should take care of not calling this after all has been 
-     *        done. Use \ref HasAllTPDTSent for checking.
+     *        done. Use \ref tN2kTPSession::IsComplete for checking.
      * 
-     * \param iDev    index of the device on \ref Devices
+     * \param Session   TP session
      * 
      * \retval true   Message was send successful
      * \retval false 
      */
-    bool SendTPDT(int iDev);
-
-    /*********************************************************************//**
-     * \brief Check if all data bytes of the multi packet message has been send 
-     *        successful
-     *
-     * \param iDev    index of the device on \ref Devices
-     * 
-     * \retval true 
-     * \retval false 
-     */
-    bool HasAllTPDTSent(int iDev);
+    bool SendTPDT(tN2kTPSession &Session);
 
     /*********************************************************************//**
      * \brief Start sending an ISO-TP message
      *
+     * Message will be sent on own session. Start fails, if there is already
+     * session from same device to same destination or session pool is full.
+     *
      * \param msg     Reference to a N2kMsg Object
      * \param iDev    index of the device on \ref Devices
      * 
@@ -1716,18 +1799,21 @@ protected:
     bool StartSendTPMessage(const tN2kMsg& msg, int iDev);
 
     /*********************************************************************//**
-     * \brief Ends sending of ISO-TP message
+     * \brief Ends ISO-TP session and updates statistics
      *
-     * \param iDev    index of the device on \ref Devices
+     * \param Session     TP session
+     * \param Completed   Session was completed successfully
+     * \param TimedOut    Session ended due to timeout
      */
-    void EndSendTPMessage(int iDev);
+    void EndTPSession(tN2kTPSession &Session, bool Completed, bool TimedOut=false);
 
     /*********************************************************************//**
-     * \brief Send pending ISO-TP Messages
+     * \brief Run ISO-TP session timers
      *
-     * \param iDev    index of the device on \ref Devices
+     * Sends next BAM data packets, when pacing time has elapsed, and
+     * handles session timeouts.
      */
-    void SendPendingTPMessage(int iDev);
+    void HandleTPSessionTimers();
 #endif
 #if !defined(N2K_NO_GROUP_FUNCTION_SUPPORT)
     /*********************************************************************//**
@@ -1815,6 +1901,29 @@ public:
      */
     void SetN2kCANMsgBufSize(const uint8_t _MaxN2kCANMsgs) { if (N2kCANMsgBuf==0) { MaxN2kCANMsgs=_MaxN2kCANMsgs; }; }
 
+#if !defined(N2K_NO_ISO_MULTI_PACKET_SUPPORT)
+    /*********************************************************************//**
+     * \brief Set ISO TP session pool size.
+     *
+     * Each ISO TP transfer, incoming or outgoing, uses one session from
+     * the pool. Several displays may request e.g. product information or
+     * PGN lists at same time during boot, so there should be enough sessions
+     * for all concurrent transfers. The default size is 8.
+     *
+     * Function has to be called before communication opens. See \ref tNMEA2000::Open().
+     *
+     * \param _MaxTPSessions  Number of concurrent TP sessions
+     */
+    void SetTPSessionPoolSize(const uint8_t _MaxTPSessions) { if (TPSessions==0) { MaxTPSessions=_MaxTPSessions; }; }
+
+    /*********************************************************************//**
+     * \brief Get ISO TP session statistics
+     *
+     * \return const tN2kTPStatistics&
+     */
+    const tN2kTPStatistics &GetTPStatistics() const { return TPStatistics; }
+#endif
+
     /*********************************************************************//**
      * \brief Set CAN send frame buffer size.
      * 
@@ -2712,6 +2821,54 @@ public:
      * See example TemperatureMonitor.ino.
      */
     void ParseMessages();
+
+    /*********************************************************************//**
+     * \brief Get time to next library event
+     *
+     * All library timers (pending information, address claim, heartbeat,
+     * ISO TP sessions) are kept on one timer wheel. Event driven application
+     * can sleep this time or until next frame arrives before calling
+     * \ref ParseMessages again.
+     *
+     * Frames waiting on library send buffer are not included. Application
+     * should check \ref HasPendingFrames and call \ref SendPendingFrames,
+     * when CAN driver can accept frames again.
+     *
+     * \return Time in ms to next event, 0 if ParseMessages should be called
+     *         immediately or \ref N2kNoEvent, if there is no pending event.
+     */
+    uint32_t GetTimeToNextEvent();
+
+    /*********************************************************************//**
+     * \brief Check are there frames waiting on library send buffer
+     *
+     * \retval true   Frames could not be sent and are waiting for driver.
+     * \retval false  Send buffer is empty.
+     */
+    bool HasPendingFrames() const { return CANSendFrameBuf!=0 && CANSendFrameBufferRead!=CANSendFrameBufferWrite; }
+
+    /*********************************************************************//**
+     * \brief Send frames waiting on library send buffer
+     *
+     * \retval true   All frames has been sent.
+     * \retval false  Driver could not accept all frames.
+     */
+    bool SendPendingFrames() { return SendFrames(); }
+
+    /*********************************************************************//**
+     * \brief Get data length of frames used for fast packet messages
+     *
+     * \return 8 for classic CAN, up to 64 on CAN FD
+     */
+    unsigned char GetCANFrameDataLen() const { return CANFrameDataLen; }
+
+    /*********************************************************************//**
+     * \brief Get timer wheel used by library
+     *
+     * Application can schedule own tN2kWheelScheduler timers on the same
+     * wheel. Wheel must be accessed only from thread calling ParseMessages.
+     */
+    tN2kTimerWheel &GetTimerWheel() { return TimerWheel; }
     
     /*********************************************************************//**
      * \brief Set OnOpen callback function
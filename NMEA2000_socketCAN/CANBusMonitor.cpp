@@ -0,0 +1,186 @@
+/*
+CANBusMonitor.cpp
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+Bus state, error counters and bus load for a socketCAN port.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "CANBusMonitor.h"
+
+#include <string.h>
+#include <linux/can/error.h>
+
+
+//*****************************************************************************
+tCANBusMonitor::tCANBusMonitor(uint32_t BitRate)
+    : bitRate(BitRate), state(bs_ErrorActive), txErrors(0), rxErrors(0), lastErrorMs(0), currentSlot(0)
+{
+    memset(&counters, 0, sizeof(counters));
+    memset(slotBits, 0, sizeof(slotBits));
+}
+
+
+//*****************************************************************************
+//  Extended data frame is 67 + 8*len bits including inter frame space.
+//  54 + 8*len of those are stuffed, worst case one stuff bit per 4 bits.
+//  Real data is rarely worst case, so half of that is counted.  CAN FD data
+//  is counted at the nominal bit rate, so FD load is over estimated.
+void tCANBusMonitor::AddFrame(unsigned char len, uint64_t nowMs) {
+    if (len > CANFD_MAX_DLEN)
+        len = CANFD_MAX_DLEN;
+
+    Advance(nowMs);
+    slotBits[currentSlot % Slots] += 67 + 8 * len + (54 + 8 * len - 1) / 8;
+}
+
+
+//*****************************************************************************
+uint8_t tCANBusMonitor::GetBusLoad(uint32_t windowMs, uint64_t nowMs) {
+    uint32_t slots = windowMs / SlotMs;
+    if (slots == 0)
+        slots = 1;
+    if (slots > Slots - 1)
+        slots = Slots - 1;
+
+    Advance(nowMs);
+    uint64_t bits = 0;
+    for (uint32_t i = 1; i <= slots; i++)                                       // skip the slot being filled
+        bits += slotBits[(currentSlot - i) % Slots];
+
+    uint64_t load = bits * 100 / ((uint64_t)bitRate * slots * SlotMs / 1000);
+    return (load > 100) ? 100 : (uint8_t)load;
+}
+
+
+//*****************************************************************************
+void tCANBusMonitor::Advance(uint64_t nowMs) {
+    uint64_t slot = nowMs / SlotMs;
+    if (slot <= currentSlot)
+        return;
+
+    uint64_t steps = slot - currentSlot;
+    if (steps > Slots)
+        steps = Slots;
+    for (uint64_t i = 1; i <= steps; i++)                                       // clear the slots we skipped over
+        slotBits[(currentSlot + i) % Slots] = 0;
+
+    currentSlot = slot;
+}
+
+
+//*****************************************************************************
+//  Bus off is left only on CAN_ERR_RESTARTED, the controller does not send
+//  while it is off.
+void tCANBusMonitor::FrameSent(uint64_t nowMs) {
+    if (state == bs_ErrorActive || state == bs_BusOff)
+        return;
+
+    if (nowMs - lastErrorMs >= RecoveryMs)
+        SetState(bs_ErrorActive);
+}
+
+
+//*****************************************************************************
+void tCANBusMonitor::HandleErrorFrame(const struct can_frame &frame, uint64_t nowMs) {
+    counters.ErrorFrames++;
+    lastErrorMs = nowMs;
+    bool stateReported = false;
+
+    if (frame.can_id & CAN_ERR_LOSTARB)
+        counters.ArbitrationLost++;
+    if (frame.can_id & (CAN_ERR_PROT | CAN_ERR_BUSERROR))
+        counters.ProtocolErrors++;
+    if (frame.can_id & CAN_ERR_ACK)
+        counters.AckErrors++;
+    if (frame.can_id & CAN_ERR_TX_TIMEOUT)
+        counters.TxTimeouts++;
+
+    if (frame.can_id & CAN_ERR_CRTL) {
+        uint8_t ctrl = frame.data[1];
+        if (ctrl & (CAN_ERR_CRTL_RX_OVERFLOW | CAN_ERR_CRTL_TX_OVERFLOW))
+            counters.RxOverflows++;
+        stateReported = true;
+        if (ctrl & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE))
+            SetState(bs_ErrorPassive);
+        else if (ctrl & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING))
+            SetState(bs_ErrorWarning);
+#ifdef CAN_ERR_CRTL_ACTIVE
+        else if (ctrl & CAN_ERR_CRTL_ACTIVE)
+            SetState(bs_ErrorActive);
+#endif
+        else
+            stateReported = false;
+        }
+
+    if (frame.can_id & CAN_ERR_BUSOFF)
+        SetState(bs_BusOff);
+
+    if (frame.can_id & CAN_ERR_RESTARTED) {
+        counters.Restarts++;
+        SetState(bs_ErrorActive);
+        }
+
+#ifdef CAN_ERR_CNT
+    if (frame.can_id & CAN_ERR_CNT) {                                           // controller reports its error counters
+        txErrors = frame.data[6];
+        rxErrors = frame.data[7];
+        if (!stateReported && state != bs_BusOff) {                             // ISO 11898 limits 96 and 128
+            uint8_t errors = (txErrors > rxErrors) ? txErrors : rxErrors;
+            if (errors >= 128)
+                SetState(bs_ErrorPassive);
+            else if (errors >= 96)
+                SetState(bs_ErrorWarning);
+            else
+                SetState(bs_ErrorActive);
+            }
+        }
+#endif
+}
+
+
+//*****************************************************************************
+void tCANBusMonitor::SetState(tBusState newState) {
+    if (newState == state)
+        return;
+
+    switch (newState) {
+        case bs_ErrorWarning:   counters.ErrorWarning++;    break;
+        case bs_ErrorPassive:   counters.ErrorPassive++;    break;
+        case bs_BusOff:         counters.BusOff++;          break;
+        default:                                            break;
+        }
+    state = newState;
+}
+
+
+//*****************************************************************************
+const char *tCANBusMonitor::BusStateName(tBusState s) {
+    switch (s) {
+        case bs_ErrorActive:    return "error active";
+        case bs_ErrorWarning:   return "error warning";
+        case bs_ErrorPassive:   return "error passive";
+        case bs_BusOff:         return "bus off";
+        }
+    return "unknown";
+}
@@ -0,0 +1,114 @@
+/*
+CANBusMonitor.h
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+Bus state, error counters and bus load for a socketCAN port.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+The driver feeds every frame it sends or receives and every error frame
+(CAN_RAW_ERR_FILTER) into the monitor.  Bus load is estimated from frame
+sizes, so it also works on controllers which do not report it.
+
+Not every controller reports its way back to error active.  The state is
+also taken from the error counters when the controller reports them, and
+error warning or error passive return to error active when frames are
+sent after RecoveryMs without an error frame.
+*/
+
+#ifndef CANBUSMONITOR_H_
+#define CANBUSMONITOR_H_
+
+#include <stdint.h>
+#include <linux/can.h>
+
+//-----------------------------------------------------------------------------
+class tCANBusMonitor
+{
+public:
+    // Controller state, ordered by severity
+    enum tBusState {
+        bs_ErrorActive = 0,
+        bs_ErrorWarning,
+        bs_ErrorPassive,
+        bs_BusOff
+    };
+
+    struct tErrorCounters {
+        uint32_t ErrorFrames;       // error frames received
+        uint32_t ErrorWarning;      // transitions to error warning
+        uint32_t ErrorPassive;      // transitions to error passive
+        uint32_t BusOff;            // transitions to bus off
+        uint32_t Restarts;          // controller restarts after bus off
+        uint32_t ArbitrationLost;
+        uint32_t ProtocolErrors;    // bit, form and stuff errors
+        uint32_t AckErrors;         // no ack, usually we are alone on the bus
+        uint32_t RxOverflows;       // controller or rx buffer overflow
+        uint32_t TxTimeouts;
+    };
+
+    // Bus load is kept in 100ms slots for the last 10s
+    static const uint32_t SlotMs = 100;
+    static const uint32_t Slots = 100;
+
+    // Quiet time before a frame sent returns the state to error active
+    static const uint32_t RecoveryMs = 1000;
+
+protected:
+    uint32_t bitRate;
+    tBusState state;
+    tErrorCounters counters;
+    uint8_t txErrors;               // controller tx error counter, if reported
+    uint8_t rxErrors;               // controller rx error counter, if reported
+    uint64_t lastErrorMs;           // time of the last error frame
+
+    uint32_t slotBits[Slots];
+    uint64_t currentSlot;           // absolute slot number of newest slot
+
+    void Advance(uint64_t nowMs);
+    void SetState(tBusState newState);
+
+public:
+    tCANBusMonitor(uint32_t BitRate = 250000);
+
+    // Count a data frame sent or received at nowMs
+    void AddFrame(unsigned char len, uint64_t nowMs);
+
+    // Count a frame the driver accepted for sending at nowMs
+    void FrameSent(uint64_t nowMs);
+
+    // Update state and counters from an error frame received at nowMs
+    void HandleErrorFrame(const struct can_frame &frame, uint64_t nowMs);
+
+    // Bus load in percent over the last windowMs (rounded to slots, max 10s).
+    // The slot being filled is not included.
+    uint8_t GetBusLoad(uint32_t windowMs, uint64_t nowMs);
+
+    tBusState GetBusState() const { return state; }
+    const tErrorCounters &GetErrorCounters() const { return counters; }
+    uint8_t GetTxErrorCount() const { return txErrors; }
+    uint8_t GetRxErrorCount() const { return rxErrors; }
+
+    static const char *BusStateName(tBusState s);
+};
+
+#endif /* CANBUSMONITOR_H_ */
@@ -0,0 +1,278 @@
+/*
+CANRecorder.cpp
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+Records the CAN frames sent and received on a socketCAN port.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "CANRecorder.h"
+
+#include <stdio.h>
+#include <iostream>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/can.h>
+#include <algorithm>
+
+using namespace std;
+
+
+//*****************************************************************************
+tCANRecorder::tCANRecorder()
+    : files(0), fileCount(0), fileSize(0), current(0), used(0), generation(0)
+{
+    memset(interface, 0, sizeof(interface));
+}
+
+
+//*****************************************************************************
+tCANRecorder::~tCANRecorder() {
+    Close();
+}
+
+
+//*****************************************************************************
+//  Files are sized and allocated up front and mapped with MAP_POPULATE, so
+//  recording a frame never extends a file or waits for a block allocation.
+bool tCANRecorder::Open(const char *Dir, const char *Name, const char *Interface, uint32_t FileCount, uint32_t FileSize) {
+    Close();
+    if (FileCount == 0 || FileSize < 4096) {
+        cerr << "CAN capture needs at least one file of 4096 bytes" << endl;
+        return false;
+        }
+
+    files = new tCaptureFile[FileCount];
+    fileCount = FileCount;
+    fileSize = FileSize;
+    for (uint32_t i = 0; i < fileCount; i++) {
+        files[i].map = 0;
+        files[i].header = 0;
+        }
+    strncpy(interface, Interface, sizeof(interface) - 1);
+
+    bool found = false;
+    uint32_t newest = 0;
+    for (uint32_t i = 0; i < fileCount; i++) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s_%u.n2c", Dir, Name, i);
+
+        int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            cerr << "Failed to open CAN capture file " << path << endl;
+            Close();
+            return false;
+            }
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size != (off_t)fileSize) {
+            int err = (ftruncate(fd, fileSize) < 0) ? errno : posix_fallocate(fd, 0, fileSize);
+            if (err != 0) {
+                cerr << "Failed to allocate CAN capture file " << path << ": " << strerror(err) << endl;
+                close(fd);
+                Close();
+                return false;
+                }
+            }
+
+        void *map = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        close(fd);                                                              // the mapping keeps the file
+        if (map == MAP_FAILED) {
+            cerr << "Failed to map CAN capture file " << path << endl;
+            Close();
+            return false;
+            }
+        files[i].map = (unsigned char *)map;
+        files[i].header = (tCANCaptureHeader *)map;
+
+        const tCANCaptureHeader *header = files[i].header;
+        if (memcmp(header->Magic, CAN_CAPTURE_MAGIC, sizeof(header->Magic)) == 0
+            && (!found || (int32_t)(header->Generation - generation) > 0)) {
+            found = true;
+            newest = i;
+            generation = header->Generation;
+            }
+        }
+
+    if (!found)
+        generation = 0;
+    current = newest;
+    StartFile(found ? (newest + 1) % fileCount : 0, NowUs());
+    return true;
+}
+
+
+//*****************************************************************************
+void tCANRecorder::Close() {
+    if (files == 0)
+        return;
+
+    for (uint32_t i = 0; i < fileCount; i++) {
+        if (files[i].map != 0) {
+            msync(files[i].map, fileSize, MS_SYNC);
+            munmap(files[i].map, fileSize);
+            }
+        }
+    delete[] files;
+    files = 0;
+}
+
+
+//*****************************************************************************
+//  The file is marked empty before its header is rewritten, so a reader
+//  never takes the old records for part of the new generation.  The file
+//  just filled is handed to the kernel to write back.
+void tCANRecorder::StartFile(uint32_t index, uint64_t nowUs) {
+    if (index != current && files[current].map != 0)
+        msync(files[current].map, fileSize, MS_ASYNC);
+
+    current = index;
+    generation++;
+    tCANCaptureHeader *header = files[current].header;
+    __atomic_store_n(&header->Used, 0, __ATOMIC_RELEASE);
+    memcpy(header->Magic, CAN_CAPTURE_MAGIC, sizeof(header->Magic));
+    header->Generation = generation;
+    header->StartUs = nowUs;
+    memcpy(header->Interface, interface, sizeof(header->Interface));
+
+    used = sizeof(tCANCaptureHeader);
+    __atomic_store_n(&header->Used, used, __ATOMIC_RELEASE);
+}
+
+
+//*****************************************************************************
+uint64_t tCANRecorder::NowUs() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return ((uint64_t)now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+
+//*****************************************************************************
+tCANCaptureReader::tCANCaptureReader() : fileIndex(0), position(0), corrupt(false) {
+}
+
+
+//*****************************************************************************
+tCANCaptureReader::~tCANCaptureReader() {
+    Close();
+}
+
+
+//*****************************************************************************
+bool tCANCaptureReader::Open(const char *const *FileNames, int Count) {
+    Close();
+    for (int i = 0; i < Count; i++) {
+        int fd = open(FileNames[i], O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            cerr << "Failed to open CAN capture file " << FileNames[i] << endl;
+            continue;
+            }
+
+        struct stat st;
+        void *map = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(tCANCaptureHeader))
+            map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            cerr << "Failed to read CAN capture file " << FileNames[i] << endl;
+            continue;
+            }
+
+        const tCANCaptureHeader *header = (const tCANCaptureHeader *)map;
+        if (memcmp(header->Magic, CAN_CAPTURE_MAGIC, sizeof(header->Magic)) != 0) {
+            cerr << FileNames[i] << " is not a CAN capture file" << endl;
+            munmap(map, st.st_size);
+            continue;
+            }
+
+        tCaptureFile file = { (const unsigned char *)map, (size_t)st.st_size, header->Generation };
+        files.push_back(file);
+        }
+
+    sort(files.begin(), files.end(), IsOlder);
+    fileIndex = 0;
+    position = sizeof(tCANCaptureHeader);
+    return !files.empty();
+}
+
+
+//*****************************************************************************
+void tCANCaptureReader::Close() {
+    for (size_t i = 0; i < files.size(); i++)
+        munmap((void *)files[i].map, files[i].size);
+    files.clear();
+    fileIndex = 0;
+    corrupt = false;
+}
+
+
+//*****************************************************************************
+//  Used is read from the header each time, so a capture still being
+//  written is read up to its last complete record.
+bool tCANCaptureReader::Next(tCANCaptureRecord &Record, const unsigned char *&Data) {
+    while (fileIndex < files.size()) {
+        const tCaptureFile &file = files[fileIndex];
+        const tCANCaptureHeader *header = (const tCANCaptureHeader *)file.map;
+        size_t used = __atomic_load_n(&header->Used, __ATOMIC_ACQUIRE);
+        if (used > file.size)
+            used = file.size;
+
+        if (position + sizeof(tCANCaptureRecord) <= used) {
+            memcpy(&Record, file.map + position, sizeof(Record));
+            if (Record.Len <= CANFD_MAX_DLEN && position + sizeof(Record) + Record.Len <= used) {
+                Data = file.map + position + sizeof(Record);
+                position += sizeof(Record) + Record.Len;
+                return true;
+                }
+            corrupt = true;
+            }
+
+        fileIndex++;
+        position = sizeof(tCANCaptureHeader);
+        }
+    return false;
+}
+
+
+//*****************************************************************************
+const char *tCANCaptureReader::GetInterface(char *Buf, size_t Size) const {
+    if (Size == 0)
+        return Buf;
+
+    Buf[0] = '\0';
+    size_t index = (fileIndex < files.size()) ? fileIndex : files.size() - 1;
+    if (index < files.size()) {
+        const tCANCaptureHeader *header = (const tCANCaptureHeader *)files[index].map;
+        size_t len = strnlen(header->Interface, sizeof(header->Interface));
+        if (len >= Size)
+            len = Size - 1;
+        memcpy(Buf, header->Interface, len);
+        Buf[len] = '\0';
+        }
+    return Buf;
+}
@@ -0,0 +1,168 @@
+/*
+CANRecorder.h
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+Records the CAN frames sent and received on a socketCAN port.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+The capture is a set of preallocated files, <Name>_<n>.n2c, which are
+memory mapped and written in turn.  When the last file is full the oldest
+is started again, so the set holds the most recent traffic and the disk
+use is fixed.  Recording a frame is a copy into the mapping, the kernel
+writes the pages back in the background.
+
+The recorder is not thread safe, it must be used from the thread doing the
+CAN I/O (the reactor thread of the bus).  tCANCaptureReader reads a set
+back in time order, Tools/CANCaptureExport.cpp uses it to turn a capture
+into candump log text (candump -l) and tNMEA2000_Replay to replay it.
+*/
+
+#ifndef CANRECORDER_H_
+#define CANRECORDER_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include <vector>
+
+#define CAN_CAPTURE_MAGIC "N2CCAP01"
+
+//-----------------------------------------------------------------------------
+//  File layout.  The header is followed by the records, Used is written
+//  after each record, so a file from a crash is read up to the last
+//  complete record.  Numbers are little endian.
+struct tCANCaptureHeader {
+    char     Magic[8];          // CAN_CAPTURE_MAGIC
+    uint32_t Generation;        // increases each time a file is started, orders the set
+    uint32_t Used;              // bytes used including this header
+    uint64_t StartUs;           // time the file was started, us since epoch
+    char     Interface[16];     // CAN port
+};
+
+struct tCANCaptureRecord {
+    uint64_t TimeUs;            // kernel receive time or send time, us since epoch
+    uint32_t CANId;             // socketCAN id, with CAN_EFF_FLAG and CAN_ERR_FLAG
+    uint8_t  Len;               // data bytes following the record
+    uint8_t  Flags;             // tCANCaptureFlags
+} __attribute__((packed));
+
+enum tCANCaptureFlags {
+    ccf_Tx  = 0x01,             // sent by us, otherwise received
+    ccf_FD  = 0x02,             // CAN FD frame
+    ccf_BRS = 0x04              // CAN FD bit rate switch
+};
+
+//-----------------------------------------------------------------------------
+class tCANRecorder
+{
+public:
+    static const uint32_t DefaultFileCount = 4;
+    static const uint32_t DefaultFileSize = 16 * 1024 * 1024;
+
+protected:
+    struct tCaptureFile {
+        unsigned char *map;
+        tCANCaptureHeader *header;
+    };
+
+    tCaptureFile *files;
+    uint32_t fileCount;
+    uint32_t fileSize;
+    uint32_t current;           // file being written
+    uint32_t used;              // bytes used in the current file
+    uint32_t generation;
+    char     interface[16];
+
+    void StartFile(uint32_t index, uint64_t nowUs);
+
+public:
+    tCANRecorder();
+    ~tCANRecorder();
+
+    // Opens, creating and preallocating as needed, Dir/Name_<n>.n2c for
+    // n = 0..FileCount-1.  Recording continues after the newest file
+    // already in the set.
+    bool Open(const char *Dir, const char *Name, const char *Interface,
+              uint32_t FileCount = DefaultFileCount, uint32_t FileSize = DefaultFileSize);
+    void Close();
+    bool IsOpen() const { return files != 0; }
+
+    // Record one frame, Flags from tCANCaptureFlags
+    void Record(uint64_t TimeUs, uint32_t CANId, uint8_t Len, const unsigned char *Data, uint8_t Flags) {
+        uint32_t size = sizeof(tCANCaptureRecord) + Len;
+        if (files == 0)
+            return;
+        if (used + size > fileSize)
+            StartFile((current + 1) % fileCount, TimeUs);
+
+        unsigned char *p = files[current].map + used;
+        tCANCaptureRecord rec = { TimeUs, CANId, Len, Flags };
+        memcpy(p, &rec, sizeof(rec));
+        memcpy(p + sizeof(rec), Data, Len);
+        used += size;
+        __atomic_store_n(&files[current].header->Used, used, __ATOMIC_RELEASE);
+        }
+
+    // current time in us since epoch, for frames without a kernel time
+    static uint64_t NowUs();
+};
+
+//-----------------------------------------------------------------------------
+class tCANCaptureReader
+{
+protected:
+    struct tCaptureFile {
+        const unsigned char *map;
+        size_t size;
+        uint32_t generation;
+    };
+
+    std::vector<tCaptureFile> files;
+    size_t fileIndex;           // file being read
+    size_t position;            // next record in it
+    bool corrupt;
+
+    static bool IsOlder(const tCaptureFile &a, const tCaptureFile &b) {
+        return (int32_t)(a.generation - b.generation) < 0;
+        }
+
+public:
+    tCANCaptureReader();
+    ~tCANCaptureReader();
+
+    // Maps the files of a capture set, they are read oldest first.  Files
+    // which are not captures are reported and skipped.
+    bool Open(const char *const *FileNames, int Count);
+    void Close();
+
+    // Next record and its data, false at the end of the capture
+    bool Next(tCANCaptureRecord &Record, const unsigned char *&Data);
+
+    // CAN port of the file the last record came from
+    const char *GetInterface(char *Buf, size_t Size) const;
+
+    // A file ended in a corrupt record, the rest of that file was skipped
+    bool IsCorrupt() const { return corrupt; }
+};
+
+#endif /* CANRECORDER_H_ */
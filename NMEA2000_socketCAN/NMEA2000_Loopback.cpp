@@ -0,0 +1,250 @@
+/*
+NMEA2000_Loopback.cpp
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+NMEA2000 driver for an in-process bus, see NMEA2000_Loopback.h.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "NMEA2000_Loopback.h"
+
+#include <iostream>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+
+
+//*****************************************************************************
+tNMEA2000_Loopback::tNMEA2000_Loopback(tTransport Transport, bool CANFD, uint32_t RingSize)
+    : tNMEA2000_SocketCAN("loopback", CANFD), transport(Transport), peer(NULL), ring(NULL), ringSize(1),
+      ringHead(0), ringTail(0), ringEvent(-1), pipeFd(-1), feedFd(-1), framesSent(0), framesReceived(0)
+{
+    countBusLoad = false;
+    if (transport == lt_Ring) {
+        while (ringSize < RingSize)
+            ringSize <<= 1;
+        ring = new tRingFrame[ringSize];
+        ringEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (ringEvent < 0)
+            cerr << "Failed loopback eventfd" << endl;
+        }
+}
+
+
+//*****************************************************************************
+tNMEA2000_Loopback::~tNMEA2000_Loopback() {
+    if (ringEvent >= 0)
+        close(ringEvent);
+    if (pipeFd >= 0)
+        close(pipeFd);
+    if (feedFd >= 0)
+        close(feedFd);
+    delete[] ring;
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_Loopback::Connect(tNMEA2000_Loopback &A, tNMEA2000_Loopback &B) {
+    if (A.transport != B.transport || A.peer != NULL || B.peer != NULL || A.skt >= 0 || B.skt >= 0)
+        return false;
+
+    if (A.transport == lt_Pipe) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) < 0) {
+            cerr << "Failed loopback socket pair" << endl;
+            return false;
+            }
+        A.pipeFd = sv[0];
+        B.pipeFd = sv[1];
+        }
+
+    A.peer = &B;
+    B.peer = &A;
+    return true;
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_Loopback::CANOpen() {
+    fdEnabled = fdRequested && N2K_MAX_CAN_FRAME_DATA_LEN >= CANFD_MAX_DLEN;
+    SetCANFrameDataLen(fdEnabled ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+
+    if (transport == lt_Ring) {
+        skt = ringEvent;
+        return skt >= 0;
+        }
+
+    if (pipeFd < 0) {                                                           // no peer, the other end is for InjectFrame()
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) < 0) {
+            cerr << "Failed loopback socket pair" << endl;
+            return false;
+            }
+        pipeFd = sv[0];
+        feedFd = sv[1];
+        }
+    skt = pipeFd;
+    EnableRxTimestamps();
+    return true;
+}
+
+
+//*****************************************************************************
+//  Writer side of a receive ring.  The head is published before the tail
+//  is read, and the reader stores the tail before reading the head, so
+//  either the reader sees the frame or the writer sees the ring was empty
+//  and wakes it.
+bool tNMEA2000_Loopback::PushFrame(unsigned long id, unsigned char len, const unsigned char *buf) {
+    uint32_t head = __atomic_load_n(&ringHead, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&ringTail, __ATOMIC_ACQUIRE) >= ringSize)
+        return false;
+
+    tRingFrame &frame = ring[head & (ringSize - 1)];
+    frame.id = id;
+    frame.len = len;
+    memcpy(frame.data, buf, len);
+    __atomic_store_n(&ringHead, head + 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&ringTail, __ATOMIC_SEQ_CST) == head) {
+        uint64_t value = 1;
+        if (write(ringEvent, &value, sizeof(value)) < 0 && errno != EAGAIN)
+            cerr << "Failed loopback signal" << endl;
+        }
+    return true;
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_Loopback::WriteFrame(int fd, unsigned long id, unsigned char len, const unsigned char *buf) {
+    struct canfd_frame frame;
+    size_t mtu = (len > CAN_MAX_DLEN) ? CANFD_MTU : CAN_MTU;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.can_id = id | CAN_EFF_FLAG;
+    frame.len = len;
+    if (mtu == CANFD_MTU)
+        frame.flags = CANFD_BRS;
+    memcpy(frame.data, buf, len);
+    return write(fd, &frame, mtu) == (ssize_t)mtu;
+}
+
+
+//*****************************************************************************
+//  A full ring is counted as a full device queue, there is no writability
+//  event for it so a CANInterface retries on its timer.  Stall times are
+//  on the realtime clock here, only their differences are used.
+bool tNMEA2000_Loopback::CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent) {
+    if (len > GetCANFrameDataLen())
+        return false;
+
+    if (peer == NULL) {
+        framesSent++;
+        if (recorder != NULL)
+            recorder->Record(tCANRecorder::NowUs(), id | CAN_EFF_FLAG, len, buf,
+                             ccf_Tx | ((len > CAN_MAX_DLEN) ? ccf_FD | ccf_BRS : 0));
+        return true;
+        }
+
+    if (transport == lt_Pipe) {
+        if (!tNMEA2000_SocketCAN::CANSendFrame(id, len, buf, wait_sent))
+            return false;
+        framesSent++;
+        return true;
+        }
+
+    if (!peer->PushFrame(id, len, buf)) {
+        if (txStallStartUs == 0) {
+            txStallStartUs = tCANRecorder::NowUs();
+            txStats.DeviceQueueFull++;
+            }
+        return false;
+        }
+    if (txStallStartUs != 0) {
+        uint64_t stall = tCANRecorder::NowUs() - txStallStartUs;
+        txStats.StallTimeUs += stall;
+        txStats.LastStallUs = stall;
+        if (stall > txStats.MaxStallUs)
+            txStats.MaxStallUs = stall;
+        txStallStartUs = 0;
+        }
+    framesSent++;
+    if (recorder != NULL)
+        recorder->Record(tCANRecorder::NowUs(), id | CAN_EFF_FLAG, len, buf,
+                         ccf_Tx | ((len > CAN_MAX_DLEN) ? ccf_FD | ccf_BRS : 0));
+    return true;
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_Loopback::InjectFrame(unsigned long id, unsigned char len, const unsigned char *buf) {
+    if (peer != NULL || len > GetCANFrameDataLen())
+        return false;
+
+    if (transport == lt_Ring)
+        return PushFrame(id, len, buf);
+    return feedFd >= 0 && WriteFrame(feedFd, id, len, buf);
+}
+
+
+//*****************************************************************************
+//  The eventfd is only left clear when the ring is empty, so a reader which
+//  stops before the end of the ring is woken again.  Frames are timestamped when they are read.
+bool tNMEA2000_Loopback::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs) {
+    if (transport == lt_Pipe) {
+        if (!tNMEA2000_SocketCAN::CANGetFrame(id, len, buf, TimeUs))
+            return false;
+        id &= CAN_EFF_MASK;
+        if (TimeUs == 0)
+            TimeUs = tCANRecorder::NowUs();
+        framesReceived++;
+        return true;
+        }
+
+    uint32_t tail = ringTail;
+    if (__atomic_load_n(&ringHead, __ATOMIC_ACQUIRE) == tail) {
+        uint64_t value;
+        while (read(ringEvent, &value, sizeof(value)) > 0)
+            ;
+        if (__atomic_load_n(&ringHead, __ATOMIC_SEQ_CST) == tail)
+            return false;
+        value = 1;                                                              // the wake up just cleared was for these frames
+        if (write(ringEvent, &value, sizeof(value)) < 0 && errno != EAGAIN)
+            cerr << "Failed loopback signal" << endl;
+        }
+
+    const tRingFrame &frame = ring[tail & (ringSize - 1)];
+    id = frame.id & CAN_EFF_MASK;
+    len = frame.len;
+    memset(buf, 0, CAN_MAX_DLEN);
+    memcpy(buf, frame.data, len);
+    __atomic_store_n(&ringTail, tail + 1, __ATOMIC_SEQ_CST);
+
+    TimeUs = tCANRecorder::NowUs();
+    framesReceived++;
+    if (recorder != NULL)
+        recorder->Record(TimeUs, id | CAN_EFF_FLAG, len, buf, (len > CAN_MAX_DLEN) ? ccf_FD | ccf_BRS : 0);
+    return true;
+}
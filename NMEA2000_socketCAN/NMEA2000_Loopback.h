@@ -0,0 +1,114 @@
+/*
+NMEA2000_Loopback.h
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+NMEA2000 driver for an in-process bus.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+Runs the library without a CAN port, so the whole stack can be run and
+measured on a machine with no CAN hardware or vcan privileges.  Frames are
+carried by one of two transports:
+
+  lt_Ring   a lock-free ring of frames in memory with an eventfd to wake
+            the reader, no system call per frame while the reader is busy
+  lt_Pipe   a SOCK_SEQPACKET socket pair carrying struct canfd_frame, read
+            and written as a socketCAN port is, including a full socket
+            stalling the sender
+
+Connect() joins two drivers so the frames one sends are received by the
+other.  A driver with no peer receives the frames given to InjectFrame()
+and its own frames are counted and dropped.  GetSocket() signals received
+frames in both transports, so a driver can run behind a CANInterface on a
+reactor.  Frames do not count towards the bus load, an in-process bus has
+no bit rate and the load would pace a CANInterface.
+
+Each receive ring has one writer, the thread sending on the peer or the
+one calling InjectFrame(), and one reader, the thread doing the CAN I/O.
+*/
+
+#ifndef NMEA2000_LOOPBACK_H_
+#define NMEA2000_LOOPBACK_H_
+
+#include "NMEA2000_SocketCAN.h"
+
+//-----------------------------------------------------------------------------
+class tNMEA2000_Loopback : public tNMEA2000_SocketCAN
+{
+public:
+    enum tTransport {
+        lt_Ring,
+        lt_Pipe
+    };
+
+    static const uint32_t DefaultRingSize = 4096;
+
+protected:
+    struct tRingFrame {
+        uint32_t id;
+        uint8_t  len;
+        unsigned char data[N2K_MAX_CAN_FRAME_DATA_LEN];
+    };
+
+    bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent);
+    bool CANOpen();
+    bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs);
+
+    tTransport transport;
+    tNMEA2000_Loopback *peer;
+
+    // lt_Ring, frames for this driver
+    tRingFrame *ring;
+    uint32_t ringSize;                  // power of 2
+    uint32_t ringHead;                  // next to write, by the writer
+    uint32_t ringTail;                  // next to read, by the reader
+    int      ringEvent;                 // eventfd, signalled when the ring stops being empty
+
+    // lt_Pipe, this end is skt once open
+    int      pipeFd;
+    int      feedFd;                    // other end when there is no peer, for InjectFrame()
+
+    uint32_t framesSent;
+    uint32_t framesReceived;
+
+    bool PushFrame(unsigned long id, unsigned char len, const unsigned char *buf);
+    bool WriteFrame(int fd, unsigned long id, unsigned char len, const unsigned char *buf);
+
+public:
+    // RingSize frames are held for this driver in lt_Ring, rounded up to
+    // a power of 2
+    tNMEA2000_Loopback(tTransport Transport=lt_Ring, bool CANFD=false, uint32_t RingSize=DefaultRingSize);
+    ~tNMEA2000_Loopback();
+
+    // Join two drivers with the same transport, before either is opened
+    static bool Connect(tNMEA2000_Loopback &A, tNMEA2000_Loopback &B);
+
+    // A frame to be received as if from the bus, for a driver with no
+    // peer.  The library drops frames while it opens, so wait for
+    // IsOpen().  False when the transport is full.
+    bool InjectFrame(unsigned long id, unsigned char len, const unsigned char *buf);
+
+    uint32_t GetFramesSent() const { return framesSent; }
+    uint32_t GetFramesReceived() const { return framesReceived; }
+};
+
+#endif /* NMEA2000_LOOPBACK_H_ */
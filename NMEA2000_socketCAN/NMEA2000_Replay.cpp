@@ -0,0 +1,156 @@
+/*
+NMEA2000_Replay.cpp
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+NMEA2000 driver replaying a CAN capture.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "NMEA2000_Replay.h"
+
+#include <iostream>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <linux/can.h>
+
+
+//*****************************************************************************
+tNMEA2000_Replay::tNMEA2000_Replay(bool CANFD)
+    : tNMEA2000_SocketCAN("replay", CANFD), capture(NULL), speed(0), started(false), havePending(false),
+      pendingData(NULL), firstRecordUs(0), startUs(0), framesReplayed(0), framesSent(0)
+{
+    memset(&pending, 0, sizeof(pending));
+}
+
+
+//*****************************************************************************
+tNMEA2000_Replay::~tNMEA2000_Replay() {
+    if (skt >= 0)
+        close(skt);
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_Replay::CANOpen() {
+    skt = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (skt < 0) {
+        cerr << "Failed replay eventfd" << endl;
+        return false;
+        }
+
+    fdEnabled = fdRequested && N2K_MAX_CAN_FRAME_DATA_LEN >= CANFD_MAX_DLEN;
+    SetCANFrameDataLen(fdEnabled ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+    return true;
+}
+
+
+//*****************************************************************************
+//  Frames are not added to the bus monitor, there is no bus, and a busy
+//  monitor would pace the queued messages of a CANInterface.
+bool tNMEA2000_Replay::CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent) {
+    if (len > GetCANFrameDataLen())
+        return false;
+
+    framesSent++;
+    if (recorder != NULL)
+        recorder->Record(tCANRecorder::NowUs(), id | CAN_EFF_FLAG, len, buf,
+                         ccf_Tx | ((len > CAN_MAX_DLEN) ? ccf_FD | ccf_BRS : 0));
+    return true;
+}
+
+
+//*****************************************************************************
+void tNMEA2000_Replay::SetCapture(tCANCaptureReader *Capture, double Speed) {
+    capture = Capture;
+    speed = (Speed < 0) ? 0 : Speed;
+    started = false;
+    havePending = false;
+}
+
+
+//*****************************************************************************
+void tNMEA2000_Replay::StartReplay() {
+    started = true;
+    startUs = tCANRecorder::NowUs();
+    firstRecordUs = 0;
+    if (ReadPending())
+        firstRecordUs = pending.TimeUs;
+}
+
+
+//*****************************************************************************
+//  Frames we sent in the capture are skipped, the library makes its own.
+//  Error frames go to the bus monitor as they would from the bus.
+bool tNMEA2000_Replay::ReadPending() {
+    if (havePending)
+        return true;
+    if (capture == NULL)
+        return false;
+
+    while (capture->Next(pending, pendingData)) {
+        if (pending.Flags & ccf_Tx)
+            continue;
+        if (pending.CANId & CAN_ERR_FLAG) {
+            struct can_frame err_frame;
+            memset(&err_frame, 0, sizeof(err_frame));
+            err_frame.can_id = pending.CANId;
+            err_frame.can_dlc = (pending.Len > CAN_MAX_DLEN) ? CAN_MAX_DLEN : pending.Len;
+            memcpy(err_frame.data, pendingData, err_frame.can_dlc);
+            busMonitor.HandleErrorFrame(err_frame, pending.TimeUs / 1000);
+            continue;
+            }
+        if (pending.Len > GetCANFrameDataLen())                                // FD frame on a classic replay
+            continue;
+        havePending = true;
+        return true;
+        }
+    return false;
+}
+
+
+//*****************************************************************************
+uint64_t tNMEA2000_Replay::GetTimeToNextFrameUs() {
+    if (!started || !ReadPending() || speed == 0)
+        return 0;
+
+    uint64_t dueUs = startUs + (uint64_t)((pending.TimeUs - firstRecordUs) / speed);
+    uint64_t nowUs = tCANRecorder::NowUs();
+    return (dueUs > nowUs) ? dueUs - nowUs : 0;
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_Replay::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs) {
+    if (!started || !ReadPending() || GetTimeToNextFrameUs() > 0)
+        return false;
+
+    id = pending.CANId & CAN_EFF_MASK;
+    len = pending.Len;
+    memset(buf, 0, CAN_MAX_DLEN);
+    memcpy(buf, pendingData, len);
+    TimeUs = tCANRecorder::NowUs();
+    havePending = false;
+    framesReplayed++;
+    return true;
+}
@@ -0,0 +1,87 @@
+/*
+NMEA2000_Replay.h
+
+2026 Copyright (c) Chelton Ltd.   All rights reserved
+
+NMEA2000 driver replaying a CAN capture.
+
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+Frames received in a capture (see CANRecorder.h) are passed to the library
+as if they came from the bus, at the recorded pace, faster or as fast as
+the library takes them.  Each frame is timestamped when it is passed on, so
+MsgTimeUs of a message is its arrival time in the replay.  Frames the
+library sends are counted and can be recorded, they go nowhere else.
+
+The driver has an eventfd as its socket which never signals, so it can
+also run behind a CANInterface on a reactor with no capture at all.
+*/
+
+#ifndef NMEA2000_REPLAY_H_
+#define NMEA2000_REPLAY_H_
+
+#include "NMEA2000_SocketCAN.h"
+
+//-----------------------------------------------------------------------------
+class tNMEA2000_Replay : public tNMEA2000_SocketCAN
+{
+protected:
+    bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent);
+    bool CANOpen();
+    bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs);
+
+    tCANCaptureReader *capture;
+    double   speed;
+    bool     started;
+    bool     havePending;               // next frame read, waiting for its time
+    tCANCaptureRecord pending;
+    const unsigned char *pendingData;
+    uint64_t firstRecordUs;
+    uint64_t startUs;
+    uint32_t framesReplayed;
+    uint32_t framesSent;
+
+    // read ahead to the next received frame, false at the end
+    bool ReadPending();
+
+public:
+    tNMEA2000_Replay(bool CANFD=false);
+    ~tNMEA2000_Replay();
+
+    // Capture to replay.  Speed 1 replays at the recorded pace, 10 ten
+    // times faster and 0 as fast as possible.
+    void SetCapture(tCANCaptureReader *Capture, double Speed);
+
+    // Start passing frames to the library, the pace is kept from now
+    void StartReplay();
+
+    // us until the next frame is due, 0 if it is due now
+    uint64_t GetTimeToNextFrameUs();
+
+    // all the frames of the capture have been passed on
+    bool IsReplayDone() { return started && !havePending && !ReadPending(); }
+
+    uint32_t GetFramesReplayed() const { return framesReplayed; }
+    uint32_t GetFramesSent() const { return framesSent; }
+};
+
+#endif /* NMEA2000_REPLAY_H_ */
@@ -40,19 +40,25 @@ See also NMEA2000 library.
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <errno.h>
 #include <sys/ioctl.h>
 #include <sys/select.h>
+#include <sys/socket.h>
+#include <linux/net_tstamp.h>
 #include <net/if.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
+#include <linux/can/error.h>
 
 //*****************************************************************************
 //  Pass in pointer to character array which contains (or will contain) the
 //  string of the CANsocket to use in :open().   If no paramater is passed in,
 //  or NULL is passed in, the defalt socket 'can0' will be used
-tNMEA2000_SocketCAN::tNMEA2000_SocketCAN(char* CANport) : tNMEA2000()
+tNMEA2000_SocketCAN::tNMEA2000_SocketCAN(const char* CANport, bool CANFD)
+    : tNMEA2000(), skt(-1), fdRequested(CANFD), fdEnabled(false), txBlocked(false), countBusLoad(true), txStallStartUs(0), recorder(NULL)
 {
-    static char defaultCANport[] = "can0";
+    memset(&txStats, 0, sizeof(txStats));
+    static const char defaultCANport[] = "can0";
 
     if (CANport != NULL)
         _CANport = CANport;
@@ -77,7 +83,7 @@ bool tNMEA2000_SocketCAN::CANOpen() {
         }
 
     strncpy(ifr.ifr_name, _CANport, (sizeof(ifr.ifr_name)-1));
-    ifr.ifr_name[sizeof(ifr.ifr_name)] = '\0';                                          //  (And make sure to null terminate)
+    ifr.ifr_name[sizeof(ifr.ifr_name)-1] = '\0';                                          //  (And make sure to null terminate)
 
     if (ioctl(skt, SIOCGIFINDEX, &ifr) < 0) {
         cerr << "Failed CAN ioctl: " << ifr.ifr_name << endl;
@@ -104,19 +110,92 @@ bool tNMEA2000_SocketCAN::CANOpen() {
         return (false);
         }
 
+    //----- Receive error frames for bus state and error counters
+    can_err_mask_t errMask = CAN_ERR_TX_TIMEOUT | CAN_ERR_LOSTARB | CAN_ERR_CRTL | CAN_ERR_PROT
+                           | CAN_ERR_ACK | CAN_ERR_BUSOFF | CAN_ERR_BUSERROR | CAN_ERR_RESTARTED;
+    if (setsockopt(skt, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask)) < 0)
+        cerr << "CAN error frames not available" << endl;
+
+    //----- CAN FD frames, when requested and the interface has FD MTU
+    fdEnabled = false;
+    if (fdRequested) {
+        int enable = 1;
+        if (N2K_MAX_CAN_FRAME_DATA_LEN < CANFD_MAX_DLEN)
+            cerr << "CAN FD not built in (N2K_MAX_CAN_FRAME_DATA_LEN), using classic CAN on " << _CANport << endl;
+        else if (ioctl(skt, SIOCGIFMTU, &ifr) < 0 || ifr.ifr_mtu != CANFD_MTU)
+            cerr << "CAN FD not enabled on " << _CANport << ", using classic CAN" << endl;
+        else if (setsockopt(skt, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) < 0)
+            cerr << "Failed CAN FD frames on " << _CANport << ", using classic CAN" << endl;
+        else
+            fdEnabled = true;
+        }
+    SetCANFrameDataLen(fdEnabled ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+
+    EnableRxTimestamps();
+
     return true;
 }
 
 
 //*****************************************************************************
-bool tNMEA2000_SocketCAN::CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent) {
-   struct can_frame frame_wr;
+static uint64_t monotonicUs(void) {
+    struct timespec ticker;
+
+    clock_gettime(CLOCK_MONOTONIC, &ticker);
+    return ((uint64_t)ticker.tv_sec * 1000000) + (ticker.tv_nsec / 1000);
+}
 
-   frame_wr.can_id  = id | CAN_EFF_FLAG;
-   frame_wr.can_dlc = len;
-   memcpy(frame_wr.data, buf, 8);
 
-   return (write(skt, &frame_wr, sizeof(frame_wr)) == sizeof(frame_wr));        // Send this frame out to the socketCAN handler
+//*****************************************************************************
+bool tNMEA2000_SocketCAN::CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent) {
+   struct canfd_frame frame_wr;                                                 // classic frame is the first CAN_MTU bytes
+   size_t mtu = CAN_MTU;
+
+   memset(&frame_wr, 0, sizeof(frame_wr));
+   frame_wr.can_id = id | CAN_EFF_FLAG;
+   frame_wr.len    = len;
+   if (len > CAN_MAX_DLEN) {
+       if (!fdEnabled || len > CANFD_MAX_DLEN)
+           return false;
+       frame_wr.flags = CANFD_BRS;                                              // data phase at the FD bit rate
+       mtu = CANFD_MTU;
+       memcpy(frame_wr.data, buf, len);
+       }
+   else
+       memcpy(frame_wr.data, buf, CAN_MAX_DLEN);
+
+   if (write(skt, &frame_wr, mtu) == (ssize_t)mtu) {                           // Send this frame out to the socketCAN handler
+       uint64_t nowMs = monotonicUs() / 1000;
+       busMonitor.FrameSent(nowMs);
+       if (countBusLoad)
+           busMonitor.AddFrame(len, nowMs);
+       if (recorder != NULL)
+           recorder->Record(tCANRecorder::NowUs(), frame_wr.can_id, len, frame_wr.data,
+                            ccf_Tx | ((mtu == CANFD_MTU) ? ccf_FD | ccf_BRS : 0));
+       if (txStallStartUs != 0) {                                               // Kernel is accepting frames again, stall is over
+           uint64_t stall = monotonicUs() - txStallStartUs;
+           txStats.StallTimeUs += stall;
+           txStats.LastStallUs = stall;
+           if (stall > txStats.MaxStallUs)
+               txStats.MaxStallUs = stall;
+           txStallStartUs = 0;
+           }
+       txBlocked = false;
+       return true;
+       }
+
+   // Library buffers the frame.  On EAGAIN the socket signals writability
+   // when there is room, ENOBUFS comes from the device queue which does not.
+   bool socketFull = (errno == EAGAIN || errno == EWOULDBLOCK);
+   if ((socketFull || errno == ENOBUFS) && txStallStartUs == 0) {
+       txStallStartUs = monotonicUs();
+       if (socketFull)
+           txStats.SocketFull++;
+       else
+           txStats.DeviceQueueFull++;
+       }
+   txBlocked = socketFull;
+   return false;
 
              // socketCAN works to keeping all packets in-order, so
              // no need to do anything special for wait-sent
@@ -124,27 +203,102 @@ bool tNMEA2000_SocketCAN::CANSendFrame(unsigned long id, unsigned char len, cons
 
 
 //*****************************************************************************
-bool tNMEA2000_SocketCAN::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf) {
-    struct can_frame frame_rd;
-    struct timeval tv = {0, 0};                                                 // Non-blocking timout when checking
-    fd_set fds;
-
-    FD_ZERO(&fds);
-    FD_SET(skt, &fds);
+//  Ask the kernel to timestamp received frames.  SO_TIMESTAMPING gives the
+//  software receive time (and hardware time where the controller supports
+//  it), older kernels fall back to SO_TIMESTAMP.  Without either, frames are
+//  still received but MsgTimeUs stays 0.
+void tNMEA2000_SocketCAN::EnableRxTimestamps() {
+    int tsflags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE
+                | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    if (setsockopt(skt, SOL_SOCKET, SO_TIMESTAMPING, &tsflags, sizeof(tsflags)) == 0)
+        return;
+
+    int enable = 1;
+    if (setsockopt(skt, SOL_SOCKET, SO_TIMESTAMP, &enable, sizeof(enable)) < 0)
+        cerr << "CAN receive timestamps not available" << endl;
+}
 
-    if (select((skt + 1), &fds, NULL, NULL, &tv) < 0)                           // Is there a FD with something to read out there?
-        return false;
 
-    if (FD_ISSET(skt, &fds)) {                                                  // Was it our CAN file-descriptor that is ready?
-        if (read(skt, &frame_rd, sizeof(frame_rd)) > 0) {
-            memcpy(buf, frame_rd.data, 8);
-            len = frame_rd.can_dlc;
-            id  = frame_rd.can_id;
-            return true;
+//*****************************************************************************
+//  Kernel receive time from the ancillary data of recvmsg(), 0 if there is none
+static uint64_t rxTimeUs(struct msghdr &msg) {
+    uint64_t TimeUs = 0;
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET)
+            continue;
+
+        if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+            struct timespec ts[3];                                              // [0] software, [2] raw hardware
+            memcpy(ts, CMSG_DATA(cmsg), sizeof(ts));
+            const struct timespec &t = (ts[0].tv_sec != 0) ? ts[0] : ts[2];
+            TimeUs = (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+            }
+        else if (cmsg->cmsg_type == SO_TIMESTAMP) {
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            TimeUs = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
             }
         }
-    return false;
+    return TimeUs;
+}
+
+
+//*****************************************************************************
+bool tNMEA2000_SocketCAN::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf) {
+    uint64_t TimeUs;
+    return CANGetFrame(id, len, buf, TimeUs);
+}
 
+
+//*****************************************************************************
+//  Socket is non-blocking, so recvmsg() returns straight away when there is
+//  nothing to read.  The kernel receive time comes back as ancillary data.
+//  Error frames are passed to the bus monitor and not to the library.
+//  On CAN FD ports both classic and FD frames are received.
+bool tNMEA2000_SocketCAN::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs) {
+    struct canfd_frame frame_rd;
+    struct iovec iov;
+    struct msghdr msg;
+    char ctrl[CMSG_SPACE(sizeof(struct timespec) * 3) + CMSG_SPACE(sizeof(struct timeval))];
+
+    iov.iov_base = &frame_rd;
+    iov.iov_len = sizeof(frame_rd);
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+
+    ssize_t nbytes;
+    for (;;) {
+        msg.msg_controllen = sizeof(ctrl);
+        nbytes = recvmsg(skt, &msg, 0);
+        if (nbytes != CAN_MTU && nbytes != CANFD_MTU)
+            return false;
+        if (!(frame_rd.can_id & CAN_ERR_FLAG))
+            break;
+        struct can_frame err_frame;                                             // error frames are always classic
+        memcpy(&err_frame, &frame_rd, sizeof(err_frame));
+        busMonitor.HandleErrorFrame(err_frame, monotonicUs() / 1000);
+        if (recorder != NULL) {
+            uint64_t errTimeUs = rxTimeUs(msg);
+            recorder->Record(errTimeUs ? errTimeUs : tCANRecorder::NowUs(), err_frame.can_id, CAN_MAX_DLEN, err_frame.data, 0);
+            }
+        }
+    if (nbytes == CAN_MTU || frame_rd.len > N2K_MAX_CAN_FRAME_DATA_LEN)
+        frame_rd.len = (frame_rd.len > CAN_MAX_DLEN) ? CAN_MAX_DLEN : frame_rd.len;
+    if (countBusLoad)
+        busMonitor.AddFrame(frame_rd.len, monotonicUs() / 1000);
+
+    TimeUs = rxTimeUs(msg);
+    if (recorder != NULL)
+        recorder->Record(TimeUs ? TimeUs : tCANRecorder::NowUs(), frame_rd.can_id, frame_rd.len, frame_rd.data,
+                         (nbytes == CANFD_MTU) ? ccf_FD | ((frame_rd.flags & CANFD_BRS) ? ccf_BRS : 0) : 0);
+
+    memcpy(buf, frame_rd.data, (frame_rd.len > CAN_MAX_DLEN) ? frame_rd.len : CAN_MAX_DLEN);
+    len = frame_rd.len;
+    id  = frame_rd.can_id;
+    return true;
 }
 
 
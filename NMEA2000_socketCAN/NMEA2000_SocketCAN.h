@@ -38,6 +38,8 @@ Inherited NMEA2000 object for socketCAN setup. See also NMEA2000 library.
 #include <stdio.h>
 #include <NMEA2000.h>
 #include <N2kMsg.h>
+#include "CANBusMonitor.h"
+#include "CANRecorder.h"
 
 using namespace std;
 
@@ -51,13 +53,66 @@ protected:
     bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent);
     bool CANOpen();
     bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf);
+    bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, uint64_t &TimeUs);
+    void EnableRxTimestamps();
 
     int   skt;
-    char*  _CANport;
+    const char*  _CANport;
 
+public:
+    // Transmit stall statistics. A stall starts when the kernel refuses a
+    // frame and ends when the next frame is accepted.
+    struct tTxStats {
+        uint32_t SocketFull;        // stalls on full socket send buffer (EAGAIN)
+        uint32_t DeviceQueueFull;   // stalls on full device tx queue (ENOBUFS)
+        uint64_t StallTimeUs;       // total time stalled
+        uint64_t MaxStallUs;        // longest stall
+        uint64_t LastStallUs;       // most recent completed stall
+    };
+
+protected:
+    bool     fdRequested;
+    bool     fdEnabled;
+    bool     txBlocked;
+    bool     countBusLoad;              // frames count towards the bus load, not on an in-process bus
+    uint64_t txStallStartUs;
+    tTxStats txStats;
+    tCANBusMonitor busMonitor;
+    tCANRecorder *recorder;
 
 public:
-    tNMEA2000_SocketCAN(char* CANport=NULL);
+    // CANFD requests CAN FD framing. Fast packets are then carried in up to
+    // 64 byte frames, which only other CAN FD nodes can receive, so use it
+    // on a private segment. Falls back to classic CAN when the interface
+    // is not in FD mode (ip link set canX mtu 72).
+    tNMEA2000_SocketCAN(const char* CANport=NULL, bool CANFD=false);
+
+    // CAN socket for event driven reading, -1 before open
+    int GetSocket() const { return skt; }
+
+    // name of the CAN port
+    const char *GetPort() const { return _CANport; }
+
+    // true when the port was opened for CAN FD frames
+    bool IsCANFD() const { return fdEnabled; }
+
+    // true while waiting for the socket to become writable. A full device
+    // queue does not signal writability, so then this is false and sending
+    // must be retried on a timer.
+    bool IsTxBlocked() const { return txBlocked; }
+
+    const tTxStats &GetTxStats() const { return txStats; }
+
+    // Bus state, error counters and bus load, updated from the reactor thread
+    tCANBusMonitor &GetBusMonitor() { return busMonitor; }
+
+    // true once open and the address claim is over, so messages can be sent
+    bool IsAddressClaimed() { return IsOpen() && !IsAddressClaimStarted(0); }
+
+    // Record every frame sent and received, NULL to stop.  Set before the
+    // port is opened, the recorder is then only used by the thread doing
+    // the CAN I/O.
+    void SetRecorder(tCANRecorder *Recorder) { recorder = Recorder; }
 
 };
 
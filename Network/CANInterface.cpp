@@ -0,0 +1,406 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : CAN Interface implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "CANInterface.h"
+
+// C includes
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// C++ includes
+
+// includes
+#include "../EventLogger.h"
+#include "../Config.h"
+#include "../Utils.h"
+#include <N2kTimer.h>
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+CANInterface::CANInterface(tNMEA2000_SocketCAN &p_rNMEA2000, Reactor &p_rReactor)
+    : m_rNMEA2000(p_rNMEA2000), m_rReactor(p_rReactor), m_txEventFd(-1), m_socketEvents(EPOLLIN), m_txStalled(false)
+    , m_nextSendMs(0), m_retrySendMs(0), m_busState(tCANBusMonitor::bs_ErrorActive)
+    , m_latencyCount(0), m_latencyTotalUs(0), m_latencyMaxUs(0)
+    , m_metrics(RegisterMetrics(p_rNMEA2000.GetPort())), m_rxCounter(&p_rNMEA2000, m_metrics.m_pReceived)
+    , m_nextSampleMs(0)
+{
+    memset(&m_sampledTxStats, 0, sizeof(m_sampledTxStats));
+    memset(&m_sampledErrorCounters, 0, sizeof(m_sampledErrorCounters));
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+CANInterface::~CANInterface()
+{
+    if (m_txEventFd >= 0)
+    {
+        m_rReactor.RemoveHandler(m_txEventFd);
+        close(m_txEventFd);
+    }
+    m_rReactor.RemoveHandler(m_rNMEA2000.GetSocket());
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool CANInterface::Init()
+{
+    m_txEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_txEventFd < 0)
+    {
+        EventLogger::Error("CANInterface() eventfd failed %d", errno);
+        return false;
+    }
+
+    bool l_success = m_rReactor.AddHandler(m_rNMEA2000.GetSocket(), m_socketEvents, this)
+                  && m_rReactor.AddHandler(m_txEventFd, EPOLLIN, this);
+    if (!l_success)
+    {
+        EventLogger::Error("CANInterface() failed to register on the reactor");
+    }
+    return l_success;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool CANInterface::SendMsg(const tN2kMsg &p_rMsg, const TraceContext *p_pTrace)
+{
+    TxEntry l_entry;
+    l_entry.m_msg = p_rMsg;
+    if (p_pTrace != nullptr)
+    {
+        l_entry.m_trace = *p_pTrace;
+        LatencyTrace::Stamp(l_entry.m_trace, eTraceStage::TxQueue);
+    }
+    else
+    {
+        l_entry.m_trace.m_stampNs[static_cast<int>(eTraceStage::Receive)] = 0;
+    }
+    m_metrics.m_pQueued->Add();
+    if (m_txQueue.enqueue_bounded(l_entry, cCAN_TX_QUEUE_DEPTH))
+    {
+        // the oldest message made room, the depth is unchanged
+        m_metrics.m_pDropped->Add();
+    }
+    else
+    {
+        m_metrics.m_pQueueDepth->Add(1);
+    }
+
+    uint64_t l_value = 1;
+    if (write(m_txEventFd, &l_value, sizeof(l_value)) < 0 && errno != EAGAIN)
+    {
+        EventLogger::Error("CANInterface() tx signal failed %d", errno);
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void CANInterface::HandleEvent(int p_fd, uint32_t p_events)
+{
+    if (p_fd == m_txEventFd)
+    {
+        uint64_t l_value;
+        while (read(m_txEventFd, &l_value, sizeof(l_value)) > 0)
+        {
+        }
+        SendQueued();
+    }
+    else
+    {
+        if (p_events & EPOLLOUT)
+        {
+            m_rNMEA2000.SendPendingFrames();
+            SendQueued();
+        }
+        if (p_events & (EPOLLIN | EPOLLERR))
+        {
+            m_rNMEA2000.ParseMessages();
+            CheckBusState();
+        }
+    }
+    UpdateTxInterest();
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int CANInterface::GetTimeToNextEvent()
+{
+    uint32_t l_time = m_rNMEA2000.GetTimeToNextEvent();
+
+    // a full device queue gives no writability event so retry on a timer,
+    // kept as a deadline so that it comes due
+    if (m_rNMEA2000.HasPendingFrames() && !m_rNMEA2000.IsTxBlocked())
+    {
+        uint64_t l_now = N2kMillis64();
+        if (m_retrySendMs == 0)
+        {
+            m_retrySendMs = l_now + 1;
+        }
+        uint32_t l_retry = (m_retrySendMs > l_now) ? static_cast<uint32_t>(m_retrySendMs - l_now) : 0;
+        if (l_retry < l_time)
+        {
+            l_time = l_retry;
+        }
+    }
+
+    // driver statistics sample
+    uint64_t l_nowMs = N2kMillis64();
+    uint32_t l_sample = (m_nextSampleMs > l_nowMs) ? static_cast<uint32_t>(m_nextSampleMs - l_nowMs) : 0;
+    if (l_sample < l_time)
+    {
+        l_time = l_sample;
+    }
+
+    // paced messages waiting
+    if (!m_txQueue.isEmpty() && !m_rNMEA2000.HasPendingFrames())
+    {
+        uint64_t l_now = N2kMillis64();
+        uint32_t l_paced = (m_nextSendMs > l_now) ? static_cast<uint32_t>(m_nextSendMs - l_now) : 0;
+        if (l_paced < l_time)
+        {
+            l_time = l_paced;
+        }
+    }
+
+    if (l_time == N2kNoEvent)
+    {
+        return -1;
+    }
+    return (l_time > INT_MAX) ? INT_MAX : static_cast<int>(l_time);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void CANInterface::HandleTimeout()
+{
+    m_retrySendMs = 0;
+    m_rNMEA2000.ParseMessages();
+    CheckBusState();
+    SendQueued();
+    UpdateTxInterest();
+
+    uint64_t l_now = N2kMillis64();
+    if (l_now >= m_nextSampleMs)
+    {
+        m_nextSampleMs = l_now + cMETRICS_SAMPLE_MS;
+        SampleMetrics();
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool CANInterface::IsBackingOff()
+{
+    tCANBusMonitor &l_rMonitor = m_rNMEA2000.GetBusMonitor();
+    return l_rMonitor.GetBusState() >= tCANBusMonitor::bs_ErrorPassive
+        || l_rMonitor.GetBusLoad(cCAN_BUSLOAD_WINDOW_MS, N2kMillis64()) >= cCAN_BUSLOAD_BACKOFF_PERCENT;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+CANInterface::LatencyStats CANInterface::GetLatencyStats() const
+{
+    LatencyStats l_stats;
+    l_stats.m_count = m_latencyCount.load(std::memory_order_relaxed);
+    l_stats.m_totalUs = m_latencyTotalUs.load(std::memory_order_relaxed);
+    l_stats.m_maxUs = m_latencyMaxUs.load(std::memory_order_relaxed);
+    return l_stats;
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void CANInterface::SendQueued()
+{
+    // hold the queue while frames are waiting on the socket to keep order
+    // and to leave the library buffer for its own messages
+    while (!m_txQueue.isEmpty() && !m_rNMEA2000.HasPendingFrames())
+    {
+        if (IsBackingOff())
+        {
+            uint64_t l_now = N2kMillis64();
+            if (l_now < m_nextSendMs)
+            {
+                break;
+            }
+            m_nextSendMs = l_now + cCAN_BACKOFF_INTERVAL_MS;
+        }
+
+        TxEntry l_entry = m_txQueue.dequeue();
+        const tN2kMsg &l_msg = l_entry.m_msg;
+        m_metrics.m_pQueueDepth->Add(-1);
+        if (!m_rNMEA2000.SendMsg(l_msg))
+        {
+            EVENT_DEBUG("CANInterface() failed to send PGN %lu", l_msg.PGN);
+            m_metrics.m_pSendFailed->Add();
+            continue;
+        }
+        m_metrics.m_pSent->Add();
+
+        LatencyTrace::Stamp(l_entry.m_trace, eTraceStage::Wire);
+        LatencyTrace::Record(l_entry.m_trace, eTraceStage::TxQueue, eTraceStage::Wire);
+        if (l_msg.MsgTimeUs != 0)
+        {
+            uint64_t l_now = Utils::CurrentTimestampMicroSeconds();
+            uint64_t l_latency = (l_now > l_msg.MsgTimeUs) ? l_now - l_msg.MsgTimeUs : 0;
+            m_metrics.m_pTxLatency->Record(l_latency);
+            m_latencyCount.fetch_add(1, std::memory_order_relaxed);
+            m_latencyTotalUs.fetch_add(l_latency, std::memory_order_relaxed);
+            if (l_latency > m_latencyMaxUs.load(std::memory_order_relaxed))
+            {
+                m_latencyMaxUs.store(l_latency, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void CANInterface::UpdateTxInterest()
+{
+    bool l_stalled = m_rNMEA2000.HasPendingFrames();
+    uint32_t l_events = EPOLLIN;
+    if (l_stalled && m_rNMEA2000.IsTxBlocked())
+    {
+        l_events |= EPOLLOUT;
+    }
+
+    if (l_events != m_socketEvents && m_rReactor.ModifyHandler(m_rNMEA2000.GetSocket(), l_events))
+    {
+        m_socketEvents = l_events;
+    }
+
+    if (m_txStalled && !l_stalled)
+    {
+        const tNMEA2000_SocketCAN::tTxStats &l_stats = m_rNMEA2000.GetTxStats();
+        EVENT_DEBUG("CANInterface() tx stall cleared after %llu us, socket full %u, device queue full %u",
+                    l_stats.LastStallUs, l_stats.SocketFull, l_stats.DeviceQueueFull);
+    }
+    m_txStalled = l_stalled;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void CANInterface::CheckBusState()
+{
+    tCANBusMonitor &l_rMonitor = m_rNMEA2000.GetBusMonitor();
+    tCANBusMonitor::tBusState l_state = l_rMonitor.GetBusState();
+    if (l_state == m_busState)
+    {
+        return;
+    }
+
+    if (l_state > m_busState)
+    {
+        EventLogger::Error("CANInterface() bus %s, tx errors %u rx errors %u",
+                           tCANBusMonitor::BusStateName(l_state),
+                           l_rMonitor.GetTxErrorCount(), l_rMonitor.GetRxErrorCount());
+    }
+    else
+    {
+        EventLogger::LogEvent("CANInterface() bus recovered to %s", tCANBusMonitor::BusStateName(l_state));
+    }
+    m_busState = l_state;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+CANInterface::BusMetrics CANInterface::RegisterMetrics(const char *p_pPort)
+{
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    std::string l_bus = std::string("bus=\"") + p_pPort + "\"";
+    BusMetrics l_metrics;
+
+    l_metrics.m_pQueued = l_pRegistry->AddCounter("nmea2can_n2k_messages_queued_total",
+        "NMEA2000 messages queued for the bus", l_bus);
+    l_metrics.m_pSent = l_pRegistry->AddCounter("nmea2can_n2k_messages_sent_total",
+        "NMEA2000 messages passed to the library to send", l_bus);
+    l_metrics.m_pSendFailed = l_pRegistry->AddCounter("nmea2can_n2k_send_failures_total",
+        "NMEA2000 messages the library refused to send", l_bus);
+    l_metrics.m_pDropped = l_pRegistry->AddCounter("nmea2can_n2k_tx_dropped_total",
+        "NMEA2000 messages dropped from a full tx queue", l_bus);
+    l_metrics.m_pReceived = l_pRegistry->AddCounter("nmea2can_n2k_messages_received_total",
+        "NMEA2000 messages received from the bus", l_bus);
+    l_metrics.m_pQueueDepth = l_pRegistry->AddGauge("nmea2can_n2k_tx_queue_depth",
+        "NMEA2000 messages waiting to be sent", l_bus);
+    l_metrics.m_pTxLatency = l_pRegistry->AddHistogram("nmea2can_n2k_tx_latency_us",
+        "Time from a message being received to it being sent, us",
+        { 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000 }, l_bus);
+    l_metrics.m_pSocketFull = l_pRegistry->AddCounter("nmea2can_can_socket_full_total",
+        "CAN transmit stalls on a full socket buffer", l_bus);
+    l_metrics.m_pDeviceQueueFull = l_pRegistry->AddCounter("nmea2can_can_device_queue_full_total",
+        "CAN transmit stalls on a full device queue", l_bus);
+    l_metrics.m_pStallUs = l_pRegistry->AddCounter("nmea2can_can_tx_stall_us_total",
+        "Time CAN transmit was stalled, us", l_bus);
+    l_metrics.m_pErrorFrames = l_pRegistry->AddCounter("nmea2can_can_error_frames_total",
+        "CAN error frames received", l_bus);
+    l_metrics.m_pBusOff = l_pRegistry->AddCounter("nmea2can_can_bus_off_total",
+        "CAN controller transitions to bus off", l_bus);
+    l_metrics.m_pRxOverflows = l_pRegistry->AddCounter("nmea2can_can_rx_overflows_total",
+        "CAN controller or receive buffer overflows", l_bus);
+    l_metrics.m_pBusLoad = l_pRegistry->AddGauge("nmea2can_can_bus_load_percent",
+        "CAN bus load over the load window", l_bus);
+    l_metrics.m_pBusState = l_pRegistry->AddGauge("nmea2can_can_bus_state",
+        "CAN bus state, 0 error active, 1 warning, 2 passive, 3 bus off", l_bus);
+    l_metrics.m_pTxErrors = l_pRegistry->AddGauge("nmea2can_can_tx_error_count",
+        "CAN controller transmit error counter", l_bus);
+    l_metrics.m_pRxErrors = l_pRegistry->AddGauge("nmea2can_can_rx_error_count",
+        "CAN controller receive error counter", l_bus);
+    return l_metrics;
+}
+
+//----------------------------------------------------------------
+// counters are advanced by the change since the last sample
+//----------------------------------------------------------------
+void CANInterface::SampleMetrics()
+{
+    const tNMEA2000_SocketCAN::tTxStats &l_txStats = m_rNMEA2000.GetTxStats();
+    m_metrics.m_pSocketFull->Add(l_txStats.SocketFull - m_sampledTxStats.SocketFull);
+    m_metrics.m_pDeviceQueueFull->Add(l_txStats.DeviceQueueFull - m_sampledTxStats.DeviceQueueFull);
+    m_metrics.m_pStallUs->Add(l_txStats.StallTimeUs - m_sampledTxStats.StallTimeUs);
+    m_sampledTxStats = l_txStats;
+
+    tCANBusMonitor &l_rMonitor = m_rNMEA2000.GetBusMonitor();
+    const tCANBusMonitor::tErrorCounters &l_errors = l_rMonitor.GetErrorCounters();
+    m_metrics.m_pErrorFrames->Add(l_errors.ErrorFrames - m_sampledErrorCounters.ErrorFrames);
+    m_metrics.m_pBusOff->Add(l_errors.BusOff - m_sampledErrorCounters.BusOff);
+    m_metrics.m_pRxOverflows->Add(l_errors.RxOverflows - m_sampledErrorCounters.RxOverflows);
+    m_sampledErrorCounters = l_errors;
+
+    m_metrics.m_pBusLoad->Set(l_rMonitor.GetBusLoad(cCAN_BUSLOAD_WINDOW_MS, N2kMillis64()));
+    m_metrics.m_pBusState->Set(static_cast<int64_t>(l_rMonitor.GetBusState()));
+    m_metrics.m_pTxErrors->Set(l_rMonitor.GetTxErrorCount());
+    m_metrics.m_pRxErrors->Set(l_rMonitor.GetRxErrorCount());
+}
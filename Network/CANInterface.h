@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : CAN Interface header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _CAN_INTERFACE_H_INCLUDED_
+#define _CAN_INTERFACE_H_INCLUDED_
+
+// C includes
+
+// C++ includes
+#include <atomic>
+
+// includes
+#include "Reactor.h"
+#include "../SafeQueue.h"
+#include "../LatencyTrace.h"
+#include "../Metrics.h"
+#include <NMEA2000_SocketCAN.h>
+
+//----------------------------------------------
+// CAN Interface class owns the NMEA2000 object on the reactor thread.
+// Received frames and library timers are handled from the reactor,
+// other threads send messages through a queue.
+//
+// Backpressure - when the kernel refuses frames the library buffers them
+// and the queue is held. The socket is then watched for EPOLLOUT and both
+// are drained as soon as it can accept frames again. The queue holds at
+// most cCAN_TX_QUEUE_DEPTH messages, the oldest is dropped to make room.
+//
+// Pacing - while the bus load is over cCAN_BUSLOAD_BACKOFF_PERCENT or the
+// controller is error passive or bus off, queued messages are sent one per
+// cCAN_BACKOFF_INTERVAL_MS.
+//
+// Metrics - the messages queued, sent and received are counted as they
+// pass, labelled with the CAN port. The driver statistics are sampled on
+// the reactor thread every cMETRICS_SAMPLE_MS, so the library is not read
+// from another thread.
+//----------------------------------------------
+class CANInterface : public IEventHandler
+{
+public:
+    //----------------------------------------------
+    // Time from a message being received, from a bus or as a NMEA0183
+    // sentence (tN2kMsg::MsgTimeUs), to it being passed to the library
+    // for this bus
+    //----------------------------------------------
+    struct LatencyStats
+    {
+        uint64_t m_count;       ///< messages with a receive time
+        uint64_t m_totalUs;     ///< sum of the latencies
+        uint64_t m_maxUs;       ///< largest latency
+    };
+
+    /// Default Constructor
+    /// Detail- CAN Interface constructor
+    /// Returns- n/a
+    /// Throws - n/a
+    CANInterface
+    (
+        tNMEA2000_SocketCAN& p_rNMEA2000,   ///< NMEA2000 object for the CAN port
+        Reactor& p_rReactor                 ///< reactor running the CAN I/O
+    );
+
+    /// Default Destructor
+    /// Detail- CAN Interface destructor
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual ~CANInterface();
+
+    /// Init
+    /// Detail- Registers the CAN socket on the reactor. NMEA2000 must
+    ///         have been opened before
+    /// Returns- true if the interface was registered
+    /// Throws - n/a
+    bool Init();
+
+    /// SendMsg
+    /// Detail- Queues a message to be sent from the reactor thread.
+    ///         Safe to call from any thread
+    /// Returns- true if the message was queued
+    /// Throws - n/a
+    bool SendMsg
+    (
+        const tN2kMsg& p_rMsg,                  ///< message to send
+        const TraceContext* p_pTrace = nullptr  ///< trace of the sentence it was made from, nullptr for none
+    );
+
+    /// HandleEvent
+    /// Detail- Reads the CAN socket, or sends the buffered and queued
+    ///         messages when the socket is writable or messages are queued
+    /// Returns- n/a
+    /// Throws - n/a
+    void HandleEvent(int p_fd, uint32_t p_events) override;
+
+    /// GetTimeToNextEvent
+    /// Detail- Time to the next NMEA2000 library timer
+    /// Returns- time in ms, -1 if there are no timers
+    /// Throws - n/a
+    int GetTimeToNextEvent() override;
+
+    /// HandleTimeout
+    /// Detail- Runs the NMEA2000 library timers and paced messages
+    /// Returns- n/a
+    /// Throws - n/a
+    void HandleTimeout() override;
+
+    /// IsBackingOff
+    /// Detail- Bus is busy or in error, queued messages are paced
+    /// Returns- true when backing off
+    /// Throws - n/a
+    bool IsBackingOff();
+
+    /// GetLatencyStats
+    /// Detail- Latency of the messages sent so far, safe to call from
+    ///         any thread
+    /// Returns- the latency statistics
+    /// Throws - n/a
+    LatencyStats GetLatencyStats() const;
+
+    /// IsTxQueueEmpty
+    /// Detail- No messages are waiting in the queue
+    /// Returns- true when the queue is empty
+    /// Throws - n/a
+    bool IsTxQueueEmpty() const
+    {
+        return m_txQueue.isEmpty();
+    }
+
+private:
+    //----------------------------------------------
+    // A queued message and the trace it carries
+    //----------------------------------------------
+    struct TxEntry
+    {
+        tN2kMsg m_msg;
+        TraceContext m_trace;
+    };
+
+    //----------------------------------------------
+    // Metrics of the bus, owned by the MetricsRegistry
+    //----------------------------------------------
+    struct BusMetrics
+    {
+        MetricCounter * m_pQueued;          ///< messages queued
+        MetricCounter * m_pSent;            ///< messages passed to the library
+        MetricCounter * m_pSendFailed;      ///< messages the library refused
+        MetricCounter * m_pDropped;         ///< oldest messages dropped from a full queue
+        MetricCounter * m_pReceived;        ///< messages handed out by the library
+        MetricGauge * m_pQueueDepth;        ///< messages waiting in the queue
+        MetricHistogram * m_pTxLatency;     ///< receive to sent, us
+        MetricCounter * m_pSocketFull;      ///< sampled driver statistics
+        MetricCounter * m_pDeviceQueueFull;
+        MetricCounter * m_pStallUs;
+        MetricCounter * m_pErrorFrames;
+        MetricCounter * m_pBusOff;
+        MetricCounter * m_pRxOverflows;
+        MetricGauge * m_pBusLoad;
+        MetricGauge * m_pBusState;
+        MetricGauge * m_pTxErrors;
+        MetricGauge * m_pRxErrors;
+    };
+
+    //----------------------------------------------
+    // Counts every message the library hands out
+    //----------------------------------------------
+    class RxCounter : public tNMEA2000::tMsgHandler
+    {
+    public:
+        RxCounter(tNMEA2000 * p_pNMEA2000, MetricCounter * p_pCounter)
+        : tNMEA2000::tMsgHandler(0, p_pNMEA2000), m_pCounter(p_pCounter) {}
+
+    protected:
+        void HandleMsg(const tN2kMsg &) override { m_pCounter->Add(); }
+
+    private:
+        MetricCounter * m_pCounter;
+    };
+
+    // register the metrics of a bus
+    static BusMetrics RegisterMetrics(const char * p_pPort);
+
+    // copy the driver statistics into the metrics
+    void SampleMetrics();
+
+    // send the queued messages while the CAN socket accepts frames
+    void SendQueued();
+
+    // watch the CAN socket for writability while frames are waiting on it
+    void UpdateTxInterest();
+
+    // log bus state changes reported by the bus monitor
+    void CheckBusState();
+
+    tNMEA2000_SocketCAN& m_rNMEA2000;   ///!< NMEA2000 object
+    Reactor& m_rReactor;                ///!< the reactor
+    int m_txEventFd;                    ///!< eventfd signalled when messages are queued
+    uint32_t m_socketEvents;            ///!< events registered for the CAN socket
+    bool m_txStalled;                   ///!< frames were waiting on the socket
+    uint64_t m_nextSendMs;              ///!< next paced send time
+    uint64_t m_retrySendMs;             ///!< next retry of frames held by a full device queue, 0 for none
+    tCANBusMonitor::tBusState m_busState;   ///!< last logged bus state
+    SafeQueue<TxEntry> m_txQueue;       ///!< messages waiting to be sent
+    std::atomic<uint64_t> m_latencyCount;   ///!< LatencyStats, written on the reactor thread
+    std::atomic<uint64_t> m_latencyTotalUs;
+    std::atomic<uint64_t> m_latencyMaxUs;
+    BusMetrics m_metrics;               ///!< metrics of the bus
+    RxCounter m_rxCounter;              ///!< counts the received messages
+    uint64_t m_nextSampleMs;            ///!< next sample of the driver statistics
+    tNMEA2000_SocketCAN::tTxStats m_sampledTxStats;         ///!< driver statistics at the last sample
+    tCANBusMonitor::tErrorCounters m_sampledErrorCounters;
+};
+
+#endif
@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Metrics Server implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "MetricsServer.h"
+
+// C includes
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/prctl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// C++ includes
+
+// includes
+#include "../EventLogger.h"
+#include "../Metrics.h"
+
+namespace
+{
+    const int kPollTimeoutMs = 500;         // thread exit check
+    const int kRequestTimeoutMs = 1000;     // time for a client to send its request
+    const size_t kMaxRequestSize = 2048;
+#define METRICS_THREAD_NAME "Metrics"
+
+    //-------------------------------------
+    // write all of a buffer to a blocking socket
+    //-------------------------------------
+    bool WriteAll(int p_socket, const char * p_pData, size_t p_size)
+    {
+        while (p_size > 0)
+        {
+            ssize_t l_written = send(p_socket, p_pData, p_size, MSG_NOSIGNAL);
+            if (l_written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            p_pData += l_written;
+            p_size -= static_cast<size_t>(l_written);
+        }
+        return true;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricsServer::MetricsServer(uint16_t p_port, const std::string &p_rSocketPath)
+    : m_port(p_port), m_socketPath(p_rSocketPath), m_tcpSocket(-1), m_unixSocket(-1)
+{
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+MetricsServer::~MetricsServer()
+{
+    StopThread();
+    if (m_tcpSocket >= 0)
+    {
+        close(m_tcpSocket);
+    }
+    if (m_unixSocket >= 0)
+    {
+        close(m_unixSocket);
+        unlink(m_socketPath.c_str());
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool MetricsServer::Init()
+{
+    bool l_success = true;
+
+    if (m_port != 0)
+    {
+        m_tcpSocket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int l_reuse = 1;
+        struct sockaddr_in l_addr;
+        memset(&l_addr, 0, sizeof(l_addr));
+        l_addr.sin_family = AF_INET;
+        l_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        l_addr.sin_port = htons(m_port);
+        if (m_tcpSocket < 0
+            || setsockopt(m_tcpSocket, SOL_SOCKET, SO_REUSEADDR, &l_reuse, sizeof(l_reuse)) < 0
+            || bind(m_tcpSocket, reinterpret_cast<struct sockaddr *>(&l_addr), sizeof(l_addr)) < 0
+            || listen(m_tcpSocket, 4) < 0)
+        {
+            EventLogger::Error("MetricsServer() can not listen on 127.0.0.1:%d", m_port);
+            l_success = false;
+        }
+        else
+        {
+            EventLogger::LogEvent("MetricsServer() listening on 127.0.0.1:%d", m_port);
+        }
+    }
+
+    if (!m_socketPath.empty())
+    {
+        m_unixSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        struct sockaddr_un l_addr;
+        memset(&l_addr, 0, sizeof(l_addr));
+        l_addr.sun_family = AF_UNIX;
+        strncpy(l_addr.sun_path, m_socketPath.c_str(), sizeof(l_addr.sun_path) - 1);
+
+        // a socket left by a previous run
+        unlink(m_socketPath.c_str());
+        if (m_unixSocket < 0
+            || bind(m_unixSocket, reinterpret_cast<struct sockaddr *>(&l_addr), sizeof(l_addr)) < 0
+            || listen(m_unixSocket, 4) < 0)
+        {
+            EventLogger::Error("MetricsServer() can not listen on %s", m_socketPath.c_str());
+            l_success = false;
+        }
+        else
+        {
+            EventLogger::LogEvent("MetricsServer() listening on %s", m_socketPath.c_str());
+        }
+    }
+    return l_success;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool MetricsServer::StartThread()
+{
+    bool l_success(false);
+    m_threadRunning = true;
+    m_threadHandle = std::thread([=]
+                                 { ServerThread(); });
+    if (m_threadHandle.joinable())
+    {
+        l_success = true;
+    }
+    return l_success;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void MetricsServer::StopThread()
+{
+    if (m_threadRunning)
+    {
+        m_threadRunning = false;
+        if (m_threadHandle.joinable())
+        {
+            m_threadHandle.join();
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+/// Server Thread
+///- Details:   Waits on the listening sockets and answers each
+///             connection in turn
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void MetricsServer::ServerThread()
+{
+    EventLogger::Debug("#%s Thread Started", METRICS_THREAD_NAME);
+    prctl(PR_SET_NAME, METRICS_THREAD_NAME, 0, 0, 0);
+
+    struct pollfd l_fds[2];
+    int l_count = 0;
+    for (int l_socket : { m_tcpSocket, m_unixSocket })
+    {
+        if (l_socket >= 0)
+        {
+            l_fds[l_count].fd = l_socket;
+            l_fds[l_count].events = POLLIN;
+            l_count++;
+        }
+    }
+
+    while (m_threadRunning)
+    {
+        int l_ready = poll(l_fds, l_count, kPollTimeoutMs);
+        if (l_ready < 0 && errno != EINTR)
+        {
+            EventLogger::Error("MetricsServer poll failure %d", errno);
+            break;
+        }
+
+        for (int l_index = 0; l_ready > 0 && l_index < l_count; l_index++)
+        {
+            if (l_fds[l_index].revents & POLLIN)
+            {
+                int l_socket = accept4(l_fds[l_index].fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (l_socket >= 0)
+                {
+                    HandleConnection(l_socket);
+                    close(l_socket);
+                }
+            }
+        }
+    }
+
+    EventLogger::Debug("$%s Thread Exit", METRICS_THREAD_NAME);
+}
+
+/// HandleConnection
+///- Details:   Reads the request head, a slow or silent client is
+///             dropped after kRequestTimeoutMs
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void MetricsServer::HandleConnection(int p_socket)
+{
+    struct timeval l_timeout = { kRequestTimeoutMs / 1000, (kRequestTimeoutMs % 1000) * 1000 };
+    setsockopt(p_socket, SOL_SOCKET, SO_RCVTIMEO, &l_timeout, sizeof(l_timeout));
+    setsockopt(p_socket, SOL_SOCKET, SO_SNDTIMEO, &l_timeout, sizeof(l_timeout));
+
+    char l_request[kMaxRequestSize + 1];
+    size_t l_size = 0;
+    while (l_size < kMaxRequestSize)
+    {
+        ssize_t l_read = recv(p_socket, l_request + l_size, kMaxRequestSize - l_size, 0);
+        if (l_read <= 0)
+        {
+            break;
+        }
+        l_size += static_cast<size_t>(l_read);
+        l_request[l_size] = '\0';
+        if (strstr(l_request, "\r\n\r\n") != nullptr || strstr(l_request, "\n\n") != nullptr)
+        {
+            break;
+        }
+    }
+    l_request[l_size] = '\0';
+
+    std::string l_body;
+    const char * l_pStatus;
+    if (strncmp(l_request, "GET /metrics ", 13) == 0 || strncmp(l_request, "GET / ", 6) == 0)
+    {
+        l_pStatus = "200 OK";
+        l_body = MetricsRegistry::GetInstance()->Snapshot();
+    }
+    else
+    {
+        l_pStatus = "404 Not Found";
+        l_body = "GET /metrics\n";
+    }
+
+    char l_header[160];
+    int l_headerSize = snprintf(l_header, sizeof(l_header),
+                                "HTTP/1.0 %s\r\n"
+                                "Content-Type: text/plain; version=0.0.4\r\n"
+                                "Content-Length: %zu\r\n"
+                                "Connection: close\r\n\r\n",
+                                l_pStatus, l_body.size());
+    if (!WriteAll(p_socket, l_header, static_cast<size_t>(l_headerSize))
+        || !WriteAll(p_socket, l_body.data(), l_body.size()))
+    {
+        EVENT_DEBUG("MetricsServer() response not sent %d", errno);
+    }
+}
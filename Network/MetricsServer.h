@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Metrics Server header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _METRICS_SERVER_H_INCLUDED_
+#define _METRICS_SERVER_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <string>
+
+// includes
+#include "../IThread.h"
+
+//----------------------------------------------
+// Metrics Server answers HTTP GET /metrics with a snapshot of the
+// MetricsRegistry in the Prometheus text format. It listens on the
+// loopback address only and, when a path is given, on a Unix socket
+//
+//  curl http://127.0.0.1:<port>/metrics
+//  curl --unix-socket <path> http://localhost/metrics
+//
+// A request is answered and the connection closed, one at a time on
+// the server thread, so scraping never runs on the message path.
+//----------------------------------------------
+class MetricsServer : public IThread
+{
+public:
+    /// Default Constructor
+    /// Detail- Metrics Server constructor
+    /// Returns- n/a
+    /// Throws - n/a
+    MetricsServer
+    (
+        uint16_t p_port,                    ///< TCP port on 127.0.0.1, 0 for none
+        const std::string& p_rSocketPath    ///< Unix socket path, empty for none
+    );
+
+    /// Default Destructor
+    /// Detail- stops the thread, closes the sockets and removes the Unix socket
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual ~MetricsServer();
+
+    /// Init
+    /// Detail- Opens the listening sockets
+    /// Returns- true if every socket asked for is listening
+    /// Throws - n/a
+    bool Init();
+
+    /// Start Thread
+    ///- Details:   Method to Start the Thread, overrides the method in the base class
+    ///
+    ///- Returns:   true if the thread started OK
+    ///- Throws:    n/a
+    bool StartThread() override;
+
+    /// Stop Thread
+    ///- Details:   Method to Stop the Thread, overrides the method in the base class
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    void StopThread() override;
+
+private:
+    // accepts and answers the requests
+    void ServerThread();
+
+    // reads a request and writes the response
+    void HandleConnection(int p_socket);
+
+    uint16_t m_port;                ///!< TCP port, 0 for none
+    std::string m_socketPath;       ///!< Unix socket path, empty for none
+    int m_tcpSocket;                ///!< listening TCP socket
+    int m_unixSocket;               ///!< listening Unix socket
+};
+
+#endif
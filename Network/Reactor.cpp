@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : epoll Reactor implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "Reactor.h"
+
+// C includes
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+
+// C++ includes
+#include <algorithm>
+
+// includes
+#include "../EventLogger.h"
+
+namespace
+{
+    const int kMaxEvents = 16;
+#define REACTOR_THREAD_NAME "Reactor"
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+Reactor::Reactor()
+    : m_epollFd(-1), m_wakeFd(-1)
+{
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+Reactor::~Reactor()
+{
+    StopThread();
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+    }
+    if (m_epollFd >= 0)
+    {
+        close(m_epollFd);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool Reactor::Init()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0)
+    {
+        EventLogger::Error("Reactor() epoll_create1 failed %d", errno);
+        return false;
+    }
+
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0)
+    {
+        EventLogger::Error("Reactor() eventfd failed %d", errno);
+        return false;
+    }
+
+    struct epoll_event l_event = {};
+    l_event.events = EPOLLIN;
+    l_event.data.fd = m_wakeFd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &l_event) < 0)
+    {
+        EventLogger::Error("Reactor() failed to add wake fd %d", errno);
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool Reactor::AddHandler(int p_fd, uint32_t p_events, IEventHandler *p_pHandler)
+{
+    if (p_fd < 0 || p_pHandler == nullptr)
+    {
+        return false;
+    }
+
+    struct epoll_event l_event = {};
+    l_event.events = p_events;
+    l_event.data.fd = p_fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, p_fd, &l_event) < 0)
+    {
+        EventLogger::Error("Reactor() failed to add fd %d error %d", p_fd, errno);
+        return false;
+    }
+
+    if (static_cast<size_t>(p_fd) >= m_fdHandlers.size())
+    {
+        m_fdHandlers.resize(p_fd + 1, nullptr);
+    }
+    m_fdHandlers[p_fd] = p_pHandler;
+
+    if (std::find(m_handlers.begin(), m_handlers.end(), p_pHandler) == m_handlers.end())
+    {
+        m_handlers.push_back(p_pHandler);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool Reactor::ModifyHandler(int p_fd, uint32_t p_events)
+{
+    struct epoll_event l_event = {};
+    l_event.events = p_events;
+    l_event.data.fd = p_fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, p_fd, &l_event) < 0)
+    {
+        EventLogger::Error("Reactor() failed to modify fd %d error %d", p_fd, errno);
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void Reactor::RemoveHandler(int p_fd)
+{
+    if (p_fd < 0 || static_cast<size_t>(p_fd) >= m_fdHandlers.size() || m_fdHandlers[p_fd] == nullptr)
+    {
+        return;
+    }
+
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, p_fd, nullptr);
+    IEventHandler *l_pHandler = m_fdHandlers[p_fd];
+    m_fdHandlers[p_fd] = nullptr;
+
+    // keep the handler while it still owns other fds
+    if (std::find(m_fdHandlers.begin(), m_fdHandlers.end(), l_pHandler) == m_fdHandlers.end())
+    {
+        m_handlers.erase(std::remove(m_handlers.begin(), m_handlers.end(), l_pHandler), m_handlers.end());
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void Reactor::Wake()
+{
+    uint64_t l_value = 1;
+    if (write(m_wakeFd, &l_value, sizeof(l_value)) < 0 && errno != EAGAIN)
+    {
+        EventLogger::Error("Reactor() wake failed %d", errno);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool Reactor::StartThread()
+{
+    bool l_success(false);
+    // start the reactor thread
+    m_threadRunning = true;
+    m_threadHandle = std::thread([=]
+                                 { ReactorThread(); });
+    if (m_threadHandle.joinable())
+    {
+        l_success = true;
+    }
+    return l_success;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void Reactor::StopThread()
+{
+    // stop the reactor thread
+    if (m_threadRunning)
+    {
+        m_threadRunning = false;
+        Wake();
+        if (m_threadHandle.joinable())
+        {
+            m_threadHandle.join();
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int Reactor::GetTimeout()
+{
+    int l_timeout = -1;
+    for (IEventHandler *l_pHandler : m_handlers)
+    {
+        int l_handlerTimeout = l_pHandler->GetTimeToNextEvent();
+        if (l_handlerTimeout >= 0 && (l_timeout < 0 || l_handlerTimeout < l_timeout))
+        {
+            l_timeout = l_handlerTimeout;
+        }
+    }
+    return l_timeout;
+}
+
+/// Reactor Thread
+///- Details:   Waits for fd activity or the next handler deadline and
+///             dispatches to the handlers. With no activity and no
+///             deadline the thread sleeps in epoll_wait. The thread
+///             ends if epoll_wait fails other than by a signal
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void Reactor::ReactorThread()
+{
+    EventLogger::Debug("#%s Thread Started", REACTOR_THREAD_NAME);
+    // Set the thread name for system debugging
+    prctl(PR_SET_NAME, REACTOR_THREAD_NAME, 0, 0, 0);
+
+    struct epoll_event l_events[kMaxEvents];
+
+    while (m_threadRunning)
+    {
+        int l_count = epoll_wait(m_epollFd, l_events, kMaxEvents, GetTimeout());
+        if (l_count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // EBADF, EFAULT and EINVAL do not clear, so waiting again
+            // would spin. The thread ends, m_threadRunning is left for
+            // StopThread to join it
+            EventLogger::Error("Reactor epoll_wait failure %d, reactor stopped", errno);
+            break;
+        }
+
+        for (int l_index = 0; l_index < l_count && m_threadRunning; l_index++)
+        {
+            int l_fd = l_events[l_index].data.fd;
+            if (l_fd == m_wakeFd)
+            {
+                uint64_t l_value;
+                while (read(m_wakeFd, &l_value, sizeof(l_value)) > 0)
+                {
+                }
+            }
+            else if (static_cast<size_t>(l_fd) < m_fdHandlers.size() && m_fdHandlers[l_fd] != nullptr)
+            {
+                m_fdHandlers[l_fd]->HandleEvent(l_fd, l_events[l_index].events);
+            }
+        }
+
+        // service the handlers whose deadline has passed
+        for (size_t l_index = 0; l_index < m_handlers.size() && m_threadRunning; l_index++)
+        {
+            if (m_handlers[l_index]->GetTimeToNextEvent() == 0)
+            {
+                m_handlers[l_index]->HandleTimeout();
+            }
+        }
+    }
+
+    EventLogger::Debug("$%s Thread Exit", REACTOR_THREAD_NAME);
+}
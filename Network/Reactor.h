@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : epoll Reactor header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _REACTOR_H_INCLUDED_
+#define _REACTOR_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <vector>
+
+// includes
+#include "../IThread.h"
+
+//---------------------------------------
+// Interface class for handlers registered on the Reactor
+//---------------------------------------
+class IEventHandler
+{
+public:
+    /// Default Destructor
+    /// Detail- virtual base class destructor
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual ~IEventHandler() {}
+
+    /// HandleEvent
+    /// Detail- Called from the reactor thread when a registered fd is ready
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual void HandleEvent
+    (
+        int p_fd,               ///< file descriptor which is ready
+        uint32_t p_events       ///< epoll events
+    ) = 0;
+
+    /// GetTimeToNextEvent
+    /// Detail- Time until the handler needs servicing without fd activity
+    /// Returns- time in ms, -1 if the handler has no timed work
+    /// Throws - n/a
+    virtual int GetTimeToNextEvent() { return -1; }
+
+    /// HandleTimeout
+    /// Detail- Called from the reactor thread when GetTimeToNextEvent has elapsed
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual void HandleTimeout() {}
+};
+
+//----------------------------------------------
+// Reactor class waits on all registered file descriptors with a
+// single epoll_wait, sleeping until the next handler deadline.
+// Handlers are called from the reactor thread only.
+//----------------------------------------------
+class Reactor : public IThread
+{
+public:
+    /// Default Constructor
+    /// Detail- Reactor constructor
+    /// Returns- n/a
+    /// Throws - n/a
+    Reactor();
+
+    /// Default Destructor
+    /// Detail- stops the thread and closes the epoll fd
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual ~Reactor();
+
+    /// Init
+    /// Detail- Creates the epoll instance and the wake up eventfd
+    /// Returns- true if the reactor was initialised
+    /// Throws - n/a
+    bool Init();
+
+    /// AddHandler
+    /// Detail- Registers a file descriptor. The handler is also asked for
+    ///         its next deadline. Call before the thread is started or
+    ///         from the reactor thread
+    /// Returns- true if the fd was added
+    /// Throws - n/a
+    bool AddHandler
+    (
+        int p_fd,                       ///< file descriptor
+        uint32_t p_events,              ///< epoll events to wait for
+        IEventHandler* p_pHandler       ///< handler called when the fd is ready
+    );
+
+    /// ModifyHandler
+    /// Detail- Changes the events waited on a registered file descriptor
+    /// Returns- true if the events were changed
+    /// Throws - n/a
+    bool ModifyHandler
+    (
+        int p_fd,                       ///< file descriptor
+        uint32_t p_events               ///< epoll events to wait for
+    );
+
+    /// RemoveHandler
+    /// Detail- Removes a registered file descriptor
+    /// Returns- n/a
+    /// Throws - n/a
+    void RemoveHandler
+    (
+        int p_fd                        ///< file descriptor
+    );
+
+    /// Wake
+    /// Detail- Wakes the reactor thread, so deadlines are re-evaluated.
+    ///         Safe to call from any thread
+    /// Returns- n/a
+    /// Throws - n/a
+    void Wake();
+
+    /// Start Thread
+    ///- Details:   Method to Start the Thread, overrides the method in the base class
+    ///
+    ///- Returns:   true if the thread started OK
+    ///- Throws:    n/a
+    bool StartThread() override;
+
+    /// Stop Thread
+    ///- Details:   Method to Stop the Thread, overrides the method in the base class
+    ///
+    ///- Returns:   n/a
+    ///- Throws:    n/a
+    void StopThread() override;
+
+private:
+    // The Reactor Thread function
+    void ReactorThread();
+
+    // Shortest timeout of all handlers
+    int GetTimeout();
+
+    int m_epollFd;                              ///< epoll instance
+    int m_wakeFd;                               ///< eventfd used to wake the thread
+    std::vector<IEventHandler*> m_fdHandlers;   ///< handlers indexed by fd
+    std::vector<IEventHandler*> m_handlers;     ///< unique registered handlers
+};
+
+#endif
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Serial NMEA0183 Reader implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "SerialReader.h"
+
+// C includes
+#include <string.h>
+#include <sys/epoll.h>
+
+// C++ includes
+
+// includes
+#include "../EventLogger.h"
+#include "../Handlers/MessageHandlerInterface.h"
+#include "../LatencyTrace.h"
+#include "../Metrics.h"
+
+namespace
+{
+    const size_t kMaxSentenceSize = MAX_NMEA0183_MSG_BUF_LEN + 4;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+SerialReader::SerialReader(IMessageHandlerInterface *p_pMessageHandler, Reactor &p_rReactor,
+                           const std::string &p_rDevice, uint32_t p_baud)
+    : m_pMsgHandler(p_pMessageHandler), m_rReactor(p_rReactor), m_device(p_rDevice), m_baud(p_baud), m_pStream(nullptr)
+{
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    std::string l_device = "device=\"" + p_rDevice + "\"";
+    m_pSentences = l_pRegistry->AddCounter("nmea2can_serial_sentences_total", "Serial NMEA0183 sentences received", l_device);
+    m_pErrors = l_pRegistry->AddCounter("nmea2can_serial_errors_total", "Serial NMEA0183 sentences not handled", l_device);
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+SerialReader::~SerialReader()
+{
+    if (IsOpen())
+    {
+        m_rReactor.RemoveHandler(m_pStream->GetFd());
+    }
+    delete m_pStream;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool SerialReader::Init()
+{
+    m_pStream = new tNMEA0183LinuxStream(m_device.c_str(), m_baud);
+    if (!m_pStream->IsOpen())
+    {
+        EventLogger::Error("SerialReader() can not open %s at %u baud", m_device.c_str(), m_baud);
+        return false;
+    }
+
+    m_nmea0183.SetMessageStream(m_pStream);
+    if (!m_nmea0183.Open() || !m_rReactor.AddHandler(m_pStream->GetFd(), EPOLLIN, this))
+    {
+        EventLogger::Error("SerialReader() can not read %s", m_device.c_str());
+        delete m_pStream;
+        m_pStream = nullptr;
+        return false;
+    }
+
+    EventLogger::LogEvent("SerialReader() Opened %s at %u baud", m_device.c_str(), m_baud);
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void SerialReader::HandleEvent(int p_fd, uint32_t p_events)
+{
+    // a USB adaptor that has been unplugged
+    if (p_events & (EPOLLHUP | EPOLLERR))
+    {
+        EventLogger::Error("SerialReader() %s closed", m_device.c_str());
+        m_rReactor.RemoveHandler(p_fd);
+        delete m_pStream;
+        m_pStream = nullptr;
+        m_nmea0183.SetMessageStream(nullptr);
+        return;
+    }
+
+    // the sentence is passed on as text, as received from the network
+    tNMEA0183Msg l_msg;
+    char l_sentence[kMaxSentenceSize];
+    while (m_nmea0183.GetMessage(l_msg))
+    {
+        LatencyTrace::Begin();
+        m_pSentences->Add();
+        if (!l_msg.GetMessage(l_sentence, sizeof(l_sentence)))
+        {
+            m_pErrors->Add();
+            continue;
+        }
+
+        uint16_t l_size = static_cast<uint16_t>(strlen(l_sentence));
+        if (m_pMsgHandler != nullptr && !m_pMsgHandler->HandleMessage(reinterpret_cast<const uint8_t *>(l_sentence), l_size))
+        {
+            m_pErrors->Add();
+        }
+    }
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Serial NMEA0183 Reader header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _SERIAL_READER_H_INCLUDED_
+#define _SERIAL_READER_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <string>
+
+// includes
+#include "Reactor.h"
+#include <NMEA0183.h>
+#include <NMEA0183LinuxStream.h>
+
+// forward declarations
+class IMessageHandlerInterface;
+class MetricCounter;
+
+//----------------------------------------------
+// Serial Reader reads NMEA0183 sentences from a serial port, e.g. a
+// 4800 baud instrument or a 38400 baud AIS receiver, and passes them to
+// the message handler as the UDP Reader does.
+//
+// The port is watched on a reactor. When it is readable the stream reads
+// what has arrived in one go and tNMEA0183 frames the sentences, so a
+// busy port costs a read per chunk not a read per byte. Several ports
+// can share one reactor.
+//----------------------------------------------
+class SerialReader : public IEventHandler
+{
+public:
+    /// Default Constructor
+    /// Detail- Serial Reader constructor, the port is opened by Init
+    /// Returns- n/a
+    /// Throws - n/a
+    SerialReader
+    (
+        IMessageHandlerInterface* p_pMessageHandler,    ///< pointer to the message handler
+        Reactor& p_rReactor,                            ///< reactor watching the port
+        const std::string& p_rDevice,                   ///< serial device, e.g. /dev/ttyUSB0
+        uint32_t p_baud                                 ///< baud rate
+    );
+
+    /// Default Destructor
+    /// Detail- Removes the port from the reactor and closes it
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual ~SerialReader();
+
+    /// Init
+    /// Detail- Opens and configures the port and registers it on the reactor.
+    ///         Call before the reactor thread is started
+    /// Returns- true if the port is open
+    /// Throws - n/a
+    bool Init();
+
+    /// IsOpen
+    ///- Details:   Returns the state of the port
+    ///
+    ///- Returns:   true if the port is open
+    ///- Throws:    n/a
+    bool IsOpen() { return m_pStream != nullptr && m_pStream->IsOpen(); }
+
+    /// HandleEvent
+    /// Detail- Reads the port and passes the sentences to the message handler
+    /// Returns- n/a
+    /// Throws - n/a
+    void HandleEvent
+    (
+        int p_fd,               ///< file descriptor which is ready
+        uint32_t p_events       ///< epoll events
+    ) override;
+
+private:
+    IMessageHandlerInterface* m_pMsgHandler;    ///!< The message handler instance
+    Reactor& m_rReactor;                        ///!< reactor watching the port
+    std::string m_device;                       ///!< serial device
+    uint32_t m_baud;                            ///!< baud rate
+    tNMEA0183LinuxStream* m_pStream;            ///!< the port
+    tNMEA0183 m_nmea0183;                       ///!< sentence framing
+    MetricCounter* m_pSentences;                ///!< sentences received
+    MetricCounter* m_pErrors;                   ///!< sentences not handled
+};
+
+#endif
@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Source address filter implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "SourceFilter.h"
+
+// C includes
+#include <stdlib.h>
+#include <arpa/inet.h>
+
+// C++ includes
+#include <algorithm>
+
+// includes
+#include "../EventLogger.h"
+
+namespace
+{
+    const uint64_t kTokensPerDatagram = 1000000;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+SourceFilter::SourceFilter(uint32_t p_rate, uint32_t p_burst)
+    : m_rate(p_rate), m_burst(static_cast<uint64_t>(p_burst > 0 ? p_burst : 1) * kTokensPerDatagram)
+{
+    m_shared.m_tokens = m_burst;
+    m_shared.m_updatedUs = 0;
+    m_shared.m_limited = false;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool SourceFilter::Allow(const std::string &p_rRange)
+{
+    Range l_range;
+    if (!Parse(p_rRange, l_range))
+    {
+        return false;
+    }
+    m_allow.push_back(l_range);
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool SourceFilter::Deny(const std::string &p_rRange)
+{
+    Range l_range;
+    if (!Parse(p_rRange, l_range))
+    {
+        return false;
+    }
+    m_deny.push_back(l_range);
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool SourceFilter::AddRoute(const std::string &p_rRange, IMessageHandlerInterface *p_pMessageHandler)
+{
+    Range l_range;
+    if (!Parse(p_rRange, l_range))
+    {
+        return false;
+    }
+    m_routes.push_back(std::make_pair(l_range, p_pMessageHandler));
+    return true;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool SourceFilter::IsActive() const
+{
+    return !m_allow.empty() || !m_deny.empty() || !m_routes.empty() || m_rate != 0;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+eSourceVerdict SourceFilter::Check(uint32_t p_address, uint64_t p_nowUs)
+{
+    uint32_t l_address = ntohl(p_address);
+    if (Match(m_deny, l_address) || (!m_allow.empty() && !Match(m_allow, l_address)))
+    {
+        return eSourceVerdict::Denied;
+    }
+    if (m_rate == 0)
+    {
+        return eSourceVerdict::Accept;
+    }
+
+    Bucket &l_rBucket = GetBucket(p_address, p_nowUs);
+    if (Take(l_rBucket, p_nowUs))
+    {
+        l_rBucket.m_limited = false;
+        return eSourceVerdict::Accept;
+    }
+
+    // log when a source starts being dropped, not for every datagram
+    if (!l_rBucket.m_limited)
+    {
+        l_rBucket.m_limited = true;
+        char l_name[INET_ADDRSTRLEN] = "";
+        inet_ntop(AF_INET, &p_address, l_name, sizeof(l_name));
+        EventLogger::LogEvent("SourceFilter() %s is over its rate, dropping", l_name);
+    }
+    return eSourceVerdict::Limited;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+IMessageHandlerInterface *SourceFilter::Route(uint32_t p_address, IMessageHandlerInterface *p_pDefault) const
+{
+    uint32_t l_address = ntohl(p_address);
+    for (const auto &l_rRoute : m_routes)
+    {
+        if ((l_address & l_rRoute.first.m_mask) == l_rRoute.first.m_network)
+        {
+            return l_rRoute.second;
+        }
+    }
+    return p_pDefault;
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+/// Parse
+///- Details:   Parses address/prefix, an address on its own is a /32
+///
+///- Returns:   false if the range is not valid
+///- Throws:    n/a
+bool SourceFilter::Parse(const std::string &p_rRange, Range &p_rResult)
+{
+    std::string l_address = p_rRange;
+    unsigned long l_prefix = 32;
+    size_t l_slash = p_rRange.find('/');
+    if (l_slash != std::string::npos)
+    {
+        l_address = p_rRange.substr(0, l_slash);
+        char *l_pEnd = nullptr;
+        l_prefix = strtoul(p_rRange.c_str() + l_slash + 1, &l_pEnd, 10);
+        if (l_pEnd == p_rRange.c_str() + l_slash + 1 || *l_pEnd != '\0' || l_prefix > 32)
+        {
+            EventLogger::Error("SourceFilter() invalid prefix %s", p_rRange.c_str());
+            return false;
+        }
+    }
+
+    struct in_addr l_addr;
+    if (inet_pton(AF_INET, l_address.c_str(), &l_addr) != 1)
+    {
+        EventLogger::Error("SourceFilter() invalid address %s", p_rRange.c_str());
+        return false;
+    }
+
+    p_rResult.m_mask = (l_prefix == 0) ? 0 : (0xFFFFFFFFu << (32 - l_prefix));
+    p_rResult.m_network = ntohl(l_addr.s_addr) & p_rResult.m_mask;
+    return true;
+}
+
+/// Match
+///- Details:   Searches a list of ranges
+///
+///- Returns:   true if a range holds the address
+///- Throws:    n/a
+bool SourceFilter::Match(const std::vector<Range> &p_rList, uint32_t p_address)
+{
+    for (const Range &l_rRange : p_rList)
+    {
+        if ((p_address & l_rRange.m_mask) == l_rRange.m_network)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// GetBucket
+///- Details:   Finds the source's bucket, a new source starts with a
+///             full bucket. When kMaxSources are tracked the buckets
+///             that are full again are removed, they are the same as new
+///             ones. If none are, the source uses the shared bucket.
+///             A bucket refilled later than p_nowUs, the time stepped
+///             back, is kept and restarts from p_nowUs
+///
+///- Returns:   the bucket
+///- Throws:    n/a
+SourceFilter::Bucket &SourceFilter::GetBucket(uint32_t p_address, uint64_t p_nowUs)
+{
+    auto l_found = m_buckets.find(p_address);
+    if (l_found != m_buckets.end())
+    {
+        return l_found->second;
+    }
+
+    if (m_buckets.size() >= kMaxSources)
+    {
+        for (auto l_it = m_buckets.begin(); l_it != m_buckets.end();)
+        {
+            // idle long enough to have refilled from empty
+            if (p_nowUs < l_it->second.m_updatedUs)
+            {
+                l_it->second.m_updatedUs = p_nowUs;
+                ++l_it;
+            }
+            else if (p_nowUs - l_it->second.m_updatedUs >= m_burst / m_rate)
+            {
+                l_it = m_buckets.erase(l_it);
+            }
+            else
+            {
+                ++l_it;
+            }
+        }
+        if (m_buckets.size() >= kMaxSources)
+        {
+            return m_shared;
+        }
+    }
+
+    Bucket &l_rBucket = m_buckets[p_address];
+    l_rBucket.m_tokens = m_burst;
+    l_rBucket.m_updatedUs = p_nowUs;
+    l_rBucket.m_limited = false;
+    return l_rBucket;
+}
+
+/// Take
+///- Details:   Refills the bucket for the time since it was last
+///             refilled, up to the burst, then takes a datagram's tokens.
+///             If the time stepped back the bucket is not refilled, and
+///             refills from the new time on
+///
+///- Returns:   false if there were not enough tokens
+///- Throws:    n/a
+bool SourceFilter::Take(Bucket &p_rBucket, uint64_t p_nowUs)
+{
+    if (p_nowUs > p_rBucket.m_updatedUs)
+    {
+        uint64_t l_elapsed = p_nowUs - p_rBucket.m_updatedUs;
+        // the bucket is full after m_burst / m_rate us, limit the product
+        p_rBucket.m_tokens = (l_elapsed >= m_burst / m_rate) ? m_burst
+                                                             : std::min(m_burst, p_rBucket.m_tokens + l_elapsed * m_rate);
+    }
+    p_rBucket.m_updatedUs = p_nowUs;
+    if (p_rBucket.m_tokens < kTokensPerDatagram)
+    {
+        return false;
+    }
+    p_rBucket.m_tokens -= kTokensPerDatagram;
+    return true;
+}
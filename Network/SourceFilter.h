@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Source address filter header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _SOURCE_FILTER_H_INCLUDED_
+#define _SOURCE_FILTER_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// includes
+
+// forward declarations
+class IMessageHandlerInterface;
+
+//----------------------------------------------
+// Result of checking a source
+//----------------------------------------------
+enum class eSourceVerdict
+{
+    Accept,     ///< pass the data on
+    Denied,     ///< source is not allowed
+    Limited     ///< source is sending faster than its rate
+};
+
+//----------------------------------------------
+// Source Filter decides what a network input does with data from an
+// IPv4 source before it is parsed.
+//
+// Allow and deny lists hold address/prefix ranges, e.g. 192.168.1.0/24.
+// A denied source is dropped, and when there is an allow list a source
+// must be on it.
+//
+// Each source has a token bucket of p_burst datagrams refilled at
+// p_rate a second, so a talker that floods the port is dropped without
+// holding up the others. Up to kMaxSources are tracked, sources beyond
+// that share one bucket. The time passed to Check should be monotonic,
+// if it steps back the buckets carry on from the new time.
+//
+// Routes send the data from a range to another message handler, e.g. a
+// converter for one bus.
+//
+// Check updates the buckets and is not thread safe, each reader has its
+// own copy of the filter.
+//----------------------------------------------
+class SourceFilter
+{
+public:
+    /// Default Constructor
+    /// Detail- Source Filter constructor
+    /// Returns- n/a
+    /// Throws - n/a
+    SourceFilter
+    (
+        uint32_t p_rate = 0,    ///< datagrams a second from each source, 0 for no limit
+        uint32_t p_burst = 0    ///< datagrams a source can send at once
+    );
+
+    /// Allow
+    /// Detail- Adds a range to the allow list
+    /// Returns- false if the range is not valid
+    /// Throws - n/a
+    bool Allow
+    (
+        const std::string& p_rRange     ///< address/prefix, or an address
+    );
+
+    /// Deny
+    /// Detail- Adds a range to the deny list
+    /// Returns- false if the range is not valid
+    /// Throws - n/a
+    bool Deny
+    (
+        const std::string& p_rRange     ///< address/prefix, or an address
+    );
+
+    /// AddRoute
+    /// Detail- Data from the range goes to the handler, the first route
+    ///         matching is used
+    /// Returns- false if the range is not valid
+    /// Throws - n/a
+    bool AddRoute
+    (
+        const std::string& p_rRange,                ///< address/prefix, or an address
+        IMessageHandlerInterface* p_pMessageHandler ///< handler for the range
+    );
+
+    /// IsActive
+    /// Detail- The filter has something to check
+    /// Returns- true if there are lists, a rate or routes
+    /// Throws - n/a
+    bool IsActive() const;
+
+    /// Check
+    /// Detail- Checks the lists and takes a token from the source's bucket
+    /// Returns- what to do with the data
+    /// Throws - n/a
+    eSourceVerdict Check
+    (
+        uint32_t p_address,     ///< IPv4 source address, network byte order
+        uint64_t p_nowUs        ///< time now in us, monotonic
+    );
+
+    /// Route
+    /// Detail- Finds the handler for a source
+    /// Returns- the routed handler, or p_pDefault
+    /// Throws - n/a
+    IMessageHandlerInterface* Route
+    (
+        uint32_t p_address,                     ///< IPv4 source address, network byte order
+        IMessageHandlerInterface* p_pDefault    ///< handler when no route matches
+    ) const;
+
+private:
+    //----------------------------------------------
+    // Address range, host byte order
+    //----------------------------------------------
+    struct Range
+    {
+        uint32_t m_network;     ///< network address
+        uint32_t m_mask;        ///< prefix mask
+    };
+
+    //----------------------------------------------
+    // Token bucket, tokens in millionths of a datagram
+    //----------------------------------------------
+    struct Bucket
+    {
+        uint64_t m_tokens;      ///< tokens available
+        uint64_t m_updatedUs;   ///< time the bucket was refilled
+        bool m_limited;         ///< dropping, logged once
+    };
+
+    // parse address/prefix
+    static bool Parse(const std::string& p_rRange, Range& p_rResult);
+
+    // true if a range in the list holds the address
+    static bool Match(const std::vector<Range>& p_rList, uint32_t p_address);
+
+    // the bucket for a source, or the shared bucket when full
+    Bucket& GetBucket(uint32_t p_address, uint64_t p_nowUs);
+
+    // refill and take a token, false if the bucket is empty
+    bool Take(Bucket& p_rBucket, uint64_t p_nowUs);
+
+    static const size_t kMaxSources = 256;
+
+    uint64_t m_rate;                                    ///!< tokens a us, millionths of a datagram
+    uint64_t m_burst;                                   ///!< bucket size, millionths of a datagram
+    std::vector<Range> m_allow;                         ///!< allowed ranges, empty allows all
+    std::vector<Range> m_deny;                          ///!< denied ranges
+    std::vector<std::pair<Range, IMessageHandlerInterface*>> m_routes; ///!< handler for a range
+    std::unordered_map<uint32_t, Bucket> m_buckets;     ///!< bucket for each source
+    Bucket m_shared;                                    ///!< bucket for sources beyond kMaxSources
+};
+
+#endif
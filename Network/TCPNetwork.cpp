@@ -0,0 +1,669 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : TCP NMEA0183 Network implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "TCPNetwork.h"
+
+// C includes
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// C++ includes
+
+// includes
+#include "../EventLogger.h"
+#include "../Handlers/MessageHandlerInterface.h"
+#include "../Config.h"
+#include "../LatencyTrace.h"
+#include "../Metrics.h"
+#include "../Utils.h"
+
+namespace
+{
+    const size_t kRxChunkSize = 4096;
+    const int kMaxReadsPerEvent = 4;        // a busy client gives way to the others
+    const int kListenBacklog = 128;
+    const uint32_t kRxEvents = EPOLLIN | EPOLLRDHUP;
+
+    //-------------------------------------
+    // address:port of a socket address
+    //-------------------------------------
+    std::string PeerName(const struct sockaddr_in & p_rAddr)
+    {
+        char l_address[INET_ADDRSTRLEN] = "";
+        inet_ntop(AF_INET, &p_rAddr.sin_addr, l_address, sizeof(l_address));
+        return std::string(l_address) + ":" + std::to_string(ntohs(p_rAddr.sin_port));
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+TCPNetwork::TCPNetwork(IMessageHandlerInterface *p_pMessageHandler, Reactor &p_rReactor, uint16_t p_listenPort,
+                       const std::string &p_rClientAddress, uint16_t p_clientPort)
+    : m_pMsgHandler(p_pMessageHandler), m_rReactor(p_rReactor), m_listenPort(p_listenPort),
+      m_clientAddress(p_rClientAddress), m_clientPort(p_clientPort), m_listenSocket(-1), m_clientSocket(-1),
+      m_txEventFd(-1), m_reconnectMs(0), m_connectionCount(0)
+{
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    m_pConnections = l_pRegistry->AddGauge("nmea2can_tcp_connections", "TCP connections open");
+    m_pAccepted = l_pRegistry->AddCounter("nmea2can_tcp_accepted_total", "TCP clients accepted");
+    m_pRejected = l_pRegistry->AddCounter("nmea2can_tcp_rejected_total", "TCP clients refused, too many connections");
+    m_pRxBytes = l_pRegistry->AddCounter("nmea2can_tcp_rx_bytes_total", "TCP bytes received");
+    m_pSentences = l_pRegistry->AddCounter("nmea2can_tcp_sentences_total", "TCP sentences received");
+    m_pTxBytes = l_pRegistry->AddCounter("nmea2can_tcp_tx_bytes_total", "TCP bytes sent");
+    m_pTxDropped = l_pRegistry->AddCounter("nmea2can_tcp_tx_dropped_total", "TCP sentences dropped for slow clients");
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+TCPNetwork::~TCPNetwork()
+{
+    for (std::unique_ptr<Connection> &l_rpConnection : m_connections)
+    {
+        if (l_rpConnection)
+        {
+            m_rReactor.RemoveHandler(l_rpConnection->m_socket);
+            close(l_rpConnection->m_socket);
+        }
+    }
+    if (m_listenSocket >= 0)
+    {
+        m_rReactor.RemoveHandler(m_listenSocket);
+        close(m_listenSocket);
+    }
+    if (m_txEventFd >= 0)
+    {
+        m_rReactor.RemoveHandler(m_txEventFd);
+        close(m_txEventFd);
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool TCPNetwork::Init()
+{
+    bool l_success = true;
+
+    m_txEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_txEventFd < 0 || !m_rReactor.AddHandler(m_txEventFd, EPOLLIN, this))
+    {
+        EventLogger::Error("TCPNetwork() can not create the send event %d", errno);
+        return false;
+    }
+
+    if (m_listenPort != 0)
+    {
+        m_listenSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int l_reuse = 1;
+        struct sockaddr_in l_addr;
+        memset(&l_addr, 0, sizeof(l_addr));
+        l_addr.sin_family = AF_INET;
+        l_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        l_addr.sin_port = htons(m_listenPort);
+        if (m_listenSocket < 0
+            || setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &l_reuse, sizeof(l_reuse)) < 0
+            || bind(m_listenSocket, reinterpret_cast<struct sockaddr *>(&l_addr), sizeof(l_addr)) < 0
+            || listen(m_listenSocket, kListenBacklog) < 0
+            || !m_rReactor.AddHandler(m_listenSocket, EPOLLIN, this))
+        {
+            EventLogger::Error("TCPNetwork() can not listen on port %d", m_listenPort);
+            l_success = false;
+        }
+        else
+        {
+            EventLogger::LogEvent("TCPNetwork() listening on port %d", m_listenPort);
+        }
+    }
+
+    if (!m_clientAddress.empty())
+    {
+        Connect();
+    }
+    return l_success;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int16_t TCPNetwork::SendData(const char *p_pData, uint16_t p_dataSize, int p_socket)
+{
+    Lock l_lock(m_lock);
+    bool l_queued = false;
+    bool l_dropped = false;
+    bool l_wake = m_txReady.empty();
+
+    if (p_socket >= 0)
+    {
+        if (static_cast<size_t>(p_socket) < m_connections.size() && m_connections[p_socket])
+        {
+            l_queued = Queue(*m_connections[p_socket], p_pData, p_dataSize);
+            l_dropped = !l_queued;
+        }
+    }
+    else
+    {
+        for (std::unique_ptr<Connection> &l_rpConnection : m_connections)
+        {
+            if (l_rpConnection)
+            {
+                bool l_sent = Queue(*l_rpConnection, p_pData, p_dataSize);
+                l_queued |= l_sent;
+                l_dropped |= !l_sent;
+            }
+        }
+    }
+
+    // the reactor sends, so a sentence to many clients does not make a
+    // send() per client on this thread
+    if (l_wake && !m_txReady.empty())
+    {
+        uint64_t l_value = 1;
+        if (write(m_txEventFd, &l_value, sizeof(l_value)) < 0 && errno != EAGAIN)
+        {
+            EventLogger::Error("TCPNetwork() send event failed %d", errno);
+        }
+    }
+
+    if (l_queued)
+    {
+        return static_cast<int16_t>(p_dataSize);
+    }
+    return l_dropped ? -1 : 0;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+size_t TCPNetwork::GetConnectionCount()
+{
+    Lock l_lock(m_lock);
+    return m_connectionCount;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void TCPNetwork::HandleEvent(int p_fd, uint32_t p_events)
+{
+    if (p_fd == m_listenSocket)
+    {
+        Accept();
+        return;
+    }
+    if (p_fd == m_txEventFd)
+    {
+        SendQueued();
+        return;
+    }
+    if (static_cast<size_t>(p_fd) >= m_connections.size() || !m_connections[p_fd])
+    {
+        return;
+    }
+    Connection &l_rConnection = *m_connections[p_fd];
+
+    // the connection out completes when the socket is writable
+    if (l_rConnection.m_connecting)
+    {
+        int l_error = 0;
+        socklen_t l_length = sizeof(l_error);
+        if (getsockopt(p_fd, SOL_SOCKET, SO_ERROR, &l_error, &l_length) < 0 || l_error != 0)
+        {
+            CloseConnection(l_rConnection, "connect failed");
+            return;
+        }
+        EventLogger::LogEvent("TCPNetwork() connected to %s", l_rConnection.m_peer.c_str());
+        Lock l_lock(m_lock);
+        l_rConnection.m_connecting = false;
+        Flush(l_rConnection);
+        return;
+    }
+
+    if (p_events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+    {
+        // closes the connection when the peer has gone
+        if (!Receive(l_rConnection))
+        {
+            return;
+        }
+    }
+
+    if (p_events & EPOLLOUT)
+    {
+        bool l_flushed;
+        {
+            Lock l_lock(m_lock);
+            l_flushed = Flush(l_rConnection);
+        }
+        if (!l_flushed)
+        {
+            CloseConnection(l_rConnection, "send failed");
+        }
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int TCPNetwork::GetTimeToNextEvent()
+{
+    if (m_clientAddress.empty() || m_clientSocket >= 0)
+    {
+        return -1;
+    }
+    uint64_t l_now = Utils::CurrentTimestampMilliSeconds();
+    return (m_reconnectMs > l_now) ? static_cast<int>(m_reconnectMs - l_now) : 0;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+void TCPNetwork::HandleTimeout()
+{
+    if (!m_clientAddress.empty() && m_clientSocket < 0 && Utils::CurrentTimestampMilliSeconds() >= m_reconnectMs)
+    {
+        Connect();
+    }
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+/// Accept
+///- Details:   Accepts every client waiting, a client over
+///             cTCP_MAX_CONNECTIONS is closed straight away
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void TCPNetwork::Accept()
+{
+    while (true)
+    {
+        struct sockaddr_in l_addr;
+        socklen_t l_length = sizeof(l_addr);
+        int l_socket = accept4(m_listenSocket, reinterpret_cast<struct sockaddr *>(&l_addr), &l_length,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (l_socket < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                EventLogger::Error("TCPNetwork() accept failed %d", errno);
+            }
+            return;
+        }
+
+        if (GetConnectionCount() >= cTCP_MAX_CONNECTIONS)
+        {
+            m_pRejected->Add();
+            close(l_socket);
+            continue;
+        }
+
+        if (AddConnection(l_socket, l_addr, false) != nullptr)
+        {
+            m_pAccepted->Add();
+        }
+    }
+}
+
+/// Connect
+///- Details:   Starts the connection out to the multiplexer, it
+///             completes on the reactor. A failure is retried after
+///             cTCP_RECONNECT_MS
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void TCPNetwork::Connect()
+{
+    m_reconnectMs = Utils::CurrentTimestampMilliSeconds() + cTCP_RECONNECT_MS;
+
+    struct sockaddr_in l_addr;
+    memset(&l_addr, 0, sizeof(l_addr));
+    l_addr.sin_family = AF_INET;
+    l_addr.sin_port = htons(m_clientPort);
+    if (inet_pton(AF_INET, m_clientAddress.c_str(), &l_addr.sin_addr) != 1)
+    {
+        EventLogger::Error("TCPNetwork() invalid address %s", m_clientAddress.c_str());
+        return;
+    }
+
+    int l_socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (l_socket < 0)
+    {
+        EventLogger::Error("TCPNetwork() can not open a socket %d", errno);
+        return;
+    }
+
+    int l_result = connect(l_socket, reinterpret_cast<struct sockaddr *>(&l_addr), sizeof(l_addr));
+    if (l_result < 0 && errno != EINPROGRESS)
+    {
+        EVENT_DEBUG("TCPNetwork() connect to %s failed %d", PeerName(l_addr).c_str(), errno);
+        close(l_socket);
+        return;
+    }
+
+    Connection *l_pConnection = AddConnection(l_socket, l_addr, true);
+    if (l_pConnection != nullptr)
+    {
+        m_clientSocket = l_socket;
+        if (l_result < 0)
+        {
+            // writable when connected
+            l_pConnection->m_connecting = true;
+            l_pConnection->m_txWatched = true;
+            m_rReactor.ModifyHandler(l_socket, kRxEvents | EPOLLOUT);
+        }
+        else
+        {
+            EventLogger::LogEvent("TCPNetwork() connected to %s", l_pConnection->m_peer.c_str());
+        }
+    }
+}
+
+/// AddConnection
+///- Details:   Registers a connected socket on the reactor
+///
+///- Returns:   the connection, nullptr if it could not be added
+///- Throws:    n/a
+TCPNetwork::Connection *TCPNetwork::AddConnection(int p_socket, const struct sockaddr_in &p_rPeer, bool p_outbound)
+{
+    // sentences are small and latency matters more than packet count
+    int l_noDelay = 1;
+    setsockopt(p_socket, IPPROTO_TCP, TCP_NODELAY, &l_noDelay, sizeof(l_noDelay));
+
+    std::unique_ptr<Connection> l_pConnection(new Connection());
+    l_pConnection->m_socket = p_socket;
+    l_pConnection->m_outbound = p_outbound;
+    l_pConnection->m_connecting = false;
+    l_pConnection->m_discarding = false;
+    l_pConnection->m_txWatched = false;
+    l_pConnection->m_txReady = false;
+    l_pConnection->m_peer = PeerName(p_rPeer);
+    l_pConnection->m_peerAddress = p_rPeer.sin_addr.s_addr;
+    l_pConnection->m_rxSize = 0;
+    l_pConnection->m_txSent = 0;
+    Connection *l_pAdded = l_pConnection.get();
+
+    {
+        Lock l_lock(m_lock);
+        if (static_cast<size_t>(p_socket) >= m_connections.size())
+        {
+            m_connections.resize(p_socket + 1);
+        }
+        m_connections[p_socket] = std::move(l_pConnection);
+        m_connectionCount++;
+        m_pConnections->Set(static_cast<int64_t>(m_connectionCount));
+    }
+
+    if (!m_rReactor.AddHandler(p_socket, kRxEvents, this))
+    {
+        CloseConnection(*l_pAdded, "not added to the reactor");
+        return nullptr;
+    }
+    EVENT_DEBUG("TCPNetwork() %s %s", p_outbound ? "connecting to" : "client", l_pAdded->m_peer.c_str());
+    return l_pAdded;
+}
+
+/// CloseConnection
+///- Details:   Closes a connection and drops what is queued to it. The
+///             connection out is retried after cTCP_RECONNECT_MS
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void TCPNetwork::CloseConnection(Connection &p_rConnection, const char *p_pReason)
+{
+    int l_socket = p_rConnection.m_socket;
+    bool l_outbound = p_rConnection.m_outbound;
+    EventLogger::LogEvent("TCPNetwork() %s closed, %s", p_rConnection.m_peer.c_str(), p_pReason);
+
+    m_rReactor.RemoveHandler(l_socket);
+    {
+        Lock l_lock(m_lock);
+        close(l_socket);
+        m_connections[l_socket].reset();
+        m_connectionCount--;
+        m_pConnections->Set(static_cast<int64_t>(m_connectionCount));
+    }
+
+    if (l_outbound)
+    {
+        m_clientSocket = -1;
+        m_reconnectMs = Utils::CurrentTimestampMilliSeconds() + cTCP_RECONNECT_MS;
+    }
+}
+
+/// Receive
+///- Details:   Reads what the connection has received and frames it,
+///             closes the connection when the peer has gone
+///
+///- Returns:   false if the connection was closed
+///- Throws:    n/a
+bool TCPNetwork::Receive(Connection &p_rConnection)
+{
+    char l_buffer[kRxChunkSize];
+    for (int l_reads = 0; l_reads < kMaxReadsPerEvent; l_reads++)
+    {
+        ssize_t l_size = recv(p_rConnection.m_socket, l_buffer, sizeof(l_buffer), 0);
+        if (l_size > 0)
+        {
+            m_pRxBytes->Add(static_cast<uint64_t>(l_size));
+            Frame(p_rConnection, l_buffer, static_cast<size_t>(l_size));
+            if (static_cast<size_t>(l_size) < sizeof(l_buffer))
+            {
+                break;
+            }
+        }
+        else if (l_size == 0)
+        {
+            CloseConnection(p_rConnection, "by the peer");
+            return false;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            CloseConnection(p_rConnection, strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Frame
+///- Details:   Collects the received data into lines, a line which is
+///             a sentence is passed to the message handler. A line
+///             longer than the buffer is dropped
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void TCPNetwork::Frame(Connection &p_rConnection, const char *p_pData, size_t p_size)
+{
+    while (p_size > 0)
+    {
+        const char *l_pEnd = static_cast<const char *>(memchr(p_pData, '\n', p_size));
+        size_t l_length = (l_pEnd != nullptr) ? static_cast<size_t>(l_pEnd - p_pData) : p_size;
+
+        if (!p_rConnection.m_discarding)
+        {
+            if (p_rConnection.m_rxSize + l_length < sizeof(p_rConnection.m_rxBuffer))
+            {
+                memcpy(p_rConnection.m_rxBuffer + p_rConnection.m_rxSize, p_pData, l_length);
+                p_rConnection.m_rxSize += l_length;
+            }
+            else
+            {
+                p_rConnection.m_discarding = true;
+            }
+        }
+
+        if (l_pEnd == nullptr)
+        {
+            break;
+        }
+
+        // a whole line
+        char *l_pLine = p_rConnection.m_rxBuffer;
+        size_t l_lineSize = p_rConnection.m_rxSize;
+        if (l_lineSize > 0 && l_pLine[l_lineSize - 1] == '\r')
+        {
+            l_lineSize--;
+        }
+        if (!p_rConnection.m_discarding && l_lineSize > 0 && (l_pLine[0] == '$' || l_pLine[0] == '!'))
+        {
+            l_pLine[l_lineSize] = '\0';
+            LatencyTrace::Begin();
+            m_pSentences->Add();
+            if (m_pMsgHandler != nullptr)
+            {
+                uint16_t l_handledSize = static_cast<uint16_t>(l_lineSize);
+                m_pMsgHandler->HandleMessage(reinterpret_cast<const uint8_t *>(l_pLine), l_handledSize,
+                                             p_rConnection.m_socket, p_rConnection.m_peerAddress);
+            }
+        }
+        p_rConnection.m_rxSize = 0;
+        p_rConnection.m_discarding = false;
+
+        p_pData += l_length + 1;
+        p_size -= l_length + 1;
+    }
+}
+
+/// Flush
+///- Details:   Sends what is queued until the socket is full. The
+///             socket is watched for EPOLLOUT while data is left
+///
+///- Returns:   false if the connection failed
+///- Throws:    n/a
+bool TCPNetwork::Flush(Connection &p_rConnection)
+{
+    std::string &l_rBuffer = p_rConnection.m_txBuffer;
+    while (p_rConnection.m_txSent < l_rBuffer.size())
+    {
+        ssize_t l_sent = send(p_rConnection.m_socket, l_rBuffer.data() + p_rConnection.m_txSent,
+                              l_rBuffer.size() - p_rConnection.m_txSent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (l_sent > 0)
+        {
+            p_rConnection.m_txSent += static_cast<size_t>(l_sent);
+            m_pTxBytes->Add(static_cast<uint64_t>(l_sent));
+        }
+        else if (l_sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (l_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    p_rConnection.m_txReady = false;
+    bool l_pending = p_rConnection.m_txSent < l_rBuffer.size();
+    if (!l_pending)
+    {
+        l_rBuffer.clear();
+        p_rConnection.m_txSent = 0;
+    }
+    else if (p_rConnection.m_txSent > l_rBuffer.size() / 2)
+    {
+        l_rBuffer.erase(0, p_rConnection.m_txSent);
+        p_rConnection.m_txSent = 0;
+    }
+    if (l_pending != p_rConnection.m_txWatched)
+    {
+        p_rConnection.m_txWatched = l_pending;
+        m_rReactor.ModifyHandler(p_rConnection.m_socket, kRxEvents | (l_pending ? static_cast<uint32_t>(EPOLLOUT) : 0u));
+    }
+    return true;
+}
+
+/// Queue
+///- Details:   Adds data to the connection queue, the connection is
+///             listed for the reactor to send if it was idle. Data that
+///             would take the queue over cTCP_TX_QUEUE_BYTES is dropped
+///
+///- Returns:   false if the data was dropped
+///- Throws:    n/a
+bool TCPNetwork::Queue(Connection &p_rConnection, const char *p_pData, uint16_t p_size)
+{
+    size_t l_queued = p_rConnection.m_txBuffer.size() - p_rConnection.m_txSent;
+    if (l_queued + p_size > cTCP_TX_QUEUE_BYTES)
+    {
+        m_pTxDropped->Add();
+        return false;
+    }
+
+    p_rConnection.m_txBuffer.append(p_pData, p_size);
+
+    // a connection waiting for EPOLLOUT is sent to when it is writable
+    if (!p_rConnection.m_txReady && !p_rConnection.m_txWatched && !p_rConnection.m_connecting)
+    {
+        p_rConnection.m_txReady = true;
+        m_txReady.push_back(p_rConnection.m_socket);
+    }
+    return true;
+}
+
+/// SendQueued
+///- Details:   Sends to the connections with data queued since the
+///             last send, on the reactor thread
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void TCPNetwork::SendQueued()
+{
+    uint64_t l_value;
+    while (read(m_txEventFd, &l_value, sizeof(l_value)) > 0)
+    {
+    }
+
+    std::vector<int> l_failed;
+    {
+        Lock l_lock(m_lock);
+        for (int l_socket : m_txReady)
+        {
+            Connection *l_pConnection = m_connections[l_socket].get();
+            if (l_pConnection != nullptr && l_pConnection->m_txReady && !Flush(*l_pConnection))
+            {
+                l_failed.push_back(l_socket);
+            }
+        }
+        m_txReady.clear();
+    }
+
+    for (int l_socket : l_failed)
+    {
+        if (m_connections[l_socket])
+        {
+            CloseConnection(*m_connections[l_socket], "send failed");
+        }
+    }
+}
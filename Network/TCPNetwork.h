@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : TCP NMEA0183 Network header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _TCP_NETWORK_H_INCLUDED_
+#define _TCP_NETWORK_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+#include <netinet/in.h>
+
+// C++ includes
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// includes
+#include "INetwork.h"
+#include "Reactor.h"
+#include "../IThread.h"
+
+// forward declarations
+class IMessageHandlerInterface;
+class MetricCounter;
+class MetricGauge;
+
+//----------------------------------------------
+// TCP Network carries NMEA0183 over TCP, as chartplotters and
+// multiplexers do. It listens for clients and can also connect out to
+// a multiplexer, which is reconnected when the link drops.
+//
+// Every connection is non blocking and handled on the reactor. Received
+// data is framed into sentences in a buffer per connection and passed
+// to the message handler with the connection socket and peer address,
+// as UDP datagrams are. SendData queues a sentence to one or every
+// connection and the reactor sends it, what has been queued meanwhile
+// goes in one send.
+// A client that does not keep up has sentences dropped once its queue
+// holds cTCP_TX_QUEUE_BYTES, it never holds up the reactor, the sender
+// or the other clients.
+//----------------------------------------------
+class TCPNetwork : public IEventHandler, public INetwork
+{
+public:
+    /// Default Constructor
+    /// Detail- TCP Network constructor, the sockets are opened by Init
+    /// Returns- n/a
+    /// Throws - n/a
+    TCPNetwork
+    (
+        IMessageHandlerInterface* p_pMessageHandler,    ///< pointer to the message handler
+        Reactor& p_rReactor,                            ///< reactor running the connections
+        uint16_t p_listenPort,                          ///< port to listen on, 0 for none
+        const std::string& p_rClientAddress,            ///< multiplexer to connect to, empty for none
+        uint16_t p_clientPort                           ///< multiplexer port
+    );
+
+    /// Default Destructor
+    /// Detail- Closes the connections. The reactor thread must be stopped
+    /// Returns- n/a
+    /// Throws - n/a
+    virtual ~TCPNetwork();
+
+    /// Init
+    /// Detail- Opens the listening socket and starts the connection out.
+    ///         Call before the reactor thread is started
+    /// Returns- true if the listening socket is open
+    /// Throws - n/a
+    bool Init();
+
+    /// SendData
+    /// Detail- Queues data to a connection, or every connection. Safe to
+    ///         call from any thread
+    /// Returns- Number of bytes queued (-1 if the data was dropped for
+    ///          every connection)
+    /// Throws - n/a
+    int16_t SendData
+    (
+        const char * p_pData ,  ///< pointer to the data to be sent
+        uint16_t p_dataSize,    ///< size of the data to be sent
+        int p_socket = -1       ///< connection to send to (-1 means every connection)
+    ) override;
+
+    /// GetConnectionCount
+    /// Detail- Connections open, in and out
+    /// Returns- number of connections
+    /// Throws - n/a
+    size_t GetConnectionCount();
+
+    /// HandleEvent
+    /// Detail- Accepts clients, reads and writes the connections
+    /// Returns- n/a
+    /// Throws - n/a
+    void HandleEvent
+    (
+        int p_fd,               ///< file descriptor which is ready
+        uint32_t p_events       ///< epoll events
+    ) override;
+
+    /// GetTimeToNextEvent
+    /// Detail- Time until the connection out is retried
+    /// Returns- time in ms, -1 if nothing is waiting
+    /// Throws - n/a
+    int GetTimeToNextEvent() override;
+
+    /// HandleTimeout
+    /// Detail- Retries the connection out
+    /// Returns- n/a
+    /// Throws - n/a
+    void HandleTimeout() override;
+
+private:
+    //----------------------------------------------
+    // A client or the connection out
+    //----------------------------------------------
+    struct Connection
+    {
+        int m_socket;                   ///< non blocking socket
+        bool m_outbound;                ///< the connection out
+        bool m_connecting;              ///< connect() not yet complete
+        bool m_discarding;              ///< line too long, dropped up to its end
+        bool m_txWatched;               ///< EPOLLOUT is being waited for
+        bool m_txReady;                 ///< listed in m_txReady
+        std::string m_peer;             ///< address:port
+        uint32_t m_peerAddress;         ///< IPv4 address, network byte order
+        size_t m_rxSize;                ///< bytes of the sentence so far
+        char m_rxBuffer[128];           ///< sentence being received
+        std::string m_txBuffer;         ///< data waiting to be sent
+        size_t m_txSent;                ///< bytes of m_txBuffer sent
+    };
+
+    // accept the clients waiting
+    void Accept();
+
+    // start the connection out
+    void Connect();
+
+    // add a connected socket
+    Connection* AddConnection(int p_socket, const struct sockaddr_in& p_rPeer, bool p_outbound);
+
+    // close a connection, on the reactor thread
+    void CloseConnection(Connection& p_rConnection, const char* p_pReason);
+
+    // read what a connection has received, false if it was closed
+    bool Receive(Connection& p_rConnection);
+
+    // split received data into sentences
+    void Frame(Connection& p_rConnection, const char* p_pData, size_t p_size);
+
+    // send what is queued, m_lock held. Returns false if the connection failed
+    bool Flush(Connection& p_rConnection);
+
+    // queue data to a connection, m_lock held. Returns false if it was dropped
+    bool Queue(Connection& p_rConnection, const char* p_pData, uint16_t p_size);
+
+    // send to the connections listed in m_txReady
+    void SendQueued();
+
+    IMessageHandlerInterface* m_pMsgHandler;                ///!< The message handler instance
+    Reactor& m_rReactor;                                    ///!< reactor running the connections
+    uint16_t m_listenPort;                                  ///!< port listened on
+    std::string m_clientAddress;                            ///!< multiplexer address
+    uint16_t m_clientPort;                                  ///!< multiplexer port
+    int m_listenSocket;                                     ///!< listening socket
+    int m_clientSocket;                                     ///!< the connection out, -1 if down
+    int m_txEventFd;                                        ///!< eventfd, data has been queued
+    uint64_t m_reconnectMs;                                 ///!< time to retry the connection out
+
+    std::mutex m_lock;                                      ///!< guards the connections
+    std::vector<std::unique_ptr<Connection>> m_connections; ///!< connections indexed by socket
+    size_t m_connectionCount;                               ///!< connections open
+    std::vector<int> m_txReady;                             ///!< connections with data to send
+
+    MetricGauge* m_pConnections;                            ///!< connections open
+    MetricCounter* m_pAccepted;                             ///!< clients accepted
+    MetricCounter* m_pRejected;                             ///!< clients refused, too many
+    MetricCounter* m_pRxBytes;                              ///!< bytes received
+    MetricCounter* m_pSentences;                            ///!< sentences received
+    MetricCounter* m_pTxBytes;                              ///!< bytes sent
+    MetricCounter* m_pTxDropped;                            ///!< sentences dropped for slow clients
+};
+
+#endif
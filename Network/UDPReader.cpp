@@ -43,6 +43,9 @@
 #include "../EventLogger.h"
 #include "../Handlers/MessageHandler.h"
 #include "../Config.h"
+#include "../LatencyTrace.h"
+#include "../Metrics.h"
+#include "../Utils.h"
 
 namespace
 {
@@ -61,10 +64,27 @@ UDPReader::UDPReader(
     uint16_t p_port,
     const std::string &p_rAdaptorAddress,
     const std::string &p_rSenderAddress,
-    bool l_broadcastEnable)
-    : m_socket(SOCKET_ERROR), m_pMsgHandler(p_pMessageHandler), m_port(p_port), m_adaptorAddr(p_rAdaptorAddress), m_senderAddr(p_rSenderAddress), m_broadcastEnable(l_broadcastEnable), m_initOk(false)
+    bool l_broadcastEnable,
+    const std::string &p_rMulticastGroup,
+    bool p_reusePort,
+    const SourceFilter *p_pFilter)
+    : m_socket(SOCKET_ERROR), m_pMsgHandler(p_pMessageHandler), m_port(p_port), m_adaptorAddr(p_rAdaptorAddress), m_senderAddr(p_rSenderAddress), m_broadcastEnable(l_broadcastEnable), m_multicastGroup(p_rMulticastGroup), m_reusePort(p_reusePort), m_initOk(false)
 
 {
+    MetricsRegistry *l_pRegistry = MetricsRegistry::GetInstance();
+    std::string l_port = "port=\"" + std::to_string(p_port) + "\"";
+    m_pDatagrams = l_pRegistry->AddCounter("nmea2can_udp_datagrams_total", "UDP datagrams received", l_port);
+    m_pBytes = l_pRegistry->AddCounter("nmea2can_udp_bytes_total", "UDP bytes received", l_port);
+    m_pErrors = l_pRegistry->AddCounter("nmea2can_udp_errors_total", "UDP receive errors", l_port);
+    m_pDenied = l_pRegistry->AddCounter("nmea2can_udp_denied_total", "UDP datagrams dropped, source not allowed", l_port);
+    m_pLimited = l_pRegistry->AddCounter("nmea2can_udp_rate_limited_total", "UDP datagrams dropped, source over its rate", l_port);
+
+    // the thread has its own copy, the buckets are not shared
+    if (p_pFilter != nullptr)
+    {
+        m_filter = *p_pFilter;
+    }
+
     m_threadRunning = false;
     if (InitSocket() && p_pMessageHandler != nullptr)
     {
@@ -115,6 +135,15 @@ bool UDPReader::InitSocket()
         l_success = false;
     }
 
+#ifdef __linux__
+    // readers sharing the port, the kernel spreads the senders over them
+    if (l_success && m_reusePort && setsockopt(m_socket, SOL_SOCKET, SO_REUSEPORT, &l_dummy, sizeof(l_dummy)) == SOCKET_ERROR)
+    {
+        EventLogger::Error("Error setting UDP Reader SO_REUSEPORT");
+        l_success = false;
+    }
+#endif
+
     if (l_success && m_broadcastEnable)
     {
         // if we want to broadcast
@@ -126,10 +155,11 @@ bool UDPReader::InitSocket()
         }
     }
 
-    // set up destination address
+    // set up destination address, a multicast reader binds to the group
+    // so that it does not get other traffic to the port
     memset(&m_addr, 0, sizeof(m_addr));
     m_addr.sin_family = AF_INET;
-    m_addr.sin_addr.s_addr = inet_addr(m_adaptorAddr.c_str());
+    m_addr.sin_addr.s_addr = inet_addr(m_multicastGroup.empty() ? m_adaptorAddr.c_str() : m_multicastGroup.c_str());
     m_addr.sin_port = htons(m_port);
 
     // bind to the address
@@ -139,9 +169,27 @@ bool UDPReader::InitSocket()
         l_success = false;
     }
 
+    if (l_success && !m_multicastGroup.empty())
+    {
+        struct ip_mreq l_membership;
+        l_membership.imr_multiaddr.s_addr = inet_addr(m_multicastGroup.c_str());
+        l_membership.imr_interface.s_addr = inet_addr(m_adaptorAddr.c_str());
+        if (setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<char *>(&l_membership), sizeof(l_membership)) == SOCKET_ERROR)
+        {
+            EventLogger::Error("UDPReader() can not join multicast group %s", m_multicastGroup.c_str());
+            l_success = false;
+        }
+#ifdef __linux__
+        // only the group joined, not the groups other sockets on the host have joined
+        int l_all = 0;
+        setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_ALL, &l_all, sizeof(l_all));
+#endif
+    }
+
     if (l_success)
     {
-        EventLogger::LogEvent("UDPReader() Opened Reader on %s:%d", m_adaptorAddr.c_str(), m_port);
+        EventLogger::LogEvent("UDPReader() Opened Reader on %s:%d%s%s", m_adaptorAddr.c_str(), m_port,
+                              m_multicastGroup.empty() ? "" : " group ", m_multicastGroup.c_str());
     }
     else
     {
@@ -279,6 +327,7 @@ void UDPReader::ReaderThread()
     {
         l_AdaptorAddress = inet_addr(m_adaptorAddr.c_str());
     }*/
+    bool l_filtering = m_filter.IsActive();
 
     // run until the thread has been told to exit
     while (m_threadRunning)
@@ -296,16 +345,40 @@ void UDPReader::ReaderThread()
         else if (l_retval > 0 && FD_ISSET(m_socket, &l_rfds))
         {
             // Data received
-            int l_dataSize = recvfrom(m_socket, reinterpret_cast<char *>(l_receiveBuffer), kRxBufferSize, 0, reinterpret_cast<struct sockaddr *>(&l_addr), &l_addrlen);
+            l_addrlen = sizeof(l_addr);
+            int l_dataSize = recvfrom(m_socket, reinterpret_cast<char *>(l_receiveBuffer), kRxBufferSize - 1, 0, reinterpret_cast<struct sockaddr *>(&l_addr), &l_addrlen);
+            LatencyTrace::Begin();
             if (l_dataSize == SOCKET_ERROR)
             {
                 EventLogger::Error("UDPReader thread():recvfrom returned socket error");
+                m_pErrors->Add();
             }
             else if (l_dataSize > 0)
             {
-                if (l_senderAddress != 0 && l_senderAddress != l_addr.sin_addr.s_addr)
+                m_pDatagrams->Add();
+                m_pBytes->Add(l_dataSize);
+                // drop unwanted sources before the data is parsed
+                uint32_t l_source = l_addr.sin_addr.s_addr;
+                if (l_senderAddress != 0 && l_senderAddress != l_source)
+                {
+                    m_pDenied->Add();
+                    continue;
+                }
+                IMessageHandlerInterface *l_pHandler = m_pMsgHandler;
+                if (l_filtering)
                 {
-                    //continue;
+                    eSourceVerdict l_verdict = m_filter.Check(l_source, Utils::MonotonicTimestampMicroSeconds());
+                    if (l_verdict == eSourceVerdict::Denied)
+                    {
+                        m_pDenied->Add();
+                        continue;
+                    }
+                    if (l_verdict == eSourceVerdict::Limited)
+                    {
+                        m_pLimited->Add();
+                        continue;
+                    }
+                    l_pHandler = m_filter.Route(l_source, m_pMsgHandler);
                 }
 
                 // If the data has been loopback, ignore it
@@ -314,10 +387,10 @@ void UDPReader::ReaderThread()
                     continue;
                 }*/
                 l_receiveBuffer[l_dataSize] = 0;
-                if (m_pMsgHandler != nullptr && m_threadRunning)
+                if (l_pHandler != nullptr && m_threadRunning)
                 {
                     uint16_t l_handledSize = l_dataSize;
-                    m_pMsgHandler->HandleMessage(l_receiveBuffer, l_handledSize);
+                    l_pHandler->HandleMessage(l_receiveBuffer, l_handledSize, m_socket, l_source);
                 }
             }
         }
@@ -28,12 +28,32 @@
 
 // includes
 #include "../IThread.h"
+#include "SourceFilter.h"
 
 // forward declarations
 class IMessageHandlerInterface;
+class MetricCounter;
 
 //----------------------------------------------
 // UDP Reader class reads MMH messages from the network
+//
+// Multicast - with a group address the reader joins the group on the
+// adaptor address interface (0.0.0.0 lets the kernel choose) and only
+// receives datagrams sent to that group.
+//
+// Sharding - readers created with p_reusePort share the port with
+// SO_REUSEPORT. The kernel hashes each sender to one of the sockets,
+// so a talker's sentences are always read by the same thread, in order,
+// and several talkers are read in parallel. The kernel does not share
+// out multicast this way, every reader in the group gets each datagram,
+// so a multicast group has one reader.
+//
+// Source filtering - each datagram is checked against the reader's copy
+// of the source filter before it is parsed. Denied sources and sources
+// over their rate are dropped and counted, the rest go to the handler
+// routed for the source with the socket and source address. As a sender
+// is always read by the same reader the rate of each source is kept by
+// one thread.
 //----------------------------------------------
 class UDPReader : public IThread
 {
@@ -48,7 +68,10 @@ public:
         uint16_t p_port,                                ///< UDP port number
         const std::string& p_rAdaptorAddress,           ///< adaptor address to receive the UDP data
         const std::string& p_rSenderAddress,            ///< the UDP Sender
-        bool broadcastEnable                            ///< if true, then the received data will be from a broadcast address
+        bool broadcastEnable,                           ///< if true, then the received data will be from a broadcast address
+        const std::string& p_rMulticastGroup = "",      ///< multicast group to join, empty for none
+        bool p_reusePort = false,                       ///< share the port with the other readers
+        const SourceFilter* p_pFilter = nullptr         ///< source filter, copied. nullptr for none
     );
 
     /// Default Destructor
@@ -121,7 +144,15 @@ private:
     std::string m_adaptorAddr;      ///!< adaptor address
     std::string m_senderAddr;       ///!< the UDP sender address, used to filter received packets
     bool m_broadcastEnable;         ///!< true if broadcast is enabled
+    std::string m_multicastGroup;   ///!< multicast group joined, empty for none
+    bool m_reusePort;               ///!< port shared with SO_REUSEPORT
     bool m_initOk;                  ///!< true if the Reader is running OK
+    MetricCounter* m_pDatagrams;    ///!< datagrams received
+    MetricCounter* m_pBytes;        ///!< bytes received
+    MetricCounter* m_pErrors;       ///!< receive errors
+    MetricCounter* m_pDenied;       ///!< datagrams from sources not allowed
+    MetricCounter* m_pLimited;      ///!< datagrams from sources over their rate
+    SourceFilter m_filter;          ///!< this reader's source filter
 };
 
 #endif
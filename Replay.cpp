@@ -0,0 +1,406 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Replay of recorded traffic implementation file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#include "Replay.h"
+
+// C includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// C++ includes
+#include <string>
+#include <vector>
+
+// includes
+#include "Config.h"
+#include "EventLogger.h"
+#include "Utils.h"
+#include "Handlers/MessageHandler.h"
+#include "Network/Reactor.h"
+#include "Network/CANInterface.h"
+#include "nmea0183converter.h"
+#include "LatencyTrace.h"
+#include <NMEA2000_Replay.h>
+#include <N2kDeviceList.h>
+
+namespace
+{
+    const uint32_t cOpenTimeoutMs = 2000;   // time to open and claim an address
+    const uint32_t cDrainTimeoutMs = 5000;  // time for the pipeline to empty after the last sentence
+    const uint32_t cMaxSleepUs = 1000;      // longest sleep while waiting for the next frame
+
+    //-------------------------------------
+    // Counts the messages the library hands out and their latency
+    // from the last frame being received
+    //-------------------------------------
+    class MessageCounter : public tNMEA2000::tMsgHandler
+    {
+    public:
+        MessageCounter(tNMEA2000 * p_pNMEA2000)
+        : tNMEA2000::tMsgHandler(0, p_pNMEA2000), m_count(0), m_latencyTotalUs(0), m_latencyMaxUs(0) {}
+
+        uint64_t m_count;           ///< messages handled
+        uint64_t m_latencyTotalUs;  ///< sum of the latencies
+        uint64_t m_latencyMaxUs;    ///< largest latency
+
+    protected:
+        void HandleMsg(const tN2kMsg & p_rMsg) override
+        {
+            m_count++;
+            if (p_rMsg.MsgTimeUs != 0)
+            {
+                uint64_t l_now = Utils::CurrentTimestampMicroSeconds();
+                uint64_t l_latency = (l_now > p_rMsg.MsgTimeUs) ? l_now - p_rMsg.MsgTimeUs : 0;
+                m_latencyTotalUs += l_latency;
+                if (l_latency > m_latencyMaxUs)
+                {
+                    m_latencyMaxUs = l_latency;
+                }
+            }
+        }
+    };
+
+    //-------------------------------------
+    // split "(seconds.micros) sentence", false if there is no time
+    //-------------------------------------
+    bool ParseTime(char *& p_rpLine, uint64_t & p_rTimeUs)
+    {
+        unsigned long long l_seconds;
+        unsigned long long l_micros;
+        int l_length = 0;
+        if (sscanf(p_rpLine, "(%llu.%llu) %n", &l_seconds, &l_micros, &l_length) != 2 || l_length == 0)
+        {
+            return false;
+        }
+        p_rTimeUs = l_seconds * 1000000ULL + l_micros;
+        p_rpLine += l_length;
+        return true;
+    }
+
+    //-------------------------------------
+    // the library opens once its scheduler has ticked
+    //-------------------------------------
+    bool OpenDriver(tNMEA2000 & p_rNMEA2000)
+    {
+        for (uint32_t l_waitMs = 0; l_waitMs < cOpenTimeoutMs; l_waitMs++)
+        {
+            if (p_rNMEA2000.Open())
+            {
+                return true;
+            }
+            usleep(1000);
+        }
+        EventLogger::Error("Replay() NMEA2000 replay driver failed to open");
+        return false;
+    }
+
+    double PerSecond(uint64_t p_count, uint64_t p_elapsedUs)
+    {
+        return (p_elapsedUs == 0) ? 0.0 : static_cast<double>(p_count) * 1000000.0 / p_elapsedUs;
+    }
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+bool Replay::IsRequested(int argc, char * argv[])
+{
+    for (int l_index = 1; l_index < argc; l_index++)
+    {
+        if (strcmp(argv[l_index], "--replay-0183") == 0 || strcmp(argv[l_index], "--replay-can") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------
+//
+//----------------------------------------------------------------
+int Replay::Run(int argc, char * argv[])
+{
+    double l_speed = 1.0;
+    const char * l_pNMEA0183Log = nullptr;
+    const char * l_pCaptureDir = nullptr;
+    std::vector<const char *> l_captureFiles;
+
+    for (int l_index = 1; l_index < argc; l_index++)
+    {
+        std::string l_arg = argv[l_index];
+        bool l_hasValue = (l_index + 1 < argc);
+        if (l_arg == "--replay-0183" && l_hasValue)
+        {
+            l_pNMEA0183Log = argv[++l_index];
+        }
+        else if (l_arg == "--replay-can")
+        {
+            while (l_index + 1 < argc && strncmp(argv[l_index + 1], "--", 2) != 0)
+            {
+                l_captureFiles.push_back(argv[++l_index]);
+            }
+        }
+        else if (l_arg == "--speed" && l_hasValue)
+        {
+            l_speed = atof(argv[++l_index]);
+            if (l_speed <= 0.0)
+            {
+                fprintf(stderr, "--speed must be more than 0, use --fast for as fast as possible\n");
+                return 1;
+            }
+        }
+        else if (l_arg == "--fast")
+        {
+            l_speed = 0.0;
+        }
+        else if (l_arg == "--capture" && l_hasValue)
+        {
+            l_pCaptureDir = argv[++l_index];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s --replay-0183 <log> [--speed <n> | --fast] [--capture <dir>]\n"
+                            "       %s --replay-can <capture_n.n2c> ... [--speed <n> | --fast]\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+
+    Replay l_replay(l_speed);
+    bool l_success;
+    if (l_pNMEA0183Log != nullptr)
+    {
+        l_success = l_replay.RunNMEA0183(l_pNMEA0183Log, l_pCaptureDir);
+    }
+    else
+    {
+        l_success = l_replay.RunCAN(l_captureFiles.data(), static_cast<int>(l_captureFiles.size()));
+    }
+    return l_success ? 0 : 1;
+}
+
+//----------------------------------------------------------------
+// Private Methods
+//----------------------------------------------------------------
+
+/// RunNMEA0183
+///- Details:   Sentences are paced on this thread and handed to the
+///             MessageHandler as the UDPReader does. The converter and
+///             the reactor run on their own threads as in the gateway,
+///             the replay ends when both have emptied their queues
+///
+///- Returns:   true if the log was replayed
+///- Throws:    n/a
+bool Replay::RunNMEA0183
+(
+    const char * p_pFileName,       ///!< NMEA0183 log
+    const char * p_pCaptureDir      ///!< directory for a capture of the frames, nullptr for none
+)
+{
+    FILE * l_pFile = fopen(p_pFileName, "r");
+    if (l_pFile == nullptr)
+    {
+        EventLogger::Error("Replay() can not open %s", p_pFileName);
+        return false;
+    }
+
+    MessageHandler l_msgHandler;
+    tNMEA2000_Replay l_nmea2000;
+    Reactor l_reactor;
+    CANInterface l_interface(l_nmea2000, l_reactor);
+    tCANRecorder l_recorder;
+    if (p_pCaptureDir != nullptr)
+    {
+        if (!l_recorder.Open(p_pCaptureDir, "replay", "replay", cCAN_CAPTURE_FILES, cCAN_CAPTURE_FILE_SIZE))
+        {
+            fclose(l_pFile);
+            return false;
+        }
+        l_nmea2000.SetRecorder(&l_recorder);
+    }
+
+    l_nmea2000.SetMode(tNMEA2000::N2km_ListenAndNode, cN2K_ADDRESS_0);
+    l_nmea2000.EnableForward(false);
+    if (!OpenDriver(l_nmea2000) || !l_reactor.Init() || !l_interface.Init() || !l_reactor.StartThread())
+    {
+        EventLogger::Error("Replay() CAN reactor failed");
+        fclose(l_pFile);
+        return false;
+    }
+    for (uint32_t l_waitMs = 0; !l_nmea2000.IsAddressClaimed() && l_waitMs < cOpenTimeoutMs; l_waitMs++)
+    {
+        usleep(1000);
+    }
+
+    NMEA0183Converter l_converter(l_interface);
+    l_converter.Init();
+
+    uint32_t l_lines = 0;
+    uint32_t l_accepted = 0;
+    uint64_t l_firstTimeUs = 0;
+    bool l_haveFirstTime = false;
+    uint64_t l_startUs = Utils::CurrentTimestampMicroSeconds();
+    char l_buffer[256];
+    while (fgets(l_buffer, sizeof(l_buffer), l_pFile) != nullptr)
+    {
+        char * l_pLine = l_buffer;
+        l_pLine[strcspn(l_pLine, "\r\n")] = '\0';
+        uint64_t l_timeUs;
+        if (ParseTime(l_pLine, l_timeUs) && m_speed > 0.0)
+        {
+            if (!l_haveFirstTime)
+            {
+                l_firstTimeUs = l_timeUs;
+                l_haveFirstTime = true;
+            }
+            SleepUntil(l_startUs + static_cast<uint64_t>((l_timeUs - l_firstTimeUs) / m_speed));
+        }
+        if (*l_pLine == '\0')
+        {
+            continue;
+        }
+
+        l_lines++;
+        uint16_t l_size = static_cast<uint16_t>(strlen(l_pLine));
+        LatencyTrace::Begin();
+        if (l_msgHandler.HandleMessage(reinterpret_cast<const uint8_t *>(l_pLine), l_size) && l_size > 0)
+        {
+            l_accepted++;
+        }
+    }
+    fclose(l_pFile);
+
+    // wait for the converter and the tx queue to empty
+    uint64_t l_endUs = Utils::CurrentTimestampMicroSeconds();
+    uint64_t l_drainEndUs = l_endUs + cDrainTimeoutMs * 1000ULL;
+    while ((l_converter.GetProcessedCount() < l_accepted || !l_interface.IsTxQueueEmpty()) && l_endUs < l_drainEndUs)
+    {
+        usleep(100);
+        l_endUs = Utils::CurrentTimestampMicroSeconds();
+    }
+    usleep(10000);
+
+    l_converter.StopThread();
+    MessageHandler::UnSubscribeHandler(&l_converter);
+    l_reactor.StopThread();
+
+    uint64_t l_elapsedUs = l_endUs - l_startUs;
+    CANInterface::LatencyStats l_latency = l_interface.GetLatencyStats();
+    printf("Replay %s: %u lines, %u sentences converted in %.3f s, %.0f sentences/s\n",
+           p_pFileName, l_lines, l_converter.GetProcessedCount(), l_elapsedUs / 1000000.0,
+           PerSecond(l_converter.GetProcessedCount(), l_elapsedUs));
+    printf("  NMEA2000 messages %llu, %.0f messages/s, CAN frames %u\n",
+           static_cast<unsigned long long>(l_latency.m_count), PerSecond(l_latency.m_count, l_elapsedUs),
+           l_nmea2000.GetFramesSent());
+    printf("  latency sentence received to message sent avg %llu us, max %llu us\n",
+           static_cast<unsigned long long>(l_latency.m_count ? l_latency.m_totalUs / l_latency.m_count : 0),
+           static_cast<unsigned long long>(l_latency.m_maxUs));
+    if (l_lines != l_accepted)
+    {
+        printf("  %u lines were not valid sentences\n", l_lines - l_accepted);
+    }
+    LatencyTrace::Dump(stdout);
+
+    // a fast replay queues the whole log so only a paced one is held to the SLO
+    if (LatencyTrace::IsEnabled() && m_speed > 0.0)
+    {
+        uint64_t l_wireP99Us = LatencyTrace::GetWorstPercentileUs(eTraceStage::Wire, 99.0);
+        bool l_sloMet = (l_wireP99Us <= cLATENCY_SLO_WIRE_P99_US);
+        printf("  latency SLO p99 receive to wire %llu us, limit %u us, %s\n",
+               static_cast<unsigned long long>(l_wireP99Us), cLATENCY_SLO_WIRE_P99_US, l_sloMet ? "met" : "FAILED");
+        return l_sloMet;
+    }
+    return true;
+}
+
+/// RunCAN
+///- Details:   Runs the library on this thread only, so a replay as
+///             fast as possible handles the frames in the same order
+///             every time
+///
+///- Returns:   true if the capture was replayed
+///- Throws:    n/a
+bool Replay::RunCAN
+(
+    const char * const * p_pFileNames,  ///!< files of the capture
+    int p_count                         ///!< number of files
+)
+{
+    tCANCaptureReader l_capture;
+    if (!l_capture.Open(p_pFileNames, p_count))
+    {
+        EventLogger::Error("Replay() no CAN capture to replay");
+        return false;
+    }
+
+    tNMEA2000_Replay l_nmea2000(true);
+    tN2kDeviceList l_deviceList(&l_nmea2000);
+    MessageCounter l_counter(&l_nmea2000);
+    l_nmea2000.SetMode(tNMEA2000::N2km_ListenAndNode, cN2K_ADDRESS_0);
+    l_nmea2000.EnableForward(false);
+    l_nmea2000.SetCapture(&l_capture, m_speed);
+    if (!OpenDriver(l_nmea2000))
+    {
+        return false;
+    }
+    for (uint32_t l_waitMs = 0; !l_nmea2000.IsAddressClaimed() && l_waitMs < cOpenTimeoutMs; l_waitMs++)
+    {
+        l_nmea2000.ParseMessages();
+        usleep(1000);
+    }
+
+    uint64_t l_startUs = Utils::CurrentTimestampMicroSeconds();
+    l_nmea2000.StartReplay();
+    while (!l_nmea2000.IsReplayDone())
+    {
+        l_nmea2000.ParseMessages();
+        uint64_t l_waitUs = l_nmea2000.GetTimeToNextFrameUs();
+        if (l_waitUs > 0)
+        {
+            usleep((l_waitUs < cMaxSleepUs) ? l_waitUs : cMaxSleepUs);
+        }
+    }
+    uint64_t l_elapsedUs = Utils::CurrentTimestampMicroSeconds() - l_startUs;
+
+    printf("Replay: %u frames, %llu messages in %.3f s, %.0f frames/s, %.0f messages/s\n",
+           l_nmea2000.GetFramesReplayed(), static_cast<unsigned long long>(l_counter.m_count),
+           l_elapsedUs / 1000000.0, PerSecond(l_nmea2000.GetFramesReplayed(), l_elapsedUs),
+           PerSecond(l_counter.m_count, l_elapsedUs));
+    printf("  latency frame received to message handled avg %llu us, max %llu us\n",
+           static_cast<unsigned long long>(l_counter.m_count ? l_counter.m_latencyTotalUs / l_counter.m_count : 0),
+           static_cast<unsigned long long>(l_counter.m_latencyMaxUs));
+    printf("  devices %u, frames sent %u\n", l_deviceList.Count(), l_nmea2000.GetFramesSent());
+    if (l_capture.IsCorrupt())
+    {
+        printf("  capture has corrupt records, they were skipped\n");
+    }
+    return true;
+}
+
+/// SleepUntil
+///- Details:   Sleeps until a time, returns straight away if it has passed
+///
+///- Returns:   n/a
+///- Throws:    n/a
+void Replay::SleepUntil
+(
+    uint64_t p_dueUs        ///!< us since epoch
+)
+{
+    uint64_t l_now = Utils::CurrentTimestampMicroSeconds();
+    if (p_dueUs > l_now)
+    {
+        usleep(static_cast<useconds_t>(p_dueUs - l_now));
+    }
+}
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Replay of recorded traffic header file
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef _REPLAY_H_INCLUDED_
+#define _REPLAY_H_INCLUDED_
+
+// C includes
+#include <stdint.h>
+
+// C++ includes
+
+// includes
+
+//----------------------------------------------
+// Replays recorded traffic through the gateway without the hardware,
+// to reproduce field issues and as an end to end benchmark.
+//
+//  nmea2can --replay-0183 <log> [--speed <n> | --fast] [--capture <dir>]
+//      Feeds a NMEA0183 log through MessageHandler, NMEA0183Converter
+//      and CANInterface to a replay driver. A log line is a sentence,
+//      optionally preceded by its receive time as "(seconds.micros) ",
+//      lines without a time are sent straight after the previous line.
+//      The CAN frames made can be captured for comparison.
+//
+//  nmea2can --replay-can <capture_n.n2c> ... [--speed <n> | --fast]
+//      Passes the received frames of a CAN capture to
+//      tNMEA2000::ParseMessages through the replay driver.
+//
+// --speed n replays n times faster than recorded, --fast as fast as
+// possible, the default is the recorded pace. Replay ends with the
+// message rate and the latency from a message being received to it
+// being sent or handled. A NMEA0183 replay also dumps the latency
+// trace, and a paced one fails when the p99 time from receive to the
+// CAN driver is over cLATENCY_SLO_WIRE_P99_US.
+//----------------------------------------------
+class Replay
+{
+public:
+    /// IsRequested
+    /// Detail- The command line asks for a replay
+    /// Returns- true for replay mode
+    /// Throws - n/a
+    static bool IsRequested
+    (
+        int argc,           ///< argument count
+        char * argv[]       ///< arguments
+    );
+
+    /// Run
+    /// Detail- Runs the replay given on the command line
+    /// Returns- exit code of the program
+    /// Throws - n/a
+    static int Run
+    (
+        int argc,           ///< argument count
+        char * argv[]       ///< arguments
+    );
+
+private:
+    Replay(double p_speed) : m_speed(p_speed) {}
+
+    // replay a NMEA0183 log, frames made go to p_pCaptureDir if set
+    bool RunNMEA0183(const char * p_pFileName, const char * p_pCaptureDir);
+
+    // replay the received frames of a CAN capture
+    bool RunCAN(const char * const * p_pFileNames, int p_count);
+
+    // sleep until p_dueUs, us since epoch
+    static void SleepUntil(uint64_t p_dueUs);
+
+    double m_speed;     ///!< 1 for the recorded pace, 0 as fast as possible
+};
+
+#endif
@@ -1,17 +1,24 @@
 #ifndef SAFE_QUEUE
 #define SAFE_QUEUE
 
-#include <queue>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
+#include <utility>
 
 // A threadsafe-queue.
+// The elements are held in a ring that doubles when it is full, so once
+// the queue has grown to its working size adding an element does not
+// allocate. enqueue_bounded keeps the queue, and so the ring, to a limit.
 template <class T>
 class SafeQueue
 {
 public:
   SafeQueue(void)
-    : q()
+    : q(16)
+    , head(0)
+    , count(0)
     , m()
     , c()
   {}
@@ -23,8 +30,34 @@ public:
   void enqueue(T t)
   {
     std::lock_guard<std::mutex> lock(m);
-    q.push(t);
+    if (count == q.size())
+    {
+      grow();
+    }
+    q[(head + count) & (q.size() - 1)] = std::move(t);
+    count++;
+    c.notify_one();
+  }
+
+  // Add an element to the queue, dropping the front element when the
+  // queue already holds limit elements. Returns true if one was dropped.
+  bool enqueue_bounded(T t, size_t limit)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    bool dropped = false;
+    if (count >= limit && count != 0)
+    {
+      pop();
+      dropped = true;
+    }
+    if (count == q.size())
+    {
+      grow();
+    }
+    q[(head + count) & (q.size() - 1)] = std::move(t);
+    count++;
     c.notify_one();
+    return dropped;
   }
 
   // Get the "front"-element.
@@ -32,31 +65,68 @@ public:
   T dequeue(void)
   {
     std::unique_lock<std::mutex> lock(m);
-    while(q.empty())
+    while(count == 0)
     {
       // release lock as long as the wait and reaquire it afterwards.
       c.wait(lock);
     }
-    T val = q.front();
-    q.pop();
+    T val = std::move(q[head]);
+    pop();
     return val;
   }
 
+  // Get the "front"-element.
+  // If the queue is empty, wait till a element is avaiable or the timeout.
+  // Returns false on timeout.
+  bool dequeue_for(T& val, std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lock(m);
+    if (!c.wait_for(lock, timeout, [this] { return count != 0; }))
+    {
+      return false;
+    }
+    val = std::move(q[head]);
+    pop();
+    return true;
+  }
+
   bool isEmpty(void) const
   {
     std::lock_guard<std::mutex> lock(m);
-    return q.empty();
+    return count == 0;
   }
-  
+
   size_t size(void) const
   {
     std::lock_guard<std::mutex> lock(m);
-    return q.size();
+    return count;
   }
 
 private:
-  std::queue<T> q;
+  // Remove the front element, the lock must be held.
+  void pop(void)
+  {
+    head = (head + 1) & (q.size() - 1);
+    count--;
+  }
+
+  // Double the ring, the elements move to the start in order. The size
+  // stays a power of 2 for the index mask. The lock must be held.
+  void grow(void)
+  {
+    std::vector<T> bigger(q.size() * 2);
+    for (size_t i = 0; i < count; i++)
+    {
+      bigger[i] = std::move(q[(head + i) & (q.size() - 1)]);
+    }
+    q.swap(bigger);
+    head = 0;
+  }
+
+  std::vector<T> q;
+  size_t head;
+  size_t count;
   mutable std::mutex m;
   std::condition_variable c;
 };
-#endif
\ No newline at end of file
+#endif
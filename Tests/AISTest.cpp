@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Test of the AIS decoder against known messages
+//
+//                        make test
+//
+//                        A class A position report and a two part class A
+//                        static and voyage message, both with published
+//                        decodes, are converted and the PGNs parsed back.
+//                        A second part without its first is dropped.
+//                        Decoding them again must not allocate.
+//
+//                        Exits 0 when all checks pass.
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ includes
+#include <new>
+
+// includes
+#include <N2kMsg.h>
+#include <N2kMessages.h>
+#include <NMEA0183Msg.h>
+#include "AISDecoder.h"
+
+namespace
+{
+
+const int kMaxSent = 4;             ///< PGNs kept from one sentence
+const int kAllocationRuns = 1000;   ///< decodes while counting allocations
+
+const double kDegToRad = M_PI / 180.0;
+
+// type 1, MMSI 477553000, moored, 47.582833 -122.345833, COG 51, heading 181
+const char cPosition[] = "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C";
+
+// type 5, MMSI 351759000, EVER DIADEM to NEW YORK
+const char cStatic1[] = "!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C";
+const char cStatic2[] = "!AIVDM,2,2,1,A,88888888880,2*25";
+
+uint64_t g_allocations = 0;         ///< operator new calls
+tN2kMsg g_sent[kMaxSent];           ///< PGNs sent by the decoder
+int g_sentCount = 0;
+
+//----------------------------------------------
+// Keeps the PGNs the decoder sends
+//----------------------------------------------
+void Send(tN2kMsg& p_rMsg)
+{
+    if (g_sentCount < kMaxSent)
+    {
+        g_sent[g_sentCount] = p_rMsg;
+    }
+    g_sentCount++;
+}
+
+//----------------------------------------------
+// Hands a sentence to the decoder, returns the PGNs it sent
+//----------------------------------------------
+int Decode(AISDecoder& p_rDecoder, const char* p_pSentence)
+{
+    tNMEA0183Msg l_msg;
+    g_sentCount = 0;
+    if (l_msg.SetMessage(p_pSentence))
+    {
+        p_rDecoder.HandleSentence(l_msg, Send);
+    }
+    return g_sentCount;
+}
+
+//----------------------------------------------
+// Checks, print the failures
+//----------------------------------------------
+void Check(bool p_ok, const char* p_pWhat, int& p_rFailures)
+{
+    if (!p_ok)
+    {
+        printf("  %s\n", p_pWhat);
+        p_rFailures++;
+    }
+}
+
+void CheckNear(double p_value, double p_expected, double p_tolerance, const char* p_pWhat, int& p_rFailures)
+{
+    if (fabs(p_value - p_expected) > p_tolerance)
+    {
+        printf("  %s %.9g, expected %.9g\n", p_pWhat, p_value, p_expected);
+        p_rFailures++;
+    }
+}
+
+//----------------------------------------------
+// Class A position report to 129038
+//----------------------------------------------
+void CheckPosition(AISDecoder& p_rDecoder, int& p_rFailures)
+{
+    Check(Decode(p_rDecoder, cPosition) == 1 && g_sent[0].PGN == 129038L, "position report: no PGN 129038", p_rFailures);
+
+    uint8_t l_messageId;
+    tN2kAISRepeat l_repeat;
+    uint32_t l_userId;
+    double l_latitude;
+    double l_longitude;
+    bool l_accuracy;
+    bool l_raim;
+    uint8_t l_seconds;
+    double l_COG;
+    double l_SOG;
+    double l_heading;
+    double l_ROT;
+    tN2kAISNavStatus l_navStatus;
+    tN2kAISTransceiverInformation l_info;
+    uint8_t l_SID;
+    if (!ParseN2kPGN129038(g_sent[0], l_messageId, l_repeat, l_userId, l_latitude, l_longitude, l_accuracy, l_raim,
+                           l_seconds, l_COG, l_SOG, l_heading, l_ROT, l_navStatus, l_info, l_SID))
+    {
+        Check(false, "position report: 129038 does not parse", p_rFailures);
+        return;
+    }
+    Check(l_messageId == 1, "position report: message id", p_rFailures);
+    Check(l_userId == 477553000UL, "position report: MMSI", p_rFailures);
+    CheckNear(l_latitude, 47.582833, 1e-6, "position report: latitude", p_rFailures);
+    CheckNear(l_longitude, -122.345833, 1e-6, "position report: longitude", p_rFailures);
+    CheckNear(l_COG, 51.0 * kDegToRad, 1e-4, "position report: COG", p_rFailures);
+    CheckNear(l_SOG, 0.0, 1e-2, "position report: SOG", p_rFailures);
+    CheckNear(l_heading, 181.0 * kDegToRad, 1e-4, "position report: heading", p_rFailures);
+    Check(l_seconds == 15, "position report: seconds", p_rFailures);
+    Check(!l_accuracy, "position report: accuracy", p_rFailures);
+    Check(l_navStatus == N2kaisns_Moored, "position report: navigation status", p_rFailures);
+}
+
+//----------------------------------------------
+// Class A static and voyage data, two parts, to 129794
+//----------------------------------------------
+void CheckStatic(AISDecoder& p_rDecoder, int& p_rFailures)
+{
+    Check(Decode(p_rDecoder, cStatic2) == 0, "static data: second part alone was decoded", p_rFailures);
+    Check(Decode(p_rDecoder, cStatic1) == 0, "static data: first part was decoded", p_rFailures);
+    Check(Decode(p_rDecoder, cStatic2) == 1 && g_sent[0].PGN == 129794L, "static data: no PGN 129794", p_rFailures);
+
+    uint8_t l_messageId;
+    tN2kAISRepeat l_repeat;
+    uint32_t l_userId;
+    uint32_t l_IMO;
+    char l_callsign[8];
+    char l_name[21];
+    uint8_t l_vesselType;
+    double l_length;
+    double l_beam;
+    double l_posRefStbd;
+    double l_posRefBow;
+    uint16_t l_etaDate;
+    double l_etaTime;
+    double l_draught;
+    char l_destination[21];
+    tN2kAISVersion l_version;
+    tN2kGNSStype l_GNSStype;
+    tN2kAISDTE l_DTE;
+    tN2kAISTransceiverInformation l_info;
+    uint8_t l_SID;
+    if (!ParseN2kPGN129794(g_sent[0], l_messageId, l_repeat, l_userId, l_IMO, l_callsign, sizeof(l_callsign),
+                           l_name, sizeof(l_name), l_vesselType, l_length, l_beam, l_posRefStbd, l_posRefBow,
+                           l_etaDate, l_etaTime, l_draught, l_destination, sizeof(l_destination),
+                           l_version, l_GNSStype, l_DTE, l_info, l_SID))
+    {
+        Check(false, "static data: 129794 does not parse", p_rFailures);
+        return;
+    }
+    Check(l_userId == 351759000UL, "static data: MMSI", p_rFailures);
+    Check(l_IMO == 9134270UL, "static data: IMO number", p_rFailures);
+    Check(strcmp(l_callsign, "3FOF8") == 0, "static data: callsign", p_rFailures);
+    Check(strcmp(l_name, "EVER DIADEM") == 0, "static data: name", p_rFailures);
+    Check(strcmp(l_destination, "NEW YORK") == 0, "static data: destination", p_rFailures);
+    Check(l_vesselType == 70, "static data: vessel type", p_rFailures);
+    CheckNear(l_length, 295.0, 0.1, "static data: length", p_rFailures);
+    CheckNear(l_beam, 32.0, 0.1, "static data: beam", p_rFailures);
+    CheckNear(l_posRefStbd, 31.0, 0.1, "static data: reference from starboard", p_rFailures);
+    CheckNear(l_posRefBow, 225.0, 0.1, "static data: reference from bow", p_rFailures);
+    CheckNear(l_etaTime, 14 * 3600.0, 1.0, "static data: ETA time", p_rFailures);
+    CheckNear(l_draught, 12.2, 0.01, "static data: draught", p_rFailures);
+}
+
+} // namespace
+
+//----------------------------------------------------------------
+// Allocations are counted by replacing the global new and delete
+// operators. None of them is inlined, gcc would otherwise pair malloc()
+// with operator delete, or operator new with free(), and warn
+// (-Wmismatched-new-delete)
+//----------------------------------------------------------------
+static void * CountedAllocate(size_t p_size)
+{
+    g_allocations++;
+    void * l_pMemory = malloc(p_size ? p_size : 1);
+    if (l_pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return l_pMemory;
+}
+
+__attribute__((noinline)) void * operator new(size_t p_size)
+{
+    return CountedAllocate(p_size);
+}
+
+__attribute__((noinline)) void * operator new[](size_t p_size)
+{
+    return CountedAllocate(p_size);
+}
+
+__attribute__((noinline)) void operator delete(void * p_pMemory) noexcept
+{
+    free(p_pMemory);
+}
+
+__attribute__((noinline)) void operator delete(void * p_pMemory, size_t) noexcept
+{
+    free(p_pMemory);
+}
+
+__attribute__((noinline)) void operator delete[](void * p_pMemory) noexcept
+{
+    free(p_pMemory);
+}
+
+__attribute__((noinline)) void operator delete[](void * p_pMemory, size_t) noexcept
+{
+    free(p_pMemory);
+}
+
+int main()
+{
+    int l_failures = 0;
+    AISDecoder l_decoder;
+
+    CheckPosition(l_decoder, l_failures);
+    CheckStatic(l_decoder, l_failures);
+
+    // the decoder and its metrics are set up, decoding must not allocate
+    uint64_t l_before = g_allocations;
+    for (int l_run = 0; l_run < kAllocationRuns; l_run++)
+    {
+        Decode(l_decoder, cPosition);
+        Decode(l_decoder, cStatic1);
+        Decode(l_decoder, cStatic2);
+    }
+    uint64_t l_allocations = g_allocations - l_before;
+    if (l_allocations != 0)
+    {
+        printf("  %llu allocations decoding %d messages\n",
+               static_cast<unsigned long long>(l_allocations), 2 * kAllocationRuns);
+        l_failures++;
+    }
+
+    printf("AIS decoder: %s", l_failures == 0 ? "ok" : "FAILED");
+    if (l_failures != 0)
+    {
+        printf(", %d failures", l_failures);
+    }
+    printf("\n");
+    return l_failures == 0 ? 0 : 1;
+}
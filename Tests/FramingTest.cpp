@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Comparison of the NMEA0183 span and byte framing
+//
+//                        make test
+//
+//                        tNMEA0183::GetMessage frames sentences from the
+//                        span of a stream with readSpan(), or a byte at a
+//                        time with read() for streams without spans. The
+//                        same random input, valid sentences mixed with
+//                        corrupt ones, restarts, checksum only fragments,
+//                        overlong sentences and stray bytes, is fed to both
+//                        in random size chunks. Both must give the same
+//                        messages in the same order.
+//
+//                        Exits 0 when the messages are the same.
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// C++ includes
+#include <string>
+#include <vector>
+
+// includes
+#include <NMEA0183.h>
+#include <NMEA0183Msg.h>
+
+namespace
+{
+
+const int kRuns = 2000;             ///< random streams
+const int kSentences = 200;         ///< pieces in each stream
+const int kMaxChunk = 200;          ///< largest chunk handed to the stream
+const int kMaxReported = 10;        ///< differences printed
+
+//----------------------------------------------
+// Random numbers, xorshift so the cases are the same on each run
+//----------------------------------------------
+uint64_t g_random = 0x9e3779b97f4a7c15ULL;
+
+uint64_t Random()
+{
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 7;
+    g_random ^= g_random << 17;
+    return g_random;
+}
+
+//----------------------------------------------
+// Stream over a buffer. Bytes arrive a chunk at a time with Receive, so
+// a sentence may be split over several GetMessage calls. With p_spans
+// false readSpan returns -1, as on a stream without spans, so only read()
+// is used
+//----------------------------------------------
+class BufferStream : public tNMEA0183Stream
+{
+public:
+    BufferStream(const std::string& p_rData, bool p_spans)
+    : m_rData(p_rData), m_spans(p_spans), m_pos(0), m_received(0) {}
+
+    // make up to p_size more bytes available
+    void Receive(size_t p_size)
+    {
+        m_received += p_size;
+        if (m_received > m_rData.size())
+        {
+            m_received = m_rData.size();
+        }
+    }
+
+    bool AllReceived() const { return m_received == m_rData.size(); }
+
+    int available() override { return static_cast<int>(m_received - m_pos); }
+
+    int read() override
+    {
+        if (m_pos >= m_received)
+        {
+            return -1;
+        }
+        return static_cast<uint8_t>(m_rData[m_pos++]);
+    }
+
+    int readSpan(const uint8_t*& p_rData) override
+    {
+        if (!m_spans)
+        {
+            return tNMEA0183Stream::readSpan(p_rData);
+        }
+        p_rData = reinterpret_cast<const uint8_t*>(m_rData.data()) + m_pos;
+        return static_cast<int>(m_received - m_pos);
+    }
+
+    void consume(size_t p_size) override { m_pos += p_size; }
+
+    size_t write(const uint8_t*, size_t p_size) override { return p_size; }
+
+private:
+    const std::string& m_rData;
+    bool m_spans;
+    size_t m_pos;           ///< next byte to read
+    size_t m_received;      ///< bytes available so far
+};
+
+//----------------------------------------------
+// Random printable field text, without the framing characters
+//----------------------------------------------
+std::string RandomFields()
+{
+    static const char cChars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.,-";
+    std::string l_fields;
+    int l_length = static_cast<int>(Random() % 90);
+    for (int i = 0; i < l_length; i++)
+    {
+        l_fields += cChars[Random() % (sizeof(cChars) - 1)];
+    }
+    return l_fields;
+}
+
+//----------------------------------------------
+// Sentence with a valid checksum, overlong when the fields are
+//----------------------------------------------
+std::string ValidSentence()
+{
+    static const char* cHeaders[] = { "GPGGA", "GPRMC", "IIMWV", "AIVDM", "SDDBT" };
+    std::string l_body = std::string(cHeaders[Random() % 5]) + "," + RandomFields();
+    uint8_t l_checkSum = 0;
+    for (size_t i = 0; i < l_body.size(); i++)
+    {
+        l_checkSum ^= static_cast<uint8_t>(l_body[i]);
+    }
+    char l_tail[8];
+    snprintf(l_tail, sizeof(l_tail), (Random() % 4 == 0) ? "*%02x\r\n" : "*%02X\r\n", l_checkSum);
+    return std::string((Random() % 4 == 0) ? "!" : "$") + l_body + l_tail;
+}
+
+//----------------------------------------------
+// Piece of a stream, mostly valid sentences, otherwise one of the inputs
+// the framing has to recover from
+//----------------------------------------------
+std::string RandomPiece()
+{
+    std::string l_sentence = ValidSentence();
+    switch (Random() % 12)
+    {
+    case 0:
+        // cut short, the next sentence restarts it
+        return l_sentence.substr(0, Random() % l_sentence.size());
+    case 1:
+        // one byte changed to anything
+        l_sentence[Random() % l_sentence.size()] = static_cast<char>(Random());
+        return l_sentence;
+    case 2:
+        // a start or checksum character inside
+        l_sentence.insert(Random() % l_sentence.size(), 1, "$!*"[Random() % 3]);
+        return l_sentence;
+    case 3:
+        // checksum mark with a single character after it
+        return "$GPXTE," + RandomFields() + "*1";
+    case 4:
+    {
+        // stray bytes between sentences
+        std::string l_noise;
+        int l_length = static_cast<int>(Random() % 20);
+        for (int i = 0; i < l_length; i++)
+        {
+            l_noise += static_cast<char>(Random());
+        }
+        return l_noise;
+    }
+    default:
+        return l_sentence;
+    }
+}
+
+//----------------------------------------------
+// Message as text for comparing
+//----------------------------------------------
+std::string MessageText(const tNMEA0183Msg& p_rMsg)
+{
+    std::string l_text(1, p_rMsg.GetPrefix());
+    l_text += p_rMsg.Sender();
+    l_text += p_rMsg.MessageCode();
+    for (int i = 0; i < p_rMsg.FieldCount(); i++)
+    {
+        l_text += ",";
+        l_text += p_rMsg.Field(i);
+    }
+    char l_checkSum[4];
+    snprintf(l_checkSum, sizeof(l_checkSum), "*%02X", p_rMsg.GetCheckSum());
+    return l_text + l_checkSum;
+}
+
+//----------------------------------------------
+// Frame a stream with one of the paths, handing it out in random chunks
+//----------------------------------------------
+std::vector<std::string> Frame(const std::string& p_rData, bool p_spans, uint64_t p_chunkSeed)
+{
+    BufferStream l_stream(p_rData, p_spans);
+    tNMEA0183 l_nmea0183(&l_stream, 1);
+    l_nmea0183.Open();
+
+    // the chunks come from their own sequence, so the two paths can be
+    // split differently
+    uint64_t l_saved = g_random;
+    g_random = p_chunkSeed;
+
+    std::vector<std::string> l_messages;
+    tNMEA0183Msg l_msg;
+    do
+    {
+        l_stream.Receive(1 + Random() % kMaxChunk);
+        while (l_nmea0183.GetMessage(l_msg))
+        {
+            l_messages.push_back(MessageText(l_msg));
+        }
+    } while (!l_stream.AllReceived());
+
+    g_random = l_saved;
+    return l_messages;
+}
+
+} // namespace
+
+int main()
+{
+    int l_failures = 0;
+    size_t l_total = 0;
+    for (int l_run = 0; l_run < kRuns; l_run++)
+    {
+        std::string l_data;
+        for (int i = 0; i < kSentences; i++)
+        {
+            l_data += RandomPiece();
+        }
+
+        std::vector<std::string> l_bytes = Frame(l_data, false, Random() | 1);
+        std::vector<std::string> l_spans = Frame(l_data, true, Random() | 1);
+        l_total += l_bytes.size();
+        if (l_bytes == l_spans)
+        {
+            continue;
+        }
+
+        if (++l_failures <= kMaxReported)
+        {
+            printf("  run %d: byte path %zu messages, span path %zu messages\n", l_run, l_bytes.size(), l_spans.size());
+            for (size_t i = 0; i < l_bytes.size() || i < l_spans.size(); i++)
+            {
+                const char* l_pByte = (i < l_bytes.size()) ? l_bytes[i].c_str() : "-";
+                const char* l_pSpan = (i < l_spans.size()) ? l_spans[i].c_str() : "-";
+                if (strcmp(l_pByte, l_pSpan) != 0)
+                {
+                    printf("    message %zu\n      byte %s\n      span %s\n", i, l_pByte, l_pSpan);
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("NMEA0183 framing: %s, %zu messages in %d streams", l_failures == 0 ? "ok" : "FAILED", l_total, kRuns);
+    if (l_failures != 0)
+    {
+        printf(", %d streams differ", l_failures);
+    }
+    printf("\n");
+    return l_failures == 0 ? 0 : 1;
+}
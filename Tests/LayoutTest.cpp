@@ -0,0 +1,924 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Golden test of the compile-time PGN layouts
+//
+//                        make test
+//
+//                        The layout encoders and decoders of
+//                        N2kMessagesLayout.h (used by SetN2kPGN* and
+//                        ParseN2kPGN* of 127250, 128259, 129025, 129026,
+//                        129029 and 130306) are compared against the
+//                        tN2kMsg::AddXXX / GetXXX sequences they replaced.
+//                        The encoded bytes must be identical, including
+//                        NA values, rounding at half a resolution step and
+//                        out of range values. Full length messages must
+//                        parse the same. A truncated message must give
+//                        each field that fits in DataLen as decoded from
+//                        the full message, and NA for the others.
+//
+//                        Exits 0 when all cases pass.
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// C++ includes
+#include <limits>
+
+// includes
+#include <N2kMsg.h>
+#include <N2kMessages.h>
+#include <N2kMessagesLayout.h>
+
+namespace
+{
+
+const int kMaxFields = 16;          ///< most fields in a PGN, 129029 with its reference station
+const int kIterations = 100000;     ///< random messages for each PGN
+const int kMaxReported = 10;        ///< failures printed for each PGN
+
+//----------------------------------------------
+// Field of a PGN, drives the random values and gives the NA that a
+// truncated message decodes to
+//----------------------------------------------
+enum FieldKind
+{
+    kByte,          ///< byte or enum, any value 0 to 255
+    kUInt16,        ///< 2 byte unsigned integer
+    kDouble         ///< scaled integer of m_size bytes
+};
+
+struct Field
+{
+    const char* m_pName;
+    int m_offset;           ///< byte offset in the message
+    int m_size;             ///< bytes
+    FieldKind m_kind;
+    double m_resolution;    ///< kDouble only
+    bool m_signed;          ///< kDouble only
+    double m_na;            ///< decoded value when the field is past DataLen
+};
+
+typedef void (*SetFunction)(tN2kMsg& p_rMsg, const double* p_pValues);
+typedef bool (*ParseFunction)(const tN2kMsg& p_rMsg, double* p_pValues);
+
+//----------------------------------------------
+// PGN under test. Values are passed as doubles in field order, bytes and
+// enums converted
+//----------------------------------------------
+struct PGNCase
+{
+    unsigned long m_pgn;
+    int m_length;               ///< bytes of the layout
+    int m_rawLength;            ///< bytes of a message made of random bytes
+    const Field* m_pFields;
+    int m_fieldCount;
+    SetFunction m_set;          ///< SetN2kPGN*
+    SetFunction m_dataSet;      ///< tN2kPGN*Data::Encode
+    SetFunction m_refSet;       ///< AddXXX sequence it replaced
+    ParseFunction m_parse;      ///< ParseN2kPGN*
+    ParseFunction m_dataParse;  ///< tN2kPGN*Data::Decode
+    ParseFunction m_refParse;   ///< GetXXX sequence it replaced
+};
+
+//----------------------------------------------
+// Random numbers, xorshift so the cases are the same on each run
+//----------------------------------------------
+uint64_t g_random = 0x9e3779b97f4a7c15ULL;
+
+uint64_t Random()
+{
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 7;
+    g_random ^= g_random << 17;
+    return g_random;
+}
+
+// uniform in [0, 1)
+double RandomUnit()
+{
+    return (Random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//----------------------------------------------
+// Value for a scaled field. Besides random values it gives NA, values
+// half a resolution step either side of a raw value and just beside it,
+// values at the limits of the raw range and values out of range
+//----------------------------------------------
+double RandomDouble(const Field& p_rField)
+{
+    double l_bits = 8.0 * p_rField.m_size;
+    double l_min = p_rField.m_signed ? -ldexp(1.0, (int)l_bits - 1) : 0.0;
+    double l_max = p_rField.m_signed ? ldexp(1.0, (int)l_bits - 1) - 1 : ldexp(1.0, (int)l_bits) - 1;
+    double l_res = p_rField.m_resolution;
+
+    // the 8 byte fields convert to int64_t without a range check, as
+    // N2kMsg.cpp does, so only values that fit are defined
+    bool l_wide = (p_rField.m_size == 8);
+    if (l_wide)
+    {
+        l_min = -ldexp(1.0, 62);
+        l_max = ldexp(1.0, 62);
+    }
+
+    double l_raw = floor(l_min + RandomUnit() * (l_max - l_min + 1));
+    switch (Random() % 8)
+    {
+    case 0:
+        return N2kDoubleNA;
+    case 1:
+        return l_raw * l_res;
+    case 2:
+        // halfway between two raw values
+        return (l_raw + 0.5) * l_res;
+    case 3:
+    {
+        // just beside halfway
+        double l_half = (l_raw + 0.5) * l_res;
+        return (Random() & 1) ? nextafter(l_half, HUGE_VAL) : nextafter(l_half, -HUGE_VAL);
+    }
+    case 4:
+    {
+        // limits of the range, the OR and NA raw values and one past
+        static const double kSteps[] = { -1.0, -0.5, 0.0, 0.5, 1.0 };
+        double l_edges[] = { l_min, l_min + 1, l_max - 2, l_max - 1, l_max };
+        double l_edge = l_edges[Random() % 5] + kSteps[Random() % 5];
+        double l_value = l_edge * l_res;
+        switch (Random() % 3)
+        {
+        case 0: return l_value;
+        case 1: return nextafter(l_value, HUGE_VAL);
+        default: return nextafter(l_value, -HUGE_VAL);
+        }
+    }
+    case 5:
+    {
+        if (l_wide)
+        {
+            return 0.0;
+        }
+        static const double kSpecial[] =
+        {
+            0.0, -0.0, 1e300, -1e300, 1e-300,
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::quiet_NaN()
+        };
+        return kSpecial[Random() % (sizeof(kSpecial) / sizeof(kSpecial[0]))];
+    }
+    case 6:
+        // typical values
+        return (RandomUnit() * 20.0 - 10.0);
+    default:
+        // anywhere in the range, not on a raw value
+        return l_min * l_res + RandomUnit() * (l_max - l_min) * l_res;
+    }
+}
+
+void RandomValues(const PGNCase& p_rCase, double* p_pValues)
+{
+    for (int i = 0; i < p_rCase.m_fieldCount; i++)
+    {
+        const Field& l_rField = p_rCase.m_pFields[i];
+        switch (l_rField.m_kind)
+        {
+        case kByte:
+            p_pValues[i] = (double)(Random() & 0xff);
+            break;
+        case kUInt16:
+            p_pValues[i] = (double)(Random() & 0xffff);
+            break;
+        case kDouble:
+            p_pValues[i] = RandomDouble(l_rField);
+            break;
+        }
+    }
+}
+
+// bits of the values, so NaN and -0.0 compare as they are
+bool SameValue(double p_a, double p_b)
+{
+    return memcmp(&p_a, &p_b, sizeof(double)) == 0;
+}
+
+bool SameMessage(const tN2kMsg& p_rA, const tN2kMsg& p_rB)
+{
+    return p_rA.PGN == p_rB.PGN &&
+           p_rA.Priority == p_rB.Priority &&
+           p_rA.DataLen == p_rB.DataLen &&
+           memcmp(p_rA.Data, p_rB.Data, p_rA.DataLen) == 0;
+}
+
+void PrintMessage(const char* p_pName, const tN2kMsg& p_rMsg)
+{
+    printf("    %-10s pgn %lu pri %u len %d :", p_pName, p_rMsg.PGN, p_rMsg.Priority, p_rMsg.DataLen);
+    for (int i = 0; i < p_rMsg.DataLen; i++)
+    {
+        printf(" %02x", p_rMsg.Data[i]);
+    }
+    printf("\n");
+}
+
+void PrintValues(const char* p_pName, const PGNCase& p_rCase, const double* p_pValues)
+{
+    printf("    %-10s", p_pName);
+    for (int i = 0; i < p_rCase.m_fieldCount; i++)
+    {
+        printf(" %s=%.17g", p_rCase.m_pFields[i].m_pName, p_pValues[i]);
+    }
+    printf("\n");
+}
+
+//----------------------------------------------
+// Compare the decoded values, the first failures are printed
+//----------------------------------------------
+bool Compare(const char* p_pWhat, const PGNCase& p_rCase, const tN2kMsg& p_rMsg,
+             const double* p_pValues, const double* p_pExpected, int& p_rFailures)
+{
+    for (int i = 0; i < p_rCase.m_fieldCount; i++)
+    {
+        if (!SameValue(p_pValues[i], p_pExpected[i]))
+        {
+            if (p_rFailures++ < kMaxReported)
+            {
+                printf("  PGN %lu %s, field %s\n", p_rCase.m_pgn, p_pWhat, p_rCase.m_pFields[i].m_pName);
+                PrintMessage("message", p_rMsg);
+                PrintValues("decoded", p_rCase, p_pValues);
+                PrintValues("expected", p_rCase, p_pExpected);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------
+// Encode with the layout and the data struct, both must give the bytes
+// of the AddXXX sequence
+//----------------------------------------------
+void CheckEncode(const PGNCase& p_rCase, const double* p_pValues, int& p_rFailures)
+{
+    tN2kMsg l_ref;
+    tN2kMsg l_msg;
+    tN2kMsg l_data;
+    p_rCase.m_refSet(l_ref, p_pValues);
+    p_rCase.m_set(l_msg, p_pValues);
+    p_rCase.m_dataSet(l_data, p_pValues);
+
+    if (!SameMessage(l_msg, l_ref) || !SameMessage(l_data, l_ref))
+    {
+        if (p_rFailures++ < kMaxReported)
+        {
+            printf("  PGN %lu encode\n", p_rCase.m_pgn);
+            PrintValues("values", p_rCase, p_pValues);
+            PrintMessage("reference", l_ref);
+            PrintMessage("layout", l_msg);
+            PrintMessage("data", l_data);
+        }
+    }
+}
+
+//----------------------------------------------
+// Decode a message of at least the layout length, must be the same as
+// the GetXXX sequence. Then decode it cut short at each length
+//----------------------------------------------
+void CheckDecode(const PGNCase& p_rCase, tN2kMsg& p_rMsg, int& p_rFailures)
+{
+    double l_ref[kMaxFields];
+    double l_full[kMaxFields];
+    double l_values[kMaxFields];
+
+    if (!p_rCase.m_refParse(p_rMsg, l_ref) || !p_rCase.m_parse(p_rMsg, l_full))
+    {
+        if (p_rFailures++ < kMaxReported)
+        {
+            printf("  PGN %lu parse failed\n", p_rCase.m_pgn);
+            PrintMessage("message", p_rMsg);
+        }
+        return;
+    }
+    if (!Compare("parse", p_rCase, p_rMsg, l_full, l_ref, p_rFailures))
+    {
+        return;
+    }
+    if (!p_rCase.m_dataParse(p_rMsg, l_values) ||
+        !Compare("data decode", p_rCase, p_rMsg, l_values, l_ref, p_rFailures))
+    {
+        return;
+    }
+
+    int l_dataLen = p_rMsg.DataLen;
+    for (int l_len = 0; l_len < p_rCase.m_length; l_len++)
+    {
+        double l_expected[kMaxFields];
+        for (int i = 0; i < p_rCase.m_fieldCount; i++)
+        {
+            const Field& l_rField = p_rCase.m_pFields[i];
+            l_expected[i] = (l_rField.m_offset + l_rField.m_size <= l_len) ? l_full[i] : l_rField.m_na;
+        }
+
+        p_rMsg.DataLen = l_len;
+        bool l_ok = p_rCase.m_parse(p_rMsg, l_values) &&
+                    Compare("truncated parse", p_rCase, p_rMsg, l_values, l_expected, p_rFailures) &&
+                    p_rCase.m_dataParse(p_rMsg, l_values) &&
+                    Compare("truncated data decode", p_rCase, p_rMsg, l_values, l_expected, p_rFailures);
+        p_rMsg.DataLen = l_dataLen;
+        if (!l_ok)
+        {
+            return;
+        }
+    }
+}
+
+//----------------------------------------------
+// Runs a PGN, returns the failures
+//----------------------------------------------
+int RunCase(const PGNCase& p_rCase)
+{
+    int l_failures = 0;
+    double l_values[kMaxFields];
+
+    // NA for every field
+    for (int i = 0; i < p_rCase.m_fieldCount; i++)
+    {
+        const Field& l_rField = p_rCase.m_pFields[i];
+        l_values[i] = (l_rField.m_kind == kDouble) ? N2kDoubleNA : (l_rField.m_kind == kUInt16 ? 0xffff : 0xff);
+    }
+    CheckEncode(p_rCase, l_values, l_failures);
+
+    for (int l_iteration = 0; l_iteration < kIterations; l_iteration++)
+    {
+        RandomValues(p_rCase, l_values);
+        CheckEncode(p_rCase, l_values, l_failures);
+
+        tN2kMsg l_msg;
+        p_rCase.m_refSet(l_msg, l_values);
+        CheckDecode(p_rCase, l_msg, l_failures);
+
+        // random bytes, for the reserved raw values
+        l_msg.SetPGN(p_rCase.m_pgn);
+        l_msg.DataLen = p_rCase.m_rawLength;
+        for (int i = 0; i < l_msg.DataLen; i++)
+        {
+            l_msg.Data[i] = (unsigned char)Random();
+        }
+        CheckDecode(p_rCase, l_msg, l_failures);
+    }
+
+    printf("PGN %lu: %s", p_rCase.m_pgn, l_failures == 0 ? "ok" : "FAILED");
+    if (l_failures != 0)
+    {
+        printf(", %d failures", l_failures);
+    }
+    printf("\n");
+    return l_failures;
+}
+
+//----------------------------------------------
+// 127250 Vessel Heading
+//----------------------------------------------
+const Field k127250Fields[] =
+{
+    { "SID",       0, 1, kByte,   0,      false, 0xff },
+    { "Heading",   1, 2, kDouble, 0.0001, false, N2kDoubleNA },
+    { "Deviation", 3, 2, kDouble, 0.0001, true,  N2kDoubleNA },
+    { "Variation", 5, 2, kDouble, 0.0001, true,  N2kDoubleNA },
+    { "ref",       7, 1, kByte,   0,      false, 0x03 },
+};
+
+void Set127250(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    SetN2kPGN127250(p_rMsg, (unsigned char)p_pV[0], p_pV[1], p_pV[2], p_pV[3], (tN2kHeadingReference)(int)p_pV[4]);
+}
+
+void DataSet127250(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    tN2kPGN127250Data l_data;
+    l_data.SID = (unsigned char)p_pV[0];
+    l_data.Heading = p_pV[1];
+    l_data.Deviation = p_pV[2];
+    l_data.Variation = p_pV[3];
+    l_data.ref = (tN2kHeadingReference)(int)p_pV[4];
+    l_data.Encode(p_rMsg);
+}
+
+void RefSet127250(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    p_rMsg.SetPGN(127250L);
+    p_rMsg.Priority = 2;
+    p_rMsg.AddByte((unsigned char)p_pV[0]);
+    p_rMsg.Add2ByteUDouble(p_pV[1], 0.0001);
+    p_rMsg.Add2ByteDouble(p_pV[2], 0.0001);
+    p_rMsg.Add2ByteDouble(p_pV[3], 0.0001);
+    p_rMsg.AddByte(0xfc | (tN2kHeadingReference)(int)p_pV[4]);
+}
+
+bool Parse127250(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    unsigned char l_sid;
+    tN2kHeadingReference l_ref;
+    bool l_ok = ParseN2kPGN127250(p_rMsg, l_sid, p_pV[1], p_pV[2], p_pV[3], l_ref);
+    p_pV[0] = l_sid;
+    p_pV[4] = l_ref;
+    return l_ok;
+}
+
+bool DataParse127250(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    tN2kPGN127250Data l_data;
+    bool l_ok = l_data.Decode(p_rMsg);
+    p_pV[0] = l_data.SID;
+    p_pV[1] = l_data.Heading;
+    p_pV[2] = l_data.Deviation;
+    p_pV[3] = l_data.Variation;
+    p_pV[4] = l_data.ref;
+    return l_ok;
+}
+
+bool RefParse127250(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    if (p_rMsg.PGN != 127250L) return false;
+    int l_index = 0;
+    p_pV[0] = p_rMsg.GetByte(l_index);
+    p_pV[1] = p_rMsg.Get2ByteUDouble(0.0001, l_index);
+    p_pV[2] = p_rMsg.Get2ByteDouble(0.0001, l_index);
+    p_pV[3] = p_rMsg.Get2ByteDouble(0.0001, l_index);
+    p_pV[4] = (tN2kHeadingReference)(p_rMsg.GetByte(l_index) & 0x03);
+    return true;
+}
+
+//----------------------------------------------
+// 128259 Boat speed
+//----------------------------------------------
+const Field k128259Fields[] =
+{
+    { "SID",              0, 1, kByte,   0,    false, 0xff },
+    { "WaterReferenced",  1, 2, kDouble, 0.01, false, N2kDoubleNA },
+    { "GroundReferenced", 3, 2, kDouble, 0.01, false, N2kDoubleNA },
+    { "SWRT",             5, 1, kByte,   0,    false, 0x0f },
+};
+
+void Set128259(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    SetN2kPGN128259(p_rMsg, (unsigned char)p_pV[0], p_pV[1], p_pV[2], (tN2kSpeedWaterReferenceType)(int)p_pV[3]);
+}
+
+void DataSet128259(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    tN2kPGN128259Data l_data;
+    l_data.SID = (unsigned char)p_pV[0];
+    l_data.WaterReferenced = p_pV[1];
+    l_data.GroundReferenced = p_pV[2];
+    l_data.SWRT = (tN2kSpeedWaterReferenceType)(int)p_pV[3];
+    l_data.Encode(p_rMsg);
+}
+
+void RefSet128259(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    p_rMsg.SetPGN(128259L);
+    p_rMsg.Priority = 2;
+    p_rMsg.AddByte((unsigned char)p_pV[0]);
+    p_rMsg.Add2ByteUDouble(p_pV[1], 0.01);
+    p_rMsg.Add2ByteUDouble(p_pV[2], 0.01);
+    p_rMsg.AddByte((tN2kSpeedWaterReferenceType)(int)p_pV[3]);
+    p_rMsg.AddByte(0xff);
+    p_rMsg.AddByte(0xff);
+}
+
+bool Parse128259(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    unsigned char l_sid;
+    tN2kSpeedWaterReferenceType l_swrt;
+    bool l_ok = ParseN2kPGN128259(p_rMsg, l_sid, p_pV[1], p_pV[2], l_swrt);
+    p_pV[0] = l_sid;
+    p_pV[3] = l_swrt;
+    return l_ok;
+}
+
+bool DataParse128259(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    tN2kPGN128259Data l_data;
+    bool l_ok = l_data.Decode(p_rMsg);
+    p_pV[0] = l_data.SID;
+    p_pV[1] = l_data.WaterReferenced;
+    p_pV[2] = l_data.GroundReferenced;
+    p_pV[3] = l_data.SWRT;
+    return l_ok;
+}
+
+bool RefParse128259(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    if (p_rMsg.PGN != 128259L) return false;
+    int l_index = 0;
+    p_pV[0] = p_rMsg.GetByte(l_index);
+    p_pV[1] = p_rMsg.Get2ByteUDouble(0.01, l_index);
+    p_pV[2] = p_rMsg.Get2ByteUDouble(0.01, l_index);
+    p_pV[3] = (tN2kSpeedWaterReferenceType)(p_rMsg.GetByte(l_index) & 0x0F);
+    return true;
+}
+
+//----------------------------------------------
+// 129025 Lat long rapid
+//----------------------------------------------
+const Field k129025Fields[] =
+{
+    { "Latitude",  0, 4, kDouble, 1e-7, true, N2kDoubleNA },
+    { "Longitude", 4, 4, kDouble, 1e-7, true, N2kDoubleNA },
+};
+
+void Set129025(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    SetN2kPGN129025(p_rMsg, p_pV[0], p_pV[1]);
+}
+
+void DataSet129025(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    tN2kPGN129025Data l_data;
+    l_data.Latitude = p_pV[0];
+    l_data.Longitude = p_pV[1];
+    l_data.Encode(p_rMsg);
+}
+
+void RefSet129025(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    p_rMsg.SetPGN(129025L);
+    p_rMsg.Priority = 2;
+    p_rMsg.Add4ByteDouble(p_pV[0], 1e-7);
+    p_rMsg.Add4ByteDouble(p_pV[1], 1e-7);
+}
+
+bool Parse129025(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    return ParseN2kPGN129025(p_rMsg, p_pV[0], p_pV[1]);
+}
+
+bool DataParse129025(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    tN2kPGN129025Data l_data;
+    bool l_ok = l_data.Decode(p_rMsg);
+    p_pV[0] = l_data.Latitude;
+    p_pV[1] = l_data.Longitude;
+    return l_ok;
+}
+
+bool RefParse129025(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    if (p_rMsg.PGN != 129025L) return false;
+    int l_index = 0;
+    p_pV[0] = p_rMsg.Get4ByteDouble(1e-7, l_index);
+    p_pV[1] = p_rMsg.Get4ByteDouble(1e-7, l_index);
+    return true;
+}
+
+//----------------------------------------------
+// 129026 COG SOG rapid
+//----------------------------------------------
+const Field k129026Fields[] =
+{
+    { "SID", 0, 1, kByte,   0,      false, 0xff },
+    { "ref", 1, 1, kByte,   0,      false, 0x03 },
+    { "COG", 2, 2, kDouble, 0.0001, false, N2kDoubleNA },
+    { "SOG", 4, 2, kDouble, 0.01,   false, N2kDoubleNA },
+};
+
+void Set129026(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    SetN2kPGN129026(p_rMsg, (unsigned char)p_pV[0], (tN2kHeadingReference)(int)p_pV[1], p_pV[2], p_pV[3]);
+}
+
+void DataSet129026(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    tN2kPGN129026Data l_data;
+    l_data.SID = (unsigned char)p_pV[0];
+    l_data.ref = (tN2kHeadingReference)(int)p_pV[1];
+    l_data.COG = p_pV[2];
+    l_data.SOG = p_pV[3];
+    l_data.Encode(p_rMsg);
+}
+
+void RefSet129026(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    p_rMsg.SetPGN(129026L);
+    p_rMsg.Priority = 2;
+    p_rMsg.AddByte((unsigned char)p_pV[0]);
+    p_rMsg.AddByte((((unsigned char)(int)p_pV[1]) & 0x03) | 0xfc);
+    p_rMsg.Add2ByteUDouble(p_pV[2], 0.0001);
+    p_rMsg.Add2ByteUDouble(p_pV[3], 0.01);
+    p_rMsg.AddByte(0xff);
+    p_rMsg.AddByte(0xff);
+}
+
+bool Parse129026(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    unsigned char l_sid;
+    tN2kHeadingReference l_ref;
+    bool l_ok = ParseN2kPGN129026(p_rMsg, l_sid, l_ref, p_pV[2], p_pV[3]);
+    p_pV[0] = l_sid;
+    p_pV[1] = l_ref;
+    return l_ok;
+}
+
+bool DataParse129026(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    tN2kPGN129026Data l_data;
+    bool l_ok = l_data.Decode(p_rMsg);
+    p_pV[0] = l_data.SID;
+    p_pV[1] = l_data.ref;
+    p_pV[2] = l_data.COG;
+    p_pV[3] = l_data.SOG;
+    return l_ok;
+}
+
+bool RefParse129026(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    if (p_rMsg.PGN != 129026L) return false;
+    int l_index = 0;
+    p_pV[0] = p_rMsg.GetByte(l_index);
+    p_pV[1] = (tN2kHeadingReference)(p_rMsg.GetByte(l_index) & 0x03);
+    p_pV[2] = p_rMsg.Get2ByteUDouble(0.0001, l_index);
+    p_pV[3] = p_rMsg.Get2ByteUDouble(0.01, l_index);
+    return true;
+}
+
+//----------------------------------------------
+// 129029 GNSS Position Data. The reference station part after the layout
+// is still written by the function, it is included so a whole message is
+// compared. When byte 42 is missing it decodes as no stations
+//----------------------------------------------
+const Field k129029Fields[] =
+{
+    { "SID",                  0,  1, kByte,   0,      false, 0xff },
+    { "DaysSince1970",        1,  2, kUInt16, 0,      false, 0xffff },
+    { "SecondsSinceMidnight", 3,  4, kDouble, 0.0001, false, N2kDoubleNA },
+    { "Latitude",             7,  8, kDouble, 1e-16,  true,  N2kDoubleNA },
+    { "Longitude",            15, 8, kDouble, 1e-16,  true,  N2kDoubleNA },
+    { "Altitude",             23, 8, kDouble, 1e-6,   true,  N2kDoubleNA },
+    { "GNSStype",             31, 1, kByte,   0,      false, 0x0f },
+    { "GNSSmethod",           31, 1, kByte,   0,      false, 0x0f },
+    { "nSatellites",          33, 1, kByte,   0,      false, 0xff },
+    { "HDOP",                 34, 2, kDouble, 0.01,   true,  N2kDoubleNA },
+    { "PDOP",                 36, 2, kDouble, 0.01,   true,  N2kDoubleNA },
+    { "GeoidalSeparation",    38, 4, kDouble, 0.01,   true,  N2kDoubleNA },
+    { "nReferenceStations",   42, 1, kByte,   0,      false, 0xff },
+    { "ReferenceStationType", 42, 1, kByte,   0,      false, N2kGNSSt_GPS },
+    { "ReferenceSationID",    42, 2, kUInt16, 0,      false, (uint16_t)N2kInt16NA },
+    { "AgeOfCorrection",      42, 2, kDouble, 0.01,   false, N2kDoubleNA },
+};
+
+void Set129029(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    SetN2kPGN129029(p_rMsg, (unsigned char)p_pV[0], (uint16_t)p_pV[1], p_pV[2],
+                    p_pV[3], p_pV[4], p_pV[5],
+                    (tN2kGNSStype)(int)p_pV[6], (tN2kGNSSmethod)(int)p_pV[7],
+                    (unsigned char)p_pV[8], p_pV[9], p_pV[10], p_pV[11],
+                    (unsigned char)p_pV[12], (tN2kGNSStype)(int)p_pV[13], (uint16_t)p_pV[14],
+                    p_pV[15]);
+}
+
+void DataSet129029(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    tN2kPGN129029Data l_data;
+    l_data.SID = (unsigned char)p_pV[0];
+    l_data.DaysSince1970 = (uint16_t)p_pV[1];
+    l_data.SecondsSinceMidnight = p_pV[2];
+    l_data.Latitude = p_pV[3];
+    l_data.Longitude = p_pV[4];
+    l_data.Altitude = p_pV[5];
+    l_data.GNSStype = (tN2kGNSStype)(int)p_pV[6];
+    l_data.GNSSmethod = (tN2kGNSSmethod)(int)p_pV[7];
+    l_data.nSatellites = (uint8_t)p_pV[8];
+    l_data.HDOP = p_pV[9];
+    l_data.PDOP = p_pV[10];
+    l_data.GeoidalSeparation = p_pV[11];
+    l_data.nReferenceStations = (uint8_t)p_pV[12];
+    l_data.ReferenceStationType = (tN2kGNSStype)(int)p_pV[13];
+    l_data.ReferenceSationID = (uint16_t)p_pV[14];
+    l_data.AgeOfCorrection = p_pV[15];
+    l_data.Encode(p_rMsg);
+}
+
+void RefSet129029(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    unsigned char l_nReferenceStations = (unsigned char)p_pV[12];
+    uint16_t l_referenceSationID = (uint16_t)p_pV[14];
+
+    p_rMsg.SetPGN(129029L);
+    p_rMsg.Priority = 3;
+    p_rMsg.AddByte((unsigned char)p_pV[0]);
+    p_rMsg.Add2ByteUInt((uint16_t)p_pV[1]);
+    p_rMsg.Add4ByteUDouble(p_pV[2], 0.0001);
+    p_rMsg.Add8ByteDouble(p_pV[3], 1e-16);
+    p_rMsg.Add8ByteDouble(p_pV[4], 1e-16);
+    p_rMsg.Add8ByteDouble(p_pV[5], 1e-6);
+    p_rMsg.AddByte((((unsigned char)(int)p_pV[6]) & 0x0f) | (((unsigned char)(int)p_pV[7]) & 0x0f) << 4);
+    p_rMsg.AddByte(1 | 0xfc);
+    p_rMsg.AddByte((unsigned char)p_pV[8]);
+    p_rMsg.Add2ByteDouble(p_pV[9], 0.01);
+    p_rMsg.Add2ByteDouble(p_pV[10], 0.01);
+    p_rMsg.Add4ByteDouble(p_pV[11], 0.01);
+    if (l_nReferenceStations != 0xff && l_nReferenceStations > 0)
+    {
+        p_rMsg.AddByte(1);
+        p_rMsg.Add2ByteInt((((int)p_pV[13]) & 0x0f) | l_referenceSationID << 4);
+        p_rMsg.Add2ByteUDouble(p_pV[15], 0.01);
+    }
+    else
+    {
+        p_rMsg.AddByte(l_nReferenceStations);
+    }
+}
+
+bool Parse129029(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    unsigned char l_sid;
+    uint16_t l_days;
+    tN2kGNSStype l_type;
+    tN2kGNSSmethod l_method;
+    unsigned char l_nSatellites;
+    unsigned char l_nReferenceStations;
+    tN2kGNSStype l_referenceStationType;
+    uint16_t l_referenceSationID;
+    bool l_ok = ParseN2kPGN129029(p_rMsg, l_sid, l_days, p_pV[2],
+                                  p_pV[3], p_pV[4], p_pV[5],
+                                  l_type, l_method,
+                                  l_nSatellites, p_pV[9], p_pV[10], p_pV[11],
+                                  l_nReferenceStations, l_referenceStationType, l_referenceSationID,
+                                  p_pV[15]);
+    p_pV[0] = l_sid;
+    p_pV[1] = l_days;
+    p_pV[6] = l_type;
+    p_pV[7] = l_method;
+    p_pV[8] = l_nSatellites;
+    p_pV[12] = l_nReferenceStations;
+    p_pV[13] = l_referenceStationType;
+    p_pV[14] = l_referenceSationID;
+    return l_ok;
+}
+
+bool DataParse129029(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    tN2kPGN129029Data l_data;
+    bool l_ok = l_data.Decode(p_rMsg);
+    p_pV[0] = l_data.SID;
+    p_pV[1] = l_data.DaysSince1970;
+    p_pV[2] = l_data.SecondsSinceMidnight;
+    p_pV[3] = l_data.Latitude;
+    p_pV[4] = l_data.Longitude;
+    p_pV[5] = l_data.Altitude;
+    p_pV[6] = l_data.GNSStype;
+    p_pV[7] = l_data.GNSSmethod;
+    p_pV[8] = l_data.nSatellites;
+    p_pV[9] = l_data.HDOP;
+    p_pV[10] = l_data.PDOP;
+    p_pV[11] = l_data.GeoidalSeparation;
+    p_pV[12] = l_data.nReferenceStations;
+    p_pV[13] = l_data.ReferenceStationType;
+    p_pV[14] = l_data.ReferenceSationID;
+    p_pV[15] = l_data.AgeOfCorrection;
+    return l_ok;
+}
+
+bool RefParse129029(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    if (p_rMsg.PGN != 129029L) return false;
+    int l_index = 0;
+    unsigned char l_vb;
+    int16_t l_vi;
+
+    p_pV[0] = p_rMsg.GetByte(l_index);
+    p_pV[1] = p_rMsg.Get2ByteUInt(l_index);
+    p_pV[2] = p_rMsg.Get4ByteUDouble(0.0001, l_index);
+    p_pV[3] = p_rMsg.Get8ByteDouble(1e-16, l_index);
+    p_pV[4] = p_rMsg.Get8ByteDouble(1e-16, l_index);
+    p_pV[5] = p_rMsg.Get8ByteDouble(1e-6, l_index);
+    l_vb = p_rMsg.GetByte(l_index);
+    p_pV[6] = (tN2kGNSStype)(l_vb & 0x0f);
+    p_pV[7] = (tN2kGNSSmethod)((l_vb >> 4) & 0x0f);
+    p_rMsg.GetByte(l_index);
+    p_pV[8] = p_rMsg.GetByte(l_index);
+    p_pV[9] = p_rMsg.Get2ByteDouble(0.01, l_index);
+    p_pV[10] = p_rMsg.Get2ByteDouble(0.01, l_index);
+    p_pV[11] = p_rMsg.Get4ByteDouble(0.01, l_index);
+    uint8_t l_nReferenceStations = p_rMsg.GetByte(l_index);
+    p_pV[12] = l_nReferenceStations;
+    if (l_nReferenceStations != N2kUInt8NA && l_nReferenceStations > 0)
+    {
+        l_vi = p_rMsg.Get2ByteUInt(l_index);
+        p_pV[13] = (tN2kGNSStype)(l_vi & 0x0f);
+        p_pV[14] = (uint16_t)(l_vi >> 4);
+        p_pV[15] = p_rMsg.Get2ByteUDouble(0.01, l_index);
+    }
+    else
+    {
+        p_pV[13] = N2kGNSSt_GPS;
+        p_pV[14] = (uint16_t)N2kInt16NA;
+        p_pV[15] = N2kDoubleNA;
+    }
+    return true;
+}
+
+//----------------------------------------------
+// 130306 Wind Speed
+//----------------------------------------------
+const Field k130306Fields[] =
+{
+    { "SID",           0, 1, kByte,   0,      false, 0xff },
+    { "WindSpeed",     1, 2, kDouble, 0.01,   false, N2kDoubleNA },
+    { "WindAngle",     3, 2, kDouble, 0.0001, false, N2kDoubleNA },
+    { "WindReference", 5, 1, kByte,   0,      false, 0x07 },
+};
+
+void Set130306(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    SetN2kPGN130306(p_rMsg, (unsigned char)p_pV[0], p_pV[1], p_pV[2], (tN2kWindReference)(int)p_pV[3]);
+}
+
+void DataSet130306(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    tN2kPGN130306Data l_data;
+    l_data.SID = (unsigned char)p_pV[0];
+    l_data.WindSpeed = p_pV[1];
+    l_data.WindAngle = p_pV[2];
+    l_data.WindReference = (tN2kWindReference)(int)p_pV[3];
+    l_data.Encode(p_rMsg);
+}
+
+void RefSet130306(tN2kMsg& p_rMsg, const double* p_pV)
+{
+    p_rMsg.SetPGN(130306L);
+    p_rMsg.Priority = 2;
+    p_rMsg.AddByte((unsigned char)p_pV[0]);
+    p_rMsg.Add2ByteUDouble(p_pV[1], 0.01);
+    p_rMsg.Add2ByteUDouble(p_pV[2], 0.0001);
+    p_rMsg.AddByte((unsigned char)(int)p_pV[3]);
+    p_rMsg.AddByte(0xff);
+    p_rMsg.AddByte(0xff);
+}
+
+bool Parse130306(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    unsigned char l_sid;
+    tN2kWindReference l_windReference;
+    bool l_ok = ParseN2kPGN130306(p_rMsg, l_sid, p_pV[1], p_pV[2], l_windReference);
+    p_pV[0] = l_sid;
+    p_pV[3] = l_windReference;
+    return l_ok;
+}
+
+bool DataParse130306(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    tN2kPGN130306Data l_data;
+    bool l_ok = l_data.Decode(p_rMsg);
+    p_pV[0] = l_data.SID;
+    p_pV[1] = l_data.WindSpeed;
+    p_pV[2] = l_data.WindAngle;
+    p_pV[3] = l_data.WindReference;
+    return l_ok;
+}
+
+bool RefParse130306(const tN2kMsg& p_rMsg, double* p_pV)
+{
+    if (p_rMsg.PGN != 130306L) return false;
+    int l_index = 0;
+    p_pV[0] = p_rMsg.GetByte(l_index);
+    p_pV[1] = p_rMsg.Get2ByteUDouble(0.01, l_index);
+    p_pV[2] = p_rMsg.Get2ByteUDouble(0.0001, l_index);
+    p_pV[3] = (tN2kWindReference)(p_rMsg.GetByte(l_index) & 0x07);
+    return true;
+}
+
+#define FIELDS(a) a, (int)(sizeof(a) / sizeof(a[0]))
+
+const PGNCase kCases[] =
+{
+    { 127250L, 8,  8,  FIELDS(k127250Fields), Set127250, DataSet127250, RefSet127250, Parse127250, DataParse127250, RefParse127250 },
+    { 128259L, 8,  8,  FIELDS(k128259Fields), Set128259, DataSet128259, RefSet128259, Parse128259, DataParse128259, RefParse128259 },
+    { 129025L, 8,  8,  FIELDS(k129025Fields), Set129025, DataSet129025, RefSet129025, Parse129025, DataParse129025, RefParse129025 },
+    { 129026L, 8,  8,  FIELDS(k129026Fields), Set129026, DataSet129026, RefSet129026, Parse129026, DataParse129026, RefParse129026 },
+    { 129029L, 42, 47, FIELDS(k129029Fields), Set129029, DataSet129029, RefSet129029, Parse129029, DataParse129029, RefParse129029 },
+    { 130306L, 8,  8,  FIELDS(k130306Fields), Set130306, DataSet130306, RefSet130306, Parse130306, DataParse130306, RefParse130306 },
+};
+
+} // namespace
+
+int main()
+{
+    int l_failures = 0;
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++)
+    {
+        l_failures += RunCase(kCases[i]);
+    }
+    return l_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Test of the source filter rate limit
+//
+//                        make test
+//
+//                        The token buckets of SourceFilter are checked with
+//                        times that go forward and that step back. After a
+//                        step back a bucket must refill from the new time,
+//                        and a bucket in use must not be removed when the
+//                        filter makes room for a new source.
+//
+//                        Exits 0 when all checks pass.
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <stdint.h>
+#include <stdio.h>
+#include <arpa/inet.h>
+
+// C++ includes
+
+// includes
+#include "Network/SourceFilter.h"
+
+namespace
+{
+
+const uint32_t kRate = 10;                  ///< datagrams a second
+const uint32_t kBurst = 2;                  ///< datagrams at once
+const uint64_t kTokenUs = 1000000 / kRate;  ///< time to refill one datagram
+const uint64_t kStartUs = 1000000000ULL;    ///< first time used
+const uint64_t kStepBackUs = 5000000;       ///< size of the step back
+const uint32_t kMaxSources = 256;           ///< SourceFilter::kMaxSources
+
+//----------------------------------------------
+// Address of source p_index, network byte order
+//----------------------------------------------
+uint32_t Source(uint32_t p_index)
+{
+    return htonl(0x0a000000u + p_index);
+}
+
+const char* VerdictName(eSourceVerdict p_verdict)
+{
+    switch (p_verdict)
+    {
+    case eSourceVerdict::Accept:
+        return "accept";
+    case eSourceVerdict::Denied:
+        return "denied";
+    case eSourceVerdict::Limited:
+        return "limited";
+    }
+    return "unknown";
+}
+
+void Check(SourceFilter& p_rFilter, uint32_t p_source, uint64_t p_nowUs, eSourceVerdict p_expected,
+           const char* p_pWhat, int& p_rFailures)
+{
+    eSourceVerdict l_verdict = p_rFilter.Check(Source(p_source), p_nowUs);
+    if (l_verdict != p_expected)
+    {
+        printf("  %s: %s, expected %s\n", p_pWhat, VerdictName(l_verdict), VerdictName(p_expected));
+        p_rFailures++;
+    }
+}
+
+//----------------------------------------------
+// Bucket refills at the rate while the time goes forward
+//----------------------------------------------
+void CheckForward(int& p_rFailures)
+{
+    SourceFilter l_filter(kRate, kBurst);
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Accept, "forward: first datagram", p_rFailures);
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Accept, "forward: burst", p_rFailures);
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Limited, "forward: over the burst", p_rFailures);
+    Check(l_filter, 1, kStartUs + kTokenUs - 1, eSourceVerdict::Limited, "forward: before a refill", p_rFailures);
+    Check(l_filter, 1, kStartUs + kTokenUs, eSourceVerdict::Accept, "forward: after a refill", p_rFailures);
+}
+
+//----------------------------------------------
+// After a step back the bucket refills from the new time, not from when
+// the time passes the old one again
+//----------------------------------------------
+void CheckStepBack(int& p_rFailures)
+{
+    SourceFilter l_filter(kRate, kBurst);
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Accept, "step back: first datagram", p_rFailures);
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Accept, "step back: burst", p_rFailures);
+
+    uint64_t l_backUs = kStartUs - kStepBackUs;
+    Check(l_filter, 1, l_backUs, eSourceVerdict::Limited, "step back: empty bucket is not refilled", p_rFailures);
+    Check(l_filter, 1, l_backUs + kTokenUs, eSourceVerdict::Accept, "step back: refill from the new time", p_rFailures);
+    Check(l_filter, 1, l_backUs + kTokenUs, eSourceVerdict::Limited, "step back: one datagram refilled", p_rFailures);
+}
+
+//----------------------------------------------
+// With every source tracked, a new source after a step back must not
+// remove the buckets that are in use
+//----------------------------------------------
+void CheckStepBackEviction(int& p_rFailures)
+{
+    SourceFilter l_filter(kRate, kBurst);
+    for (uint32_t l_source = 1; l_source <= kMaxSources; l_source++)
+    {
+        Check(l_filter, l_source, kStartUs, eSourceVerdict::Accept, "eviction: source tracked", p_rFailures);
+    }
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Accept, "eviction: burst", p_rFailures);
+    Check(l_filter, 1, kStartUs, eSourceVerdict::Limited, "eviction: over the burst", p_rFailures);
+
+    uint64_t l_backUs = kStartUs - kStepBackUs;
+    Check(l_filter, kMaxSources + 1, l_backUs, eSourceVerdict::Accept, "eviction: new source", p_rFailures);
+    Check(l_filter, 1, l_backUs, eSourceVerdict::Limited, "eviction: bucket in use was removed", p_rFailures);
+
+    // once idle for a full refill after the step back they can go
+    uint64_t l_idleUs = l_backUs + kBurst * kTokenUs;
+    Check(l_filter, kMaxSources + 2, l_idleUs, eSourceVerdict::Accept, "eviction: new source when idle", p_rFailures);
+    Check(l_filter, 1, l_idleUs, eSourceVerdict::Accept, "eviction: refilled", p_rFailures);
+    Check(l_filter, 1, l_idleUs, eSourceVerdict::Accept, "eviction: refilled to the burst", p_rFailures);
+}
+
+} // namespace
+
+int main()
+{
+    int l_failures = 0;
+    CheckForward(l_failures);
+    CheckStepBack(l_failures);
+    CheckStepBackEviction(l_failures);
+
+    printf("Source filter: %s", l_failures == 0 ? "ok" : "FAILED");
+    if (l_failures != 0)
+    {
+        printf(", %d failures", l_failures);
+    }
+    printf("\n");
+    return l_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#!/bin/sh
+############################################################################
+#
+# Copyright(c) 2026, Chelton Ltd.
+#
+############################################################################
+#
+# Description          : Runs builds of the benchmark suite made with
+#                        different flags and prints the cpu time of each
+#                        benchmark side by side, with the gain over the
+#                        first build
+#
+#                        Tools/BenchCompare.sh <bench> <bench> ...
+#                        (make bench-compare)
+#
+# Originator           : Lee Playford
+#
+# Creation Date        : 19 October 2026
+#
+############################################################################
+
+if [ $# -lt 2 ]
+then
+    echo "usage: $0 <baseline bench> <bench> ..." >&2
+    exit 1
+fi
+
+MIN_TIME=${BENCH_MIN_TIME:-0.2}
+RESULTS=$(mktemp -d)
+trap 'rm -rf "$RESULTS"' EXIT
+
+# cpu time per benchmark of each build, name,time in ns
+INDEX=0
+for BENCH in "$@"
+do
+    INDEX=$((INDEX + 1))
+    echo "running $BENCH" >&2
+    "$BENCH" --benchmark_format=csv --benchmark_min_time="$MIN_TIME" 2>/dev/null |
+        awk -F, '/^"/ {
+            gsub(/"/, "", $1)
+            t = $4
+            if ($5 == "us") t *= 1000
+            if ($5 == "ms") t *= 1000000
+            printf "%s,%.1f\n", $1, t
+        }' > "$RESULTS/$INDEX"
+done
+
+# table of ns/op, x the gain over the baseline
+awk -F, -v builds="$*" '
+    BEGIN {
+        count = split(builds, names, " ")
+        printf "%-40s", "ns/op"
+        for (b = 1; b <= count; b++)
+        {
+            n = split(names[b], parts, "/")
+            label = (n > 1) ? parts[n - 1] : names[b]
+            printf " %18s", label
+        }
+        printf "\n"
+    }
+    {
+        split(FILENAME, path, "/")
+        build = path[length(path)]
+        if (!($1 in seen))
+        {
+            seen[$1] = 1
+            order[++rows] = $1
+        }
+        time[$1, build] = $2
+    }
+    END {
+        for (r = 1; r <= rows; r++)
+        {
+            name = order[r]
+            printf "%-40s", name
+            for (b = 1; b <= count; b++)
+            {
+                if ((name, b) in time)
+                {
+                    gain = (time[name, b] > 0) ? time[name, 1] / time[name, b] : 0
+                    printf " %10.1f %6.2fx", time[name, b], gain
+                }
+                else
+                {
+                    printf " %18s", "-"
+                }
+            }
+            printf "\n"
+        }
+    }' $(seq -f "$RESULTS/%g" 1 $INDEX)
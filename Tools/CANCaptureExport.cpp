@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : CAN capture export, prints the files of a CAN
+//                        capture set (see CANRecorder.h) as candump log
+//                        text, oldest first
+//
+//                        cancapture [-x] <file> [<file> ...]
+//                        -x adds R or T for received and sent frames
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/can.h>
+
+// C++ includes
+
+// includes
+#include "CANRecorder.h"
+
+namespace
+{
+    //-------------------------------------
+    // print a record as a candump -l line
+    //-------------------------------------
+    void Export(const char * p_pInterface, const tCANCaptureRecord & p_rRecord, const unsigned char * p_pData, bool p_direction)
+    {
+        // identifier as candump prints it
+        char l_id[16];
+        if (p_rRecord.CANId & CAN_ERR_FLAG)
+        {
+            snprintf(l_id, sizeof(l_id), "%08X", p_rRecord.CANId & (CAN_ERR_MASK | CAN_ERR_FLAG));
+        }
+        else if (p_rRecord.CANId & CAN_EFF_FLAG)
+        {
+            snprintf(l_id, sizeof(l_id), "%08X", p_rRecord.CANId & CAN_EFF_MASK);
+        }
+        else
+        {
+            snprintf(l_id, sizeof(l_id), "%03X", p_rRecord.CANId & CAN_SFF_MASK);
+        }
+
+        char l_data[2 * CANFD_MAX_DLEN + 1];
+        for (int l_index = 0; l_index < p_rRecord.Len; l_index++)
+        {
+            snprintf(l_data + 2 * l_index, 3, "%02X", p_pData[l_index]);
+        }
+        l_data[2 * p_rRecord.Len] = '\0';
+
+        printf("(%llu.%06llu) %s %s", static_cast<unsigned long long>(p_rRecord.TimeUs / 1000000),
+               static_cast<unsigned long long>(p_rRecord.TimeUs % 1000000), p_pInterface, l_id);
+        if (p_rRecord.Flags & ccf_FD)
+        {
+            printf("##%X%s", (p_rRecord.Flags & ccf_BRS) ? CANFD_BRS : 0, l_data);
+        }
+        else
+        {
+            printf("#%s", l_data);
+        }
+        if (p_direction)
+        {
+            printf((p_rRecord.Flags & ccf_Tx) ? " T" : " R");
+        }
+        printf("\n");
+    }
+}
+
+//-------------------------------------
+//
+//-------------------------------------
+int main(int argc, char * argv[])
+{
+    bool l_direction = false;
+    int l_first = 1;
+    if (argc > 1 && strcmp(argv[1], "-x") == 0)
+    {
+        l_direction = true;
+        l_first++;
+    }
+    if (l_first >= argc)
+    {
+        fprintf(stderr, "usage: %s [-x] <capture_n.n2c> ...\n", argv[0]);
+        return 1;
+    }
+
+    tCANCaptureReader l_reader;
+    if (!l_reader.Open(argv + l_first, argc - l_first))
+    {
+        return 1;
+    }
+
+    tCANCaptureRecord l_record;
+    const unsigned char * l_pData;
+    char l_interface[sizeof(tCANCaptureHeader::Interface) + 1];
+    while (l_reader.Next(l_record, l_pData))
+    {
+        Export(l_reader.GetInterface(l_interface, sizeof(l_interface)), l_record, l_pData, l_direction);
+    }
+
+    if (l_reader.IsCorrupt())
+    {
+        fprintf(stderr, "capture has corrupt records, they were skipped\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright(c) 2026, Chelton Ltd.
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// Description          : Binary event log decoder, prints a binary log
+//                        file (EventLog_DD_MM_YYYY.bin) as text
+//
+//                        logdecode <file> [<file> ...]
+//
+// Originator           : Lee Playford
+//
+// Creation Date        : 19 October 2026
+//
+////////////////////////////////////////////////////////////////////////////
+
+// C includes
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// C++ includes
+#include <map>
+#include <string>
+
+// includes
+#include "BinaryLog.h"
+
+namespace
+{
+    const int cMaxTextSize = 1024;
+
+    //-------------------------------------
+    // read exactly p_length bytes
+    //-------------------------------------
+    bool ReadBytes(FILE * p_pFile, void * p_pBuffer, size_t p_length)
+    {
+        return fread(p_pBuffer, 1, p_length, p_pFile) == p_length;
+    }
+
+    //-------------------------------------
+    // same time format as the text log
+    //-------------------------------------
+    void PrintTime(int64_t p_timeMs)
+    {
+        int l_mseconds = static_cast<int>(p_timeMs % 1000);
+        int64_t l_secondsEpoch = p_timeMs / 1000;
+        printf("[%02d:%02d:%02d:%03d] ",
+               static_cast<int>((l_secondsEpoch / 3600) % 24),
+               static_cast<int>((l_secondsEpoch / 60) % 60),
+               static_cast<int>(l_secondsEpoch % 60),
+               l_mseconds);
+    }
+
+    //-------------------------------------
+    // decode one file, false if it is not a binary log or is corrupt
+    //-------------------------------------
+    bool Decode(const char * p_pFileName)
+    {
+        FILE * l_pFile = fopen(p_pFileName, "rb");
+        if (l_pFile == nullptr)
+        {
+            perror(p_pFileName);
+            return false;
+        }
+
+        char l_magic[sizeof(BinaryLog::cFileMagic)];
+        if (!ReadBytes(l_pFile, l_magic, sizeof(l_magic))
+            || memcmp(l_magic, BinaryLog::cFileMagic, sizeof(l_magic)) != 0)
+        {
+            fprintf(stderr, "%s: not a binary event log\n", p_pFileName);
+            fclose(l_pFile);
+            return false;
+        }
+
+        std::map<uint16_t, std::string> l_formats;
+        bool l_success = true;
+        int l_type;
+        while ((l_type = fgetc(l_pFile)) != EOF)
+        {
+            uint16_t l_formatId;
+            uint16_t l_length;
+            if (l_type == BinaryLog::cRecordFormat)
+            {
+                std::string l_format;
+                if (!ReadBytes(l_pFile, &l_formatId, sizeof(l_formatId))
+                    || !ReadBytes(l_pFile, &l_length, sizeof(l_length)))
+                {
+                    l_success = false;
+                    break;
+                }
+                l_format.resize(l_length);
+                if (l_length > 0 && !ReadBytes(l_pFile, &l_format[0], l_length))
+                {
+                    l_success = false;
+                    break;
+                }
+                l_formats[l_formatId] = l_format;
+            }
+            else if (l_type == BinaryLog::cRecordMessage)
+            {
+                int64_t l_timeMs;
+                char l_args[UINT16_MAX];
+                if (!ReadBytes(l_pFile, &l_formatId, sizeof(l_formatId))
+                    || !ReadBytes(l_pFile, &l_timeMs, sizeof(l_timeMs))
+                    || !ReadBytes(l_pFile, &l_length, sizeof(l_length))
+                    || !ReadBytes(l_pFile, l_args, l_length))
+                {
+                    l_success = false;
+                    break;
+                }
+
+                char l_text[cMaxTextSize];
+                std::map<uint16_t, std::string>::const_iterator l_it = l_formats.find(l_formatId);
+                if (l_it == l_formats.end())
+                {
+                    snprintf(l_text, sizeof(l_text), "<unknown format %u>", l_formatId);
+                }
+                else
+                {
+                    BinaryLog::Format(l_it->second.c_str(), l_args, l_length, l_text, sizeof(l_text));
+                }
+                PrintTime(l_timeMs);
+                printf("#Debug# %s\n", l_text);
+            }
+            else
+            {
+                l_success = false;
+                break;
+            }
+        }
+
+        if (!l_success)
+        {
+            fprintf(stderr, "%s: truncated or corrupt record at offset %ld\n", p_pFileName, ftell(l_pFile));
+        }
+        fclose(l_pFile);
+        return l_success;
+    }
+}
+
+//-------------------------------------
+//
+//-------------------------------------
+int main(int argc, char * argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <EventLog_DD_MM_YYYY.bin> ...\n", argv[0]);
+        return 1;
+    }
+
+    int l_result = 0;
+    for (int l_index = 1; l_index < argc; l_index++)
+    {
+        if (!Decode(argv[l_index]))
+        {
+            l_result = 1;
+        }
+    }
+    return l_result;
+}
@@ -138,6 +138,22 @@ uint64_t Utils::CurrentTimestampMilliSeconds()
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+//--------------------------
+//
+//--------------------------
+uint64_t Utils::CurrentTimestampMicroSeconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+//--------------------------
+//
+//--------------------------
+uint64_t Utils::MonotonicTimestampMicroSeconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 /// toFloat
 ///- Details:   Converts a uint32_t to a float
 ///
@@ -100,6 +100,22 @@ public:
     ///- Throws:    n/a
     static uint64_t CurrentTimestampMilliSeconds();
 
+    /// Current Timestamp microseconds
+    ///- Details:   returns the current timestamp in microseconds, the
+    ///             clock of the kernel receive timestamps (tN2kMsg::MsgTimeUs)
+    ///
+    ///- Returns:   timestamp in microseconds (since epoch)
+    ///- Throws:    n/a
+    static uint64_t CurrentTimestampMicroSeconds();
+
+    /// Monotonic Timestamp microseconds
+    ///- Details:   returns a timestamp in microseconds that never steps
+    ///             back, for measuring intervals
+    ///
+    ///- Returns:   timestamp in microseconds (from an unspecified start)
+    ///- Throws:    n/a
+    static uint64_t MonotonicTimestampMicroSeconds();
+
     /// Get Interface Address
     ///- Details:   return the IP address, broadcast address and netmask of the interface
     ///
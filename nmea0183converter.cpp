@@ -14,16 +14,20 @@
 #include "Handlers/MessageHandler.h"
 
 #include "EventLogger.h"
+#include "Utils.h"
 
 #include <sstream>
 #include <iomanip>
 #include <complex>
 
 //-------------------------------------
-// Handler vars
+// Handler vars, for the converter running on the thread. Each
+// converter thread sets them so several converters can run
 //-------------------------------------
-tBoatData* pBD;
-tNMEA2000* pNMEA2000;
+thread_local tBoatData* pBD;
+thread_local std::vector<CANInterface*>* pCANInterfaces;
+thread_local uint64_t sentenceReceivedUs;    // receive time of the sentence being converted
+thread_local AISDecoder* pAIS;
 
 const double cDegToRads = M_PI / 180.0;
 const double cRadsToDeg = 180.0 / M_PI;
@@ -33,6 +37,20 @@ const double M_2PI = 2 * M_PI;
 
 void HandleNMEA0183Msg(const tNMEA0183Msg &NMEA0183Msg);
 
+//-------------------------------------
+// Send a converted message to all the NMEA2000 buses, it carries
+// the receive time of the sentence
+//-------------------------------------
+static void SendN2kMsg(tN2kMsg &N2kMsg)
+{
+    N2kMsg.MsgTimeUs = sentenceReceivedUs;
+    LatencyTrace::Stamp(eTraceStage::Encode);
+    for (CANInterface* l_pInterface : *pCANInterfaces)
+    {
+        l_pInterface->SendMsg(N2kMsg, LatencyTrace::GetCurrent());
+    }
+}
+
 // Predefinition for functions to make it possible for constant definition for NMEA0183Handlers
 void HandleRMC(const tNMEA0183Msg &NMEA0183Msg);
 void HandleGGA(const tNMEA0183Msg &NMEA0183Msg);
@@ -45,6 +63,7 @@ void HandleDPT(const tNMEA0183Msg &NMEA0183Msg);
 void HandleGLL(const tNMEA0183Msg &NMEA0183Msg);
 void HandleZDA(const tNMEA0183Msg &NMEA0183Msg);
 void HandleRSA(const tNMEA0183Msg &NMEA0183Msg);
+void HandleVDM(const tNMEA0183Msg &NMEA0183Msg);
 
 
 
@@ -61,34 +80,59 @@ tNMEA0183Handler NMEA0183Handlers[] = {
     {"GLL", &HandleGLL},
     {"ZDA", &HandleZDA},
     {"RSA", &HandleRSA},
+    {"VDM", &HandleVDM},
+    {"VDO", &HandleVDM},
     {0, 0}};
 
 
+//-------------------------------------
+// metric labels of a converter
+//-------------------------------------
+static std::string ConverterLabels (const char * p_pName)
+{
+    return std::string("converter=\"") + p_pName + "\"";
+}
+
 //-------------------------------------
 //
 //-------------------------------------
-NMEA0183Converter::NMEA0183Converter ()
+NMEA0183Converter::NMEA0183Converter (const char * p_pName)
+    : m_aisDecoder (ConverterLabels(p_pName))
 {
     m_pBoatData = new tBoatData;
-    m_pNMEA2000 = (nullptr);
     pBD = m_pBoatData;
-    pNMEA2000 = m_pNMEA2000;
+    pCANInterfaces = &m_canInterfaces;
+    pAIS = &m_aisDecoder;
     m_isDst = false;
     m_currentYear = 0;
-
+    m_processed = 0;
+    RegisterMetrics(ConverterLabels(p_pName));
 }
 
 //-------------------------------------
 //
 //-------------------------------------
-NMEA0183Converter::NMEA0183Converter (tNMEA2000 & p_NMEA2000) : m_pNMEA2000 (&p_NMEA2000)
+NMEA0183Converter::NMEA0183Converter (CANInterface & p_rCANInterface, const char * p_pName)
+    : m_aisDecoder (ConverterLabels(p_pName))
 {
+    m_canInterfaces.push_back(&p_rCANInterface);
 
     m_pBoatData = new tBoatData;
     pBD = m_pBoatData;
-    pNMEA2000 = m_pNMEA2000;
+    pCANInterfaces = &m_canInterfaces;
+    pAIS = &m_aisDecoder;
     m_isDst = false;
     m_currentYear = 0;
+    m_processed = 0;
+    RegisterMetrics(ConverterLabels(p_pName));
+}
+
+//-------------------------------------
+//
+//-------------------------------------
+void NMEA0183Converter::AddInterface (CANInterface & p_rCANInterface)
+{
+    m_canInterfaces.push_back(&p_rCANInterface);
 }
 
 //-------------------------------------
@@ -101,11 +145,15 @@ NMEA0183Converter::~NMEA0183Converter()
 //-------------------------------------
 //
 //-------------------------------------
-bool NMEA0183Converter::Init ()
+bool NMEA0183Converter::Init (bool p_subscribe)
 {
     bool l_success (false);
         // subscribe to get updates
-    MessageHandler::SubscribeHandler("$", this);
+    if (p_subscribe)
+    {
+        MessageHandler::SubscribeHandler("$", this);
+        MessageHandler::SubscribeHandler("!", this);
+    }
     l_success = StartThread();
 
     memset (m_pBoatData , 0x0 , sizeof(tBoatData));
@@ -153,7 +201,8 @@ void NMEA0183Converter::StopThread()
 bool NMEA0183Converter::HandleMessage        (
             const uint8_t *p_pMessage,  ///< pointer to the message
             uint16_t &p_size,           ///< size of the message in bytes, returns the number of bytes processed
-            int p_socket           ///< socket receiving the data (-1 if the socket doesn't matter)
+            int /*p_socket*/,          ///< socket receiving the data, not used
+            uint32_t /*p_sourceAddress*/ ///< IPv4 address of the sender, not used, the source is filtered before
         )
 {
     if (p_pMessage == nullptr || p_size == 0)
@@ -161,22 +210,50 @@ bool NMEA0183Converter::HandleMessage        (
         return false; // No message to process
     }
 
-    tNMEA0183Msg NMEA0183Msg;
-    static char msgBuffer[128];
-    strncpy(msgBuffer, reinterpret_cast<const char*>(p_pMessage), sizeof(msgBuffer) - 1);
-    msgBuffer[sizeof(msgBuffer) - 1] = '\0'; // Ensure null
+    uint64_t l_receivedUs = Utils::CurrentTimestampMicroSeconds();
+    const char *l_pData = reinterpret_cast<const char*>(p_pMessage);
+    const char *l_pEnd = l_pData + p_size;
+    bool l_queued = false;
 
-    if (NMEA0183Msg.SetMessage(msgBuffer))
-    {
-        m_NMEA0183Queue.enqueue(NMEA0183Msg); // Add the message to the queue
-        return true; // Message processed successfully
-    } 
-    else
+    // a datagram can hold several sentences, e.g. the parts of an AIS message
+    while (l_pData < l_pEnd)
     {
-        // Handle parsing error
-        return false; // Parsing failed
-    }
+        const char *l_pLineEnd = static_cast<const char*>(memchr(l_pData, '\n', l_pEnd - l_pData));
+        size_t l_length = ((l_pLineEnd != nullptr) ? l_pLineEnd : l_pEnd) - l_pData;
+        const char *l_pLine = l_pData;
+        l_pData = (l_pLineEnd != nullptr) ? l_pLineEnd + 1 : l_pEnd;
+        if (l_length == 0 || *l_pLine == '\r' || *l_pLine == '\0')
+        {
+            continue;
+        }
+
+        char msgBuffer[128];    // on the stack, readers on several threads call in
+        if (l_length > sizeof(msgBuffer) - 1)
+        {
+            l_length = sizeof(msgBuffer) - 1;
+        }
+        memcpy(msgBuffer, l_pLine, l_length);
+        msgBuffer[l_length] = '\0'; // Ensure null
 
+        NMEA0183Entry l_entry;
+        l_entry.m_receivedUs = l_receivedUs;
+        if (l_entry.m_msg.SetMessage(msgBuffer))
+        {
+            LatencyTrace::Copy(l_entry.m_trace);
+            LatencyTrace::SetType(l_entry.m_trace, l_entry.m_msg.MessageCode());
+            LatencyTrace::Stamp(l_entry.m_trace, eTraceStage::Enqueue);
+            m_NMEA0183Queue.enqueue(l_entry); // Add the message to the queue
+            m_pQueued->Add();
+            m_pQueueDepth->Add(1);
+            l_queued = true;
+        }
+        else
+        {
+            // Handle parsing error
+            m_pRejected->Add();
+        }
+    }
+    return l_queued;
 }
 
 
@@ -185,24 +262,46 @@ bool NMEA0183Converter::HandleMessage        (
 //-------------------------------------
 void NMEA0183Converter::Thread ()
 {
+    pBD = m_pBoatData;
+    pCANInterfaces = &m_canInterfaces;
+    pAIS = &m_aisDecoder;
     while (m_threadRunning)
     {
-        if (!m_NMEA0183Queue.isEmpty())
+        NMEA0183Entry l_entry;
+        // Block until a message arrives, wake periodically to check for thread exit
+        if (m_NMEA0183Queue.dequeue_for(l_entry, std::chrono::milliseconds(100)))
         {
-            tNMEA0183Msg NMEA0183Msg = m_NMEA0183Queue.dequeue(); // Get the next message from the queue
-
             //EventLogger::Debug ("Qs=%d", m_NMEA0183Queue.size());
             // Process the NMEA0183 message
-            processNMEASentence(NMEA0183Msg);
-        }
-        else
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Sleep to avoid busy waiting
+            sentenceReceivedUs = l_entry.m_receivedUs;
+            LatencyTrace::Stamp(l_entry.m_trace, eTraceStage::Dequeue);
+            LatencyTrace::SetCurrent(&l_entry.m_trace);
+            processNMEASentence(l_entry.m_msg);
+            LatencyTrace::SetCurrent(nullptr);
+            LatencyTrace::Record(l_entry.m_trace, eTraceStage::Dispatch, eTraceStage::Encode);
+            m_pQueueDepth->Add(-1);
+            m_pConverted->Add();
+            m_pLatency->Record(Utils::CurrentTimestampMicroSeconds() - l_entry.m_receivedUs);
+            m_processed.fetch_add(1, std::memory_order_release);
         }
     }
 }
 
 
+//-------------------------------------
+//
+//-------------------------------------
+void NMEA0183Converter::RegisterMetrics (const std::string & p_rLabels)
+{
+    MetricsRegistry * l_pRegistry = MetricsRegistry::GetInstance();
+    m_pQueued = l_pRegistry->AddCounter("nmea2can_sentences_queued_total", "NMEA0183 sentences queued for conversion", p_rLabels);
+    m_pRejected = l_pRegistry->AddCounter("nmea2can_sentences_rejected_total", "Messages that were not a valid NMEA0183 sentence", p_rLabels);
+    m_pConverted = l_pRegistry->AddCounter("nmea2can_sentences_converted_total", "NMEA0183 sentences converted", p_rLabels);
+    m_pQueueDepth = l_pRegistry->AddGauge("nmea2can_sentence_queue_depth", "NMEA0183 sentences waiting for the converter", p_rLabels);
+    m_pLatency = l_pRegistry->AddHistogram("nmea2can_sentence_latency_us", "Time from a sentence being received to it being converted, us",
+                                           { 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 50000 }, p_rLabels);
+}
+
 //-------------------------------------
 //
 //-------------------------------------
@@ -301,7 +400,7 @@ std::string NMEA0183Converter::ConvertToDegreesMinutes(double value, bool isLati
       return;
     }
     // If no handler found, then just print the message
-    EventLogger::Debug ("Missed NMEA %s" , NMEA0183Msg.MessageCode());
+    EVENT_DEBUG("Missed NMEA %s", NMEA0183Msg.MessageCode());
   }
 
   // NMEA0183 message Handler functions
@@ -315,13 +414,14 @@ std::string NMEA0183Converter::ConvertToDegreesMinutes(double value, bool isLati
 
       if (NMEA0183ParseRMC_nc(NMEA0183Msg, pBD->GPSTime, pBD->Latitude, pBD->Longitude, pBD->COG, pBD->SOG, pBD->DaysSince1970, pBD->Variation))
       {
-          if (pNMEA2000 != 0)
+          LatencyTrace::Stamp(eTraceStage::Parse);
+          if (pCANInterfaces != 0)
           {
               tN2kMsg N2kMsg;
               SetN2kGNSS(N2kMsg, 1, pBD->DaysSince1970, pBD->GPSTime, pBD->Latitude, pBD->Longitude, 0,
                          N2kGNSSt_GPS, GNSMethofNMEA0183ToN2k(pBD->GPSQualityIndicator), pBD->SatelliteCount, pBD->HDOP, 0,
                          0, 1, N2kGNSSt_GPS, pBD->DGPSReferenceStationID, pBD->DGPSAge);
-              pNMEA2000->SendMsg(N2kMsg);
+              SendN2kMsg(N2kMsg);
           }
       }
   }
@@ -337,6 +437,7 @@ void HandleGSV(const tNMEA0183Msg &NMEA0183Msg)
     struct tGSV gsv[4];
     if (NMEA0183ParseGSV_nc(NMEA0183Msg,totMsg , thisMsg , pBD->SatelliteCount,gsv[0] , gsv[1] , gsv[2] , gsv[3]))
     {
+        LatencyTrace::Stamp(eTraceStage::Parse);
     }
     //else if (NMEA0183HandlersDebugStream!=0) { NMEA0183HandlersDebugStream->println("Failed to parse GSV");}
 } 
@@ -353,13 +454,14 @@ void HandleGGA(const tNMEA0183Msg &NMEA0183Msg)
     if (NMEA0183ParseGGA_nc(NMEA0183Msg,time,pBD->Latitude,pBD->Longitude,
                      pBD->GPSQualityIndicator,satcount,pBD->HDOP,pBD->Altitude,pBD->GeoidalSeparation,
                      pBD->DGPSAge,pBD->DGPSReferenceStationID)) {
-      if (pNMEA2000!=0) {
+      LatencyTrace::Stamp(eTraceStage::Parse);
+      if (pCANInterfaces!=0) {
         tN2kMsg N2kMsg;
         SetN2kGNSS(N2kMsg,1,pBD->DaysSince1970,pBD->GPSTime,pBD->Latitude,pBD->Longitude,pBD->Altitude,
                   N2kGNSSt_GPS,GNSMethofNMEA0183ToN2k(pBD->GPSQualityIndicator),pBD->SatelliteCount,pBD->HDOP,0,
                   pBD->GeoidalSeparation,1,N2kGNSSt_GPS,pBD->DGPSReferenceStationID,pBD->DGPSAge
                   );
-        pNMEA2000->SendMsg(N2kMsg); 
+        SendN2kMsg(N2kMsg); 
       }
   
      /* if (NMEA0183HandlersDebugStream!=0) {
@@ -390,21 +492,23 @@ void HandleGGA(const tNMEA0183Msg &NMEA0183Msg)
 
       if (NMEA0183ParseHDT_nc(NMEA0183Msg, pBD->TrueHeading))
       {
-          if (pNMEA2000 != 0)
+          LatencyTrace::Stamp(eTraceStage::Parse);
+          if (pCANInterfaces != 0)
           {
               tN2kMsg N2kMsg;
-              double MHeading = pBD->TrueHeading - pBD->Variation;
-              while (MHeading < 0)
+              // Variation is NA until RMC gives one, fmod as stepping round
+              // from a huge value takes seconds
+              double Variation = NMEA0183IsNA(pBD->Variation) ? 0 : pBD->Variation;
+              double MHeading = fmod(pBD->TrueHeading - Variation, PI_2);
+              if (MHeading < 0)
                   MHeading += PI_2;
-              while (MHeading >= PI_2)
-                  MHeading -= PI_2;
               // Stupid Raymarine can not use true heading
               SetN2kMagneticHeading(N2kMsg, 1, MHeading, 0, pBD->Variation);
-              pNMEA2000->SendMsg(N2kMsg);
+              SendN2kMsg(N2kMsg);
 
               SetN2kTrueHeading(N2kMsg, 1, pBD->TrueHeading);
-              pNMEA2000->SendMsg(N2kMsg);
-              // EventLogger::Debug("NMEA0183Converter::HandleHDT: HDG=%f", pBD->TrueHeading);
+              SendN2kMsg(N2kMsg);
+              // EVENT_DEBUG("NMEA0183Converter::HandleHDT: HDG=%f", pBD->TrueHeading);
           }
       }
   }
@@ -420,16 +524,17 @@ void HandleGGA(const tNMEA0183Msg &NMEA0183Msg)
 
       if (NMEA0183ParseVTG_nc(NMEA0183Msg, pBD->COG, MagneticCOG, pBD->SOG))
       {
+          LatencyTrace::Stamp(eTraceStage::Parse);
           MagneticCOG = 0.0;
           pBD->Variation = pBD->COG - MagneticCOG; // Save variation for Magnetic heading
-          if (pNMEA2000 != 0)
+          if (pCANInterfaces != 0)
           {
               tN2kMsg N2kMsg;
               SetN2kCOGSOGRapid(N2kMsg, 1, N2khr_true, pBD->COG, pBD->SOG);
-              pNMEA2000->SendMsg(N2kMsg);
+              SendN2kMsg(N2kMsg);
               SetN2kBoatSpeed(N2kMsg, 1, pBD->SOG);
-              pNMEA2000->SendMsg(N2kMsg);
-              // EventLogger::Debug("NMEA0183Converter::HandleVTG: COG=%f, SOG=%f", pBD->COG, pBD->SOG);
+              SendN2kMsg(N2kMsg);
+              // EVENT_DEBUG("NMEA0183Converter::HandleVTG: COG=%f, SOG=%f", pBD->COG, pBD->SOG);
           }
       }
   }
@@ -446,7 +551,8 @@ void HandleGGA(const tNMEA0183Msg &NMEA0183Msg)
       tNMEA0183WindReference WindReference = tNMEA0183WindReference::NMEA0183Wind_True; // Default to True wind
       if (NMEA0183ParseMWV_nc(NMEA0183Msg, WindAngle, WindReference, WindSpeed))
       {
-          if (pNMEA2000 != 0)
+          LatencyTrace::Stamp(eTraceStage::Parse);
+          if (pCANInterfaces != 0)
           {
               tN2kWindReference N2KWindReference = tN2kWindReference::N2kWind_Apparent; // Default to True wind
               if (WindReference == tNMEA0183WindReference::NMEA0183Wind_True)
@@ -458,7 +564,7 @@ void HandleGGA(const tNMEA0183Msg &NMEA0183Msg)
 
               tN2kMsg N2kMsg;
               SetN2kWindSpeed(N2kMsg, 1, pBD->AWS, pBD->AWA, N2KWindReference);
-              pNMEA2000->SendMsg(N2kMsg);
+              SendN2kMsg(N2kMsg);
 
               // Calculate the TWS and TWA
               if (WindReference == tNMEA0183WindReference::NMEA0183Wind_Apparent)
@@ -482,7 +588,7 @@ void HandleGGA(const tNMEA0183Msg &NMEA0183Msg)
 
 
                       SetN2kWindSpeed(N2kMsg, 1, pBD->TWS, pBD->TWA, tN2kWindReference::N2kWind_True_boat);
-                      pNMEA2000->SendMsg(N2kMsg);
+                      SendN2kMsg(N2kMsg);
                   }
               }
           }
@@ -500,13 +606,14 @@ void HandleVHW(const tNMEA0183Msg &NMEA0183Msg)
     double WaterSpeed, WaterDirectionMag , WaterDirectionTrue;
     if (NMEA0183ParseVHW_nc(NMEA0183Msg,WaterDirectionTrue , WaterDirectionMag , WaterSpeed))
     {
-        if (pNMEA2000 != 0)
+        LatencyTrace::Stamp(eTraceStage::Parse);
+        if (pCANInterfaces != 0)
         {
             tN2kMsg N2kMsg;
             SetN2kPGN128259(N2kMsg, 1, WaterSpeed, 0.0, tN2kSpeedWaterReferenceType::N2kSWRT_Paddle_wheel);
-            pNMEA2000->SendMsg(N2kMsg);
+            SendN2kMsg(N2kMsg);
             SetN2kPGN127250(N2kMsg, 1, WaterDirectionMag, 0.0,0.0,tN2kHeadingReference::N2khr_magnetic);
-            pNMEA2000->SendMsg(N2kMsg);
+            SendN2kMsg(N2kMsg);
         }
     }
 }
@@ -521,11 +628,12 @@ void HandleDPT(const tNMEA0183Msg &NMEA0183Msg)
     double DepthBelowTransducer, Offset , Range;
     if (NMEA0183ParseDPT_nc(NMEA0183Msg, DepthBelowTransducer, Offset, Range))
     {
-        if (pNMEA2000 != 0)
+        LatencyTrace::Stamp(eTraceStage::Parse);
+        if (pCANInterfaces != 0)
         {
             tN2kMsg N2kMsg;
             SetN2kPGN128267(N2kMsg, 1, DepthBelowTransducer, Offset, Range);
-            pNMEA2000->SendMsg(N2kMsg);
+            SendN2kMsg(N2kMsg);
         }
     }
 }
@@ -541,18 +649,19 @@ void HandleGLL(const tNMEA0183Msg &NMEA0183Msg)
     tGLL GLL;
     if (NMEA0183ParseGLL_nc(NMEA0183Msg,GLL))
     {
+        LatencyTrace::Stamp(eTraceStage::Parse);
         pBD->GPSTime = GLL.GPSTime;
         pBD->Latitude = GLL.latitude;
         pBD->Longitude = GLL.longitude;
 
         if (GLL.status == 'A') // 'A' = OK
         {
-            if (pNMEA2000 != 0)
+            if (pCANInterfaces != 0)
             {
                 tN2kMsg N2kMsg;
                 SetN2kGNSS(N2kMsg, 1, pBD->DaysSince1970, pBD->GPSTime, pBD->Latitude, pBD->Longitude,
                            0.0, tN2kGNSStype::N2kGNSSt_integrated, tN2kGNSSmethod::N2kGNSSm_DGNSS, 0, 0.0);
-                pNMEA2000->SendMsg(N2kMsg);
+                SendN2kMsg(N2kMsg);
             }
         }
     }
@@ -570,6 +679,7 @@ void HandleZDA(const tNMEA0183Msg &NMEA0183Msg)
     tZDA zda;
     if (NMEA0183ParseZDA(NMEA0183Msg, zda))
     {
+        LatencyTrace::Stamp(eTraceStage::Parse);
         //time_t lDT;
         tm lDT;
         lDT.tm_year = zda.GPSYear - 1900; // tm_year is years since 1900
@@ -587,11 +697,11 @@ void HandleZDA(const tNMEA0183Msg &NMEA0183Msg)
         }
         pBD->MOBActivated = false; // Reset MOB status on ZDA message
 
-        if (pNMEA2000 != 0)
+        if (pCANInterfaces != 0)
         {
             tN2kMsg N2kMsg;
             SetN2kPGN126992 (N2kMsg , 1 , pBD->DaysSince1970, zda.GPSTime,tN2kTimeSource::N2ktimes_GPS);
-            pNMEA2000->SendMsg(N2kMsg);
+            SendN2kMsg(N2kMsg);
         }
 
     }
@@ -609,16 +719,29 @@ void HandleRSA(const tNMEA0183Msg &NMEA0183Msg)
     
     if (NMEA0183Msg.FieldCount() > 2 )
     {
+        LatencyTrace::Stamp(eTraceStage::Parse);
     
         double rudderAngle = std::atof(NMEA0183Msg.Field(0));    // Convert rudder angle to radians
         rudderAngle *= cDegToRads; // Convert degrees to radians
         pBD->RudderAngle = rudderAngle; // Store the rudder angle in radians
 
-        if (pNMEA2000 != 0)
+        if (pCANInterfaces != 0)
         {
             tN2kMsg N2kMsg;
             SetN2kRudder(N2kMsg, rudderAngle );
-            pNMEA2000->SendMsg(N2kMsg);
+            SendN2kMsg(N2kMsg);
         }
     }
 }
+
+//-------------------------------------
+// AIS, VDM for other ships and VDO for our own. The decoder joins the
+// parts of a message and sends the PGNs when it is complete
+//-------------------------------------
+void HandleVDM(const tNMEA0183Msg &NMEA0183Msg)
+{
+    if (pAIS == 0 || pCANInterfaces == 0)
+        return;
+
+    pAIS->HandleSentence(NMEA0183Msg, &SendN2kMsg);
+}
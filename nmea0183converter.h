@@ -14,24 +14,39 @@
 //
 //--------------------------------------
 #include <string>
+#include <vector>
+#include <atomic>
 
 #include <NMEA0183.h>
 #include <NMEA0183Msg.h>
 #include <NMEA0183Messages.h>
 
-#include <NMEA2000/NMEA2000.h>
+#include "Network/CANInterface.h"
 
+#include "AISDecoder.h"
 #include "BoatData.h"
 #include "Handlers/MessageHandlerInterface.h"
 #include "IThread.h"
 
 #include "SafeQueue.h"
+#include "LatencyTrace.h"
+#include "Metrics.h"
 
 
 #define GPS_BAUD 9600
 #define GPS_MAX_SENTENCE 100
 
 
+//-------------------------------------
+// A received sentence and the time it was received
+//-------------------------------------
+struct NMEA0183Entry
+{
+    tNMEA0183Msg m_msg;
+    uint64_t m_receivedUs;  ///< us since epoch
+    TraceContext m_trace;   ///< stage times of the sentence
+};
+
 struct tNMEA0183Handler {
     const char *Code;
     void (*Handler)(const tNMEA0183Msg &NMEA0183Msg); 
@@ -44,18 +59,46 @@ struct tNMEA0183Handler {
   class NMEA0183Converter : public IMessageHandlerInterface, IThread
 {
     public:
-        NMEA0183Converter (tNMEA2000 & NMEA2000);
-        NMEA0183Converter ();
+        /// Constructor
+        ///- Details:   p_pName labels the metrics of the converter,
+        ///             converter="<name>", each converter needs its own
+        ///
+        ///- Returns:   n/a
+        ///- Throws:    n/a
+        NMEA0183Converter (CANInterface & p_rCANInterface, const char * p_pName = "main");
+        explicit NMEA0183Converter (const char * p_pName = "main");
         ~NMEA0183Converter();
 
-        bool Init ();
+        /// Init
+        ///- Details:   Starts the converter. A converter that is not
+        ///             subscribed only gets the sentences routed to it
+        ///
+        ///- Returns:   true if the thread started
+        ///- Throws:    n/a
+        bool Init (bool p_subscribe = true);
+
+        /// AddInterface
+        ///- Details:   Converted messages are sent to every added bus.
+        ///             Call before Init
+        ///
+        ///- Returns:   n/a
+        ///- Throws:    n/a
+        void AddInterface (CANInterface & p_rCANInterface);
         void processNMEASentence(tNMEA0183Msg& NMEA0183Msg);
 
+        /// GetProcessedCount
+        ///- Details:   Sentences taken off the queue and converted
+        ///
+        ///- Returns:   number of sentences
+        ///- Throws:    n/a
+        uint32_t GetProcessedCount() const { return m_processed.load(std::memory_order_acquire); }
+
         bool HandleMessage
         (
             const uint8_t *p_pMessage,  ///< pointer to the message
             uint16_t &p_size,           ///< size of the message in bytes, returns the number of bytes processed
-            int p_socket = -1           ///< socket receiving the data (-1 if the socket doesn't matter)
+            int p_socket = -1,          ///< socket receiving the data (-1 if the socket doesn't matter)
+            uint32_t p_sourceAddress = 0 ///< IPv4 address of the sender, network byte order (0 if not known)
         );
 
         /// Start Thread 
@@ -77,18 +120,27 @@ struct tNMEA0183Handler {
     void HandleNMEA0183Msg(const tNMEA0183Msg &NMEA0183Msg);
     void InitNMEA0183Handlers(tNMEA2000 *_NMEA2000, tBoatData *_BoatData);
     void Thread ();
+    void RegisterMetrics (const std::string & p_rLabels);
     std::string GetCurrentDate(unsigned long DaysSince1970)  ;
     std::string GetCurrentTime(double secondsSinceMidnight) const;
     std::string ConvertToDegreesMinutes(double value, bool isLatitude) const;
 
-    tNMEA2000 * m_pNMEA2000;
+    std::vector<CANInterface*> m_canInterfaces;
     tBoatData * m_pBoatData;
 
     bool m_isDst;
     int m_currentYear;
-    SafeQueue<tNMEA0183Msg> m_NMEA0183Queue;
+    SafeQueue<NMEA0183Entry> m_NMEA0183Queue;
+    std::atomic<uint32_t> m_processed;
+    AISDecoder m_aisDecoder;            ///< joins and decodes AIS messages
     bool m_runThread;
 
+    MetricCounter * m_pQueued;          ///< sentences queued for conversion
+    MetricCounter * m_pRejected;        ///< messages that were not a sentence
+    MetricCounter * m_pConverted;       ///< sentences converted
+    MetricGauge * m_pQueueDepth;        ///< sentences waiting
+    MetricHistogram * m_pLatency;       ///< receive to converted, us
+
 
 
 };
@@ -1,70 +1,293 @@
-#include "ssd1306.h"
-
-#include "EventLogger.h"
-#include "Network/UDPReader.h"
-#include "Network/UDPSender.h"
-#include "Handlers/MessageHandler.h"
-#include "nmea0183converter.h"
-#include "Config.h"
-
-#include "NMEA2000/NMEA2000.h"
-#include <NMEA2000_CAN.h>
-
-
-//-------------------------------------
-//
-//-------------------------------------
-int main( int argc, char * argv [] ) {
-
-	EventLogger::GetInstance()->SetLogLevel(eLogLevel::Debug);
-	
-	SSD1306 myDisplay;
-	myDisplay.initDisplay();
-	myDisplay.clearDisplay();
-	sleep(1);
- 
-	//	SSD1306 myDisplay;
-	myDisplay.setDisplayMode(SSD1306::Mode::SCROLL);
-	myDisplay.setWordWrap(TRUE);
-	myDisplay.textDisplay("NMEA 2 CAN");
-
-	// STart a Message Handler
-	MessageHandler msgHandler;
-
-	// Start a NMEA0183 convertor
-	NMEA0183Converter nmeaConverter (NMEA2000);
-
-	// Start a NMEA2000 instance
-	NMEA2000.SetMode(tNMEA2000::N2km_ListenAndSend , 45);
-	NMEA2000.EnableForward(false);
-	if (NMEA2000.Open())
-	{
-		NMEA2000.SetProductInformation("NMEA2CAN", 0x1234, "NMEA2CAN Model", "1.0", "1.0", 1, 2101, 0);
-		// Set device information
-    	NMEA2000.SetDeviceInformation(10101010, // Unique number. Use e.g. Serial number.
-                                132, // Device function=Analog to NMEA 2000 Gateway. See codes on http://www.nmea.org/Assets/20120726%20nmea%202000%20class%20&%20function%20codes%20v%202.00.pdf
-                                25, // Device class=Inter/Intranetwork Device. See codes on  http://www.nmea.org/Assets/20120726%20nmea%202000%20class%20&%20function%20codes%20v%202.00.pdf
-                                2046 // Just choosen free from code list on http://www.nmea.org/Assets/20121020%20nmea%202000%20registration%20list.pdf                               
-                               );
-		NMEA2000.SendProductInformation(0x0);
-		nmeaConverter.Init();
-	}
-	else
-	{
-		myDisplay.textDisplay("NMEA2000 Open failed");
-		EventLogger::Error ("NMEA2000 Open failed");
-		return -1;
-	}
-
-
-
-	std::string adaptor = "0.0.0.0";//cDEFAULT_ADAPTOR;
-	std::string address = "";
-	UDPReader udpReader (&msgHandler , 2031 ,adaptor , address , false);
-	while (udpReader.IsOpen()) {
-		sleep(1);
-	}
-	
-
-
-}
+#include "ssd1306.h"
+
+#include "EventLogger.h"
+#include "Network/UDPReader.h"
+#include "Network/UDPSender.h"
+#include "Network/SerialReader.h"
+#include "Network/TCPNetwork.h"
+#include "Network/Reactor.h"
+#include "Network/CANInterface.h"
+#include "Network/MetricsServer.h"
+#include "Network/SourceFilter.h"
+#include "Handlers/MessageHandler.h"
+#include "nmea0183converter.h"
+#include "Config.h"
+
+#include "N2kBridge.h"
+#include "N2kTo0183.h"
+#include "Replay.h"
+#include "LoopbackTest.h"
+#include "LatencyTrace.h"
+
+#include "NMEA2000/NMEA2000.h"
+#include <NMEA2000_SocketCAN.h>
+#include <N2kDeviceList.h>
+#include <CANRecorder.h>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <memory>
+#include <vector>
+
+
+//-------------------------------------
+// One NMEA2000 backbone. Each bus has its own address claim,
+// device list and reactor thread, so a saturated bus cannot
+// stall the other
+//-------------------------------------
+struct N2kBus
+{
+	N2kBus (const char * p_pPort, bool p_canFD)
+	: m_pPort (p_pPort)
+	, m_nmea2000 (p_pPort, p_canFD)
+	, m_interface (m_nmea2000, m_reactor)
+	, m_deviceList (&m_nmea2000)
+	{
+	}
+
+	const char * m_pPort;				///< CAN port
+	tCANRecorder m_recorder;			///< capture of the bus traffic
+	tNMEA2000_SocketCAN m_nmea2000;		///< NMEA2000 node on the bus
+	Reactor m_reactor;					///< CAN I/O thread
+	CANInterface m_interface;			///< tx queue to the bus
+	tN2kDeviceList m_deviceList;		///< devices seen on the bus
+};
+
+//-------------------------------------
+// Record the bus traffic to $HOME/capture/<port>_<n>.n2c
+//-------------------------------------
+static void StartCapture (N2kBus & p_rBus)
+{
+	std::string l_directory = std::string(getenv("HOME") ? getenv("HOME") : ".") + "/capture";
+	mkdir(l_directory.c_str(), 0777);
+	if (p_rBus.m_recorder.Open(l_directory.c_str(), p_rBus.m_pPort, p_rBus.m_pPort,
+							   cCAN_CAPTURE_FILES, cCAN_CAPTURE_FILE_SIZE))
+	{
+		p_rBus.m_nmea2000.SetRecorder(&p_rBus.m_recorder);
+	}
+	else
+	{
+		EventLogger::Error("CAN capture of %s not available", p_rBus.m_pPort);
+	}
+}
+
+//-------------------------------------
+// Open the NMEA2000 node on a bus
+//-------------------------------------
+static bool OpenBus (N2kBus & p_rBus, uint8_t p_address, uint32_t p_uniqueNumber)
+{
+	if (cCAN_CAPTURE)
+	{
+		StartCapture(p_rBus);
+	}
+	p_rBus.m_nmea2000.SetMode(tNMEA2000::N2km_ListenAndNode , p_address);
+	p_rBus.m_nmea2000.EnableForward(false);
+	if (!p_rBus.m_nmea2000.Open())
+	{
+		p_rBus.m_nmea2000.SetRecorder(NULL);
+		p_rBus.m_recorder.Close();
+		return false;
+	}
+
+	p_rBus.m_nmea2000.SetProductInformation("NMEA2CAN", 0x1234, "NMEA2CAN Model", "1.0", "1.0", 1, 2101, 0);
+	// Set device information
+	p_rBus.m_nmea2000.SetDeviceInformation(p_uniqueNumber, // Unique number. Use e.g. Serial number.
+                                132, // Device function=Analog to NMEA 2000 Gateway. See codes on http://www.nmea.org/Assets/20120726%20nmea%202000%20class%20&%20function%20codes%20v%202.00.pdf
+                                25, // Device class=Inter/Intranetwork Device. See codes on  http://www.nmea.org/Assets/20120726%20nmea%202000%20class%20&%20function%20codes%20v%202.00.pdf
+                                2046 // Just choosen free from code list on http://www.nmea.org/Assets/20121020%20nmea%202000%20registration%20list.pdf
+                               );
+	p_rBus.m_nmea2000.SendProductInformation(0x0);
+	return true;
+}
+
+//-------------------------------------
+// Start the CAN I/O thread of a bus
+//-------------------------------------
+static bool StartBus (N2kBus & p_rBus)
+{
+	return p_rBus.m_reactor.Init() && p_rBus.m_interface.Init() && p_rBus.m_reactor.StartThread();
+}
+
+
+//-------------------------------------
+// Run the gateway until the UDP input closes. The gateway objects
+// log from their destructors, so they all go out of scope here
+// before main shuts the logger down
+//-------------------------------------
+static int RunGateway ()
+{
+	SSD1306 myDisplay;
+	myDisplay.initDisplay();
+	myDisplay.clearDisplay();
+	sleep(1);
+ 
+	//	SSD1306 myDisplay;
+	myDisplay.setDisplayMode(SSD1306::Mode::SCROLL);
+	myDisplay.setWordWrap(TRUE);
+	myDisplay.textDisplay("NMEA 2 CAN");
+
+	// STart a Message Handler
+	MessageHandler msgHandler;
+
+	// NMEA2000 buses
+	N2kBus bus0 (cCAN_PORT_0, false);
+	N2kBus bus1 (cCAN_PORT_1, cCAN_FD_1);
+
+	// Start a NMEA0183 convertor
+	NMEA0183Converter nmeaConverter (bus0.m_interface);
+
+	// Bridge between the buses. Handlers must be attached before the reactors start
+	N2kBridge bridge (bus0.m_nmea2000, bus0.m_interface, bus1.m_nmea2000, bus1.m_interface);
+
+	// serial and TCP NMEA0183 share a reactor thread, started once the buses are
+	Reactor nmeaReactor;
+	TCPNetwork tcpNetwork (&msgHandler, nmeaReactor, cDEFAULT_TCP_PORT, cTCP_CLIENT_ADDRESS, cTCP_CLIENT_PORT);
+
+	// NMEA2000 from bus 0 back out as NMEA0183
+	N2kTo0183 n2kTo0183 (bus0.m_nmea2000);
+	n2kTo0183.AddOutput(&tcpNetwork);
+	std::unique_ptr<UDPSender> nmea0183Sender;
+	if (cNMEA0183_OUT_UDP_ADDRESS[0] != '\0')
+	{
+		nmea0183Sender.reset(new UDPSender (cNMEA0183_OUT_UDP_PORT, cNMEA0183_OUT_UDP_ADDRESS, cDEFAULT_ADAPTOR_ADDRESS, false));
+		n2kTo0183.AddOutput(nmea0183Sender.get());
+	}
+
+	if (!OpenBus(bus0, cN2K_ADDRESS_0, 10101010))
+	{
+		myDisplay.textDisplay("NMEA2000 Open failed");
+		EventLogger::Error ("NMEA2000 Open failed");
+		return -1;
+	}
+
+	// second bus is optional
+	bool l_bus1Open = OpenBus(bus1, cN2K_ADDRESS_1, 10101011);
+	if (l_bus1Open)
+	{
+		nmeaConverter.AddInterface(bus1.m_interface);
+		for (int l_index = 0; cBRIDGE_PGNS[l_index] != 0; l_index++)
+		{
+			bridge.AddPGN(cBRIDGE_PGNS[l_index]);
+		}
+	}
+	else
+	{
+		EventLogger::LogEvent("NMEA2000 %s not available, running single bus", cCAN_PORT_1);
+	}
+
+	if (!StartBus(bus0) || (l_bus1Open && !StartBus(bus1)))
+	{
+		myDisplay.textDisplay("CAN reactor failed");
+		EventLogger::Error ("CAN reactor failed");
+		// bus0 may be running, stop it before the buses go out of scope
+		bus1.m_reactor.StopThread();
+		bus0.m_reactor.StopThread();
+		return -1;
+	}
+	nmeaConverter.Init();
+
+	// metrics for scraping, the gateway runs without them
+	MetricsServer metricsServer (cMETRICS_PORT, cMETRICS_SOCKET);
+	if (!metricsServer.Init() || !metricsServer.StartThread())
+	{
+		EventLogger::Error ("Metrics server not available");
+	}
+
+
+	SerialReader serialReader (&msgHandler, nmeaReactor, cSERIAL_DEVICE, cSERIAL_BAUD);
+	SerialReader aisReader (&msgHandler, nmeaReactor, cSERIAL_DEVICE_AIS, cSERIAL_BAUD_AIS);
+	if (nmeaReactor.Init())
+	{
+		serialReader.Init();
+		aisReader.Init();
+		tcpNetwork.Init();
+		nmeaReactor.StartThread();
+	}
+
+	std::string adaptor = "0.0.0.0";//cDEFAULT_ADAPTOR;
+	std::string address = "";
+
+	// filter the UDP sources, the routed sources have a converter of their own
+	NMEA0183Converter bus1Converter ("bus1");
+	SourceFilter sourceFilter (cUDP_SOURCE_RATE, cUDP_SOURCE_BURST);
+	for (int l_index = 0; cUDP_ALLOW_SOURCES[l_index] != 0; l_index++)
+	{
+		sourceFilter.Allow(cUDP_ALLOW_SOURCES[l_index]);
+	}
+	for (int l_index = 0; cUDP_DENY_SOURCES[l_index] != 0; l_index++)
+	{
+		sourceFilter.Deny(cUDP_DENY_SOURCES[l_index]);
+	}
+	if (l_bus1Open && cUDP_ROUTE_BUS1_SOURCES[0] != 0)
+	{
+		bus1Converter.AddInterface(bus1.m_interface);
+		bus1Converter.Init(false);
+		for (int l_index = 0; cUDP_ROUTE_BUS1_SOURCES[l_index] != 0; l_index++)
+		{
+			sourceFilter.AddRoute(cUDP_ROUTE_BUS1_SOURCES[l_index], &bus1Converter);
+		}
+	}
+
+	// multicast is delivered to every socket in the group, so it is not sharded
+	uint32_t l_readers = (cUDP_MULTICAST_GROUP[0] == '\0') ? cUDP_READER_THREADS : 1;
+	std::vector<std::unique_ptr<UDPReader>> udpReaders;
+	for (uint32_t l_index = 0; l_index < l_readers; l_index++)
+	{
+		udpReaders.emplace_back(new UDPReader (&msgHandler , cUDP_NMEA_PORT ,adaptor , address , false,
+											   cUDP_MULTICAST_GROUP, l_readers > 1, &sourceFilter));
+	}
+	LatencyTrace::InstallSignalHandler();
+	while (udpReaders[0]->IsOpen()) {
+		sleep(1);
+		// kill -USR1 dumps the latency histograms
+		if (LatencyTrace::TakeDumpRequest())
+		{
+			for (const std::string & l_rLine : LatencyTrace::Report())
+			{
+				EventLogger::LogEvent("%s", l_rLine.c_str());
+			}
+		}
+	}
+
+	nmeaReactor.StopThread();
+	metricsServer.StopThread();
+
+	// stop the CAN I/O before the bridge detaches from the buses
+	bus1.m_reactor.StopThread();
+	bus0.m_reactor.StopThread();
+	return 0;
+}
+
+
+//-------------------------------------
+//
+//-------------------------------------
+int main( int argc, char * argv [] ) {
+
+	EventLogger::GetInstance()->SetLogLevel(eLogLevel::Debug);
+	EventLogger::GetInstance()->SetBinaryLogging(cBINARY_DEBUG_LOG);
+	LatencyTrace::Enable(cLATENCY_TRACE);
+
+	// replay of recorded traffic, no hardware needed
+	if (Replay::IsRequested(argc, argv))
+	{
+		int l_result = Replay::Run(argc, argv);
+		EventLogger::DestroyInstance();
+		return l_result;
+	}
+
+	// throughput of the NMEA2000 stack on an in-process bus
+	if (LoopbackTest::IsRequested(argc, argv))
+	{
+		int l_result = LoopbackTest::Run(argc, argv);
+		EventLogger::DestroyInstance();
+		return l_result;
+	}
+	
+	int l_result = RunGateway();
+
+	// write out the log messages still queued
+	EventLogger::DestroyInstance();
+	return l_result;
+}